@@ -1,24 +1,61 @@
 // ShaderBuildTool.cpp : Defines the entry point for the console application.
 //
+// Expands the #permutation lines of a shader into shader instances, compiles them in parallel
+// by running COMPILE_TOOL once per instance, and writes ENTRY_POINT.h and ENTRY_POINT.cpp.
+//
+// The compile tool receives its arguments through the SBT_* environment variables, and writes
+// the C++ definition of the compiled instance to SBT_OUTPUT. With --binary (SBT_FORMAT=BINARY),
+// it writes the raw bytecode or source text instead, which is packed into ENTRY_POINT.bin and
+// linked with GFSDK_SSAO_INCBIN (src/ShaderBlob.h), so that no large array is compiled as C++.
+// With --compress, the instances are stored in the LZ4 block format, and decompressed by the
+// library the first time they are used.
+// The outputs are cached on disk, keyed by a hash of the shader source and its includes, the
+// defines, and the compile tool and compiler files, so that only the instances affected by a
+// change are recompiled.
+// With --permutations, only the values listed in a project config file are built for its keys.
+// The enums keep all the values, and the Get() accessor of a pruned instance raises
+// THROW_PERMUTATION_NOT_BUILT (src/Common.h) instead of returning a shader that was not created.
+//
 
 #include "stdafx.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <stdarg.h>
+#include <stdint.h>
 #include <vector>
 #include <string>
 #include <sstream>
+#include <thread>
+#include <atomic>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <spawn.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+extern char **environ;
+#endif
 
 #define PERMUTATION_KEYWORD "#permutation "
+#define INCLUDE_KEYWORD "#include"
 #define SEPARATORS " \n"
 #define INDENT "    "
 
+#ifdef _WIN32
+#define PATH_SEPARATOR "\\"
+#else
+#define PATH_SEPARATOR "/"
+#endif
+
 namespace
 {
     struct CShaderPermutation
     {
         std::string Key;
         std::vector<std::string> Values;
+        std::vector<bool> IsBuilt;
     };
 
     struct CShaderDefine
@@ -30,17 +67,55 @@ namespace
     struct CShaderInstance
     {
         std::string GlobalVariableName;
+        std::string DefineString;
         std::vector<CShaderDefine> Defines;
     };
 
     typedef std::vector<CShaderInstance> CShaderInstances;
     typedef std::vector<CShaderPermutation> CShaderPermutations;
+
+    // 64-bit FNV-1a
+    struct CHash
+    {
+        CHash()
+            : Value(14695981039346656037ull)
+        {
+        }
+
+        void Add(const void* pData, size_t Size)
+        {
+            const unsigned char* pBytes = (const unsigned char*)pData;
+            for (size_t i = 0; i < Size; ++i)
+            {
+                Value = (Value ^ pBytes[i]) * 1099511628211ull;
+            }
+        }
+
+        // Strings are terminated, so that ("ab", "c") and ("a", "bc") hash differently
+        void Add(const std::string& S)
+        {
+            Add(S.c_str(), S.size() + 1);
+        }
+
+        std::string ToString() const
+        {
+            char Buffer[17];
+            snprintf(Buffer, sizeof(Buffer), "%016llx", (unsigned long long)Value);
+            return Buffer;
+        }
+
+        uint64_t Value;
+    };
 };
 
 FILE *OpenFile(std::string Path, const char* Mode)
 {
     FILE *fp = NULL;
+#ifdef _MSC_VER
     if (fopen_s(&fp, Path.c_str(), Mode) || !fp)
+#else
+    if (!(fp = fopen(Path.c_str(), Mode)))
+#endif
     {
         fprintf(stderr, "Failed to open file %s\n", Path.c_str());
         exit(1);
@@ -48,6 +123,152 @@ FILE *OpenFile(std::string Path, const char* Mode)
     return fp;
 }
 
+bool ReadFile(const std::string& Path, std::string& Contents)
+{
+    FILE *fp = NULL;
+#ifdef _MSC_VER
+    if (fopen_s(&fp, Path.c_str(), "rb") || !fp)
+#else
+    if (!(fp = fopen(Path.c_str(), "rb")))
+#endif
+    {
+        return false;
+    }
+
+    Contents.clear();
+    char Buffer[64 * 1024];
+    size_t Size;
+    while ((Size = fread(Buffer, 1, sizeof(Buffer), fp)) != 0)
+    {
+        Contents.append(Buffer, Size);
+    }
+
+    fclose(fp);
+    return true;
+}
+
+void WriteFile(const std::string& Path, const std::string& Contents)
+{
+    FILE *fp = OpenFile(Path, "wb");
+    if (fwrite(Contents.data(), 1, Contents.size(), fp) != Contents.size())
+    {
+        fprintf(stderr, "Failed to write file %s\n", Path.c_str());
+        exit(1);
+    }
+    fclose(fp);
+}
+
+// Keeps the timestamp of the outputs that have not changed, so that they are not recompiled
+void WriteFileIfChanged(const std::string& Path, const std::string& Contents)
+{
+    std::string OldContents;
+    if (!ReadFile(Path, OldContents) || OldContents != Contents)
+    {
+        WriteFile(Path, Contents);
+    }
+}
+
+void Printf(std::string& Out, const char* Format, ...)
+{
+    char Buffer[4096];
+    va_list Args;
+    va_start(Args, Format);
+    vsnprintf(Buffer, sizeof(Buffer), Format, Args);
+    va_end(Args);
+    Out += Buffer;
+}
+
+void MakeDirectory(const std::string& Path)
+{
+#ifdef _WIN32
+    CreateDirectoryA(Path.c_str(), NULL);
+#else
+    mkdir(Path.c_str(), 0777);
+#endif
+}
+
+std::string GetDirectory(const std::string& Path)
+{
+    const size_t Separator = Path.find_last_of("/\\");
+    return (Separator == std::string::npos) ? std::string() : Path.substr(0, Separator + 1);
+}
+
+// Writes an LZ4 sequence length: 15 in the token, then bytes of 255 and the remainder
+void AppendLZ4Length(std::string& Out, size_t Length)
+{
+    for (Length -= 15; Length >= 255; Length -= 255)
+    {
+        Out.push_back(char(255));
+    }
+    Out.push_back(char(Length));
+}
+
+// Greedy LZ4 block compression with a single-entry hash table, decoded by DecompressLZ4 in src/ShaderBlob.h
+std::string CompressLZ4(const std::string& In)
+{
+    const unsigned char* pIn = (const unsigned char*)In.data();
+    const size_t Size = In.size();
+
+    // The last match starts at least 12 bytes before the end, and the last 5 bytes are literals
+    const size_t MatchStartLimit = (Size > 12) ? Size - 12 : 0;
+    const size_t MatchEndLimit = (Size > 5) ? Size - 5 : 0;
+
+    std::vector<size_t> HashTable(1 << 16, size_t(-1));
+    std::string Out;
+    size_t Anchor = 0;
+    size_t Pos = 0;
+
+    while (Pos < MatchStartLimit)
+    {
+        uint32_t Sequence;
+        memcpy(&Sequence, pIn + Pos, 4);
+        const uint32_t Hash = (Sequence * 2654435761u) >> 16;
+        const size_t Candidate = HashTable[Hash];
+        HashTable[Hash] = Pos;
+
+        if (Candidate == size_t(-1) || Pos - Candidate > 65535 || memcmp(pIn + Candidate, pIn + Pos, 4) != 0)
+        {
+            ++Pos;
+            continue;
+        }
+
+        size_t MatchLength = 4;
+        while (Pos + MatchLength < MatchEndLimit && pIn[Candidate + MatchLength] == pIn[Pos + MatchLength])
+        {
+            ++MatchLength;
+        }
+
+        const size_t LiteralLength = Pos - Anchor;
+        Out.push_back(char(((LiteralLength < 15 ? LiteralLength : 15) << 4) | (MatchLength - 4 < 15 ? MatchLength - 4 : 15)));
+        if (LiteralLength >= 15)
+        {
+            AppendLZ4Length(Out, LiteralLength);
+        }
+        Out.append(In, Anchor, LiteralLength);
+
+        const size_t Offset = Pos - Candidate;
+        Out.push_back(char(Offset & 0xFF));
+        Out.push_back(char(Offset >> 8));
+        if (MatchLength - 4 >= 15)
+        {
+            AppendLZ4Length(Out, MatchLength - 4);
+        }
+
+        Pos += MatchLength;
+        Anchor = Pos;
+    }
+
+    const size_t LiteralLength = Size - Anchor;
+    Out.push_back(char((LiteralLength < 15 ? LiteralLength : 15) << 4));
+    if (LiteralLength >= 15)
+    {
+        AppendLZ4Length(Out, LiteralLength);
+    }
+    Out.append(In, Anchor, LiteralLength);
+
+    return Out;
+}
+
 CShaderInstances ExpandShaderInstances(CShaderInstances In, CShaderPermutation Permutation)
 {
     CShaderInstances Out;
@@ -55,6 +276,11 @@ CShaderInstances ExpandShaderInstances(CShaderInstances In, CShaderPermutation P
     {
         for (unsigned int ValueIndex = 0; ValueIndex < Permutation.Values.size(); ++ValueIndex)
         {
+            if (!Permutation.IsBuilt[ValueIndex])
+            {
+                continue;
+            }
+
             CShaderDefine D;
             D.Key = Permutation.Key;
             D.Value = Permutation.Values[ValueIndex];
@@ -68,28 +294,33 @@ CShaderInstances ExpandShaderInstances(CShaderInstances In, CShaderPermutation P
     return Out;
 }
 
-void MySystem(const char *Command)
+struct CArgs
 {
-    //printf("%s\n", Command);
-
-    if (system(Command) != 0)
+    CArgs()
+        : NumJobs(0)
+        , UseCache(true)
+        , Binary(false)
+        , Compress(false)
     {
-        fprintf(stderr, "Failed command: %s\n", Command);
-        exit(1);
     }
-}
 
-struct CArgs
-{
     std::string Profile;
     std::string Input;
     std::string EntryPoint;
     std::string OutputDir;
     std::string Output_H;
     std::string Output_CPP;
+    std::string Output_BIN;
     std::string CompileTool;
     std::string API;
     std::string ClassName;
+    std::string CacheDir;
+    std::string PermutationConfig;
+    std::vector<std::string> CompilerFiles;
+    unsigned int NumJobs;
+    bool UseCache;
+    bool Binary;
+    bool Compress;
 };
 
 void ParseInput(
@@ -103,7 +334,7 @@ void ParseInput(
     {
         if (strncmp(row, PERMUTATION_KEYWORD, strlen(PERMUTATION_KEYWORD)) == 0)
         {
-            char *Keyword = strtok(row, SEPARATORS);
+            strtok(row, SEPARATORS);
             char *DefineKey = strtok(NULL, SEPARATORS);
             if (!DefineKey) break;
 
@@ -116,6 +347,7 @@ void ParseInput(
                 if (!DefineValue) break;
 
                 P.Values.push_back(DefineValue);
+                P.IsBuilt.push_back(true);
             }
 
             ShaderPermutations.push_back(P);
@@ -125,7 +357,89 @@ void ParseInput(
     fclose(fp);
 }
 
+// Reads the --permutations config, whose lines are "KEY VALUE..." (and "# comments"), and only keeps
+// the listed values of these keys. The keys that the shader does not declare are ignored, so that
+// one config can be shared by all the shaders of a project.
+void PrunePermutations(
+    const CArgs& Args,
+    CShaderPermutations& ShaderPermutations)
+{
+    std::string Contents;
+    if (!ReadFile(Args.PermutationConfig, Contents))
+    {
+        fprintf(stderr, "Failed to open file %s\n", Args.PermutationConfig.c_str());
+        exit(1);
+    }
+
+    std::istringstream Lines(Contents);
+    std::string Line;
+    for (unsigned int LineNumber = 1; std::getline(Lines, Line); ++LineNumber)
+    {
+        std::istringstream Tokens(Line.substr(0, Line.find('#')));
+        std::string Key;
+        if (!(Tokens >> Key))
+        {
+            continue;
+        }
+
+        std::vector<std::string> Values;
+        std::string Value;
+        while (Tokens >> Value)
+        {
+            Values.push_back(Value);
+        }
+        if (Values.empty())
+        {
+            fprintf(stderr, "%s(%u): no value listed for %s\n", Args.PermutationConfig.c_str(), LineNumber, Key.c_str());
+            exit(1);
+        }
+
+        for (unsigned int PermutationIndex = 0; PermutationIndex < ShaderPermutations.size(); ++PermutationIndex)
+        {
+            CShaderPermutation& P = ShaderPermutations[PermutationIndex];
+            if (P.Key != Key)
+            {
+                continue;
+            }
+
+            P.IsBuilt.assign(P.Values.size(), false);
+            for (unsigned int i = 0; i < Values.size(); ++i)
+            {
+                unsigned int ValueIndex = 0;
+                while (ValueIndex < P.Values.size() && P.Values[ValueIndex] != Values[i])
+                {
+                    ++ValueIndex;
+                }
+                if (ValueIndex == P.Values.size())
+                {
+                    fprintf(stderr, "%s(%u): %s is not a value of %s in %s\n",
+                        Args.PermutationConfig.c_str(), LineNumber, Values[i].c_str(), Key.c_str(), Args.Input.c_str());
+                    exit(1);
+                }
+                P.IsBuilt[ValueIndex] = true;
+            }
+        }
+    }
+}
+
+// Whether some values of the permutation keys are not built
+bool IsPruned(const CShaderPermutations& ShaderPermutations)
+{
+    for (unsigned int i = 0; i < ShaderPermutations.size(); ++i)
+    {
+        for (unsigned int j = 0; j < ShaderPermutations[i].IsBuilt.size(); ++j)
+        {
+            if (!ShaderPermutations[i].IsBuilt[j])
+            {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
 void InitShaderInstances(
+    const CArgs& Args,
     const CShaderPermutations& ShaderPermutations,
     CShaderInstances& ShaderInstances
     )
@@ -138,88 +452,378 @@ void InitShaderInstances(
         CShaderPermutation P = ShaderPermutations[PermutationIndex];
         ShaderInstances = ExpandShaderInstances(ShaderInstances, P);
     }
-}
-
-void WriteCPP(
-    const CArgs& Args,
-    const CShaderPermutations& ShaderPermutations,
-    CShaderInstances& ShaderInstances)
-{
-    remove(Args.Output_CPP.c_str());
 
     for (unsigned int InstanceIndex = 0; InstanceIndex < ShaderInstances.size(); ++InstanceIndex)
     {
         CShaderInstance& Instance = ShaderInstances[InstanceIndex];
-        std::string DefineString = "/DAPI_" + Args.API + "=1";
         std::string ShaderName = Args.EntryPoint;
 
-        for (unsigned int i = 0; i < ShaderInstances[i].Defines.size(); ++i)
+        Instance.DefineString = "/DAPI_" + Args.API + "=1";
+        for (unsigned int i = 0; i < Instance.Defines.size(); ++i)
         {
-            DefineString += " /D" + Instance.Defines[i].Key + "=" + Instance.Defines[i].Value;
+            Instance.DefineString += " /D" + Instance.Defines[i].Key + "=" + Instance.Defines[i].Value;
             ShaderName += "_" + Instance.Defines[i].Key + "_" + Instance.Defines[i].Value;
         }
 
         Instance.GlobalVariableName = "g_" + ShaderName + "_" + Args.API;
+    }
+}
 
-        std::string OutputTmp = Args.Output_CPP + ".tmp";
-        std::string Command;
-        Command += "SET SBT_PROFILE=" + Args.Profile;
-        Command += "& SET SBT_INPUT=" + Args.Input;
-        Command += "& SET SBT_ENTRY_POINT=" + Args.EntryPoint;
-        Command += "& SET SBT_DEFINES=" + DefineString;
-        Command += "& SET SBT_VARIABLE_NAME=" + Instance.GlobalVariableName;
-        Command += "& SET SBT_OUTPUT=" + OutputTmp;
-        Command += "& " + Args.CompileTool;
-        MySystem(Command.c_str());
+// Hashes Path and the files it includes with #include "...", relative to the including file
+void HashSourceFile(const std::string& Path, CHash& Hash, std::vector<std::string>& VisitedPaths)
+{
+    for (unsigned int i = 0; i < VisitedPaths.size(); ++i)
+    {
+        if (VisitedPaths[i] == Path)
+        {
+            return;
+        }
+    }
+    VisitedPaths.push_back(Path);
+
+    std::string Contents;
+    if (!ReadFile(Path, Contents))
+    {
+        fprintf(stderr, "Failed to open file %s\n", Path.c_str());
+        exit(1);
+    }
+    Hash.Add(Contents);
 
-        Command = "type " + OutputTmp + " >> " + Args.Output_CPP;
-        MySystem(Command.c_str());
+    std::istringstream Lines(Contents);
+    std::string Line;
+    while (std::getline(Lines, Line))
+    {
+        const size_t Keyword = Line.find_first_not_of(" \t");
+        if (Keyword == std::string::npos || Line.compare(Keyword, strlen(INCLUDE_KEYWORD), INCLUDE_KEYWORD) != 0)
+        {
+            continue;
+        }
 
-        Command = "del " + OutputTmp;
-        MySystem(Command.c_str());
+        const size_t Begin = Line.find('"', Keyword);
+        const size_t End = (Begin == std::string::npos) ? std::string::npos : Line.find('"', Begin + 1);
+        if (End != std::string::npos)
+        {
+            HashSourceFile(GetDirectory(Path) + Line.substr(Begin + 1, End - Begin - 1), Hash, VisitedPaths);
+        }
     }
+}
+
+CHash HashCommonInputs(const CArgs& Args)
+{
+    CHash Hash;
+    Hash.Add(Args.Profile);
+    Hash.Add(Args.EntryPoint);
+    Hash.Add(Args.API);
+    Hash.Add(Args.Binary ? "BINARY" : "CPP");
 
-    FILE *fp = OpenFile(Args.Output_CPP, "a+");
+    std::vector<std::string> VisitedPaths;
+    HashSourceFile(Args.Input, Hash, VisitedPaths);
 
-    fprintf(fp, "\n");
-    fprintf(fp, "namespace Generated\n");
-    fprintf(fp, "{\n");
+    // The compile tool may be a command line instead of a script
+    std::string Contents;
+    Hash.Add(ReadFile(Args.CompileTool, Contents) ? Contents : Args.CompileTool);
 
-    fprintf(fp, INDENT "void %s::Create(DevicePointer Device)\n", Args.EntryPoint.c_str());
-    fprintf(fp, INDENT "{\n");
+    for (unsigned int i = 0; i < Args.CompilerFiles.size(); ++i)
+    {
+        if (!ReadFile(Args.CompilerFiles[i], Contents))
+        {
+            fprintf(stderr, "Failed to open file %s\n", Args.CompilerFiles[i].c_str());
+            exit(1);
+        }
+        Hash.Add(Contents);
+    }
+
+    return Hash;
+}
+
+// Runs the compile tool with the SBT_* variables added to the environment, and returns its exit code
+int RunCompileTool(const CArgs& Args, const CShaderInstance& Instance, const std::string& Output)
+{
+    std::vector<std::string> Variables;
+    Variables.push_back("SBT_PROFILE=" + Args.Profile);
+    Variables.push_back("SBT_INPUT=" + Args.Input);
+    Variables.push_back("SBT_ENTRY_POINT=" + Args.EntryPoint);
+    Variables.push_back("SBT_DEFINES=" + Instance.DefineString);
+    Variables.push_back("SBT_VARIABLE_NAME=" + Instance.GlobalVariableName);
+    Variables.push_back("SBT_OUTPUT=" + Output);
+    Variables.push_back(std::string("SBT_FORMAT=") + (Args.Binary ? "BINARY" : "CPP"));
+
+#ifdef _WIN32
+    std::string Environment;
+    char *pParentEnvironment = GetEnvironmentStringsA();
+    for (const char *pVariable = pParentEnvironment; *pVariable; pVariable += strlen(pVariable) + 1)
+    {
+        if (_strnicmp(pVariable, "SBT_", 4) != 0)
+        {
+            Environment.append(pVariable, strlen(pVariable) + 1);
+        }
+    }
+    FreeEnvironmentStringsA(pParentEnvironment);
+    for (unsigned int i = 0; i < Variables.size(); ++i)
+    {
+        Environment.append(Variables[i].c_str(), Variables[i].size() + 1);
+    }
+    Environment.push_back(0);
+
+    // Batch files are run through the command interpreter
+    const std::string Extension = (Args.CompileTool.size() >= 4) ? Args.CompileTool.substr(Args.CompileTool.size() - 4) : "";
+    std::string CommandLine = (!_stricmp(Extension.c_str(), ".bat") || !_stricmp(Extension.c_str(), ".cmd"))
+        ? "cmd.exe /C \"" + Args.CompileTool + "\""
+        : Args.CompileTool;
+
+    STARTUPINFOA StartupInfo;
+    PROCESS_INFORMATION ProcessInfo;
+    ZeroMemory(&StartupInfo, sizeof(StartupInfo));
+    StartupInfo.cb = sizeof(StartupInfo);
+    if (!CreateProcessA(NULL, &CommandLine[0], NULL, NULL, FALSE, 0, &Environment[0], NULL, &StartupInfo, &ProcessInfo))
+    {
+        return -1;
+    }
+
+    DWORD ExitCode = 1;
+    WaitForSingleObject(ProcessInfo.hProcess, INFINITE);
+    GetExitCodeProcess(ProcessInfo.hProcess, &ExitCode);
+    CloseHandle(ProcessInfo.hThread);
+    CloseHandle(ProcessInfo.hProcess);
+    return int(ExitCode);
+#else
+    std::vector<char*> Environment;
+    for (char **ppVariable = environ; *ppVariable; ++ppVariable)
+    {
+        if (strncmp(*ppVariable, "SBT_", 4) != 0)
+        {
+            Environment.push_back(*ppVariable);
+        }
+    }
+    for (unsigned int i = 0; i < Variables.size(); ++i)
+    {
+        Environment.push_back(&Variables[i][0]);
+    }
+    Environment.push_back(NULL);
+
+    const char *pShell = "/bin/sh";
+    std::string CommandLine = Args.CompileTool;
+    char *Argv[] = { (char*)"sh", (char*)"-c", &CommandLine[0], NULL };
+
+    pid_t Pid;
+    if (posix_spawn(&Pid, pShell, NULL, NULL, Argv, &Environment[0]) != 0)
+    {
+        return -1;
+    }
+
+    int Status = 0;
+    while (waitpid(Pid, &Status, 0) < 0)
+    {
+    }
+    return WIFEXITED(Status) ? WEXITSTATUS(Status) : -1;
+#endif
+}
+
+// Compiles one shader instance, or reads it from the cache, and returns its C++ definition (or its binary)
+bool BuildShaderInstance(
+    const CArgs& Args,
+    const CHash& CommonHash,
+    const CShaderInstance& Instance,
+    unsigned int InstanceIndex,
+    std::string& Definition,
+    bool& FromCache)
+{
+    CHash Hash = CommonHash;
+    Hash.Add(Instance.DefineString);
+    Hash.Add(Instance.GlobalVariableName);
+
+    const std::string CachePath = Args.CacheDir + PATH_SEPARATOR + Hash.ToString() + (Args.Binary ? ".bin" : ".cpp");
+    FromCache = Args.UseCache && ReadFile(CachePath, Definition);
+    if (FromCache)
+    {
+        return true;
+    }
+
+    std::ostringstream OutputTmp;
+    OutputTmp << Args.Output_CPP << "." << InstanceIndex << ".tmp";
+
+    if (RunCompileTool(Args, Instance, OutputTmp.str()) != 0 || !ReadFile(OutputTmp.str(), Definition))
+    {
+        fprintf(stderr, "Failed to compile %s (%s) with %s\n", Args.Input.c_str(), Instance.DefineString.c_str(), Args.CompileTool.c_str());
+        remove(OutputTmp.str().c_str());
+        return false;
+    }
+    remove(OutputTmp.str().c_str());
+
+    // Written under another name first, so that other builds never read a partial entry
+    if (Args.UseCache)
+    {
+        const std::string CacheTmp = CachePath + ".tmp";
+        WriteFile(CacheTmp, Definition);
+        remove(CachePath.c_str());
+        if (rename(CacheTmp.c_str(), CachePath.c_str()) != 0)
+        {
+            remove(CacheTmp.c_str());
+        }
+    }
+
+    return true;
+}
+
+void WriteCPP(
+    const CArgs& Args,
+    const CShaderPermutations& ShaderPermutations,
+    CShaderInstances& ShaderInstances)
+{
+    const CHash CommonHash = HashCommonInputs(Args);
+    if (Args.UseCache)
+    {
+        MakeDirectory(Args.CacheDir);
+    }
+
+    // The instances are compiled in parallel, and concatenated in order
+    std::vector<std::string> Definitions(ShaderInstances.size());
+    std::atomic<unsigned int> NextInstance(0);
+    std::atomic<unsigned int> NumCompiled(0);
+    std::atomic<bool> Failed(false);
+
+    auto Worker = [&]()
+    {
+        while (!Failed)
+        {
+            const unsigned int InstanceIndex = NextInstance++;
+            if (InstanceIndex >= ShaderInstances.size())
+            {
+                break;
+            }
+
+            bool FromCache = false;
+            if (!BuildShaderInstance(Args, CommonHash, ShaderInstances[InstanceIndex], InstanceIndex, Definitions[InstanceIndex], FromCache))
+            {
+                Failed = true;
+            }
+            else if (!FromCache)
+            {
+                ++NumCompiled;
+            }
+        }
+    };
+
+    unsigned int NumJobs = Args.NumJobs ? Args.NumJobs : std::thread::hardware_concurrency();
+    NumJobs = (NumJobs == 0) ? 1 : (NumJobs > ShaderInstances.size()) ? (unsigned int)ShaderInstances.size() : NumJobs;
+
+    std::vector<std::thread> Threads;
+    for (unsigned int i = 1; i < NumJobs; ++i)
+    {
+        Threads.push_back(std::thread(Worker));
+    }
+    Worker();
+    for (unsigned int i = 0; i < Threads.size(); ++i)
+    {
+        Threads[i].join();
+    }
+
+    if (Failed)
+    {
+        exit(1);
+    }
+
+    printf("%s: %u of %u permutation(s) compiled\n", Args.EntryPoint.c_str(), (unsigned int)NumCompiled, (unsigned int)ShaderInstances.size());
+
+    std::string Out;
+    std::string BlobName;
+    if (Args.Binary)
+    {
+        // Each instance is zero-terminated, for the GLSL sources, and 16-byte aligned.
+        // Compressed instances are only kept when they are smaller.
+        std::string Blob;
+        std::vector<size_t> Offsets;
+        std::vector<size_t> StoredSizes;
+        size_t TotalSize = 0;
+        for (unsigned int InstanceIndex = 0; InstanceIndex < Definitions.size(); ++InstanceIndex)
+        {
+            std::string Stored = Args.Compress ? CompressLZ4(Definitions[InstanceIndex]) : Definitions[InstanceIndex];
+            if (Stored.size() >= Definitions[InstanceIndex].size())
+            {
+                Stored = Definitions[InstanceIndex];
+            }
+
+            Offsets.push_back(Blob.size());
+            StoredSizes.push_back(Stored.size());
+            TotalSize += Definitions[InstanceIndex].size();
+            Blob += Stored;
+            Blob.resize((Blob.size() + 16) & ~size_t(15), 0);
+        }
+        WriteFileIfChanged(Args.Output_BIN, Blob);
+
+        if (Args.Compress)
+        {
+            printf("%s: %u bytes compressed to %u\n", Args.EntryPoint.c_str(), (unsigned int)TotalSize, (unsigned int)Blob.size());
+        }
+
+        BlobName = "g_" + Args.EntryPoint + "_" + Args.API;
+        Printf(Out, "GFSDK_SSAO_INCBIN(%s, \"%s.bin\");\n", BlobName.c_str(), Args.EntryPoint.c_str());
+        Printf(Out, "\n");
+        Printf(Out, "// Offset, stored size and size of the instances in %s.bin\n", Args.EntryPoint.c_str());
+        Printf(Out, "static ::GFSDK::SSAO::ShaderBlobEntry %s_Index[] =\n", BlobName.c_str());
+        Printf(Out, "{\n");
+        for (unsigned int InstanceIndex = 0; InstanceIndex < Definitions.size(); ++InstanceIndex)
+        {
+            Printf(Out, INDENT "{ %s, %u, %u, %u }, // %s\n", BlobName.c_str(),
+                (unsigned int)Offsets[InstanceIndex], (unsigned int)StoredSizes[InstanceIndex], (unsigned int)Definitions[InstanceIndex].size(),
+                ShaderInstances[InstanceIndex].GlobalVariableName.c_str());
+        }
+        Printf(Out, "};\n");
+    }
+    else
+    {
+        for (unsigned int InstanceIndex = 0; InstanceIndex < Definitions.size(); ++InstanceIndex)
+        {
+            Out += Definitions[InstanceIndex];
+        }
+    }
+
+    Printf(Out, "\n");
+    Printf(Out, "namespace Generated\n");
+    Printf(Out, "{\n");
+
+    Printf(Out, INDENT "void %s::Create(DevicePointer Device)\n", Args.EntryPoint.c_str());
+    Printf(Out, INDENT "{\n");
     for (unsigned int i = 0; i < ShaderInstances.size(); ++i)
     {
         CShaderInstance Instance = ShaderInstances[i];
 
-        fprintf(fp, INDENT INDENT "m_Shader");
+        Printf(Out, INDENT INDENT "m_Shader");
         for (unsigned int j = 0; j < Instance.Defines.size(); ++j)
         {
-            fprintf(fp, "[ShaderPermutations::%s", Instance.Defines[j].Key.c_str());
-            fprintf(fp, "_%s]", Instance.Defines[j].Value.c_str());
+            Printf(Out, "[ShaderPermutations::%s", Instance.Defines[j].Key.c_str());
+            Printf(Out, "_%s]", Instance.Defines[j].Value.c_str());
+        }
+        if (Args.Binary)
+        {
+            Printf(Out, ".Create(Device, %s_Index[%u].GetData(), %s_Index[%u].Size);\n", BlobName.c_str(), i, BlobName.c_str(), i);
+        }
+        else
+        {
+            Printf(Out, ".Create(Device, %s, sizeof(%s));\n", Instance.GlobalVariableName.c_str(), Instance.GlobalVariableName.c_str());
         }
-        fprintf(fp, ".Create(Device, %s, sizeof(%s));\n", Instance.GlobalVariableName.c_str(), Instance.GlobalVariableName.c_str());
     }
-    fprintf(fp, INDENT "}\n");
-    fprintf(fp, "\n");
+    Printf(Out, INDENT "}\n");
+    Printf(Out, "\n");
 
-    fprintf(fp, INDENT "void %s::Release(DevicePointer Device)\n", Args.EntryPoint.c_str());
-    fprintf(fp, INDENT "{\n");
+    Printf(Out, INDENT "void %s::Release(DevicePointer Device)\n", Args.EntryPoint.c_str());
+    Printf(Out, INDENT "{\n");
     for (unsigned int i = 0; i < ShaderInstances.size(); ++i)
     {
-        fprintf(fp, INDENT INDENT "m_Shader");
+        Printf(Out, INDENT INDENT "m_Shader");
         CShaderInstance Instance = ShaderInstances[i];
         for (unsigned int j = 0; j < Instance.Defines.size(); ++j)
         {
-            fprintf(fp, "[ShaderPermutations::%s", Instance.Defines[j].Key.c_str());
-            fprintf(fp, "_%s]", Instance.Defines[j].Value.c_str());
+            Printf(Out, "[ShaderPermutations::%s", Instance.Defines[j].Key.c_str());
+            Printf(Out, "_%s]", Instance.Defines[j].Value.c_str());
         }
-        fprintf(fp, ".Release(Device);\n");
+        Printf(Out, ".Release(Device);\n");
     }
-    fprintf(fp, INDENT "}\n");
+    Printf(Out, INDENT "}\n");
 
-    fprintf(fp, "}\n");
+    Printf(Out, "}\n");
 
-    fclose(fp);
+    WriteFileIfChanged(Args.Output_CPP, Out);
 }
 
 void WriteHeader(
@@ -227,111 +831,218 @@ void WriteHeader(
     const CShaderPermutations& ShaderPermutations,
     const CShaderInstances& ShaderInstances)
 {
-    remove(Args.Output_H.c_str());
-
     std::string ClassName = Args.ClassName;
 
-    FILE *fp = OpenFile(Args.Output_H, "a+");
+    std::string Out;
 
-    fprintf(fp, "//! This file was auto-generated. Do not modify manually.\n");
-    fprintf(fp, "#pragma once");
-    fprintf(fp, "\n");
+    Printf(Out, "//! This file was auto-generated. Do not modify manually.\n");
+    Printf(Out, "#pragma once");
+    Printf(Out, "\n");
 
-    fprintf(fp, "\n");
-    fprintf(fp, "namespace Generated\n");
-    fprintf(fp, "{\n");
-    fprintf(fp, "\n");
+    Printf(Out, "\n");
+    Printf(Out, "namespace Generated\n");
+    Printf(Out, "{\n");
+    Printf(Out, "\n");
 
-    fprintf(fp, "namespace ShaderPermutations\n");
-    fprintf(fp, "{\n");
-    fprintf(fp, "\n");
+    Printf(Out, "namespace ShaderPermutations\n");
+    Printf(Out, "{\n");
+    Printf(Out, "\n");
 
     for (unsigned int i = 0; i < ShaderPermutations.size(); ++i)
     {
         const CShaderPermutation& Permutation = ShaderPermutations[i];
 
         std::string PermutationDefine = Permutation.Key + "_DEFINED";
-        fprintf(fp, "#ifndef %s\n", PermutationDefine.c_str());
-        fprintf(fp, "#define %s\n", PermutationDefine.c_str());
+        Printf(Out, "#ifndef %s\n", PermutationDefine.c_str());
+        Printf(Out, "#define %s\n", PermutationDefine.c_str());
 
-        fprintf(fp, INDENT "enum %s\n", Permutation.Key.c_str());
-        fprintf(fp, INDENT "{\n");
+        Printf(Out, INDENT "enum %s\n", Permutation.Key.c_str());
+        Printf(Out, INDENT "{\n");
         for (unsigned int j = 0; j < Permutation.Values.size(); ++j)
         {
-            fprintf(fp, INDENT INDENT "%s_%s,\n", Permutation.Key.c_str(), Permutation.Values[j].c_str());
+            Printf(Out, INDENT INDENT "%s_%s,\n", Permutation.Key.c_str(), Permutation.Values[j].c_str());
         }
-        fprintf(fp, INDENT INDENT "%s_COUNT,\n", Permutation.Key.c_str());
-        fprintf(fp, INDENT "};\n");
+        Printf(Out, INDENT INDENT "%s_COUNT,\n", Permutation.Key.c_str());
+        Printf(Out, INDENT "};\n");
 
-        fprintf(fp, "#endif\n");
-        fprintf(fp, "\n");
+        Printf(Out, "#endif\n");
+        Printf(Out, "\n");
     }
 
-    fprintf(fp, "};\n");
-    fprintf(fp, "\n");
+    Printf(Out, "};\n");
+    Printf(Out, "\n");
+
+    Printf(Out, "struct %s\n", Args.EntryPoint.c_str());
+    Printf(Out, "{\n");
 
-    fprintf(fp, "struct %s\n", Args.EntryPoint.c_str());
-    fprintf(fp, "{\n");
+    Printf(Out, INDENT "void Create(DevicePointer Device);\n");
+    Printf(Out, INDENT "void Release(DevicePointer Device);\n");
+
+    // One bit per value of each key, as the built instances are the product of the built values
+    Printf(Out, INDENT "static bool IsBuilt(");
+    for (unsigned int i = 0; i < ShaderPermutations.size(); ++i)
+    {
+        if (i != 0)
+        {
+            Printf(Out, ", ");
+        }
+        Printf(Out, "ShaderPermutations::%s %c", ShaderPermutations[i].Key.c_str(), 'A' + i);
+    }
+    Printf(Out, ")\n");
+    Printf(Out, INDENT "{\n");
+    if (ShaderPermutations.size() == 0)
+    {
+        Printf(Out, INDENT INDENT "return true;\n");
+    }
+    else
+    {
+        Printf(Out, INDENT INDENT "return (");
+        for (unsigned int i = 0; i < ShaderPermutations.size(); ++i)
+        {
+            if (ShaderPermutations[i].Values.size() > 32)
+            {
+                fprintf(stderr, "%s has more than 32 values\n", ShaderPermutations[i].Key.c_str());
+                exit(1);
+            }
 
-    fprintf(fp, INDENT "void Create(DevicePointer Device);\n");
-    fprintf(fp, INDENT "void Release(DevicePointer Device);\n");
+            unsigned int Mask = 0;
+            for (unsigned int j = 0; j < ShaderPermutations[i].IsBuilt.size(); ++j)
+            {
+                Mask |= ShaderPermutations[i].IsBuilt[j] ? (1u << j) : 0u;
+            }
+            Printf(Out, "(0x%Xu >> %c) & ", Mask, 'A' + i);
+        }
+        Printf(Out, "1) != 0;\n");
+    }
+    Printf(Out, INDENT "}\n");
+    Printf(Out, "\n");
 
-    fprintf(fp, INDENT "%s& Get(", ClassName.c_str());
+    Printf(Out, INDENT "%s& Get(", ClassName.c_str());
     for (unsigned int i = 0; i < ShaderPermutations.size(); ++i)
     {
         if (i != 0)
         {
-            fprintf(fp, ", ");
+            Printf(Out, ", ");
+        }
+        Printf(Out, "ShaderPermutations::%s %c", ShaderPermutations[i].Key.c_str(), 'A' + i);
+    }
+    Printf(Out, ")\n");
+    Printf(Out, INDENT "{\n");
+    if (IsPruned(ShaderPermutations))
+    {
+        Printf(Out, INDENT INDENT "if (!IsBuilt(");
+        for (unsigned int i = 0; i < ShaderPermutations.size(); ++i)
+        {
+            Printf(Out, (i != 0) ? ", %c" : "%c", 'A' + i);
         }
-        fprintf(fp, "ShaderPermutations::%s %c", ShaderPermutations[i].Key.c_str(), 'A' + i);
+        Printf(Out, "))\n");
+        Printf(Out, INDENT INDENT "{\n");
+        Printf(Out, INDENT INDENT INDENT "THROW_PERMUTATION_NOT_BUILT();\n");
+        Printf(Out, INDENT INDENT "}\n");
     }
-    fprintf(fp, ")\n");
-    fprintf(fp, INDENT "{\n");
-    fprintf(fp, INDENT INDENT "return m_Shader");
+    Printf(Out, INDENT INDENT "return m_Shader");
     for (unsigned int i = 0; i < ShaderPermutations.size(); ++i)
     {
-        fprintf(fp, "[%c]", 'A' + i);
+        Printf(Out, "[%c]", 'A' + i);
     }
-    fprintf(fp, ";\n");
-    fprintf(fp, INDENT "}\n");
+    Printf(Out, ";\n");
+    Printf(Out, INDENT "}\n");
 
-    fprintf(fp, "\n");
-    fprintf(fp, "private:\n");
+    Printf(Out, "\n");
+    Printf(Out, "private:\n");
 
-    fprintf(fp, INDENT "%s m_Shader", ClassName.c_str());
+    Printf(Out, INDENT "%s m_Shader", ClassName.c_str());
     for (unsigned int i = 0; i < ShaderPermutations.size(); ++i)
     {
-        fprintf(fp, "[ShaderPermutations::%s_COUNT]", ShaderPermutations[i].Key.c_str());
+        Printf(Out, "[ShaderPermutations::%s_COUNT]", ShaderPermutations[i].Key.c_str());
     }
-    fprintf(fp, ";\n");
+    Printf(Out, ";\n");
 
-    fprintf(fp, "#if _WIN32\n");
+    Printf(Out, "#if _WIN32\n");
     for (unsigned int i = 0; i < ShaderPermutations.size(); ++i)
     {
-        fprintf(fp, INDENT "static_assert(ShaderPermutations::%s_COUNT == %d, \"\");\n",
+        Printf(Out, INDENT "static_assert(ShaderPermutations::%s_COUNT == %d, \"\");\n",
             ShaderPermutations[i].Key.c_str(),
             (int) ShaderPermutations[i].Values.size());
     }
-    fprintf(fp, "#endif\n");
+    Printf(Out, "#endif\n");
 
-    fprintf(fp, "};\n");
-    fprintf(fp, "\n");
+    Printf(Out, "};\n");
+    Printf(Out, "\n");
 
-    fprintf(fp, "};\n");
+    Printf(Out, "};\n");
 
-    fclose(fp);
+    WriteFileIfChanged(Args.Output_H, Out);
+}
+
+void PrintUsage(const char* pProgramName)
+{
+    fprintf(stderr, "Usage: %s [OPTIONS] PROFILE INPUT_HLSL ENTRY_POINT OUTPUT_DIR COMPILE_TOOL API [CLASS_NAME]\n", pProgramName);
+    fprintf(stderr, "Options:\n");
+    fprintf(stderr, "  --jobs N          Number of parallel compiles (default: one per logical processor)\n");
+    fprintf(stderr, "  --cache-dir DIR   Directory of the compile cache (default: OUTPUT_DIR" PATH_SEPARATOR ".ShaderBuildCache)\n");
+    fprintf(stderr, "  --no-cache        Compile all the permutations, without reading or writing the cache\n");
+    fprintf(stderr, "  --binary          Pack the raw outputs of COMPILE_TOOL (SBT_FORMAT=BINARY) into OUTPUT_DIR" PATH_SEPARATOR "ENTRY_POINT.bin\n");
+    fprintf(stderr, "  --compress        With --binary, store the outputs LZ4-compressed\n");
+    fprintf(stderr, "  --compiler FILE   Compiler file (executable, library or script) whose changes invalidate the cache\n");
+    fprintf(stderr, "  --permutations FILE  Config file of \"KEY VALUE...\" lines: only builds the listed values of these keys\n");
 }
 
 int main(int argc, char **argv)
 {
-    if (argc < 7)
+    CArgs Args;
+    int ArgIndex = 1;
+
+    while (ArgIndex < argc && !strncmp(argv[ArgIndex], "--", 2))
+    {
+        const char* pOption = argv[ArgIndex++];
+        const char* pValue = (ArgIndex < argc) ? argv[ArgIndex] : NULL;
+
+        if (!strcmp(pOption, "--no-cache"))
+        {
+            Args.UseCache = false;
+        }
+        else if (!strcmp(pOption, "--binary"))
+        {
+            Args.Binary = true;
+        }
+        else if (!strcmp(pOption, "--compress"))
+        {
+            Args.Compress = true;
+        }
+        else if (!strcmp(pOption, "--jobs") && pValue)
+        {
+            Args.NumJobs = (unsigned int)atoi(pValue);
+            ++ArgIndex;
+        }
+        else if (!strcmp(pOption, "--cache-dir") && pValue)
+        {
+            Args.CacheDir = pValue;
+            ++ArgIndex;
+        }
+        else if (!strcmp(pOption, "--compiler") && pValue)
+        {
+            Args.CompilerFiles.push_back(pValue);
+            ++ArgIndex;
+        }
+        else if (!strcmp(pOption, "--permutations") && pValue)
+        {
+            Args.PermutationConfig = pValue;
+            ++ArgIndex;
+        }
+        else
+        {
+            PrintUsage(argv[0]);
+            exit(1);
+        }
+    }
+
+    if (argc - ArgIndex < 6 || (Args.Compress && !Args.Binary))
     {
-        fprintf(stderr, "Usage: %s PROFILE INPUT_HLSL ENTRY_POINT OUTPUT_DIR COMPILE_TOOL API [CLASS_NAME]\n", argv[0]);
+        PrintUsage(argv[0]);
         exit(1);
     }
 
-    CArgs Args;
-    int ArgIndex = 1;
     if (ArgIndex < argc)
     {
         Args.Profile = argv[ArgIndex++];
@@ -363,22 +1074,32 @@ int main(int argc, char **argv)
 
     if (Args.ClassName.size() == 0)
     {
-        const bool IsVS = !strcmp(Args.Profile.c_str(), "vs_5_0");
-        const bool IsGS = !strcmp(Args.Profile.c_str(), "gs_5_0");
+        const bool IsVS = !strncmp(Args.Profile.c_str(), "vs_", 3);
+        const bool IsGS = !strncmp(Args.Profile.c_str(), "gs_", 3);
         Args.ClassName =
             IsVS ? "VertexShader" :
             IsGS ? "GeometryShader" :
             "PixelShader";
     }
 
+    if (Args.CacheDir.size() == 0)
+    {
+        Args.CacheDir = Args.OutputDir + PATH_SEPARATOR ".ShaderBuildCache";
+    }
+
     CShaderPermutations ShaderPermutations;
     ParseInput(Args, ShaderPermutations);
+    if (Args.PermutationConfig.size() != 0)
+    {
+        PrunePermutations(Args, ShaderPermutations);
+    }
 
-    Args.Output_H = Args.OutputDir + "\\" + Args.EntryPoint + ".h";
-    Args.Output_CPP = Args.OutputDir + "\\" + Args.EntryPoint + ".cpp";
+    Args.Output_H = Args.OutputDir + PATH_SEPARATOR + Args.EntryPoint + ".h";
+    Args.Output_CPP = Args.OutputDir + PATH_SEPARATOR + Args.EntryPoint + ".cpp";
+    Args.Output_BIN = Args.OutputDir + PATH_SEPARATOR + Args.EntryPoint + ".bin";
 
     CShaderInstances ShaderInstances;
-    InitShaderInstances(ShaderPermutations, ShaderInstances);
+    InitShaderInstances(Args, ShaderPermutations, ShaderInstances);
 
     WriteHeader(Args, ShaderPermutations, ShaderInstances);
 
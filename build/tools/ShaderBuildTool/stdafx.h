@@ -9,10 +9,12 @@
 #define _CRT_SECURE_NO_WARNINGS
 #endif
 
+#ifdef _WIN32
 #include "targetver.h"
+#include <tchar.h>
+#endif
 
 #include <stdio.h>
-#include <tchar.h>
 
 
 
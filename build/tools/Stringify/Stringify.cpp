@@ -1,35 +1,41 @@
 #define _CRT_SECURE_NO_WARNINGS
 #include <stdio.h>
-#include <tchar.h>
+#include <stdint.h>
 #include <stdlib.h>
+#include <string.h>
 #include <vector>
 
 int main(int argc, char* argv[])
 {
-    if (argc != 4)
+    // --binary writes an unsigned char array without the terminating zero, for bytecode (DXIL, SPIR-V)
+    const bool binary = (argc == 5 && !strcmp(argv[1], "--binary"));
+    if (argc != 4 && !binary)
     {
-        fprintf(stderr, "Usage: %s TEXT_FILENAME VARIABLE_NAME OUTPUT_FILE\n", argv[0]);
+        fprintf(stderr, "Usage: %s [--binary] TEXT_FILENAME VARIABLE_NAME OUTPUT_FILE\n", argv[0]);
         exit(1);
     }
 
-    const char* pFilenameIn = argv[1];
-    const char* pVariableName = argv[2];
-    const char *pFilenameOut = argv[3];
+    const char* pFilenameIn = argv[argc - 3];
+    const char* pVariableName = argv[argc - 2];
+    const char *pFilenameOut = argv[argc - 1];
 
     FILE *fpIn = fopen(pFilenameIn, "rb");
+    if (!fpIn)
+    {
+        fprintf(stderr, "Error: Failed to open %s\n", pFilenameIn);
+        exit(1);
+    }
+
     fseek(fpIn, 0, SEEK_END);
     long fileSize = ftell(fpIn);
     fseek(fpIn, 0, SEEK_SET);
     std::vector<uint8_t> entireFile(fileSize);
     fread(entireFile.data(), 1, (size_t)fileSize, fpIn);
-    entireFile.push_back(0);
-    fseek(fpIn, 0, SEEK_SET);
-
-    if (!fpIn)
+    if (!binary)
     {
-        fprintf(stderr, "Error: Failed to open %s\n", pFilenameIn);
-        exit(1);
+        entireFile.push_back(0);
     }
+    fseek(fpIn, 0, SEEK_SET);
 
     FILE *fpOut =  fopen(pFilenameOut, "w");
     if (!fpOut)
@@ -50,7 +56,7 @@ int main(int argc, char* argv[])
     // 
     // fprintf(fpOut, "// ;\n");
 
-    fprintf(fpOut, "static const char %s[] =\n{", pVariableName);
+    fprintf(fpOut, "static const %s %s[] =\n{", binary ? "unsigned char" : "char", pVariableName);
 
     for (size_t i = 0; i < entireFile.size(); ++i)
     {
@@ -195,7 +195,7 @@ struct GFSDK_SSAO_Version
 {
     GFSDK_SSAO_Version()
         : Major(4)
-        , Minor(0)
+        , Minor(6)
         , Branch(0)
         , Revision(23827312)
     {
@@ -233,7 +233,15 @@ enum GFSDK_SSAO_Status
     GFSDK_SSAO_D3D12_INVALID_HEAP_TYPE,                     // One of the heaps provided to GFSDK_SSAO_CreateContext_D3D12 has an unexpected type
     GFSDK_SSAO_D3D12_INSUFFICIENT_DESCRIPTORS,              // One of the heaps provided to GFSDK_SSAO_CreateContext_D3D12 has an insufficient number of descriptors
     GFSDK_SSAO_D3D12_INVALID_NODE_MASK,                     // NodeMask has more than one bit set. HBAO+ only supports operation on one D3D12 device node.
-    GFSDK_SSAO_NO_SECOND_LAYER_PROVIDED                     // FullResDepthTexture2ndLayerSRV is not set, but DualLayerAO is enabled.
+    GFSDK_SSAO_NO_SECOND_LAYER_PROVIDED,                    // FullResDepthTexture2ndLayerSRV is not set, but DualLayerAO is enabled.
+    GFSDK_SSAO_CPU_UNSUPPORTED_BLEND_MODE,                  // CUSTOM_BLEND is used (implemented on D3D11 & D3D12, but not on the CPU)
+    GFSDK_SSAO_CPU_INVALID_TEXTURE_LAYOUT,                  // One of the host textures has a NumChannels or RowPitch that is too small for its content
+    GFSDK_SSAO_CPU_THREAD_CREATION_FAILED,                  // Failed to create the worker threads of the CPU context
+    GFSDK_SSAO_PIPELINE_CACHE_NOT_SUPPORTED,                // The device does not support pipeline caches (D3D12: requires ID3D12Device1)
+    GFSDK_SSAO_PIPELINE_CACHE_CORRUPTED,                    // The pipeline-cache data is truncated or corrupted
+    GFSDK_SSAO_PIPELINE_CACHE_MISMATCH,                     // The pipeline-cache data was saved by another library version, adapter or driver
+    GFSDK_SSAO_PIPELINE_CACHE_BUFFER_TOO_SMALL,             // The buffer passed to GetPipelineCacheData is too small for the pipeline-cache data
+    GFSDK_SSAO_SHADER_PERMUTATION_NOT_BUILT,                // The parameters need a shader permutation that this build of the library pruned (ShaderBuildTool --permutations)
 };
 
 enum GFSDK_SSAO_DepthTextureType
@@ -274,6 +282,12 @@ enum GFSDK_SSAO_StepCount
     GFSDK_SSAO_STEP_COUNT_8,                                // Use 8 steps per sampled direction (slower, to reduce banding artifacts)
 };
 
+enum GFSDK_SSAO_Algorithm
+{
+    GFSDK_SSAO_HBAO_PLUS,                                   // March StepCount steps along jittered directions for each pixel (same as in HBAO+ 3.x)
+    GFSDK_SSAO_LINE_SWEEP,                                  // [CPU only] Sweep each direction across the image once, with a cost independent of the AO radius
+};
+
 enum GFSDK_SSAO_DepthClampMode
 {
     GFSDK_SSAO_CLAMP_TO_EDGE,                               // Use clamp-to-edge when sampling depth (may cause false occlusion near screen borders)
@@ -301,6 +315,44 @@ enum GFSDK_SSAO_RenderMask
     GFSDK_SSAO_RENDER_DEBUG_NORMAL_Z               = GFSDK_SSAO_DRAW_Z | GFSDK_SSAO_DRAW_DEBUG_N | GFSDK_SSAO_DRAW_DEBUG_Z,
 };
 
+enum GFSDK_SSAO_InstructionSet_CPU
+{
+    GFSDK_SSAO_CPU_SCALAR,                                  // Portable scalar kernels
+    GFSDK_SSAO_CPU_SSE42,                                   // 4-wide SSE4.2 kernels
+    GFSDK_SSAO_CPU_AVX2,                                    // 8-wide AVX2 kernels
+    GFSDK_SSAO_CPU_AVX512,                                  // 16-wide AVX-512 kernels
+};
+
+enum GFSDK_SSAO_ShaderCreation
+{
+    GFSDK_SSAO_CREATE_ALL_SHADERS,                          // Create all shader permutations with the context (default)
+    GFSDK_SSAO_CREATE_SHADERS_ON_DEMAND,                    // Create each shader permutation on first use
+};
+
+enum GFSDK_SSAO_RenderPass
+{
+    GFSDK_SSAO_PASS_LINEAR_Z,                               // Linearize the input depths
+    GFSDK_SSAO_PASS_DEINTERLEAVE_Z,                         // Deinterleave the view depths into quarter-res slices
+    GFSDK_SSAO_PASS_NORMAL,                                 // Reconstruct the view normals, or fetch the input normals
+    GFSDK_SSAO_PASS_COARSE_AO,                              // Render the AO of the quarter-res slices
+    GFSDK_SSAO_PASS_INTERLEAVE_AO,                          // Reinterleave the AO into a full-res texture
+    GFSDK_SSAO_PASS_BLURX,                                  // Horizontal blur
+    GFSDK_SSAO_PASS_BLURY,                                  // Vertical blur, writing to the output render target
+    GFSDK_SSAO_PASS_TOTAL,                                  // Whole RenderAO call
+    GFSDK_SSAO_PASS_COUNT,
+};
+
+enum GFSDK_SSAO_CpuPhase
+{
+    GFSDK_SSAO_CPU_PHASE_SET_DATA_FLOW,                     // Validate the input data, parameters and output (including SET_AO_PARAMETERS)
+    GFSDK_SSAO_CPU_PHASE_SET_AO_PARAMETERS,                 // Compute the constants of the AO parameters
+    GFSDK_SSAO_CPU_PHASE_SAVE_APP_STATE,                    // Save the states of the application (D3D11 & GL)
+    GFSDK_SSAO_CPU_PHASE_RENDER,                            // Submit the passes (on the CPU context, run them)
+    GFSDK_SSAO_CPU_PHASE_RESTORE_APP_STATE,                 // Restore the states of the application (D3D11 & GL)
+    GFSDK_SSAO_CPU_PHASE_TOTAL,                             // Whole RenderAO call
+    GFSDK_SSAO_CPU_PHASE_COUNT,
+};
+
 /*====================================================================================================
    Input/output textures.
 ====================================================================================================*/
@@ -327,6 +379,50 @@ struct GFSDK_SSAO_RenderTargetView_D3D12
     GFSDK_SSAO_SIZE_T   CpuHandle;
 };
 
+//---------------------------------------------------------------------------------------------------
+// Host-memory textures for the CPU interface.
+//
+// Remarks:
+//    * Texels are FP32, with the NumChannels of a sample stored contiguously and the samples of a pixel stored contiguously.
+//    * A RowPitch of 0 means that the rows are tightly packed (RowPitch = Width * SampleCount * NumChannels * sizeof(float)).
+//    * For multisample textures, only sample 0 is used (same as the D3D paths).
+//---------------------------------------------------------------------------------------------------
+struct GFSDK_SSAO_ShaderResourceView_CPU
+{
+    GFSDK_SSAO_ShaderResourceView_CPU()
+        : pData(NULL)
+        , Width(0)
+        , Height(0)
+        , RowPitch(0)
+        , SampleCount(1)
+        , NumChannels(1)
+    {
+    }
+    const GFSDK_SSAO_FLOAT* pData;                          // Address of the first texel
+    GFSDK_SSAO_UINT         Width;                          // Width of the texture, in pixels
+    GFSDK_SSAO_UINT         Height;                         // Height of the texture, in pixels
+    GFSDK_SSAO_UINT         RowPitch;                       // Distance between two consecutive rows, in bytes
+    GFSDK_SSAO_UINT         SampleCount;                    // Number of samples per pixel
+    GFSDK_SSAO_UINT         NumChannels;                    // Number of FP32 channels per sample
+};
+
+struct GFSDK_SSAO_RenderTargetView_CPU
+{
+    GFSDK_SSAO_RenderTargetView_CPU()
+        : pData(NULL)
+        , Width(0)
+        , Height(0)
+        , RowPitch(0)
+        , NumChannels(4)
+    {
+    }
+    GFSDK_SSAO_FLOAT*       pData;                          // Address of the first texel
+    GFSDK_SSAO_UINT         Width;                          // Width of the texture, in pixels
+    GFSDK_SSAO_UINT         Height;                         // Height of the texture, in pixels
+    GFSDK_SSAO_UINT         RowPitch;                       // Distance between two consecutive rows, in bytes
+    GFSDK_SSAO_UINT         NumChannels;                    // Number of FP32 channels per pixel (1 to 4)
+};
+
 /*====================================================================================================
    Input data.
 ====================================================================================================*/
@@ -444,6 +540,12 @@ struct GFSDK_SSAO_InputDepthData_D3D11 : GFSDK_SSAO_InputDepthData
     }
 };
 
+struct GFSDK_SSAO_InputDepthData_CPU : GFSDK_SSAO_InputDepthData
+{
+    GFSDK_SSAO_ShaderResourceView_CPU   FullResDepthTextureSRV;         // Full-resolution depth texture
+    GFSDK_SSAO_ShaderResourceView_CPU   FullResDepthTexture2ndLayerSRV; // Full-resolution depth texture for the second layer
+};
+
 //---------------------------------------------------------------------------------------------------
 // [Optional] Input normal data.
 //
@@ -495,6 +597,11 @@ struct GFSDK_SSAO_InputNormalData_D3D11 : GFSDK_SSAO_InputNormalData
     }
 };
 
+struct GFSDK_SSAO_InputNormalData_CPU : GFSDK_SSAO_InputNormalData
+{
+    GFSDK_SSAO_ShaderResourceView_CPU   FullResNormalTextureSRV;    // Full-resolution world-space normal texture (NumChannels >= 3)
+};
+
 //---------------------------------------------------------------------------------------------------
 // Input data.
 //---------------------------------------------------------------------------------------------------
@@ -511,6 +618,12 @@ struct GFSDK_SSAO_InputData_D3D11
     GFSDK_SSAO_InputNormalData_D3D11        NormalData;         // Optional GBuffer normals
 };
 
+struct GFSDK_SSAO_InputData_CPU
+{
+    GFSDK_SSAO_InputDepthData_CPU           DepthData;          // Required
+    GFSDK_SSAO_InputNormalData_CPU          NormalData;         // Optional GBuffer normals
+};
+
 /*====================================================================================================
    Parameters.
 ====================================================================================================*/
@@ -603,6 +716,8 @@ struct GFSDK_SSAO_BlurParameters
 // Remarks:
 //    * The final occlusion is a weighted sum of 2 occlusion contributions. The SmallScaleAO and LargeScaleAO parameters are the weights.
 //    * Setting the DepthStorage parameter to FP16_VIEW_DEPTHS is fastest but may introduce minor false-occlusion artifacts for large depths.
+//    * With Algorithm = LINE_SWEEP, the AO of each direction is the one of its horizon, with the same Radius, Bias and falloff as HBAO_PLUS,
+//      and StepCount only scales SmallScaleAO and LargeScaleAO as if all the steps had hit the horizon. The D3D and GL contexts ignore it.
 //---------------------------------------------------------------------------------------------------
 struct GFSDK_SSAO_Parameters
 {
@@ -619,6 +734,7 @@ struct GFSDK_SSAO_Parameters
     GFSDK_SSAO_DepthThreshold       DepthThreshold;             // Optional Z threshold, to hide possible depth-precision artifacts
     GFSDK_SSAO_BlurParameters       Blur;                       // Optional AO blur, to blur the AO before compositing it
     GFSDK_SSAO_BOOL                 EnableDualLayerAO;          // To reduce halo artifacts behind foreground object
+    GFSDK_SSAO_Algorithm            Algorithm;                  // The AO-generation algorithm (only the CPU context supports LINE_SWEEP)
 
     GFSDK_SSAO_Parameters()
         : Radius(1.f)
@@ -630,6 +746,7 @@ struct GFSDK_SSAO_Parameters
         , DepthStorage(GFSDK_SSAO_FP16_VIEW_DEPTHS)
         , DepthClampMode(GFSDK_SSAO_CLAMP_TO_EDGE)
         , EnableDualLayerAO(false)
+        , Algorithm(GFSDK_SSAO_HBAO_PLUS)
     {
     }
 };
@@ -692,6 +809,16 @@ struct GFSDK_SSAO_BlendState_D3D11
     }
 };
 
+struct GFSDK_SSAO_BlendState_CPU
+{
+    GFSDK_SSAO_BlendMode                Mode;                   // OVERWRITE_RGB or MULTIPLY_RGB
+
+    GFSDK_SSAO_BlendState_CPU()
+        : Mode(GFSDK_SSAO_OVERWRITE_RGB)
+    {
+    }
+};
+
 //---------------------------------------------------------------------------------------------------
 // [Optional] Custom depth-stencil state.
 //---------------------------------------------------------------------------------------------------
@@ -745,6 +872,17 @@ struct GFSDK_SSAO_Output_D3D11
     }
 };
 
+struct GFSDK_SSAO_Output_CPU
+{
+    GFSDK_SSAO_RenderTargetView_CPU*    pRenderTargetView;      // Output render target of RenderAO
+    GFSDK_SSAO_BlendState_CPU           Blend;                  // Blend mode used when writing the AO to pRenderTargetView
+
+    GFSDK_SSAO_Output_CPU()
+        : pRenderTargetView(NULL)
+    {
+    }
+};
+
 /*====================================================================================================
   [Optional] Let the library allocate its memory on a custom heap.
 ====================================================================================================*/
@@ -760,6 +898,61 @@ struct GFSDK_SSAO_CustomHeap
     void (*delete_)(void*);
 };
 
+/*====================================================================================================
+  [Optional] Let the library run its creation work on the application's task scheduler.
+====================================================================================================*/
+
+//---------------------------------------------------------------------------------------------------
+// Remarks:
+//    * submit_ must call pTask(pTaskData) exactly once, on any thread. It may also call it before returning.
+//    * The library function that submits the tasks returns when all of them have completed, and runs tasks
+//      on the calling thread in the meantime. The submitted tasks must therefore not wait for the calling thread.
+//---------------------------------------------------------------------------------------------------
+struct GFSDK_SSAO_TaskScheduler
+{
+    GFSDK_SSAO_TaskScheduler()
+        : submit_(NULL)
+        , pUserData(NULL)
+    {
+    }
+    void (*submit_)(void (*pTask)(void* pTaskData), void* pTaskData, void* pUserData);
+    void* pUserData;
+};
+
+/*====================================================================================================
+  [Optional] Route the HBAO+ ranges and times into the application's profiler.
+====================================================================================================*/
+
+//---------------------------------------------------------------------------------------------------
+// Remarks:
+//    * begin_range_ and end_range_ are called around each pass of RenderAO, and around the whole RenderAO
+//      (pName = "HBAO+"). The passes are named "LinearZ", "DeinterleaveZ", "Normal", "CoarseAO", "InterleaveAO",
+//      "BlurX" and "BlurY", with a fixed Color per pass (0xAARRGGBB).
+//    * D3D11 & D3D12: the ranges are opened on the thread calling RenderAO, while the pass is recorded, with the
+//      ID3D11DeviceContext* or ID3D12GraphicsCommandList* of RenderAO as pCommandList, so that the application can
+//      open a GPU zone on it too. GL: pCommandList is NULL.
+//    * CPU: the ranges of the passes are opened by the worker threads, around each tile of a pass, with pCommandList = NULL.
+//      The callbacks must therefore be thread-safe.
+//    * counter_ is called with the name of each pass and its time in ms when the GPU timestamps of a frame are read back
+//      (see GetRenderTimes), and with the name of each GFSDK_SSAO_CpuPhase ("SetDataFlow", "SetAOParameters",
+//      "SaveAppState", "Render", "RestoreAppState", "RenderAO") and its time in ms at the end of each RenderAO call.
+//    * The pName strings are static.
+//---------------------------------------------------------------------------------------------------
+struct GFSDK_SSAO_ProfilerHooks
+{
+    GFSDK_SSAO_ProfilerHooks()
+        : begin_range_(NULL)
+        , end_range_(NULL)
+        , counter_(NULL)
+        , pUserData(NULL)
+    {
+    }
+    void (*begin_range_)(const char* pName, GFSDK_SSAO_UINT Color, void* pCommandList, void* pUserData);
+    void (*end_range_)(void* pCommandList, void* pUserData);
+    void (*counter_)(const char* pName, GFSDK_SSAO_FLOAT Value, void* pUserData);
+    void* pUserData;
+};
+
 /*====================================================================================================
   [Optional] For debugging any issues with the input projection matrix.
 ====================================================================================================*/
@@ -775,6 +968,43 @@ struct GFSDK_SSAO_ProjectionMatrixDepthRange
     GFSDK_SSAO_FLOAT ZFar;
 };
 
+/*====================================================================================================
+  [Optional] Per-pass render times, for profiling or for scaling the AO quality dynamically.
+====================================================================================================*/
+
+#define GFSDK_SSAO_RENDER_TIMES_HISTORY_SIZE    128         // Number of frames kept in the history of each context
+#define GFSDK_SSAO_RENDER_TIMES_FRAMES_IN_FLIGHT 16         // Number of frames whose GPU timestamps can be in flight at once, per context
+
+struct GFSDK_SSAO_PassTime
+{
+    GFSDK_SSAO_PassTime()
+        : LastMS(0.f)
+        , MinMS(0.f)
+        , AvgMS(0.f)
+        , P95MS(0.f)
+        , P99MS(0.f)
+    {
+    }
+    GFSDK_SSAO_FLOAT LastMS;                                // Time of the most recent frame read back, in milliseconds
+    GFSDK_SSAO_FLOAT MinMS;                                 // Minimum over the history
+    GFSDK_SSAO_FLOAT AvgMS;                                 // Average over the history
+    GFSDK_SSAO_FLOAT P95MS;                                 // 95th percentile over the history
+    GFSDK_SSAO_FLOAT P99MS;                                 // 99th percentile over the history
+};
+
+struct GFSDK_SSAO_RenderTimes
+{
+    GFSDK_SSAO_RenderTimes()
+        : NumFrames(0)
+        , NumCPUFrames(0)
+    {
+    }
+    GFSDK_SSAO_PassTime Passes[GFSDK_SSAO_PASS_COUNT];      // Indexed by GFSDK_SSAO_RenderPass
+    GFSDK_SSAO_UINT NumFrames;                              // Number of frames in the history (0 = no frame read back yet)
+    GFSDK_SSAO_PassTime CPUPhases[GFSDK_SSAO_CPU_PHASE_COUNT]; // Host times spent in RenderAO, indexed by GFSDK_SSAO_CpuPhase
+    GFSDK_SSAO_UINT NumCPUFrames;                           // Number of RenderAO calls in the history of CPUPhases
+};
+
 /*====================================================================================================
    Base interface.
 ====================================================================================================*/
@@ -788,6 +1018,43 @@ public:
 //---------------------------------------------------------------------------------------------------
 virtual GFSDK_SSAO_UINT GetAllocatedVideoMemoryBytes() = 0;
 
+//---------------------------------------------------------------------------------------------------
+// [Optional] Gets the per-pass times of the last GFSDK_SSAO_RENDER_TIMES_HISTORY_SIZE frames rendered by this context.
+//
+// Remarks:
+//    * The GPU timestamps are read back without ever blocking, so the times lag the RenderAO calls by a few frames.
+//    * Every RenderAO call is timed, as long as the GPU lags the RenderAO calls of the context by at most
+//      GFSDK_SSAO_RENDER_TIMES_FRAMES_IN_FLIGHT frames. The calls made while all the timestamps are in flight are not timed.
+//    * D3D12: the timestamps of a RenderAO call are read back once its command list has been executed. A call whose command list
+//      is still not executed after GFSDK_SSAO_RENDER_TIMES_FRAMES_IN_FLIGHT more RenderAO calls of the context is not timed.
+//    * A pass that did not run in a frame (e.g. the blur with Blur.Enable = false) counts as 0 ms in that frame.
+//    * The percentiles use the nearest-rank method over the frames of the history.
+//    * On the CPU context, the times are host times, read back at the end of each RenderAO call. The passes overlap,
+//      since each tile starts as soon as its inputs are ready, and the fused blur is reported as GFSDK_SSAO_PASS_BLURX.
+//    * CPUPhases are the host times of the last GFSDK_SSAO_RENDER_TIMES_HISTORY_SIZE RenderAO calls that returned
+//      GFSDK_SSAO_OK, measured with a high-resolution clock on the calling thread, without any lag.
+//      The phases that do not exist in a backend (e.g. GFSDK_SSAO_CPU_PHASE_SAVE_APP_STATE on D3D12) count as 0 ms.
+//      They are not measured if the library was built with ENABLE_CPU_TIMERS=0.
+//
+// Returns:
+//     GFSDK_SSAO_NULL_ARGUMENT                        - pRenderTimes is NULL
+//     GFSDK_SSAO_OK                                   - Success
+//---------------------------------------------------------------------------------------------------
+virtual GFSDK_SSAO_Status GetRenderTimes(GFSDK_SSAO_RenderTimes* pRenderTimes) = 0;
+
+//---------------------------------------------------------------------------------------------------
+// [Optional] Sets the callbacks through which this context reports its ranges and times to the application's profiler.
+//
+// Remarks:
+//    * The callbacks are copied, and replace the ones set previously. Set them all to NULL to stop reporting.
+//    * Must not be called while RenderAO is running on another thread.
+//
+// Returns:
+//     GFSDK_SSAO_NULL_ARGUMENT                        - Only one of begin_range_ and end_range_ is set
+//     GFSDK_SSAO_OK                                   - Success
+//---------------------------------------------------------------------------------------------------
+virtual GFSDK_SSAO_Status SetProfilerHooks(const GFSDK_SSAO_ProfilerHooks& ProfilerHooks) = 0;
+
 }; //class GFSDK_SSAO_Context
 
 //---------------------------------------------------------------------------------------------------
@@ -800,7 +1067,7 @@ GFSDK_SSAO_DECL(GFSDK_SSAO_Status, GFSDK_SSAO_GetVersion, GFSDK_SSAO_Version* pV
 ====================================================================================================*/
 
 //---------------------------------------------------------------------------------------------------
-// Note: The RenderAO, PreCreateRTs and Release entry points should not be called simultaneously from different threads.
+// Note: The RenderAO, PreCreateRTs, PreCreateShaders and Release entry points should not be called simultaneously from different threads.
 //---------------------------------------------------------------------------------------------------
 class GFSDK_SSAO_Context_D3D11 : public GFSDK_SSAO_Context
 {
@@ -822,6 +1089,7 @@ public:
     //     GFSDK_SSAO_INVALID_WORLD_TO_VIEW_MATRIX         - The world-to-view matrix is not valid (transposing it may help)
     //     GFSDK_SSAO_INVALID_NORMAL_TEXTURE_RESOLUTION    - The normal-texture resolution does not match the depth-texture resolution
     //     GFSDK_SSAO_INVALID_NORMAL_TEXTURE_SAMPLE_COUNT  - The normal-texture sample count does not match the depth-texture sample count
+    //     GFSDK_SSAO_SHADER_PERMUTATION_NOT_BUILT         - The parameters need a shader permutation pruned from this build
     //     GFSDK_SSAO_D3D_RESOURCE_CREATION_FAILED         - A D3D resource-creation call has failed (running out of memory?)
     //     GFSDK_SSAO_OK                                   - Success
     //---------------------------------------------------------------------------------------------------
@@ -850,6 +1118,27 @@ public:
         GFSDK_SSAO_UINT ViewportWidth,
         GFSDK_SSAO_UINT ViewportHeight) = 0;
 
+    //---------------------------------------------------------------------------------------------------
+    // [Optional] Pre-creates the shader permutations that RenderAO needs for the given parameters.
+    //
+    // Remarks:
+    //    * Only useful for contexts created with ShaderCreation = GFSDK_SSAO_CREATE_SHADERS_ON_DEMAND,
+    //      in which RenderAO otherwise creates the shaders it needs the first time it uses them.
+    //    * The permutations that depend on the input data (MSAA depths, input normals, view depths) are created for all inputs.
+    //    * The shaders used by RenderMask = GFSDK_SSAO_RENDER_DEBUG_NORMAL are still created on first use.
+    //    * This call performs CreatePixelShader/CreateGeometryShader/CreateVertexShader calls for the shaders not created yet,
+    //      concurrently as described in GFSDK_SSAO_ContextDesc_D3D11.
+    //
+    // Returns:
+    //     GFSDK_SSAO_NULL_ARGUMENT                        - pParameters is NULL and NumParameters is not 0
+    //     GFSDK_SSAO_SHADER_PERMUTATION_NOT_BUILT         - One of the parameters needs a shader permutation pruned from this build
+    //     GFSDK_SSAO_D3D_RESOURCE_CREATION_FAILED         - A D3D resource-creation call has failed (running out of memory?)
+    //     GFSDK_SSAO_OK                                   - Success
+    //---------------------------------------------------------------------------------------------------
+    virtual GFSDK_SSAO_Status PreCreateShaders(
+        const GFSDK_SSAO_Parameters* pParameters,
+        GFSDK_SSAO_UINT NumParameters) = 0;
+
     //---------------------------------------------------------------------------------------------------
     // [Optional] Gets the library-internal ZNear and ZFar values derived from the input projection matrix.
     //
@@ -894,12 +1183,52 @@ GFSDK_SSAO_DECL(GFSDK_SSAO_Status, GFSDK_SSAO_CreateContext_D3D11,
     GFSDK_SSAO_CUSTOM_HEAP_ARGUMENT,
     GFSDK_SSAO_VERSION_ARGUMENT);
 
+//---------------------------------------------------------------------------------------------------
+// Creation parameters of the D3D11 context.
+//
+// Remarks:
+//    * With GFSDK_SSAO_CREATE_ALL_SHADERS, all the shader permutations are created in GFSDK_SSAO_CreateContext*_D3D11.
+//    * With GFSDK_SSAO_CREATE_SHADERS_ON_DEMAND, each permutation is created by the first RenderAO or PreCreateShaders call
+//      that needs it. This makes the context creation much cheaper, at the cost of a possible hitch when the parameters
+//      of RenderAO change, which PreCreateShaders can move to a loading screen.
+//    * The shaders created by GFSDK_SSAO_CreateContext*_D3D11 and PreCreateShaders are created concurrently,
+//      by the tasks submitted to TaskScheduler if its submit_ is set (at most one per logical processor), or else by
+//      NumCreationThreads threads.
+//    * If the device was created with D3D11_CREATE_DEVICE_SINGLETHREADED, the shaders are created on the calling thread.
+//---------------------------------------------------------------------------------------------------
+struct GFSDK_SSAO_ContextDesc_D3D11
+{
+    GFSDK_SSAO_ShaderCreation   ShaderCreation;             // When to create the shader permutations
+    GFSDK_SSAO_TaskScheduler    TaskScheduler;              // Runs the shader-creation tasks (optional)
+    GFSDK_SSAO_UINT             NumCreationThreads;         // Number of threads creating the shaders if TaskScheduler.submit_ is NULL,
+                                                            // including the calling thread (0 = one per logical processor)
+
+    GFSDK_SSAO_ContextDesc_D3D11()
+        : ShaderCreation(GFSDK_SSAO_CREATE_ALL_SHADERS)
+        , NumCreationThreads(1)
+    {
+    }
+};
+
+//---------------------------------------------------------------------------------------------------
+// Same as GFSDK_SSAO_CreateContext_D3D11, with creation parameters.
+//
+// Returns:
+//     Same as GFSDK_SSAO_CreateContext_D3D11.
+//---------------------------------------------------------------------------------------------------
+GFSDK_SSAO_DECL(GFSDK_SSAO_Status, GFSDK_SSAO_CreateContextEx_D3D11,
+    ID3D11Device* pD3DDevice,
+    const GFSDK_SSAO_ContextDesc_D3D11& ContextDesc,
+    GFSDK_SSAO_Context_D3D11** ppContext,
+    GFSDK_SSAO_CUSTOM_HEAP_ARGUMENT,
+    GFSDK_SSAO_VERSION_ARGUMENT);
+
 /*====================================================================================================
    D3D12 interface.
 ====================================================================================================*/
 
 //---------------------------------------------------------------------------------------------------
-// Note: The RenderAO, PreCreateRTs and Release entry points should not be called simultaneously from different threads.
+// Note: The RenderAO, PreCreateRTs, PreCreateShaders, LoadPipelineCache, GetPipelineCacheData and Release entry points should not be called simultaneously from different threads.
 //---------------------------------------------------------------------------------------------------
 class GFSDK_SSAO_Context_D3D12 : public GFSDK_SSAO_Context
 {
@@ -922,6 +1251,7 @@ public:
     //     GFSDK_SSAO_INVALID_WORLD_TO_VIEW_MATRIX         - The world-to-view matrix is not valid (transposing it may help)
     //     GFSDK_SSAO_INVALID_NORMAL_TEXTURE_RESOLUTION    - The normal-texture resolution does not match the depth-texture resolution
     //     GFSDK_SSAO_INVALID_NORMAL_TEXTURE_SAMPLE_COUNT  - The normal-texture sample count does not match the depth-texture sample count
+    //     GFSDK_SSAO_SHADER_PERMUTATION_NOT_BUILT         - The parameters need a shader permutation pruned from this build
     //     GFSDK_SSAO_D3D_RESOURCE_CREATION_FAILED         - A D3D resource-creation call has failed (running out of memory?)
     //     GFSDK_SSAO_OK                                   - Success
     //---------------------------------------------------------------------------------------------------
@@ -952,6 +1282,30 @@ public:
         GFSDK_SSAO_UINT ViewportWidth,
         GFSDK_SSAO_UINT ViewportHeight) = 0;
 
+    //---------------------------------------------------------------------------------------------------
+    // [Optional] Pre-creates the PSOs that RenderAO needs for the given parameters.
+    //
+    // Remarks:
+    //    * RenderAO otherwise creates the PSOs it needs the first time it uses them, which may cause a hitch.
+    //    * The PSOs that depend on the input data (MSAA depths, input normals, view depths) are created for all inputs.
+    //    * The PSOs that write to the output render target are only created if pOutput is not NULL,
+    //      for the format, sample count and blend state of pOutput.
+    //    * The PSOs used by RenderMask = GFSDK_SSAO_RENDER_DEBUG_NORMAL are still created on first use.
+    //    * The PSOs are loaded from the pipeline cache if LoadPipelineCache was called with data holding them,
+    //      and are otherwise compiled with CreateGraphicsPipelineState calls, concurrently as described in
+    //      GFSDK_SSAO_ContextDesc_D3D12.
+    //
+    // Returns:
+    //     GFSDK_SSAO_NULL_ARGUMENT                        - pParameters is NULL and NumParameters is not 0, or pOutput has a NULL pointer
+    //     GFSDK_SSAO_SHADER_PERMUTATION_NOT_BUILT         - One of the parameters needs a shader permutation pruned from this build
+    //     GFSDK_SSAO_D3D_RESOURCE_CREATION_FAILED         - A D3D resource-creation call has failed (running out of memory?)
+    //     GFSDK_SSAO_OK                                   - Success
+    //---------------------------------------------------------------------------------------------------
+    virtual GFSDK_SSAO_Status PreCreateShaders(
+        const GFSDK_SSAO_Parameters* pParameters,
+        GFSDK_SSAO_UINT NumParameters,
+        const GFSDK_SSAO_Output_D3D12* pOutput = NULL) = 0;
+
     //---------------------------------------------------------------------------------------------------
     // [Optional] Gets the library-internal ZNear and ZFar values derived from the input projection matrix.
     //
@@ -968,6 +1322,43 @@ public:
         const GFSDK_SSAO_InputData_D3D12& InputData,
         GFSDK_SSAO_ProjectionMatrixDepthRange& OutputDepthRange) = 0;
 
+    //---------------------------------------------------------------------------------------------------
+    // [Optional] Loads the pipeline-cache data saved by GetPipelineCacheData in a previous run.
+    //
+    // Remarks:
+    //    * The PSOs that RenderAO creates on first use are then loaded from the cache instead of being compiled.
+    //    * Data saved by another library version, adapter or driver is rejected, and the context keeps compiling its PSOs.
+    //    * To be called right after context creation. The library keeps its own copy of the data.
+    //
+    // Returns:
+    //     GFSDK_SSAO_NULL_ARGUMENT                        - pData is NULL
+    //     GFSDK_SSAO_PIPELINE_CACHE_NOT_SUPPORTED         - The device does not support ID3D12PipelineLibrary
+    //     GFSDK_SSAO_PIPELINE_CACHE_CORRUPTED             - The data is truncated or corrupted
+    //     GFSDK_SSAO_PIPELINE_CACHE_MISMATCH              - The data was saved by another library version, adapter or driver
+    //     GFSDK_SSAO_MEMORY_ALLOCATION_FAILED             - Failed to allocate memory on the heap
+    //     GFSDK_SSAO_OK                                   - Success
+    //---------------------------------------------------------------------------------------------------
+    virtual GFSDK_SSAO_Status LoadPipelineCache(
+        const void* pData,
+        GFSDK_SSAO_SIZE_T DataSize) = 0;
+
+    //---------------------------------------------------------------------------------------------------
+    // [Optional] Gets the pipeline-cache data of all the PSOs loaded or created so far, to be saved by the application.
+    //
+    // Remarks:
+    //    * If pData is NULL, only returns the size of the data in *pDataSize.
+    //    * The data starts with a header holding the library version and the adapter and driver IDs.
+    //
+    // Returns:
+    //     GFSDK_SSAO_NULL_ARGUMENT                        - pDataSize is NULL
+    //     GFSDK_SSAO_PIPELINE_CACHE_NOT_SUPPORTED         - The device does not support ID3D12PipelineLibrary
+    //     GFSDK_SSAO_PIPELINE_CACHE_BUFFER_TOO_SMALL      - *pDataSize is smaller than the size of the data
+    //     GFSDK_SSAO_OK                                   - Success
+    //---------------------------------------------------------------------------------------------------
+    virtual GFSDK_SSAO_Status GetPipelineCacheData(
+        void* pData,
+        GFSDK_SSAO_SIZE_T* pDataSize) = 0;
+
     //---------------------------------------------------------------------------------------------------
     // Releases all D3D objects created by the library (to be called right before releasing the D3D device).
     //---------------------------------------------------------------------------------------------------
@@ -1028,4 +1419,170 @@ GFSDK_SSAO_DECL(GFSDK_SSAO_Status, GFSDK_SSAO_CreateContext_D3D12,
     GFSDK_SSAO_CUSTOM_HEAP_ARGUMENT,
     GFSDK_SSAO_VERSION_ARGUMENT);
 
+//---------------------------------------------------------------------------------------------------
+// Creation parameters of the D3D12 context.
+//
+// Remarks:
+//    * The PSOs created by PreCreateShaders are compiled concurrently, by the tasks submitted to TaskScheduler
+//      if its submit_ is set (at most one per logical processor), or else by NumCreationThreads threads.
+//    * The PSOs that RenderAO creates on first use are always compiled on the calling thread.
+//---------------------------------------------------------------------------------------------------
+struct GFSDK_SSAO_ContextDesc_D3D12
+{
+    GFSDK_SSAO_TaskScheduler    TaskScheduler;              // Runs the PSO-creation tasks (optional)
+    GFSDK_SSAO_UINT             NumCreationThreads;         // Number of threads creating the PSOs if TaskScheduler.submit_ is NULL,
+                                                            // including the calling thread (0 = one per logical processor)
+
+    GFSDK_SSAO_ContextDesc_D3D12()
+        : NumCreationThreads(1)
+    {
+    }
+};
+
+//---------------------------------------------------------------------------------------------------
+// Same as GFSDK_SSAO_CreateContext_D3D12, with creation parameters.
+//
+// Returns:
+//     Same as GFSDK_SSAO_CreateContext_D3D12.
+//---------------------------------------------------------------------------------------------------
+GFSDK_SSAO_DECL(GFSDK_SSAO_Status, GFSDK_SSAO_CreateContextEx_D3D12,
+    ID3D12Device* pD3DDevice,
+    GFSDK_SSAO_UINT NodeMask,
+    const GFSDK_SSAO_DescriptorHeaps_D3D12& DescriptorHeaps,
+    const GFSDK_SSAO_ContextDesc_D3D12& ContextDesc,
+    GFSDK_SSAO_Context_D3D12** ppContext,
+    GFSDK_SSAO_CUSTOM_HEAP_ARGUMENT,
+    GFSDK_SSAO_VERSION_ARGUMENT);
+
+/*====================================================================================================
+   CPU interface.
+====================================================================================================*/
+
+//---------------------------------------------------------------------------------------------------
+// Note: The RenderAO, PreCreateRTs and Release entry points should not be called simultaneously from different threads.
+//---------------------------------------------------------------------------------------------------
+class GFSDK_SSAO_Context_CPU : public GFSDK_SSAO_Context
+{
+public:
+
+    //---------------------------------------------------------------------------------------------------
+    // Renders SSAO on the host, reading and writing host-memory textures.
+    //
+    // Remarks:
+    //    * Runs the same passes as the D3D11 path, with the same parameters and permutations.
+    //    * Allocates internal host buffers on first use, and re-allocates them when the viewport dimensions change.
+    //    * The AO is written to the Viewport rectangle of the output texture, clipped to its dimensions.
+    //    * Setting RenderMask = GFSDK_SSAO_RENDER_DEBUG_NORMAL_Z can be useful to visualize the normals used for the AO rendering.
+    //
+    // Returns:
+    //     GFSDK_SSAO_NULL_ARGUMENT                        - One of the required argument pointers is NULL
+    //     GFSDK_SSAO_INVALID_PROJECTION_MATRIX            - The projection matrix is not valid
+    //     GFSDK_SSAO_INVALID_VIEWPORT_DIMENSIONS          - One of the viewport dimensions (width or height) is 0
+    //     GFSDK_SSAO_INVALID_VIEWPORT_DEPTH_RANGE         - The viewport depth range is not a sub-range of [0.f,1.f]
+    //     GFSDK_SSAO_INVALID_WORLD_TO_VIEW_MATRIX         - The world-to-view matrix is not valid (transposing it may help)
+    //     GFSDK_SSAO_INVALID_NORMAL_TEXTURE_RESOLUTION    - The normal-texture resolution does not match the depth-texture resolution
+    //     GFSDK_SSAO_INVALID_NORMAL_TEXTURE_SAMPLE_COUNT  - The normal-texture sample count does not match the depth-texture sample count
+    //     GFSDK_SSAO_CPU_UNSUPPORTED_BLEND_MODE           - Output.Blend.Mode is CUSTOM_BLEND
+    //     GFSDK_SSAO_CPU_INVALID_TEXTURE_LAYOUT           - One of the host textures has an invalid NumChannels or RowPitch
+    //     GFSDK_SSAO_MEMORY_ALLOCATION_FAILED             - Failed to allocate the internal buffers on the heap
+    //     GFSDK_SSAO_OK                                   - Success
+    //---------------------------------------------------------------------------------------------------
+    virtual GFSDK_SSAO_Status RenderAO(
+        const GFSDK_SSAO_InputData_CPU& InputData,
+        const GFSDK_SSAO_Parameters& Parameters,
+        const GFSDK_SSAO_Output_CPU& Output,
+        GFSDK_SSAO_RenderMask RenderMask = GFSDK_SSAO_RENDER_AO) = 0;
+
+    //---------------------------------------------------------------------------------------------------
+    // [Optional] Pre-allocates all internal buffers for RenderAO.
+    //
+    // Remarks:
+    //    * This call may be safely skipped since RenderAO allocates its buffers on demand if they were not pre-allocated.
+    //    * This call releases and re-allocates the internal buffers if the provided resolution changes.
+    //
+    // Returns:
+    //     GFSDK_SSAO_MEMORY_ALLOCATION_FAILED             - Failed to allocate the internal buffers on the heap
+    //     GFSDK_SSAO_OK                                   - Success
+    //---------------------------------------------------------------------------------------------------
+    virtual GFSDK_SSAO_Status PreCreateRTs(
+        const GFSDK_SSAO_Parameters& Parameters,
+        GFSDK_SSAO_UINT ViewportWidth,
+        GFSDK_SSAO_UINT ViewportHeight) = 0;
+
+    //---------------------------------------------------------------------------------------------------
+    // [Optional] Gets the library-internal ZNear and ZFar values derived from the input projection matrix.
+    //
+    // Returns:
+    //     GFSDK_SSAO_INVALID_PROJECTION_MATRIX            - The projection matrix is not valid
+    //     GFSDK_SSAO_OK                                   - Success
+    //---------------------------------------------------------------------------------------------------
+    virtual GFSDK_SSAO_Status GetProjectionMatrixDepthRange(
+        const GFSDK_SSAO_InputData_CPU& InputData,
+        GFSDK_SSAO_ProjectionMatrixDepthRange& OutputDepthRange) = 0;
+
+    //---------------------------------------------------------------------------------------------------
+    // Returns the instruction set of the kernels used by RenderAO.
+    //
+    // Remarks:
+    //    * The kernels are selected once, in GFSDK_SSAO_CreateContext_CPU, based on CPUID and ContextDesc.MaxInstructionSet.
+    //---------------------------------------------------------------------------------------------------
+    virtual GFSDK_SSAO_InstructionSet_CPU GetInstructionSet() = 0;
+
+    //---------------------------------------------------------------------------------------------------
+    // Releases the internal buffers and the context itself.
+    //---------------------------------------------------------------------------------------------------
+    virtual void Release() = 0;
+
+}; //class GFSDK_SSAO_Context_CPU
+
+//---------------------------------------------------------------------------------------------------
+// Creation parameters of the CPU context.
+//
+// Remarks:
+//    * RenderAO splits each pass into tiles, which are distributed over a persistent pool of worker threads.
+//    * The thread calling RenderAO executes tiles too, and counts as one of the NumThreads.
+//    * If AffinityMask is non-zero, each worker thread is pinned to one of the logical processors in the mask,
+//      in increasing order and wrapping around. The calling thread is not pinned.
+//    * MaxInstructionSet caps the kernels selected based on CPUID, e.g. to compare them with the scalar ones.
+//---------------------------------------------------------------------------------------------------
+struct GFSDK_SSAO_ContextDesc_CPU
+{
+    GFSDK_SSAO_UINT     NumThreads;                         // Number of threads rendering the AO (0 = one per logical processor)
+    GFSDK_SSAO_UINT64   AffinityMask;                       // Logical processors to run the worker threads on (0 = no affinity)
+    GFSDK_SSAO_InstructionSet_CPU MaxInstructionSet;        // Widest kernels to use, if supported by the CPU and the OS
+
+    GFSDK_SSAO_ContextDesc_CPU()
+        : NumThreads(0)
+        , AffinityMask(0)
+        , MaxInstructionSet(GFSDK_SSAO_CPU_AVX512)
+    {
+    }
+};
+
+//---------------------------------------------------------------------------------------------------
+// Creates a GFSDK_SSAO_Context that renders on the host, without any graphics device.
+//
+// Remarks:
+//    * Allocates memory using the default "::operator new", or "pCustomHeap->new_" if provided.
+//    * Creates ContextDesc.NumThreads-1 worker threads, which are released with the context.
+//    * GetAllocatedVideoMemoryBytes returns the size of the internal host buffers.
+//    * On x86-64, the widest of the SSE4.2, AVX2 (with FMA and F16C) or AVX-512 (with AVX2, FMA and F16C) kernels supported by the CPU and the OS is used.
+//    * Like on the GPU, Parameters.DepthStorage selects the format of the internal quarter-res depths,
+//      and the dual-layer depths are always stored in FP16.
+//    * With Parameters.Algorithm = LINE_SWEEP, the AO is computed at full resolution from FP32 view depths,
+//      with one pass over the whole image per pair of opposite directions, and DepthClampMode has no effect.
+//
+// Returns:
+//     GFSDK_SSAO_NULL_ARGUMENT                        - One of the required argument pointers is NULL
+//     GFSDK_SSAO_VERSION_MISMATCH                     - Invalid HeaderVersion (have you set HeaderVersion = GFSDK_SSAO_Version()?)
+//     GFSDK_SSAO_MEMORY_ALLOCATION_FAILED             - Failed to allocate memory on the heap
+//     GFSDK_SSAO_CPU_THREAD_CREATION_FAILED           - Failed to create the worker threads
+//     GFSDK_SSAO_OK                                   - Success
+//---------------------------------------------------------------------------------------------------
+GFSDK_SSAO_DECL(GFSDK_SSAO_Status, GFSDK_SSAO_CreateContext_CPU,
+    const GFSDK_SSAO_ContextDesc_CPU& ContextDesc,
+    GFSDK_SSAO_Context_CPU** ppContext,
+    GFSDK_SSAO_CUSTOM_HEAP_ARGUMENT,
+    GFSDK_SSAO_VERSION_ARGUMENT);
+
 #pragma pack(pop)
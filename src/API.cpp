@@ -33,6 +33,10 @@
 #include "Renderer_DX12.h"
 #endif
 
+#if SUPPORT_CPU
+#include "Renderer_CPU.h"
+#endif
+
 //--------------------------------------------------------------------------------
 inline static
 GFSDK_SSAO_CustomHeap InitNewDelete(const GFSDK_SSAO_CustomHeap* pCustomHeap)
@@ -70,8 +74,9 @@ void* AllocateAndZeroMemory(const GFSDK_SSAO_CustomHeap& NewDelete, std::size_t
 #if SUPPORT_D3D11
 
 //--------------------------------------------------------------------------------
-GFSDK_SSAO_DECL(GFSDK_SSAO_Status, GFSDK_SSAO_CreateContext_D3D11,
+GFSDK_SSAO_DECL(GFSDK_SSAO_Status, GFSDK_SSAO_CreateContextEx_D3D11,
     ID3D11Device* pD3DDevice,
+    const GFSDK_SSAO_ContextDesc_D3D11& ContextDesc,
     GFSDK_SSAO_Context_D3D11** ppAOContext,
     const GFSDK_SSAO_CustomHeap* pCustomHeap,
     GFSDK_SSAO_Version HeaderVersion)
@@ -93,7 +98,17 @@ GFSDK_SSAO_DECL(GFSDK_SSAO_Status, GFSDK_SSAO_CreateContext_D3D11,
 
     *ppAOContext = pAOContext;
 
-    return pAOContext->Create(pD3DDevice, HeaderVersion);
+    return pAOContext->Create(pD3DDevice, ContextDesc, HeaderVersion);
+}
+
+//--------------------------------------------------------------------------------
+GFSDK_SSAO_DECL(GFSDK_SSAO_Status, GFSDK_SSAO_CreateContext_D3D11,
+    ID3D11Device* pD3DDevice,
+    GFSDK_SSAO_Context_D3D11** ppAOContext,
+    const GFSDK_SSAO_CustomHeap* pCustomHeap,
+    GFSDK_SSAO_Version HeaderVersion)
+{
+    return GFSDK_SSAO_CreateContextEx_D3D11(pD3DDevice, GFSDK_SSAO_ContextDesc_D3D11(), ppAOContext, pCustomHeap, HeaderVersion);
 }
 
 #endif
@@ -101,10 +116,11 @@ GFSDK_SSAO_DECL(GFSDK_SSAO_Status, GFSDK_SSAO_CreateContext_D3D11,
 #if SUPPORT_D3D12
 
 //--------------------------------------------------------------------------------
-GFSDK_SSAO_DECL(GFSDK_SSAO_Status, GFSDK_SSAO_CreateContext_D3D12,
+GFSDK_SSAO_DECL(GFSDK_SSAO_Status, GFSDK_SSAO_CreateContextEx_D3D12,
     ID3D12Device* pD3DDevice,
     GFSDK_SSAO_UINT NodeMask,
     const GFSDK_SSAO_DescriptorHeaps_D3D12& DescriptorHeaps,
+    const GFSDK_SSAO_ContextDesc_D3D12& ContextDesc,
     GFSDK_SSAO_Context_D3D12** ppAOContext,
     const GFSDK_SSAO_CustomHeap* pCustomHeap,
     GFSDK_SSAO_Version HeaderVersion)
@@ -126,7 +142,50 @@ GFSDK_SSAO_DECL(GFSDK_SSAO_Status, GFSDK_SSAO_CreateContext_D3D12,
 
     *ppAOContext = pAOContext;
 
-    return pAOContext->Create(pD3DDevice, NodeMask, DescriptorHeaps, HeaderVersion);
+    return pAOContext->Create(pD3DDevice, NodeMask, DescriptorHeaps, ContextDesc, HeaderVersion);
+}
+
+//--------------------------------------------------------------------------------
+GFSDK_SSAO_DECL(GFSDK_SSAO_Status, GFSDK_SSAO_CreateContext_D3D12,
+    ID3D12Device* pD3DDevice,
+    GFSDK_SSAO_UINT NodeMask,
+    const GFSDK_SSAO_DescriptorHeaps_D3D12& DescriptorHeaps,
+    GFSDK_SSAO_Context_D3D12** ppAOContext,
+    const GFSDK_SSAO_CustomHeap* pCustomHeap,
+    GFSDK_SSAO_Version HeaderVersion)
+{
+    return GFSDK_SSAO_CreateContextEx_D3D12(pD3DDevice, NodeMask, DescriptorHeaps, GFSDK_SSAO_ContextDesc_D3D12(), ppAOContext, pCustomHeap, HeaderVersion);
+}
+
+#endif
+
+#if SUPPORT_CPU
+
+//--------------------------------------------------------------------------------
+GFSDK_SSAO_DECL(GFSDK_SSAO_Status, GFSDK_SSAO_CreateContext_CPU,
+    const GFSDK_SSAO_ContextDesc_CPU& ContextDesc,
+    GFSDK_SSAO_Context_CPU** ppAOContext,
+    const GFSDK_SSAO_CustomHeap* pCustomHeap,
+    GFSDK_SSAO_Version HeaderVersion)
+{
+    if (!ppAOContext)
+    {
+        return GFSDK_SSAO_NULL_ARGUMENT;
+    }
+
+    GFSDK_SSAO_CustomHeap NewDelete = InitNewDelete(pCustomHeap);
+
+    void *pStorage = AllocateAndZeroMemory(NewDelete, sizeof(GFSDK::SSAO::CPU::Renderer));
+    if (!pStorage)
+    {
+        return GFSDK_SSAO_MEMORY_ALLOCATION_FAILED;
+    }
+
+    GFSDK::SSAO::CPU::Renderer* pAOContext = new(pStorage) GFSDK::SSAO::CPU::Renderer(NewDelete);
+
+    *ppAOContext = pAOContext;
+
+    return pAOContext->Create(ContextDesc, HeaderVersion);
 }
 
 #endif
@@ -48,6 +48,11 @@
 #define ENABLE_EXCEPTIONS 1
 #endif
 
+// High-resolution host timers around the phases of RenderAO (GFSDK_SSAO_RenderTimes::CPUPhases)
+#ifndef ENABLE_CPU_TIMERS
+#define ENABLE_CPU_TIMERS 1
+#endif
+
 #if ENABLE_EXCEPTIONS
 #define THROW_RUNTIME_ERROR()   throw std::runtime_error("")
 #else
@@ -56,6 +61,27 @@
 
 #define THROW_IF(exp)           { if (exp) THROW_RUNTIME_ERROR(); }
 #define THROW_IF_FAILED(exp)    { if (exp != S_OK) THROW_RUNTIME_ERROR(); }
+
+// Raised by the generated Get() accessors of the shader permutations pruned by ShaderBuildTool --permutations,
+// and reported as GFSDK_SSAO_SHADER_PERMUTATION_NOT_BUILT
+#if ENABLE_EXCEPTIONS
+namespace GFSDK
+{
+namespace SSAO
+{
+struct PermutationNotBuiltError : std::runtime_error
+{
+    PermutationNotBuiltError() : std::runtime_error("shader permutation not built")
+    {
+    }
+};
+} // namespace SSAO
+} // namespace GFSDK
+
+#define THROW_PERMUTATION_NOT_BUILT()   throw GFSDK::SSAO::PermutationNotBuiltError()
+#else
+#define THROW_PERMUTATION_NOT_BUILT()   ASSERT(0)
+#endif
 #define SAFE_D3D_CALL(exp)      { if (exp != S_OK) ASSERT(0); }
 
 #define SIZEOF_ARRAY(A)         (sizeof(A) / sizeof(A[0]))
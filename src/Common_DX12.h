@@ -191,9 +191,12 @@ inline void GFSDK_D3D12_SetResourceBarrier(ID3D12GraphicsCommandList* commandLis
     commandList->ResourceBarrier(1, &desc);
 }
 
+namespace GFSDK { namespace SSAO { namespace D3D12 { class PipelineLibrary; } } }
+
 struct GFSDK_D3D12_GraphicsContext
 {
     ID3D12Device* pDevice;
+    GFSDK::SSAO::D3D12::PipelineLibrary* pPipelineLibrary;
     GFSDK_D3D12_DescriptorHeaps DescHeaps;
     ID3D12GraphicsCommandList* pCmdList;
     ID3D12CommandQueue* pCmdQueue;
@@ -209,6 +212,7 @@ struct GFSDK_D3D12_GraphicsContext
         ASSERT(pCmdQueue == NULL);
 
         pDevice = _pDevice;
+        pPipelineLibrary = NULL;
         pCmdList = NULL;
         pCmdQueue = NULL;
         NodeMask = _NodeMask;
@@ -1332,4 +1332,9 @@ typedef ptrdiff_t GLsizeiptrARB;
 
 #endif //GL_VERSION_3_2
 
+// GL 3.3 or ARB_timer_query
+#ifndef GL_TIMESTAMP
+#define GL_TIMESTAMP 0x8E28
+#endif
+
 #endif //SUPPORT_GL
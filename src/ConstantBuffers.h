@@ -349,5 +349,63 @@ private:
 } // namespace D3D12
 #endif // SUPPORT_D3D12
 
+//--------------------------------------------------------------------------------
+#if SUPPORT_CPU
+namespace CPU
+{
+
+//--------------------------------------------------------------------------------
+// On the host, the "constant buffers" are read directly by the kernels
+//--------------------------------------------------------------------------------
+class GlobalConstantBuffer : public GlobalConstants
+{
+public:
+    void UpdateBuffer(GFSDK_SSAO_RenderMask RenderMask)
+    {
+        SetRenderMask(RenderMask);
+    }
+    const SSAO::GlobalConstantBuffer& GetCB() const
+    {
+        return m_Data;
+    }
+};
+
+//--------------------------------------------------------------------------------
+class PerPassConstantBuffer : public PerPassConstants
+{
+public:
+    const PerPassConstantStruct& GetCB() const
+    {
+        return m_Data.PerPassConstants;
+    }
+};
+
+//--------------------------------------------------------------------------------
+class PerPassConstantBuffers
+{
+public:
+    void Create()
+    {
+        for (UINT SliceIndex = 0; SliceIndex < SIZEOF_ARRAY(m_CBs); ++SliceIndex)
+        {
+            m_CBs[SliceIndex].SetOffset(SliceIndex % 4, SliceIndex / 4);
+            m_CBs[SliceIndex].SetJitter(m_RandomTexture.GetJitter(SliceIndex));
+            m_CBs[SliceIndex].SetSliceIndex(SliceIndex);
+        }
+    }
+    const PerPassConstantStruct& GetCB(UINT PassIndex) const
+    {
+        ASSERT(PassIndex < SIZEOF_ARRAY(m_CBs));
+        return m_CBs[PassIndex].GetCB();
+    }
+
+private:
+    PerPassConstantBuffer m_CBs[16];
+    GFSDK::SSAO::RandomTexture m_RandomTexture;
+};
+
+} // namespace CPU
+#endif // SUPPORT_CPU
+
 } // namespace SSAO
 } // namespace GFSDK
@@ -182,5 +182,70 @@ struct InputDepthInfo : SSAO::InputDepthInfo
 } // namespace D3D12
 #endif // SUPPORT_D3D12
 
+//--------------------------------------------------------------------------------
+#if SUPPORT_CPU
+namespace CPU
+{
+
+struct InputDepthInfo : SSAO::InputDepthInfo
+{
+    InputDepthInfo()
+        : SSAO::InputDepthInfo()
+    {
+    }
+
+    GFSDK_SSAO_Status SetData(const GFSDK_SSAO_InputDepthData_CPU& DepthData)
+    {
+        GFSDK_SSAO_Status Status;
+
+        Status = ProjectionMatrixInfo.Init(DepthData.ProjectionMatrix, API_D3D11);
+        if (Status != GFSDK_SSAO_OK)
+        {
+            return Status;
+        }
+
+        Status = Texture0.Init(&DepthData.FullResDepthTextureSRV);
+        if (Status != GFSDK_SSAO_OK)
+        {
+            return Status;
+        }
+
+        if (DepthData.FullResDepthTexture2ndLayerSRV.pData)
+        {
+            Status = Texture1.Init(&DepthData.FullResDepthTexture2ndLayerSRV);
+            if (Status != GFSDK_SSAO_OK)
+            {
+                return Status;
+            }
+            if (Texture1.Width  != Texture0.Width ||
+                Texture1.Height != Texture0.Height)
+            {
+                return GFSDK_SSAO_INVALID_SECOND_DEPTH_TEXTURE_RESOLUTION;
+            }
+            if (Texture1.SampleCount != Texture0.SampleCount)
+            {
+                return GFSDK_SSAO_INVALID_SECOND_DEPTH_TEXTURE_SAMPLE_COUNT;
+            }
+        }
+
+        Status = Viewport.Init(DepthData.Viewport, Texture0);
+        if (Status != GFSDK_SSAO_OK)
+        {
+            return Status;
+        }
+
+        DepthTextureType = DepthData.DepthTextureType;
+        MetersToViewSpaceUnits = Max(DepthData.MetersToViewSpaceUnits, 0.f);
+
+        return GFSDK_SSAO_OK;
+    }
+
+    SSAO::CPU::UserTextureSRV Texture0;
+    SSAO::CPU::UserTextureSRV Texture1;
+};
+
+} // namespace CPU
+#endif // SUPPORT_CPU
+
 } // namespace SSAO
 } // namespace GFSDK
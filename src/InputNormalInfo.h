@@ -112,5 +112,33 @@ struct InputNormalInfo
 } // namespace D3D12
 #endif
 
+//--------------------------------------------------------------------------------
+#if SUPPORT_CPU
+namespace CPU
+{
+
+struct InputNormalInfo
+{
+    GFSDK_SSAO_Status SetData(const GFSDK_SSAO_InputNormalData_CPU& NormalData)
+    {
+        if (!NormalData.FullResNormalTextureSRV.pData)
+        {
+            return GFSDK_SSAO_NULL_ARGUMENT;
+        }
+
+        if (!GFSDK::SSAO::WorldToViewMatrix::IsValid(NormalData.WorldToViewMatrix))
+        {
+            return GFSDK_SSAO_INVALID_WORLD_TO_VIEW_MATRIX;
+        }
+
+        return Texture.Init(&NormalData.FullResNormalTextureSRV, 3);
+    }
+
+    SSAO::CPU::UserTextureSRV Texture;
+};
+
+} // namespace CPU
+#endif
+
 } // namespace SSAO
 } // namespace GFSDK
@@ -121,5 +121,44 @@ struct OutputInfo
 } // namespace D3D12
 #endif // SUPPORT_D3D12
 
+#if SUPPORT_CPU
+namespace CPU
+{
+
+//--------------------------------------------------------------------------------
+struct OutputInfo
+{
+    OutputInfo()
+    {
+    }
+
+    GFSDK_SSAO_Status Init(const GFSDK_SSAO_Output_CPU& Output)
+    {
+        GFSDK_SSAO_Status Status;
+
+        Status = RenderTarget.Init(Output.pRenderTargetView);
+        if (Status != GFSDK_SSAO_OK)
+        {
+            return Status;
+        }
+
+        if (Output.Blend.Mode != GFSDK_SSAO_OVERWRITE_RGB &&
+            Output.Blend.Mode != GFSDK_SSAO_MULTIPLY_RGB)
+        {
+            return GFSDK_SSAO_CPU_UNSUPPORTED_BLEND_MODE;
+        }
+
+        Blend = Output.Blend;
+
+        return GFSDK_SSAO_OK;
+    }
+
+    GFSDK::SSAO::CPU::UserTextureRTV RenderTarget;
+    GFSDK_SSAO_BlendState_CPU Blend;
+};
+
+} // namespace CPU
+#endif // SUPPORT_CPU
+
 } // namespace SSAO
 } // namespace GFSDK
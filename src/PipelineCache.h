@@ -0,0 +1,210 @@
+// This code contains NVIDIA Confidential Information and is disclosed to you
+// under a form of NVIDIA software license agreement provided separately to you.
+//
+// Notice
+// NVIDIA Corporation and its licensors retain all intellectual property and
+// proprietary rights in and to this software and related documentation and
+// any modifications thereto. Any use, reproduction, disclosure, or
+// distribution of this software and related documentation without an express
+// license agreement from NVIDIA Corporation is strictly prohibited.
+//
+// ALL NVIDIA DESIGN SPECIFICATIONS, CODE ARE PROVIDED "AS IS.". NVIDIA MAKES
+// NO WARRANTIES, EXPRESSED, IMPLIED, STATUTORY, OR OTHERWISE WITH RESPECT TO
+// THE MATERIALS, AND EXPRESSLY DISCLAIMS ALL IMPLIED WARRANTIES OF NONINFRINGEMENT,
+// MERCHANTABILITY, AND FITNESS FOR A PARTICULAR PURPOSE.
+//
+// Information and code furnished is believed to be accurate and reliable.
+// However, NVIDIA Corporation assumes no responsibility for the consequences of use of such
+// information or for any infringement of patents or other rights of third parties that may
+// result from its use. No license is granted by implication or otherwise under any patent
+// or patent rights of NVIDIA Corporation. Details are subject to change without notice.
+// This code supersedes and replaces all information previously supplied.
+// NVIDIA Corporation products are not authorized for use as critical
+// components in life support devices or systems without express written approval of
+// NVIDIA Corporation.
+//
+// Copyright (c) 2008-2021 NVIDIA Corporation. All rights reserved.
+
+#pragma once
+#include "Common.h"
+
+namespace GFSDK
+{
+namespace SSAO
+{
+
+//--------------------------------------------------------------------------------
+// FNV-1a hash
+inline UINT HashBytes(const void* pData, size_t SizeInBytes)
+{
+    const unsigned char* pBytes = static_cast<const unsigned char*>(pData);
+    UINT Hash = 2166136261u;
+    for (size_t Index = 0; Index < SizeInBytes; ++Index)
+    {
+        Hash ^= pBytes[Index];
+        Hash *= 16777619u;
+    }
+    return Hash;
+}
+
+//--------------------------------------------------------------------------------
+// Cache of all the pipelines created so far for one pass, so that switching back
+// to a previous permutation or output state does not compile the pipeline again.
+//
+// KeyType must be a POD type with no uninitialized bytes (e.g. zeroed in its
+// constructor), as keys are hashed and compared byte by byte. PipelineType is a
+// pointer to a ref-counted object, released by Release.
+//--------------------------------------------------------------------------------
+template<class KeyType, class PipelineType>
+class PipelineCache
+{
+public:
+    PipelineCache()
+        : m_pEntries(NULL)
+        , m_NumEntries(0)
+        , m_MaxNumEntries(0)
+        , m_LastIndex(0)
+    {
+        m_NewDelete.new_ = NULL;
+        m_NewDelete.delete_ = NULL;
+    }
+
+    void Create(const GFSDK_SSAO_CustomHeap& NewDelete)
+    {
+        ASSERT(!m_pEntries);
+        m_NewDelete = NewDelete;
+    }
+
+    // Releases all the cached pipelines
+    void Release()
+    {
+        for (UINT Index = 0; Index < m_NumEntries; ++Index)
+        {
+            SAFE_RELEASE(m_pEntries[Index].Pipeline);
+        }
+
+        if (m_pEntries)
+        {
+            m_NewDelete.delete_(m_pEntries);
+            m_pEntries = NULL;
+        }
+
+        m_NumEntries = 0;
+        m_MaxNumEntries = 0;
+        m_LastIndex = 0;
+    }
+
+    // Returns NULL if no pipeline has been added for this key
+    PipelineType Find(const KeyType& Key)
+    {
+        // Fast path: same key as the previous lookup
+        if (m_LastIndex < m_NumEntries && Equals(m_pEntries[m_LastIndex].Key, Key))
+        {
+            return m_pEntries[m_LastIndex].Pipeline;
+        }
+
+        const UINT Hash = GetHash(Key);
+        for (UINT Index = 0; Index < m_NumEntries; ++Index)
+        {
+            if (m_pEntries[Index].Hash == Hash && Equals(m_pEntries[Index].Key, Key))
+            {
+                m_LastIndex = Index;
+                return m_pEntries[Index].Pipeline;
+            }
+        }
+
+        return NULL;
+    }
+
+    // Takes ownership of Pipeline, which is released if the cache cannot grow
+    void Insert(const KeyType& Key, PipelineType Pipeline)
+    {
+        ASSERT(!Find(Key));
+
+        if (m_NumEntries == m_MaxNumEntries && !SafeGrow())
+        {
+            SAFE_RELEASE(Pipeline);
+            THROW_RUNTIME_ERROR();
+            return;
+        }
+
+        Entry& E = m_pEntries[m_NumEntries];
+        E.Key = Key;
+        E.Hash = GetHash(Key);
+        E.Pipeline = Pipeline;
+
+        m_LastIndex = m_NumEntries++;
+    }
+
+    UINT GetCount() const
+    {
+        return m_NumEntries;
+    }
+
+    static UINT GetHash(const KeyType& Key)
+    {
+        return HashBytes(&Key, sizeof(KeyType));
+    }
+
+private:
+    PipelineCache(const PipelineCache&);
+    PipelineCache& operator=(const PipelineCache&);
+
+    struct Entry
+    {
+        KeyType Key;
+        UINT Hash;
+        PipelineType Pipeline;
+    };
+
+    static bool Equals(const KeyType& A, const KeyType& B)
+    {
+        return memcmp(&A, &B, sizeof(KeyType)) == 0;
+    }
+
+    bool SafeGrow()
+    {
+#if ENABLE_EXCEPTIONS
+        try
+        {
+            return Grow();
+        }
+        catch (...)
+        {
+            return false;
+        }
+#else
+        return Grow();
+#endif
+    }
+
+    bool Grow()
+    {
+        const UINT MaxNumEntries = m_MaxNumEntries ? 2 * m_MaxNumEntries : 8;
+
+        Entry* pEntries = (Entry*)m_NewDelete.new_(sizeof(Entry) * MaxNumEntries);
+        if (!pEntries)
+        {
+            return false;
+        }
+
+        if (m_pEntries)
+        {
+            memcpy(pEntries, m_pEntries, sizeof(Entry) * m_NumEntries);
+            m_NewDelete.delete_(m_pEntries);
+        }
+
+        m_pEntries = pEntries;
+        m_MaxNumEntries = MaxNumEntries;
+        return true;
+    }
+
+    GFSDK_SSAO_CustomHeap m_NewDelete;
+    Entry* m_pEntries;
+    UINT m_NumEntries;
+    UINT m_MaxNumEntries;
+    UINT m_LastIndex;
+};
+
+} // namespace SSAO
+} // namespace GFSDK
@@ -0,0 +1,90 @@
+// This code contains NVIDIA Confidential Information and is disclosed to you
+// under a form of NVIDIA software license agreement provided separately to you.
+//
+// Notice
+// NVIDIA Corporation and its licensors retain all intellectual property and
+// proprietary rights in and to this software and related documentation and
+// any modifications thereto. Any use, reproduction, disclosure, or
+// distribution of this software and related documentation without an express
+// license agreement from NVIDIA Corporation is strictly prohibited.
+//
+// ALL NVIDIA DESIGN SPECIFICATIONS, CODE ARE PROVIDED "AS IS.". NVIDIA MAKES
+// NO WARRANTIES, EXPRESSED, IMPLIED, STATUTORY, OR OTHERWISE WITH RESPECT TO
+// THE MATERIALS, AND EXPRESSLY DISCLAIMS ALL IMPLIED WARRANTIES OF NONINFRINGEMENT,
+// MERCHANTABILITY, AND FITNESS FOR A PARTICULAR PURPOSE.
+//
+// Information and code furnished is believed to be accurate and reliable.
+// However, NVIDIA Corporation assumes no responsibility for the consequences of use of such
+// information or for any infringement of patents or other rights of third parties that may
+// result from its use. No license is granted by implication or otherwise under any patent
+// or patent rights of NVIDIA Corporation. Details are subject to change without notice.
+// This code supersedes and replaces all information previously supplied.
+// NVIDIA Corporation products are not authorized for use as critical
+// components in life support devices or systems without express written approval of
+// NVIDIA Corporation.
+//
+// Copyright (c) 2008-2021 NVIDIA Corporation. All rights reserved.
+
+#include "PipelineCacheBlob.h"
+#include "PipelineCache.h"
+
+//--------------------------------------------------------------------------------
+void GFSDK::SSAO::PipelineCacheBlob::WriteHeader(void* pBlob, const PipelineCacheDeviceInfo& Device, UINT DataSize)
+{
+    Header H;
+    ZERO_STRUCT(H);
+    H.Magic = MAGIC;
+    H.FormatVersion = FORMAT_VERSION;
+    H.HeaderSize = sizeof(Header);
+    H.LibraryVersion = GFSDK_SSAO_Version();
+    H.Device = Device;
+    H.DataSize = DataSize;
+    H.DataHash = HashBytes(GetData(pBlob), DataSize);
+
+    memcpy(pBlob, &H, sizeof(H));
+}
+
+//--------------------------------------------------------------------------------
+GFSDK_SSAO_Status GFSDK::SSAO::PipelineCacheBlob::Validate(
+    const void* pBlob,
+    GFSDK_SSAO_SIZE_T BlobSize,
+    const PipelineCacheDeviceInfo& Device,
+    const void** ppData,
+    UINT* pDataSize)
+{
+    Header H;
+    if (BlobSize < sizeof(H))
+    {
+        return GFSDK_SSAO_PIPELINE_CACHE_CORRUPTED;
+    }
+
+    // The blob may come straight from a file buffer, with any alignment
+    memcpy(&H, pBlob, sizeof(H));
+
+    if (H.Magic != MAGIC || H.HeaderSize != sizeof(Header))
+    {
+        return GFSDK_SSAO_PIPELINE_CACHE_CORRUPTED;
+    }
+
+    const GFSDK_SSAO_Version LibraryVersion;
+    if (H.FormatVersion != FORMAT_VERSION ||
+        H.LibraryVersion.Major != LibraryVersion.Major ||
+        H.LibraryVersion.Minor != LibraryVersion.Minor ||
+        H.LibraryVersion.Branch != LibraryVersion.Branch ||
+        H.LibraryVersion.Revision != LibraryVersion.Revision ||
+        memcmp(&H.Device, &Device, sizeof(Device)) != 0)
+    {
+        return GFSDK_SSAO_PIPELINE_CACHE_MISMATCH;
+    }
+
+    const void* pData = static_cast<const char*>(pBlob) + sizeof(Header);
+    if (H.DataSize != BlobSize - sizeof(Header) ||
+        H.DataHash != HashBytes(pData, H.DataSize))
+    {
+        return GFSDK_SSAO_PIPELINE_CACHE_CORRUPTED;
+    }
+
+    *ppData = pData;
+    *pDataSize = H.DataSize;
+    return GFSDK_SSAO_OK;
+}
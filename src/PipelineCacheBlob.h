@@ -0,0 +1,107 @@
+// This code contains NVIDIA Confidential Information and is disclosed to you
+// under a form of NVIDIA software license agreement provided separately to you.
+//
+// Notice
+// NVIDIA Corporation and its licensors retain all intellectual property and
+// proprietary rights in and to this software and related documentation and
+// any modifications thereto. Any use, reproduction, disclosure, or
+// distribution of this software and related documentation without an express
+// license agreement from NVIDIA Corporation is strictly prohibited.
+//
+// ALL NVIDIA DESIGN SPECIFICATIONS, CODE ARE PROVIDED "AS IS.". NVIDIA MAKES
+// NO WARRANTIES, EXPRESSED, IMPLIED, STATUTORY, OR OTHERWISE WITH RESPECT TO
+// THE MATERIALS, AND EXPRESSLY DISCLAIMS ALL IMPLIED WARRANTIES OF NONINFRINGEMENT,
+// MERCHANTABILITY, AND FITNESS FOR A PARTICULAR PURPOSE.
+//
+// Information and code furnished is believed to be accurate and reliable.
+// However, NVIDIA Corporation assumes no responsibility for the consequences of use of such
+// information or for any infringement of patents or other rights of third parties that may
+// result from its use. No license is granted by implication or otherwise under any patent
+// or patent rights of NVIDIA Corporation. Details are subject to change without notice.
+// This code supersedes and replaces all information previously supplied.
+// NVIDIA Corporation products are not authorized for use as critical
+// components in life support devices or systems without express written approval of
+// NVIDIA Corporation.
+//
+// Copyright (c) 2008-2021 NVIDIA Corporation. All rights reserved.
+
+#pragma once
+#include "Common.h"
+
+namespace GFSDK
+{
+namespace SSAO
+{
+
+//--------------------------------------------------------------------------------
+// Identifies the device and driver that compiled the pipelines of a pipeline cache
+struct PipelineCacheDeviceInfo
+{
+    enum APIType
+    {
+        API_D3D12 = 1,
+    };
+
+    UINT API;
+    UINT VendorId;
+    UINT DeviceId;
+    UINT SubSysId;
+    UINT Revision;
+    UINT DriverVersionHigh;
+    UINT DriverVersionLow;
+
+    PipelineCacheDeviceInfo()
+    {
+        ZERO_STRUCT(*this);
+    }
+};
+
+//--------------------------------------------------------------------------------
+// Pipeline-cache data as exchanged with the application: a header followed by the
+// backend-specific data (e.g. a serialized ID3D12PipelineLibrary).
+//
+// The header records the format and library versions and the device info, so that
+// data saved by another build, device or driver is rejected instead of being passed
+// to the driver, and a hash of the data, so that truncated or corrupted data is too.
+//--------------------------------------------------------------------------------
+class PipelineCacheBlob
+{
+public:
+    static const UINT MAGIC = 0x4F414248; // "HBAO"
+    static const UINT FORMAT_VERSION = 1;
+
+    struct Header
+    {
+        UINT Magic;
+        UINT FormatVersion;
+        UINT HeaderSize;
+        GFSDK_SSAO_Version LibraryVersion;
+        PipelineCacheDeviceInfo Device;
+        UINT DataSize;
+        UINT DataHash;
+    };
+
+    static GFSDK_SSAO_SIZE_T GetBlobSize(GFSDK_SSAO_SIZE_T DataSize)
+    {
+        return sizeof(Header) + DataSize;
+    }
+
+    static void* GetData(void* pBlob)
+    {
+        return static_cast<char*>(pBlob) + sizeof(Header);
+    }
+
+    // Writes the header of the DataSize bytes already stored at GetData(pBlob)
+    static void WriteHeader(void* pBlob, const PipelineCacheDeviceInfo& Device, UINT DataSize);
+
+    // Returns the data of pBlob if its header matches Device and this build of the library
+    static GFSDK_SSAO_Status Validate(
+        const void* pBlob,
+        GFSDK_SSAO_SIZE_T BlobSize,
+        const PipelineCacheDeviceInfo& Device,
+        const void** ppData,
+        UINT* pDataSize);
+};
+
+} // namespace SSAO
+} // namespace GFSDK
@@ -0,0 +1,206 @@
+// This code contains NVIDIA Confidential Information and is disclosed to you
+// under a form of NVIDIA software license agreement provided separately to you.
+//
+// Notice
+// NVIDIA Corporation and its licensors retain all intellectual property and
+// proprietary rights in and to this software and related documentation and
+// any modifications thereto. Any use, reproduction, disclosure, or
+// distribution of this software and related documentation without an express
+// license agreement from NVIDIA Corporation is strictly prohibited.
+//
+// ALL NVIDIA DESIGN SPECIFICATIONS, CODE ARE PROVIDED "AS IS.". NVIDIA MAKES
+// NO WARRANTIES, EXPRESSED, IMPLIED, STATUTORY, OR OTHERWISE WITH RESPECT TO
+// THE MATERIALS, AND EXPRESSLY DISCLAIMS ALL IMPLIED WARRANTIES OF NONINFRINGEMENT,
+// MERCHANTABILITY, AND FITNESS FOR A PARTICULAR PURPOSE.
+//
+// Information and code furnished is believed to be accurate and reliable.
+// However, NVIDIA Corporation assumes no responsibility for the consequences of use of such
+// information or for any infringement of patents or other rights of third parties that may
+// result from its use. No license is granted by implication or otherwise under any patent
+// or patent rights of NVIDIA Corporation. Details are subject to change without notice.
+// This code supersedes and replaces all information previously supplied.
+// NVIDIA Corporation products are not authorized for use as critical
+// components in life support devices or systems without express written approval of
+// NVIDIA Corporation.
+//
+// Copyright (c) 2008-2021 NVIDIA Corporation. All rights reserved.
+
+#if SUPPORT_D3D12
+
+#include "PipelineLibrary_DX12.h"
+
+#include <dxgi1_4.h>
+#include <wchar.h>
+
+//--------------------------------------------------------------------------------
+void GFSDK::SSAO::D3D12::PipelineLibrary::Create(ID3D12Device* pDevice, const GFSDK_SSAO_CustomHeap& NewDelete)
+{
+    ASSERT(!m_pLibrary);
+
+    m_pDevice = pDevice;
+    m_NewDelete = NewDelete;
+
+    GetDeviceInfo(pDevice, m_DeviceInfo);
+
+    if (SUCCEEDED(pDevice->QueryInterface(IID_PPV_ARGS(&m_pDevice1))))
+    {
+        // Start from an empty library, in case LoadPipelineCache is never called
+        if (FAILED(m_pDevice1->CreatePipelineLibrary(NULL, 0, IID_PPV_ARGS(&m_pLibrary))))
+        {
+            m_pLibrary = NULL;
+        }
+    }
+}
+
+//--------------------------------------------------------------------------------
+void GFSDK::SSAO::D3D12::PipelineLibrary::ReleaseLibrary()
+{
+    SAFE_RELEASE(m_pLibrary);
+
+    if (m_pLibraryData)
+    {
+        m_NewDelete.delete_(m_pLibraryData);
+        m_pLibraryData = NULL;
+    }
+}
+
+//--------------------------------------------------------------------------------
+void GFSDK::SSAO::D3D12::PipelineLibrary::Release()
+{
+    ReleaseLibrary();
+    SAFE_RELEASE(m_pDevice1);
+    m_pDevice = NULL;
+}
+
+//--------------------------------------------------------------------------------
+void GFSDK::SSAO::D3D12::PipelineLibrary::GetDeviceInfo(ID3D12Device* pDevice, PipelineCacheDeviceInfo& DeviceInfo)
+{
+    DeviceInfo = PipelineCacheDeviceInfo();
+    DeviceInfo.API = PipelineCacheDeviceInfo::API_D3D12;
+
+    IDXGIFactory4* pFactory = NULL;
+    if (FAILED(CreateDXGIFactory1(IID_PPV_ARGS(&pFactory))))
+    {
+        return;
+    }
+
+    IDXGIAdapter1* pAdapter = NULL;
+    if (SUCCEEDED(pFactory->EnumAdapterByLuid(pDevice->GetAdapterLuid(), IID_PPV_ARGS(&pAdapter))))
+    {
+        DXGI_ADAPTER_DESC1 Desc;
+        if (SUCCEEDED(pAdapter->GetDesc1(&Desc)))
+        {
+            DeviceInfo.VendorId = Desc.VendorId;
+            DeviceInfo.DeviceId = Desc.DeviceId;
+            DeviceInfo.SubSysId = Desc.SubSysId;
+            DeviceInfo.Revision = Desc.Revision;
+        }
+
+        LARGE_INTEGER DriverVersion;
+        if (SUCCEEDED(pAdapter->CheckInterfaceSupport(__uuidof(IDXGIDevice), &DriverVersion)))
+        {
+            DeviceInfo.DriverVersionHigh = DriverVersion.HighPart;
+            DeviceInfo.DriverVersionLow = DriverVersion.LowPart;
+        }
+
+        pAdapter->Release();
+    }
+
+    pFactory->Release();
+}
+
+//--------------------------------------------------------------------------------
+GFSDK_SSAO_Status GFSDK::SSAO::D3D12::PipelineLibrary::Load(const void* pBlob, GFSDK_SSAO_SIZE_T BlobSize)
+{
+    if (!m_pLibrary)
+    {
+        return GFSDK_SSAO_PIPELINE_CACHE_NOT_SUPPORTED;
+    }
+
+    const void* pData = NULL;
+    UINT DataSize = 0;
+    GFSDK_SSAO_Status Status = PipelineCacheBlob::Validate(pBlob, BlobSize, m_DeviceInfo, &pData, &DataSize);
+    if (Status != GFSDK_SSAO_OK)
+    {
+        return Status;
+    }
+
+    void* pLibraryData = m_NewDelete.new_(DataSize);
+    if (!pLibraryData)
+    {
+        return GFSDK_SSAO_MEMORY_ALLOCATION_FAILED;
+    }
+    memcpy(pLibraryData, pData, DataSize);
+
+    ID3D12PipelineLibrary* pLibrary = NULL;
+    HRESULT hr = m_pDevice1->CreatePipelineLibrary(pLibraryData, DataSize, IID_PPV_ARGS(&pLibrary));
+
+    if (FAILED(hr))
+    {
+        m_NewDelete.delete_(pLibraryData);
+
+        // The runtime does its own checks too, e.g. for driver updates not reflected in the DXGI driver version
+        return (hr == D3D12_ERROR_ADAPTER_NOT_FOUND || hr == D3D12_ERROR_DRIVER_VERSION_MISMATCH) ?
+            GFSDK_SSAO_PIPELINE_CACHE_MISMATCH : GFSDK_SSAO_PIPELINE_CACHE_CORRUPTED;
+    }
+
+    // The PSOs already loaded from the previous library remain valid after releasing it
+    ReleaseLibrary();
+    m_pLibrary = pLibrary;
+    m_pLibraryData = pLibraryData;
+
+    return GFSDK_SSAO_OK;
+}
+
+//--------------------------------------------------------------------------------
+GFSDK_SSAO_Status GFSDK::SSAO::D3D12::PipelineLibrary::GetData(void* pBlob, GFSDK_SSAO_SIZE_T* pBlobSize)
+{
+    if (!m_pLibrary)
+    {
+        return GFSDK_SSAO_PIPELINE_CACHE_NOT_SUPPORTED;
+    }
+
+    const UINT DataSize = UINT(m_pLibrary->GetSerializedSize());
+    const GFSDK_SSAO_SIZE_T BlobSize = PipelineCacheBlob::GetBlobSize(DataSize);
+
+    if (!pBlob)
+    {
+        *pBlobSize = BlobSize;
+        return GFSDK_SSAO_OK;
+    }
+
+    if (*pBlobSize < BlobSize)
+    {
+        return GFSDK_SSAO_PIPELINE_CACHE_BUFFER_TOO_SMALL;
+    }
+
+    THROW_IF_FAILED(m_pLibrary->Serialize(PipelineCacheBlob::GetData(pBlob), DataSize));
+    PipelineCacheBlob::WriteHeader(pBlob, m_DeviceInfo, DataSize);
+
+    *pBlobSize = BlobSize;
+    return GFSDK_SSAO_OK;
+}
+
+//--------------------------------------------------------------------------------
+ID3D12PipelineState* GFSDK::SSAO::D3D12::PipelineLibrary::CreateGraphicsPipelineState(const WCHAR* pName, const D3D12_GRAPHICS_PIPELINE_STATE_DESC& Desc)
+{
+    ID3D12PipelineState* pPSO = NULL;
+
+    // Fails with E_INVALIDARG if the library has no PSO with this name, or one with another desc
+    if (m_pLibrary && SUCCEEDED(m_pLibrary->LoadGraphicsPipeline(pName, &Desc, IID_PPV_ARGS(&pPSO))))
+    {
+        return pPSO;
+    }
+
+    THROW_IF_FAILED(m_pDevice->CreateGraphicsPipelineState(&Desc, IID_PPV_ARGS(&pPSO)));
+
+    if (m_pLibrary)
+    {
+        // May fail if the name is already used by a PSO with another desc, which is only a missed cache entry
+        m_pLibrary->StorePipeline(pName, pPSO);
+    }
+
+    return pPSO;
+}
+
+#endif // SUPPORT_D3D12
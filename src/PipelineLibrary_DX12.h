@@ -0,0 +1,87 @@
+// This code contains NVIDIA Confidential Information and is disclosed to you
+// under a form of NVIDIA software license agreement provided separately to you.
+//
+// Notice
+// NVIDIA Corporation and its licensors retain all intellectual property and
+// proprietary rights in and to this software and related documentation and
+// any modifications thereto. Any use, reproduction, disclosure, or
+// distribution of this software and related documentation without an express
+// license agreement from NVIDIA Corporation is strictly prohibited.
+//
+// ALL NVIDIA DESIGN SPECIFICATIONS, CODE ARE PROVIDED "AS IS.". NVIDIA MAKES
+// NO WARRANTIES, EXPRESSED, IMPLIED, STATUTORY, OR OTHERWISE WITH RESPECT TO
+// THE MATERIALS, AND EXPRESSLY DISCLAIMS ALL IMPLIED WARRANTIES OF NONINFRINGEMENT,
+// MERCHANTABILITY, AND FITNESS FOR A PARTICULAR PURPOSE.
+//
+// Information and code furnished is believed to be accurate and reliable.
+// However, NVIDIA Corporation assumes no responsibility for the consequences of use of such
+// information or for any infringement of patents or other rights of third parties that may
+// result from its use. No license is granted by implication or otherwise under any patent
+// or patent rights of NVIDIA Corporation. Details are subject to change without notice.
+// This code supersedes and replaces all information previously supplied.
+// NVIDIA Corporation products are not authorized for use as critical
+// components in life support devices or systems without express written approval of
+// NVIDIA Corporation.
+//
+// Copyright (c) 2008-2021 NVIDIA Corporation. All rights reserved.
+
+#if SUPPORT_D3D12
+
+#pragma once
+#include "Common.h"
+#include "PipelineCacheBlob.h"
+
+namespace GFSDK
+{
+namespace SSAO
+{
+namespace D3D12
+{
+
+//--------------------------------------------------------------------------------
+// Persistent store of the PSOs created by the library, backed by an ID3D12PipelineLibrary.
+//
+// If the device does not support pipeline libraries (ID3D12Device1), the PSOs are
+// always compiled and the pipeline-cache entry points return NOT_SUPPORTED.
+//--------------------------------------------------------------------------------
+class PipelineLibrary
+{
+public:
+    PipelineLibrary()
+        : m_pDevice(NULL)
+        , m_pDevice1(NULL)
+        , m_pLibrary(NULL)
+        , m_pLibraryData(NULL)
+    {
+        m_NewDelete.new_ = NULL;
+        m_NewDelete.delete_ = NULL;
+    }
+
+    void Create(ID3D12Device* pDevice, const GFSDK_SSAO_CustomHeap& NewDelete);
+    void Release();
+
+    GFSDK_SSAO_Status Load(const void* pBlob, GFSDK_SSAO_SIZE_T BlobSize);
+    GFSDK_SSAO_Status GetData(void* pBlob, GFSDK_SSAO_SIZE_T* pBlobSize);
+
+    // Loads the PSO from the library if it has one with this name and desc,
+    // or compiles it and stores it in the library.
+    // May be called from several threads at once, for different names.
+    ID3D12PipelineState* CreateGraphicsPipelineState(const WCHAR* pName, const D3D12_GRAPHICS_PIPELINE_STATE_DESC& Desc);
+
+private:
+    static void GetDeviceInfo(ID3D12Device* pDevice, PipelineCacheDeviceInfo& DeviceInfo);
+    void ReleaseLibrary();
+
+    ID3D12Device* m_pDevice;
+    ID3D12Device1* m_pDevice1;
+    ID3D12PipelineLibrary* m_pLibrary;
+    void* m_pLibraryData;   // Serialized library that m_pLibrary was created from, which must outlive it
+    PipelineCacheDeviceInfo m_DeviceInfo;
+    GFSDK_SSAO_CustomHeap m_NewDelete;
+};
+
+} // namespace D3D12
+} // namespace SSAO
+} // namespace GFSDK
+
+#endif // SUPPORT_D3D12
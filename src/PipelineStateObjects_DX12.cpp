@@ -31,20 +31,112 @@
 
 //--------------------------------------------------------------------------------
 #if ENABLE_DEBUG_NAMES
-#define SET_PSO_DEBUG_NAME(Name) \
-    m_##Name.pPSO->SetName(L#Name);
 #define SET_RS_DEBUG_NAME(Name) \
     m_##Name->SetName(L#Name);
 #else
-#define SET_PSO_DEBUG_NAME(Name) 
 #define SET_RS_DEBUG_NAME(Name)
 #endif
 
 //--------------------------------------------------------------------------------
-void GFSDK::SSAO::D3D12::LinearDepthPSO::Create(GFSDK_D3D12_GraphicsContext* pGraphicsContext)
+GFSDK::SSAO::D3D12::PSOCreationList::~PSOCreationList()
+{
+    // Only left if inserting them in their caches has thrown
+    for (UINT Index = 0; Index < m_NumPSOs; ++Index)
+    {
+        SAFE_RELEASE(m_PSOs[Index].pPSO);
+    }
+}
+
+//--------------------------------------------------------------------------------
+bool GFSDK::SSAO::D3D12::PSOCreationList::Add(const WCHAR* pName, const GraphicsPSO& PSO, PSOCache& Cache, const PSOKey& Key)
+{
+    for (UINT Index = 0; Index < m_NumPSOs; ++Index)
+    {
+        if (m_PSOs[Index].pCache == &Cache && memcmp(&m_PSOs[Index].Key, &Key, sizeof(Key)) == 0)
+        {
+            return true;
+        }
+    }
+
+    if (m_NumPSOs == MAX_NUM_PSOS)
+    {
+        return false;
+    }
+
+    // The desc is copied, as the pass reuses its GraphicsPSO for its next permutation
+    Entry& E = m_PSOs[m_NumPSOs++];
+    E.pName = pName;
+    GetPipelineLibraryName(pName, Key, E.LibraryName);
+    E.Desc = PSO.Desc;
+    E.pCache = &Cache;
+    E.Key = Key;
+    E.pPSO = nullptr;
+    return true;
+}
+
+//--------------------------------------------------------------------------------
+void GFSDK::SSAO::D3D12::PSOCreationList::CreateTask(void* pUserData, UINT TaskIndex)
+{
+    PSOCreationList* pList = static_cast<PSOCreationList*>(pUserData);
+    Entry& E = pList->m_PSOs[TaskIndex];
+
+    // Each task loads or stores its own name, which the pipeline library allows concurrently
+    E.pPSO = pList->m_pGraphicsContext->pPipelineLibrary->CreateGraphicsPipelineState(E.LibraryName, E.Desc);
+}
+
+//--------------------------------------------------------------------------------
+void GFSDK::SSAO::D3D12::PSOCreationList::InsertCreatedPSOs()
+{
+    for (UINT Index = 0; Index < m_NumPSOs; ++Index)
+    {
+        Entry& E = m_PSOs[Index];
+        ID3D12PipelineState* pPSO = E.pPSO;
+        if (pPSO)
+        {
+            // Insert releases the PSO if it throws
+            E.pPSO = nullptr;
+#if ENABLE_DEBUG_NAMES
+            pPSO->SetName(E.pName);
+#endif
+            E.pCache->Insert(E.Key, pPSO);
+        }
+    }
+
+    m_NumPSOs = 0;
+}
+
+//--------------------------------------------------------------------------------
+void GFSDK::SSAO::D3D12::PSOCreationList::Run(GFSDK_D3D12_GraphicsContext* pGraphicsContext, TaskBatch& Batch)
+{
+    m_pGraphicsContext = pGraphicsContext;
+
+#if ENABLE_EXCEPTIONS
+    try
+    {
+        Batch.Run(CreateTask, this, m_NumPSOs);
+    }
+    catch (...)
+    {
+        // Keeps the PSOs of the tasks that have succeeded
+        InsertCreatedPSOs();
+        throw;
+    }
+#else
+    Batch.Run(CreateTask, this, m_NumPSOs);
+#endif
+
+    InsertCreatedPSOs();
+}
+
+//--------------------------------------------------------------------------------
+void GFSDK::SSAO::D3D12::LinearDepthPSO::Create(
+    GFSDK_D3D12_GraphicsContext* pGraphicsContext,
+    const GFSDK_SSAO_CustomHeap& NewDelete)
 {
     ASSERT(!m_LinearDepthRS);
 
+    m_LinearDepthPSOCache.Create(NewDelete);
+
     CD3DX12_DESCRIPTOR_RANGE DescRanges[RootParameters::Count];
     DescRanges[RootParameters::Buffer0] = CD3DX12_DESCRIPTOR_RANGE(D3D12_DESCRIPTOR_RANGE_TYPE_CBV, 1, 0);
     DescRanges[RootParameters::Texture0] = CD3DX12_DESCRIPTOR_RANGE(D3D12_DESCRIPTOR_RANGE_TYPE_SRV, 1, 0);
@@ -73,18 +165,19 @@ ID3D12PipelineState* GFSDK::SSAO::D3D12::LinearDepthPSO::GetPSO(
     Shaders &Shaders,
     Generated::ShaderPermutations::RESOLVE_DEPTH ResolveDepthPermutation,
     Generated::ShaderPermutations::DEPTH_LAYER_COUNT DepthLayerCountPermutation,
-    GFSDK_SSAO_DepthTextureType InputDepthTextureType)
+    GFSDK_SSAO_DepthTextureType InputDepthTextureType,
+    PSOCreationList* pCreationList)
 {
-    if (!m_LinearDepthPSO.pPSO ||
-        m_ResolveDepthPermutation != ResolveDepthPermutation ||
-        m_DepthLayerCountPermutation != DepthLayerCountPermutation ||
-        m_InputDepthTextureType != InputDepthTextureType)
+    PSOKey Key;
+    Key.Permutations[0] = ResolveDepthPermutation;
+    Key.Permutations[1] = DepthLayerCountPermutation;
+    // Both types of hardware depths use the same PSO
+    Key.Permutations[2] = (InputDepthTextureType == GFSDK_SSAO_VIEW_DEPTHS);
+
+    ID3D12PipelineState* pPSO = m_LinearDepthPSOCache.Find(Key);
+    if (!pPSO)
     {
-        m_ResolveDepthPermutation = ResolveDepthPermutation;
-        m_DepthLayerCountPermutation = DepthLayerCountPermutation;
-        m_InputDepthTextureType = InputDepthTextureType;
-
-        GFSDK_D3D12_PixelShader* pPS = (m_InputDepthTextureType == GFSDK_SSAO_VIEW_DEPTHS) ?
+        GFSDK_D3D12_PixelShader* pPS = (InputDepthTextureType == GFSDK_SSAO_VIEW_DEPTHS) ?
             Shaders.CopyDepth_PS.Get(ResolveDepthPermutation, DepthLayerCountPermutation) :
             Shaders.LinearizeDepth_PS.Get(ResolveDepthPermutation, DepthLayerCountPermutation);
 
@@ -106,23 +199,26 @@ ID3D12PipelineState* GFSDK::SSAO::D3D12::LinearDepthPSO::GetPSO(
         m_LinearDepthPSO.Desc.pRootSignature = m_LinearDepthRS;
         m_LinearDepthPSO.Desc.SampleDesc.Count = 1;
         m_LinearDepthPSO.Desc.NodeMask = pGraphicsContext->NodeMask;
+
         m_LinearDepthPSO.SetVertexShader(pVS);
         m_LinearDepthPSO.SetPixelShader(pPS);
 
-        SafeCreateGraphicsPipelineState(pGraphicsContext, m_LinearDepthPSO);
-        SET_PSO_DEBUG_NAME(LinearDepthPSO);
+        pPSO = CreateGraphicsPipelineState(pGraphicsContext, L"LinearDepthPSO", m_LinearDepthPSO, m_LinearDepthPSOCache, Key, pCreationList);
     }
 
-    return m_LinearDepthPSO.pPSO;
+    return pPSO;
 }
 
 //--------------------------------------------------------------------------------
 void GFSDK::SSAO::D3D12::DebugNormalsPSO::Create(
     GFSDK_D3D12_GraphicsContext* pGraphicsContext,
+    const GFSDK_SSAO_CustomHeap& NewDelete,
     States &States)
 {
     ASSERT(!m_DebugNormalsRS);
 
+    m_DebugNormalsPSOCache.Create(NewDelete);
+
     CD3DX12_DESCRIPTOR_RANGE DescRanges[RootParameters::Count];
     DescRanges[RootParameters::Buffer0] = CD3DX12_DESCRIPTOR_RANGE(D3D12_DESCRIPTOR_RANGE_TYPE_CBV, 1, 0);
     DescRanges[RootParameters::Texture0] = CD3DX12_DESCRIPTOR_RANGE(D3D12_DESCRIPTOR_RANGE_TYPE_SRV, 1, 0);
@@ -157,15 +253,13 @@ ID3D12PipelineState* GFSDK::SSAO::D3D12::DebugNormalsPSO::GetPSO(
     OutputInfo& Output,
     Generated::ShaderPermutations::FETCH_GBUFFER_NORMAL FetchNormalPermutation)
 {
-    if (!m_DebugNormalsPSO.pPSO ||
-        m_RTSampleCount != Output.RenderTarget.SampleCount ||
-        m_RTFormat != Output.RenderTarget.Format ||
-        m_FetchNormalPermutation != FetchNormalPermutation)
-    {
-        m_RTSampleCount = Output.RenderTarget.SampleCount;
-        m_RTFormat = Output.RenderTarget.Format;
-        m_FetchNormalPermutation = FetchNormalPermutation;
+    PSOKey Key;
+    Key.Permutations[0] = FetchNormalPermutation;
+    Key.SetOutput(Output, *States.GetBlendStateDisabled());
 
+    ID3D12PipelineState* pPSO = m_DebugNormalsPSOCache.Find(Key);
+    if (!pPSO)
+    {
         GFSDK_D3D12_PixelShader* pPS = Shaders.DebugNormals_PS.Get(FetchNormalPermutation);
         GFSDK_D3D12_PixelShader* pVS = Shaders.FullScreenTriangle_VS.Get();
 
@@ -180,20 +274,22 @@ ID3D12PipelineState* GFSDK::SSAO::D3D12::DebugNormalsPSO::GetPSO(
         m_DebugNormalsPSO.SetVertexShader(pVS);
         m_DebugNormalsPSO.SetPixelShader(pPS);
 
-        SafeCreateGraphicsPipelineState(pGraphicsContext, m_DebugNormalsPSO);
-        SET_PSO_DEBUG_NAME(DebugNormalsPSO);
+        pPSO = CreateGraphicsPipelineState(pGraphicsContext, L"DebugNormalsPSO", m_DebugNormalsPSO, m_DebugNormalsPSOCache, Key);
     }
 
-    return m_DebugNormalsPSO.pPSO;
+    return pPSO;
 }
 
 //--------------------------------------------------------------------------------
 void GFSDK::SSAO::D3D12::DeinterleavedDepthPSO::Create(
     GFSDK_D3D12_GraphicsContext* pGraphicsContext,
+    const GFSDK_SSAO_CustomHeap& NewDelete,
     GFSDK::SSAO::D3D12::States &States)
 {
     ASSERT(!m_DeinterleavedDepthRS);
 
+    m_DeinterleavedDepthPSOCache.Create(NewDelete);
+
     CD3DX12_DESCRIPTOR_RANGE DescRanges[RootParameters::Count];
     DescRanges[RootParameters::Buffer0] = CD3DX12_DESCRIPTOR_RANGE(D3D12_DESCRIPTOR_RANGE_TYPE_CBV, 1, 0);
     DescRanges[RootParameters::Buffer1] = CD3DX12_DESCRIPTOR_RANGE(D3D12_DESCRIPTOR_RANGE_TYPE_CBV, 1, 1);
@@ -228,41 +324,47 @@ ID3D12PipelineState* GFSDK::SSAO::D3D12::DeinterleavedDepthPSO::GetPSO(
     GFSDK::SSAO::D3D12::States &States,
     GFSDK::SSAO::D3D12::RenderTargets& RTs,
     GFSDK_SSAO_DepthStorage DepthStorage,
-    Generated::ShaderPermutations::DEPTH_LAYER_COUNT DepthLayerCountPermutation)
+    Generated::ShaderPermutations::DEPTH_LAYER_COUNT DepthLayerCountPermutation,
+    PSOCreationList* pCreationList)
 {
-    if (!m_DeinterleavedDepthPSO.pPSO ||
-        m_DepthStorage != DepthStorage ||
-        m_DepthLayerCountPermutation != DepthLayerCountPermutation)
-    {
-        m_DepthStorage = DepthStorage;
-        m_DepthLayerCountPermutation = DepthLayerCountPermutation;
+    PSOKey Key;
+    Key.Permutations[0] = DepthStorage;
+    Key.Permutations[1] = DepthLayerCountPermutation;
 
+    ID3D12PipelineState* pPSO = m_DeinterleavedDepthPSOCache.Find(Key);
+    if (!pPSO)
+    {
         m_DeinterleavedDepthPSO.Desc.pRootSignature = m_DeinterleavedDepthRS;
         m_DeinterleavedDepthPSO.Desc.NumRenderTargets = MRT_COUNT;
+
         DXGI_FORMAT Format = (DepthLayerCountPermutation == Generated::ShaderPermutations::DEPTH_LAYER_COUNT_2) ? DXGI_FORMAT_R16G16_FLOAT : RTs.GetViewDepthTextureFormat(DepthStorage);
         for (UINT Idx = 0; Idx < MRT_COUNT; ++Idx)
         {
             m_DeinterleavedDepthPSO.Desc.RTVFormats[Idx] = Format;
         }
+
         m_DeinterleavedDepthPSO.Desc.SampleDesc.Count = 1;
         m_DeinterleavedDepthPSO.Desc.NodeMask = pGraphicsContext->NodeMask;
+
         m_DeinterleavedDepthPSO.SetVertexShader(Shaders.FullScreenTriangle_VS.Get());
         m_DeinterleavedDepthPSO.SetPixelShader(Shaders.DeinterleaveDepth_PS.Get(DepthLayerCountPermutation));
 
-        SafeCreateGraphicsPipelineState(pGraphicsContext, m_DeinterleavedDepthPSO);
-        SET_PSO_DEBUG_NAME(DeinterleavedDepthPSO);
+        pPSO = CreateGraphicsPipelineState(pGraphicsContext, L"DeinterleavedDepthPSO", m_DeinterleavedDepthPSO, m_DeinterleavedDepthPSOCache, Key, pCreationList);
     }
 
-    return m_DeinterleavedDepthPSO.pPSO;
+    return pPSO;
 }
 
 //--------------------------------------------------------------------------------
 void GFSDK::SSAO::D3D12::ReconstructNormalPSO::Create(
     GFSDK_D3D12_GraphicsContext* pGraphicsContext,
+    const GFSDK_SSAO_CustomHeap& NewDelete,
     GFSDK::SSAO::D3D12::States &States)
 {
     ASSERT(!m_ReconstructNormalRS);
 
+    m_ReconstructNormalPSOCache.Create(NewDelete);
+
     CD3DX12_DESCRIPTOR_RANGE DescRanges[RootParameters::Count];
     DescRanges[RootParameters::Buffer0] = CD3DX12_DESCRIPTOR_RANGE(D3D12_DESCRIPTOR_RANGE_TYPE_CBV, 1, 0);
     DescRanges[RootParameters::Texture0] = CD3DX12_DESCRIPTOR_RANGE(D3D12_DESCRIPTOR_RANGE_TYPE_SRV, 1, 0);
@@ -296,9 +398,13 @@ void GFSDK::SSAO::D3D12::ReconstructNormalPSO::Create(
 //--------------------------------------------------------------------------------
 ID3D12PipelineState* GFSDK::SSAO::D3D12::ReconstructNormalPSO::GetPSO(
     GFSDK_D3D12_GraphicsContext* pGraphicsContext,
-    Shaders &Shaders)
+    Shaders &Shaders,
+    PSOCreationList* pCreationList)
 {
-    if (!m_ReconstructNormalPSO.pPSO)
+    PSOKey Key;
+
+    ID3D12PipelineState* pPSO = m_ReconstructNormalPSOCache.Find(Key);
+    if (!pPSO)
     {
         m_ReconstructNormalPSO.Desc.pRootSignature = m_ReconstructNormalRS;
         m_ReconstructNormalPSO.Desc.NumRenderTargets = 1;
@@ -309,20 +415,22 @@ ID3D12PipelineState* GFSDK::SSAO::D3D12::ReconstructNormalPSO::GetPSO(
         m_ReconstructNormalPSO.SetVertexShader(Shaders.FullScreenTriangle_VS.Get());
         m_ReconstructNormalPSO.SetPixelShader(Shaders.ReconstructNormal_PS.Get());
 
-        SafeCreateGraphicsPipelineState(pGraphicsContext, m_ReconstructNormalPSO);
-        SET_PSO_DEBUG_NAME(ReconstructNormalPSO);
+        pPSO = CreateGraphicsPipelineState(pGraphicsContext, L"ReconstructNormalPSO", m_ReconstructNormalPSO, m_ReconstructNormalPSOCache, Key, pCreationList);
     }
 
-    return m_ReconstructNormalPSO.pPSO;
+    return pPSO;
 }
 
 //--------------------------------------------------------------------------------
 void GFSDK::SSAO::D3D12::CoarseAOPSO::Create(
     GFSDK_D3D12_GraphicsContext* pGraphicsContext,
+    const GFSDK_SSAO_CustomHeap& NewDelete,
     GFSDK::SSAO::D3D12::States &States)
 {
     ASSERT(!m_CoarseAORS);
 
+    m_CoarseAOPSOCache.Create(NewDelete);
+
     CD3DX12_DESCRIPTOR_RANGE DescRanges[RootParameters::Count];
     DescRanges[RootParameters::Buffer0] = CD3DX12_DESCRIPTOR_RANGE(D3D12_DESCRIPTOR_RANGE_TYPE_CBV, 1, 0);
     DescRanges[RootParameters::Buffer1] = CD3DX12_DESCRIPTOR_RANGE(D3D12_DESCRIPTOR_RANGE_TYPE_CBV, 1, 1);
@@ -357,40 +465,43 @@ ID3D12PipelineState* GFSDK::SSAO::D3D12::CoarseAOPSO::GetPSO(
     Shaders &Shaders,
     Generated::ShaderPermutations::FETCH_GBUFFER_NORMAL FetchNormalPermutation,
     Generated::ShaderPermutations::DEPTH_LAYER_COUNT DepthLayerCountPermutation,
-    Generated::ShaderPermutations::NUM_STEPS NumStepsPermutation)
+    Generated::ShaderPermutations::NUM_STEPS NumStepsPermutation,
+    PSOCreationList* pCreationList)
 {
-    if (!m_CoarseAOPSO.pPSO ||
-        m_FetchNormalPermutation != FetchNormalPermutation ||
-        m_DepthLayerCountPermutation != DepthLayerCountPermutation ||
-        m_NumStepsPermutation != NumStepsPermutation)
-    {
-        m_FetchNormalPermutation = FetchNormalPermutation;
-        m_DepthLayerCountPermutation = DepthLayerCountPermutation;
-        m_NumStepsPermutation = NumStepsPermutation;
+    PSOKey Key;
+    Key.Permutations[0] = FetchNormalPermutation;
+    Key.Permutations[1] = DepthLayerCountPermutation;
+    Key.Permutations[2] = NumStepsPermutation;
 
+    ID3D12PipelineState* pPSO = m_CoarseAOPSOCache.Find(Key);
+    if (!pPSO)
+    {
         m_CoarseAOPSO.Desc.pRootSignature = m_CoarseAORS;
         m_CoarseAOPSO.Desc.NumRenderTargets = 1;
         m_CoarseAOPSO.Desc.RTVFormats[0] = DXGI_FORMAT_R8_UNORM;
         m_CoarseAOPSO.Desc.SampleDesc.Count = 1;
         m_CoarseAOPSO.Desc.NodeMask = pGraphicsContext->NodeMask;
+
         m_CoarseAOPSO.SetVertexShader(Shaders.FullScreenTriangle_VS.Get());
         m_CoarseAOPSO.SetPixelShader(Shaders.CoarseAO_PS.Get(FetchNormalPermutation, DepthLayerCountPermutation, NumStepsPermutation));
         m_CoarseAOPSO.SetGeometryShader(Shaders.CoarseAO_GS.Get());
 
-        SafeCreateGraphicsPipelineState(pGraphicsContext, m_CoarseAOPSO);
-        SET_PSO_DEBUG_NAME(CoarseAOPSO);
+        pPSO = CreateGraphicsPipelineState(pGraphicsContext, L"CoarseAOPSO", m_CoarseAOPSO, m_CoarseAOPSOCache, Key, pCreationList);
     }
 
-    return m_CoarseAOPSO.pPSO;
+    return pPSO;
 }
 
 //--------------------------------------------------------------------------------
 void GFSDK::SSAO::D3D12::ReinterleavedAOBlurPSO::Create(
     GFSDK_D3D12_GraphicsContext* pGraphicsContext,
+    const GFSDK_SSAO_CustomHeap& NewDelete,
     GFSDK::SSAO::D3D12::States &States)
 {
     ASSERT(!m_ReinterleavedAOBlurRS);
 
+    m_ReinterleavedAOBlurPSOCache.Create(NewDelete);
+
     CD3DX12_DESCRIPTOR_RANGE DescRanges[RootParameters::Count];
     DescRanges[RootParameters::Buffer0] = CD3DX12_DESCRIPTOR_RANGE(D3D12_DESCRIPTOR_RANGE_TYPE_CBV, 1, 0);
     DescRanges[RootParameters::Texture0] = CD3DX12_DESCRIPTOR_RANGE(D3D12_DESCRIPTOR_RANGE_TYPE_SRV, 1, 0);
@@ -422,13 +533,15 @@ void GFSDK::SSAO::D3D12::ReinterleavedAOBlurPSO::Create(
 ID3D12PipelineState* GFSDK::SSAO::D3D12::ReinterleavedAOBlurPSO::GetPSO(
     GFSDK_D3D12_GraphicsContext* pGraphicsContext,
     Shaders &Shaders,
-    Generated::ShaderPermutations::DEPTH_LAYER_COUNT DepthLayerCountPermutation)
+    Generated::ShaderPermutations::DEPTH_LAYER_COUNT DepthLayerCountPermutation,
+    PSOCreationList* pCreationList)
 {
-    if (!m_ReinterleavedAOBlurPSO.pPSO || 
-        m_DepthLayerCountPermutation != DepthLayerCountPermutation)
-    {
-        m_DepthLayerCountPermutation = DepthLayerCountPermutation;
+    PSOKey Key;
+    Key.Permutations[0] = DepthLayerCountPermutation;
 
+    ID3D12PipelineState* pPSO = m_ReinterleavedAOBlurPSOCache.Find(Key);
+    if (!pPSO)
+    {
         m_ReinterleavedAOBlurPSO.Desc.pRootSignature = m_ReinterleavedAOBlurRS;
         m_ReinterleavedAOBlurPSO.Desc.NumRenderTargets = 1;
         m_ReinterleavedAOBlurPSO.Desc.SampleDesc.Count = 1;
@@ -438,20 +551,22 @@ ID3D12PipelineState* GFSDK::SSAO::D3D12::ReinterleavedAOBlurPSO::GetPSO(
         m_ReinterleavedAOBlurPSO.SetVertexShader(Shaders.FullScreenTriangle_VS.Get());
         m_ReinterleavedAOBlurPSO.SetPixelShader(Shaders.ReinterleaveAO_PS.Get(Generated::ShaderPermutations::ENABLE_BLUR_1, DepthLayerCountPermutation));
 
-        SafeCreateGraphicsPipelineState(pGraphicsContext, m_ReinterleavedAOBlurPSO);
-        SET_PSO_DEBUG_NAME(ReinterleavedAOBlurPSO);
+        pPSO = CreateGraphicsPipelineState(pGraphicsContext, L"ReinterleavedAOBlurPSO", m_ReinterleavedAOBlurPSO, m_ReinterleavedAOBlurPSOCache, Key, pCreationList);
     }
 
-    return m_ReinterleavedAOBlurPSO.pPSO;
+    return pPSO;
 }
 
 //--------------------------------------------------------------------------------
 void GFSDK::SSAO::D3D12::ReinterleavedAOPSO::Create(
     GFSDK_D3D12_GraphicsContext* pGraphicsContext,
+    const GFSDK_SSAO_CustomHeap& NewDelete,
     GFSDK::SSAO::D3D12::States &States)
 {
     ASSERT(!m_ReinterleavedAORS);
 
+    m_ReinterleavedAOPSOCache.Create(NewDelete);
+
     CD3DX12_DESCRIPTOR_RANGE DescRanges[RootParameters::Count];
     DescRanges[RootParameters::Buffer0] = CD3DX12_DESCRIPTOR_RANGE(D3D12_DESCRIPTOR_RANGE_TYPE_CBV, 1, 0);
     DescRanges[RootParameters::Texture0] = CD3DX12_DESCRIPTOR_RANGE(D3D12_DESCRIPTOR_RANGE_TYPE_SRV, 1, 0);
@@ -483,23 +598,22 @@ ID3D12PipelineState* GFSDK::SSAO::D3D12::ReinterleavedAOPSO::GetPSO(
     Shaders &Shaders,
     States& States,
     OutputInfo& Output,
-    Generated::ShaderPermutations::DEPTH_LAYER_COUNT DepthLayerCountPermutation)
+    Generated::ShaderPermutations::DEPTH_LAYER_COUNT DepthLayerCountPermutation,
+    PSOCreationList* pCreationList)
 {
-    if (!m_ReinterleavedAOPSO.pPSO ||
-        m_RTSampleCount != Output.RenderTarget.SampleCount ||
-        m_RTFormat != Output.RenderTarget.Format ||
-        m_BlendMode != Output.Blend.Mode ||
-        m_DepthLayerCountPermutation != DepthLayerCountPermutation)
-    {
-        m_RTSampleCount = Output.RenderTarget.SampleCount;
-        m_RTFormat = Output.RenderTarget.Format;
-        m_BlendMode = Output.Blend.Mode;
-        m_DepthLayerCountPermutation = DepthLayerCountPermutation;
+    D3D12_BLEND_DESC* pBlendState = GetOutputBlendState(Output, States);
+
+    PSOKey Key;
+    Key.Permutations[0] = DepthLayerCountPermutation;
+    Key.SetOutput(Output, *pBlendState);
 
+    ID3D12PipelineState* pPSO = m_ReinterleavedAOPSOCache.Find(Key);
+    if (!pPSO)
+    {
         m_ReinterleavedAOPSO.Desc.pRootSignature = m_ReinterleavedAORS;
         m_ReinterleavedAOPSO.Desc.NumRenderTargets = 1;
         m_ReinterleavedAOPSO.Desc.SampleDesc.Count = Output.RenderTarget.SampleCount;
-        m_ReinterleavedAOPSO.Desc.BlendState = *GetOutputBlendState(Output, States);
+        m_ReinterleavedAOPSO.Desc.BlendState = *pBlendState;
         m_ReinterleavedAOPSO.Desc.SampleMask = GetOutputMSAASampleMask();
         m_ReinterleavedAOPSO.Desc.RTVFormats[0] = Output.RenderTarget.Format;
         m_ReinterleavedAOPSO.Desc.NodeMask = pGraphicsContext->NodeMask;
@@ -507,20 +621,22 @@ ID3D12PipelineState* GFSDK::SSAO::D3D12::ReinterleavedAOPSO::GetPSO(
         m_ReinterleavedAOPSO.SetVertexShader(Shaders.FullScreenTriangle_VS.Get());
         m_ReinterleavedAOPSO.SetPixelShader(Shaders.ReinterleaveAO_PS.Get(Generated::ShaderPermutations::ENABLE_BLUR_0, DepthLayerCountPermutation));
 
-        SafeCreateGraphicsPipelineState(pGraphicsContext, m_ReinterleavedAOPSO);
-        SET_PSO_DEBUG_NAME(ReinterleavedAOPSO);
+        pPSO = CreateGraphicsPipelineState(pGraphicsContext, L"ReinterleavedAOPSO", m_ReinterleavedAOPSO, m_ReinterleavedAOPSOCache, Key, pCreationList);
     }
 
-    return m_ReinterleavedAOPSO.pPSO;
+    return pPSO;
 }
 
 //--------------------------------------------------------------------------------
 void GFSDK::SSAO::D3D12::BlurXPSO::Create(
     GFSDK_D3D12_GraphicsContext* pGraphicsContext,
+    const GFSDK_SSAO_CustomHeap& NewDelete,
     GFSDK::SSAO::D3D12::States &States)
 {
     ASSERT(!m_BlurXRS);
 
+    m_BlurXPSOCache.Create(NewDelete);
+
     CD3DX12_DESCRIPTOR_RANGE DescRanges[RootParameters::Count];
     DescRanges[RootParameters::Buffer0] = CD3DX12_DESCRIPTOR_RANGE(D3D12_DESCRIPTOR_RANGE_TYPE_CBV, 1, 0);
     DescRanges[RootParameters::Texture0] = CD3DX12_DESCRIPTOR_RANGE(D3D12_DESCRIPTOR_RANGE_TYPE_SRV, 1, 0);
@@ -554,15 +670,16 @@ ID3D12PipelineState* GFSDK::SSAO::D3D12::BlurXPSO::GetPSO(
     GFSDK_D3D12_GraphicsContext* pGraphicsContext,
     Shaders &Shaders,
     Generated::ShaderPermutations::ENABLE_SHARPNESS_PROFILE EnableSharpnessProfilePermutation,
-    Generated::ShaderPermutations::KERNEL_RADIUS BlurKernelRadiusPermutation)
+    Generated::ShaderPermutations::KERNEL_RADIUS BlurKernelRadiusPermutation,
+    PSOCreationList* pCreationList)
 {
-    if (!m_BlurXPSO.pPSO ||
-        m_EnableSharpnessProfilePermutation != EnableSharpnessProfilePermutation ||
-        m_BlurKernelRadiusPermutation != BlurKernelRadiusPermutation)
-    {
-        m_EnableSharpnessProfilePermutation = EnableSharpnessProfilePermutation;
-        m_BlurKernelRadiusPermutation = BlurKernelRadiusPermutation;
+    PSOKey Key;
+    Key.Permutations[0] = EnableSharpnessProfilePermutation;
+    Key.Permutations[1] = BlurKernelRadiusPermutation;
 
+    ID3D12PipelineState* pPSO = m_BlurXPSOCache.Find(Key);
+    if (!pPSO)
+    {
         m_BlurXPSO.Desc.pRootSignature = m_BlurXRS;
         m_BlurXPSO.Desc.NumRenderTargets = 1;
         m_BlurXPSO.Desc.RTVFormats[0] = DXGI_FORMAT_R16G16_FLOAT;
@@ -572,20 +689,22 @@ ID3D12PipelineState* GFSDK::SSAO::D3D12::BlurXPSO::GetPSO(
         m_BlurXPSO.SetVertexShader(Shaders.FullScreenTriangle_VS.Get());
         m_BlurXPSO.SetPixelShader(Shaders.BlurX_PS.Get(EnableSharpnessProfilePermutation, BlurKernelRadiusPermutation));
 
-        SafeCreateGraphicsPipelineState(pGraphicsContext, m_BlurXPSO);
-        SET_PSO_DEBUG_NAME(BlurXPSO);
+        pPSO = CreateGraphicsPipelineState(pGraphicsContext, L"BlurXPSO", m_BlurXPSO, m_BlurXPSOCache, Key, pCreationList);
     }
 
-    return m_BlurXPSO.pPSO;
+    return pPSO;
 }
 
 //--------------------------------------------------------------------------------
 void GFSDK::SSAO::D3D12::BlurYPSO::Create(
     GFSDK_D3D12_GraphicsContext* pGraphicsContext,
+    const GFSDK_SSAO_CustomHeap& NewDelete,
     GFSDK::SSAO::D3D12::States &States)
 {
     ASSERT(!m_BlurYRS);
 
+    m_BlurYPSOCache.Create(NewDelete);
+
     CD3DX12_DESCRIPTOR_RANGE DescRanges[RootParameters::Count];
     DescRanges[RootParameters::Buffer0] = CD3DX12_DESCRIPTOR_RANGE(D3D12_DESCRIPTOR_RANGE_TYPE_CBV, 1, 0);
     DescRanges[RootParameters::Texture0] = CD3DX12_DESCRIPTOR_RANGE(D3D12_DESCRIPTOR_RANGE_TYPE_SRV, 1, 0);
@@ -621,37 +740,34 @@ ID3D12PipelineState* GFSDK::SSAO::D3D12::BlurYPSO::GetPSO(
     States& States,
     OutputInfo& Output,
     Generated::ShaderPermutations::ENABLE_SHARPNESS_PROFILE EnableSharpnessProfilePermutation,
-    Generated::ShaderPermutations::KERNEL_RADIUS BlurKernelRadiusPermutation)
+    Generated::ShaderPermutations::KERNEL_RADIUS BlurKernelRadiusPermutation,
+    PSOCreationList* pCreationList)
 {
-    if (!m_BlurYPSO.pPSO ||
-        m_EnableSharpnessProfilePermutation != EnableSharpnessProfilePermutation ||
-        m_BlurKernelRadiusPermutation != BlurKernelRadiusPermutation ||
-        m_RTSampleCount != Output.RenderTarget.SampleCount ||
-        m_RTFormat != Output.RenderTarget.Format ||
-        m_BlendMode != Output.Blend.Mode)
-    {
-        m_EnableSharpnessProfilePermutation = EnableSharpnessProfilePermutation;
-        m_BlurKernelRadiusPermutation = BlurKernelRadiusPermutation;
-        m_RTSampleCount = Output.RenderTarget.SampleCount;
-        m_RTFormat = Output.RenderTarget.Format;
-        m_BlendMode = Output.Blend.Mode;
+    D3D12_BLEND_DESC* pBlendState = GetOutputBlendState(Output, States);
 
+    PSOKey Key;
+    Key.Permutations[0] = EnableSharpnessProfilePermutation;
+    Key.Permutations[1] = BlurKernelRadiusPermutation;
+    Key.SetOutput(Output, *pBlendState);
+
+    ID3D12PipelineState* pPSO = m_BlurYPSOCache.Find(Key);
+    if (!pPSO)
+    {
         m_BlurYPSO.Desc.pRootSignature = m_BlurYRS;
         m_BlurYPSO.Desc.NumRenderTargets = 1;
         m_BlurYPSO.Desc.RTVFormats[0] = Output.RenderTarget.Format;
         m_BlurYPSO.Desc.SampleDesc.Count = Output.RenderTarget.SampleCount;
-        m_BlurYPSO.Desc.BlendState = *GetOutputBlendState(Output, States);
+        m_BlurYPSO.Desc.BlendState = *pBlendState;
         m_BlurYPSO.Desc.SampleMask = GetOutputMSAASampleMask();
         m_BlurYPSO.Desc.NodeMask = pGraphicsContext->NodeMask;
 
         m_BlurYPSO.SetVertexShader(Shaders.FullScreenTriangle_VS.Get());
         m_BlurYPSO.SetPixelShader(Shaders.BlurY_PS.Get(EnableSharpnessProfilePermutation, BlurKernelRadiusPermutation));
 
-        SafeCreateGraphicsPipelineState(pGraphicsContext, m_BlurYPSO);
-        SET_PSO_DEBUG_NAME(BlurYPSO);
+        pPSO = CreateGraphicsPipelineState(pGraphicsContext, L"BlurYPSO", m_BlurYPSO, m_BlurYPSOCache, Key, pCreationList);
     }
 
-    return m_BlurYPSO.pPSO;
+    return pPSO;
 }
 
 #endif
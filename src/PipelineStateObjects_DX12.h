@@ -33,6 +33,9 @@
 #include "RenderTargets_DX12.h"
 #include "States_DX12.h"
 #include "OutputInfo.h"
+#include "PipelineCache.h"
+#include "PipelineLibrary_DX12.h"
+#include "TaskBatch.h"
 
 namespace GFSDK
 {
@@ -44,11 +47,9 @@ namespace D3D12
 //--------------------------------------------------------------------------------
 struct GraphicsPSO
 {
-    ID3D12PipelineState* pPSO;
     D3D12_GRAPHICS_PIPELINE_STATE_DESC Desc;
 
     GraphicsPSO()
-        : pPSO(nullptr)
     {
         Desc = {};
         Desc.PrimitiveTopologyType = D3D12_PRIMITIVE_TOPOLOGY_TYPE_TRIANGLE;
@@ -88,6 +89,105 @@ struct GraphicsPSO
     }
 };
 
+//--------------------------------------------------------------------------------
+// Everything that selects one of the cached PSOs of a pass
+struct PSOKey
+{
+    int Permutations[4];
+    DXGI_FORMAT RTFormat;
+    UINT RTSampleCount;
+    D3D12_BLEND_DESC BlendState;
+
+    PSOKey()
+    {
+        ZERO_STRUCT(*this);
+    }
+
+    void SetOutput(const OutputInfo& Output, const D3D12_BLEND_DESC& Blend)
+    {
+        RTFormat = Output.RenderTarget.Format;
+        RTSampleCount = Output.RenderTarget.SampleCount;
+
+        // Copied field by field, so that the padding bytes of the key stay zero
+        BlendState.AlphaToCoverageEnable = Blend.AlphaToCoverageEnable;
+        BlendState.IndependentBlendEnable = Blend.IndependentBlendEnable;
+        for (UINT RTIndex = 0; RTIndex < SIZEOF_ARRAY(Blend.RenderTarget); ++RTIndex)
+        {
+            const D3D12_RENDER_TARGET_BLEND_DESC& Src = Blend.RenderTarget[RTIndex];
+            D3D12_RENDER_TARGET_BLEND_DESC& Dst = BlendState.RenderTarget[RTIndex];
+            Dst.BlendEnable = Src.BlendEnable;
+            Dst.LogicOpEnable = Src.LogicOpEnable;
+            Dst.SrcBlend = Src.SrcBlend;
+            Dst.DestBlend = Src.DestBlend;
+            Dst.BlendOp = Src.BlendOp;
+            Dst.SrcBlendAlpha = Src.SrcBlendAlpha;
+            Dst.DestBlendAlpha = Src.DestBlendAlpha;
+            Dst.BlendOpAlpha = Src.BlendOpAlpha;
+            Dst.LogicOp = Src.LogicOp;
+            Dst.RenderTargetWriteMask = Src.RenderTargetWriteMask;
+        }
+    }
+};
+
+typedef PipelineCache<PSOKey, ID3D12PipelineState*> PSOCache;
+
+//--------------------------------------------------------------------------------
+// Name of the PSO in the pipeline library, unique per key
+inline void GetPipelineLibraryName(const WCHAR* pName, const PSOKey& Key, WCHAR (&LibraryName)[64])
+{
+    swprintf_s(LibraryName, L"%s_%08X", pName, PSOCache::GetHash(Key));
+}
+
+//--------------------------------------------------------------------------------
+// PSOs whose creation is deferred, to compile them concurrently with a TaskBatch.
+// Adding a PSO that is already listed is a no-op. Run inserts the created PSOs
+// in their caches on the calling thread, including when one of the tasks has thrown.
+//--------------------------------------------------------------------------------
+class PSOCreationList
+{
+public:
+    static const UINT MAX_NUM_PSOS = 64;
+
+    PSOCreationList()
+        : m_pGraphicsContext(nullptr)
+        , m_NumPSOs(0)
+    {
+    }
+
+    ~PSOCreationList();
+
+    // Returns false if the list is full, in which case the PSO is to be created right away
+    bool Add(const WCHAR* pName, const GraphicsPSO& PSO, PSOCache& Cache, const PSOKey& Key);
+
+    UINT GetCount() const
+    {
+        return m_NumPSOs;
+    }
+
+    void Run(GFSDK_D3D12_GraphicsContext* pGraphicsContext, TaskBatch& Batch);
+
+private:
+    PSOCreationList(const PSOCreationList&);
+    PSOCreationList& operator=(const PSOCreationList&);
+
+    static void CreateTask(void* pUserData, UINT TaskIndex);
+    void InsertCreatedPSOs();
+
+    struct Entry
+    {
+        const WCHAR* pName;
+        WCHAR LibraryName[64];
+        D3D12_GRAPHICS_PIPELINE_STATE_DESC Desc;
+        PSOCache* pCache;
+        PSOKey Key;
+        ID3D12PipelineState* pPSO;
+    };
+
+    GFSDK_D3D12_GraphicsContext* m_pGraphicsContext;
+    Entry m_PSOs[MAX_NUM_PSOS];
+    UINT m_NumPSOs;
+};
+
 //--------------------------------------------------------------------------------
 class BasePSO
 {
@@ -112,15 +212,25 @@ public:
         SignatureBlob->Release();
     }
 
-    static void SafeCreateGraphicsPipelineState(GFSDK_D3D12_GraphicsContext* pGraphicsContext, GraphicsPSO &PSO)
+    // The previous PSOs stay in the cache, so creating a new one never has to wait for the GPU
+    // to be done with them. They are released by Renderer::ReleaseResources, after WaitGPUIdle.
+    // Returns NULL if the creation is deferred to pCreationList.
+    static ID3D12PipelineState* CreateGraphicsPipelineState(GFSDK_D3D12_GraphicsContext* pGraphicsContext, const WCHAR* pName, GraphicsPSO &PSO, PSOCache &Cache, const PSOKey &Key, PSOCreationList* pCreationList = nullptr)
     {
-        //To avoid this debug runtime error:
-        //D3D12 ERROR: ID3D12PipelineState::<final-release>: CORRUPTION: An ID3D12PipelineState object (0x00000243251F2850:'Unnamed Object') is referenced by GPU operations in-flight on Command Queue (0x000002431EAF1B20:'Unnamed ID3D12CommandQueue Object').  It is not safe to final-release objects that may have GPU operations pending.  This can result in application instability. 
-        pGraphicsContext->WaitGPUIdle();
+        if (pCreationList && pCreationList->Add(pName, PSO, Cache, Key))
+        {
+            return nullptr;
+        }
 
-        SAFE_RELEASE(PSO.pPSO);
+        WCHAR LibraryName[64];
+        GetPipelineLibraryName(pName, Key, LibraryName);
 
-        THROW_IF_FAILED(pGraphicsContext->pDevice->CreateGraphicsPipelineState(&PSO.Desc, IID_PPV_ARGS(&PSO.pPSO)));
+        ID3D12PipelineState* pPSO = pGraphicsContext->pPipelineLibrary->CreateGraphicsPipelineState(LibraryName, PSO.Desc);
+#if ENABLE_DEBUG_NAMES
+        pPSO->SetName(pName);
+#endif
+        Cache.Insert(Key, pPSO);
+        return pPSO;
     }
 
     static void CopySamplerFrom(D3D12_STATIC_SAMPLER_DESC* Dest, D3D12_SAMPLER_DESC* Src)
@@ -159,17 +269,12 @@ class LinearDepthPSO : public BasePSO
 {
 private:
     GraphicsPSO m_LinearDepthPSO;
+    PSOCache m_LinearDepthPSOCache;
     ID3D12RootSignature* m_LinearDepthRS;
-    int m_ResolveDepthPermutation;
-    int m_DepthLayerCountPermutation;
-    int m_InputDepthTextureType;
 
 public:
     LinearDepthPSO()
         : m_LinearDepthRS(nullptr)
-        , m_ResolveDepthPermutation(-1)
-        , m_DepthLayerCountPermutation(-1)
-        , m_InputDepthTextureType(-1)
     {
     }
 
@@ -184,12 +289,14 @@ public:
         };
     };
 
-    void Create(GFSDK_D3D12_GraphicsContext* pGraphicsContext);
+    void Create(
+        GFSDK_D3D12_GraphicsContext* pGraphicsContext,
+        const GFSDK_SSAO_CustomHeap& NewDelete);
 
     void Release()
     {
         SAFE_RELEASE(m_LinearDepthRS);
-        SAFE_RELEASE(m_LinearDepthPSO.pPSO);
+        m_LinearDepthPSOCache.Release();
     }
 
     ID3D12RootSignature* GetRS()
@@ -203,7 +310,8 @@ public:
         Shaders &Shaders,
         Generated::ShaderPermutations::RESOLVE_DEPTH ResolveDepthPermutation,
         Generated::ShaderPermutations::DEPTH_LAYER_COUNT DepthLayerCountPermutation,
-        GFSDK_SSAO_DepthTextureType InputDepthTextureType);
+        GFSDK_SSAO_DepthTextureType InputDepthTextureType,
+        PSOCreationList* pCreationList = nullptr);
 };
 
 //--------------------------------------------------------------------------------
@@ -211,17 +319,12 @@ class DebugNormalsPSO : public BasePSO
 {
 private:
     GraphicsPSO m_DebugNormalsPSO;
+    PSOCache m_DebugNormalsPSOCache;
     ID3D12RootSignature* m_DebugNormalsRS;
-    UINT m_RTSampleCount;
-    DXGI_FORMAT m_RTFormat;
-    int m_FetchNormalPermutation;
 
 public:
     DebugNormalsPSO()
         : m_DebugNormalsRS(nullptr)
-        , m_RTSampleCount(0)
-        , m_RTFormat(DXGI_FORMAT_UNKNOWN)
-        , m_FetchNormalPermutation(-1)
     {
     }
 
@@ -238,12 +341,13 @@ public:
 
     void Create(
         GFSDK_D3D12_GraphicsContext* pGraphicsContext,
+        const GFSDK_SSAO_CustomHeap& NewDelete,
         States &States);
 
     void Release()
     {
         SAFE_RELEASE(m_DebugNormalsRS);
-        SAFE_RELEASE(m_DebugNormalsPSO.pPSO);
+        m_DebugNormalsPSOCache.Release();
     }
 
     ID3D12RootSignature* GetRS()
@@ -265,15 +369,12 @@ class DeinterleavedDepthPSO : public BasePSO
 {
 private:
     GraphicsPSO m_DeinterleavedDepthPSO;
+    PSOCache m_DeinterleavedDepthPSOCache;
     ID3D12RootSignature* m_DeinterleavedDepthRS;
-    int m_DepthStorage;
-    int m_DepthLayerCountPermutation;
 
 public:
     DeinterleavedDepthPSO()
         : m_DeinterleavedDepthRS(nullptr)
-        , m_DepthStorage(-1)
-        , m_DepthLayerCountPermutation(-1)
     {
     }
 
@@ -293,12 +394,13 @@ public:
 
     void Create(
         GFSDK_D3D12_GraphicsContext* pGraphicsContext,
+        const GFSDK_SSAO_CustomHeap& NewDelete,
         GFSDK::SSAO::D3D12::States &States);
 
     void Release()
     {
         SAFE_RELEASE(m_DeinterleavedDepthRS);
-        SAFE_RELEASE(m_DeinterleavedDepthPSO.pPSO);
+        m_DeinterleavedDepthPSOCache.Release();
     }
 
     ID3D12RootSignature* GetRS()
@@ -313,7 +415,8 @@ public:
         GFSDK::SSAO::D3D12::States &States,
         GFSDK::SSAO::D3D12::RenderTargets& RTs,
         GFSDK_SSAO_DepthStorage DepthStorage,
-        Generated::ShaderPermutations::DEPTH_LAYER_COUNT DepthLayerCountPermutation);
+        Generated::ShaderPermutations::DEPTH_LAYER_COUNT DepthLayerCountPermutation,
+        PSOCreationList* pCreationList = nullptr);
 };
 
 //--------------------------------------------------------------------------------
@@ -321,6 +424,7 @@ class ReconstructNormalPSO : public BasePSO
 {
 private:
     GraphicsPSO m_ReconstructNormalPSO;
+    PSOCache m_ReconstructNormalPSOCache;
     ID3D12RootSignature* m_ReconstructNormalRS;
 
 public:
@@ -342,12 +446,13 @@ public:
 
     void Create(
         GFSDK_D3D12_GraphicsContext* pGraphicsContext,
+        const GFSDK_SSAO_CustomHeap& NewDelete,
         GFSDK::SSAO::D3D12::States &States);
 
     void Release()
     {
         SAFE_RELEASE(m_ReconstructNormalRS);
-        SAFE_RELEASE(m_ReconstructNormalPSO.pPSO);
+        m_ReconstructNormalPSOCache.Release();
     }
 
     ID3D12RootSignature* GetRS()
@@ -358,7 +463,8 @@ public:
 
     ID3D12PipelineState* GetPSO(
         GFSDK_D3D12_GraphicsContext* pGraphicsContext,
-        Shaders &Shaders);
+        Shaders &Shaders,
+        PSOCreationList* pCreationList = nullptr);
 };
 
 //--------------------------------------------------------------------------------
@@ -366,17 +472,12 @@ class CoarseAOPSO : public BasePSO
 {
 private:
     GraphicsPSO m_CoarseAOPSO;
+    PSOCache m_CoarseAOPSOCache;
     ID3D12RootSignature* m_CoarseAORS;
-    int m_FetchNormalPermutation;
-    int m_DepthLayerCountPermutation;
-    int m_NumStepsPermutation;
 
 public:
     CoarseAOPSO()
         : m_CoarseAORS(nullptr)
-        , m_FetchNormalPermutation(-1)
-        , m_DepthLayerCountPermutation(-1)
-        , m_NumStepsPermutation(-1)
     {
     }
 
@@ -394,12 +495,13 @@ public:
 
     void Create(
         GFSDK_D3D12_GraphicsContext* pGraphicsContext,
+        const GFSDK_SSAO_CustomHeap& NewDelete,
         GFSDK::SSAO::D3D12::States &States);
 
     void Release()
     {
         SAFE_RELEASE(m_CoarseAORS);
-        SAFE_RELEASE(m_CoarseAOPSO.pPSO);
+        m_CoarseAOPSOCache.Release();
     }
 
     ID3D12RootSignature* GetRS()
@@ -413,7 +515,8 @@ public:
         Shaders &Shaders,
         Generated::ShaderPermutations::FETCH_GBUFFER_NORMAL FetchNormalPermutation,
         Generated::ShaderPermutations::DEPTH_LAYER_COUNT DepthLayerPermutation,
-        Generated::ShaderPermutations::NUM_STEPS NumStepsPermutation);
+        Generated::ShaderPermutations::NUM_STEPS NumStepsPermutation,
+        PSOCreationList* pCreationList = nullptr);
 };
 
 //--------------------------------------------------------------------------------
@@ -421,13 +524,12 @@ class ReinterleavedAOBlurPSO : public BasePSO
 {
 private:
     GraphicsPSO m_ReinterleavedAOBlurPSO;
+    PSOCache m_ReinterleavedAOBlurPSOCache;
     ID3D12RootSignature* m_ReinterleavedAOBlurRS;
-    int m_DepthLayerCountPermutation;
 
 public:
     ReinterleavedAOBlurPSO()
         : m_ReinterleavedAOBlurRS(nullptr)
-        , m_DepthLayerCountPermutation(-1)
     {
     }
 
@@ -445,12 +547,13 @@ public:
 
     void Create(
         GFSDK_D3D12_GraphicsContext* pGraphicsContext,
+        const GFSDK_SSAO_CustomHeap& NewDelete,
         GFSDK::SSAO::D3D12::States &States);
 
     void Release()
     {
         SAFE_RELEASE(m_ReinterleavedAOBlurRS);
-        SAFE_RELEASE(m_ReinterleavedAOBlurPSO.pPSO);
+        m_ReinterleavedAOBlurPSOCache.Release();
     }
 
     ID3D12RootSignature* GetRS()
@@ -462,7 +565,8 @@ public:
     ID3D12PipelineState* GetPSO(
         GFSDK_D3D12_GraphicsContext* pGraphicsContext,
         Shaders &Shaders,
-        Generated::ShaderPermutations::DEPTH_LAYER_COUNT DepthLayerCountPermutation);
+        Generated::ShaderPermutations::DEPTH_LAYER_COUNT DepthLayerCountPermutation,
+        PSOCreationList* pCreationList = nullptr);
 };
 
 //--------------------------------------------------------------------------------
@@ -470,19 +574,12 @@ class ReinterleavedAOPSO : public BasePSO
 {
 private:
     GraphicsPSO m_ReinterleavedAOPSO;
+    PSOCache m_ReinterleavedAOPSOCache;
     ID3D12RootSignature* m_ReinterleavedAORS;
-    UINT m_RTSampleCount;
-    DXGI_FORMAT m_RTFormat;
-    int m_BlendMode;
-    int m_DepthLayerCountPermutation;
 
 public:
     ReinterleavedAOPSO()
         : m_ReinterleavedAORS(nullptr)
-        , m_RTSampleCount(0)
-        , m_RTFormat(DXGI_FORMAT_UNKNOWN)
-        , m_BlendMode(-1)
-        , m_DepthLayerCountPermutation(-1)
     {
     }
 
@@ -498,12 +595,13 @@ public:
 
     void Create(
         GFSDK_D3D12_GraphicsContext* pGraphicsContext,
+        const GFSDK_SSAO_CustomHeap& NewDelete,
         GFSDK::SSAO::D3D12::States &States);
 
     void Release()
     {
         SAFE_RELEASE(m_ReinterleavedAORS);
-        SAFE_RELEASE(m_ReinterleavedAOPSO.pPSO);
+        m_ReinterleavedAOPSOCache.Release();
     }
 
     ID3D12RootSignature* GetRS()
@@ -517,7 +615,8 @@ public:
         Shaders &Shaders,
         States& States,
         OutputInfo& Output,
-        Generated::ShaderPermutations::DEPTH_LAYER_COUNT DepthLayerCountPermutation);
+        Generated::ShaderPermutations::DEPTH_LAYER_COUNT DepthLayerCountPermutation,
+        PSOCreationList* pCreationList = nullptr);
 };
 
 //--------------------------------------------------------------------------------
@@ -525,15 +624,12 @@ class BlurXPSO : public BasePSO
 {
 private:
     GraphicsPSO m_BlurXPSO;
+    PSOCache m_BlurXPSOCache;
     ID3D12RootSignature* m_BlurXRS;
-    int m_EnableSharpnessProfilePermutation;
-    int m_BlurKernelRadiusPermutation;
 
 public:
     BlurXPSO()
         : m_BlurXRS(nullptr)
-        , m_EnableSharpnessProfilePermutation(-1)
-        , m_BlurKernelRadiusPermutation(-1)
     {
     }
 
@@ -549,12 +645,13 @@ public:
 
     void Create(
         GFSDK_D3D12_GraphicsContext* pGraphicsContext,
+        const GFSDK_SSAO_CustomHeap& NewDelete,
         GFSDK::SSAO::D3D12::States &States);
 
     void Release()
     {
         SAFE_RELEASE(m_BlurXRS);
-        SAFE_RELEASE(m_BlurXPSO.pPSO);
+        m_BlurXPSOCache.Release();
     }
 
     ID3D12RootSignature* GetRS()
@@ -567,7 +664,8 @@ public:
         GFSDK_D3D12_GraphicsContext* pGraphicsContext,
         Shaders &Shaders,
         Generated::ShaderPermutations::ENABLE_SHARPNESS_PROFILE EnableSharpnessProfilePermutation,
-        Generated::ShaderPermutations::KERNEL_RADIUS BlurKernelRadiusPermutation);
+        Generated::ShaderPermutations::KERNEL_RADIUS BlurKernelRadiusPermutation,
+        PSOCreationList* pCreationList = nullptr);
 };
 
 //--------------------------------------------------------------------------------
@@ -575,21 +673,12 @@ class BlurYPSO : public BasePSO
 {
 private:
     GraphicsPSO m_BlurYPSO;
+    PSOCache m_BlurYPSOCache;
     ID3D12RootSignature* m_BlurYRS;
-    int m_EnableSharpnessProfilePermutation;
-    int m_BlurKernelRadiusPermutation;
-    UINT m_RTSampleCount;
-    DXGI_FORMAT m_RTFormat;
-    int m_BlendMode;
 
 public:
     BlurYPSO()
         : m_BlurYRS(nullptr)
-        , m_EnableSharpnessProfilePermutation(-1)
-        , m_BlurKernelRadiusPermutation(-1)
-        , m_RTSampleCount(0)
-        , m_RTFormat(DXGI_FORMAT_UNKNOWN)
-        , m_BlendMode(-1)
     {
     }
 
@@ -605,12 +694,13 @@ public:
 
     void Create(
         GFSDK_D3D12_GraphicsContext* pGraphicsContext,
+        const GFSDK_SSAO_CustomHeap& NewDelete,
         GFSDK::SSAO::D3D12::States &States);
 
     void Release()
     {
         SAFE_RELEASE(m_BlurYRS);
-        SAFE_RELEASE(m_BlurYPSO.pPSO);
+        m_BlurYPSOCache.Release();
     }
 
     ID3D12RootSignature* GetRS()
@@ -625,7 +715,8 @@ public:
         States& States,
         OutputInfo& Output,
         Generated::ShaderPermutations::ENABLE_SHARPNESS_PROFILE EnableSharpnessProfilePermutation,
-        Generated::ShaderPermutations::KERNEL_RADIUS BlurKernelRadiusPermutation);
+        Generated::ShaderPermutations::KERNEL_RADIUS BlurKernelRadiusPermutation,
+        PSOCreationList* pCreationList = nullptr);
 };
 
 } // namespace D3D12
@@ -0,0 +1,124 @@
+// This code contains NVIDIA Confidential Information and is disclosed to you
+// under a form of NVIDIA software license agreement provided separately to you.
+//
+// Notice
+// NVIDIA Corporation and its licensors retain all intellectual property and
+// proprietary rights in and to this software and related documentation and
+// any modifications thereto. Any use, reproduction, disclosure, or
+// distribution of this software and related documentation without an express
+// license agreement from NVIDIA Corporation is strictly prohibited.
+//
+// ALL NVIDIA DESIGN SPECIFICATIONS, CODE ARE PROVIDED "AS IS.". NVIDIA MAKES
+// NO WARRANTIES, EXPRESSED, IMPLIED, STATUTORY, OR OTHERWISE WITH RESPECT TO
+// THE MATERIALS, AND EXPRESSLY DISCLAIMS ALL IMPLIED WARRANTIES OF NONINFRINGEMENT,
+// MERCHANTABILITY, AND FITNESS FOR A PARTICULAR PURPOSE.
+//
+// Information and code furnished is believed to be accurate and reliable.
+// However, NVIDIA Corporation assumes no responsibility for the consequences of use of such
+// information or for any infringement of patents or other rights of third parties that may
+// result from its use. No license is granted by implication or otherwise under any patent
+// or patent rights of NVIDIA Corporation. Details are subject to change without notice.
+// This code supersedes and replaces all information previously supplied.
+// NVIDIA Corporation products are not authorized for use as critical
+// components in life support devices or systems without express written approval of
+// NVIDIA Corporation.
+//
+// Copyright (c) 2008-2021 NVIDIA Corporation. All rights reserved.
+
+#pragma once
+#include "Common.h"
+#include "RenderTimes.h"
+
+namespace GFSDK
+{
+namespace SSAO
+{
+
+//--------------------------------------------------------------------------------
+// Callbacks set by GFSDK_SSAO_Context::SetProfilerHooks. The ranges are named after the
+// regimes of RenderTimes.h, so that they line up with the times of GetRenderTimes.
+//--------------------------------------------------------------------------------
+class ProfilerHooks
+{
+public:
+    GFSDK_SSAO_Status Set(const GFSDK_SSAO_ProfilerHooks& Hooks)
+    {
+        if (!Hooks.begin_range_ != !Hooks.end_range_)
+        {
+            return GFSDK_SSAO_NULL_ARGUMENT;
+        }
+
+        m_Hooks = Hooks;
+
+        return GFSDK_SSAO_OK;
+    }
+
+    void BeginRange(GpuTimeRegimeIndex Id, void* pCommandList) const
+    {
+        if (m_Hooks.begin_range_)
+        {
+            m_Hooks.begin_range_(GetRegimeName(Id), GetRegimeColor(Id), pCommandList, m_Hooks.pUserData);
+        }
+    }
+
+    void EndRange(void* pCommandList) const
+    {
+        if (m_Hooks.end_range_)
+        {
+            m_Hooks.end_range_(pCommandList, m_Hooks.pUserData);
+        }
+    }
+
+    void Counter(const char* pName, float ValueMS) const
+    {
+        if (m_Hooks.counter_)
+        {
+            m_Hooks.counter_(pName, ValueMS, m_Hooks.pUserData);
+        }
+    }
+
+private:
+    static UINT GetRegimeColor(GpuTimeRegimeIndex Id)
+    {
+        static const UINT s_Colors[REGIME_TIME_COUNT] =
+        {
+            0xff4e79a7, // LinearZ
+            0xfff28e2b, // DeinterleaveZ
+            0xff76b7b2, // Normal
+            0xffe15759, // CoarseAO
+            0xff59a14f, // InterleaveAO
+            0xffedc948, // BlurX
+            0xffb07aa1, // BlurY
+            0xff76b900, // HBAO+
+        };
+        return s_Colors[Id];
+    }
+
+    GFSDK_SSAO_ProfilerHooks m_Hooks;
+};
+
+//--------------------------------------------------------------------------------
+class ProfilerRange
+{
+public:
+    ProfilerRange(const ProfilerHooks* pProfilerHooks, void* pCommandList, GpuTimeRegimeIndex Id)
+        : m_pProfilerHooks(pProfilerHooks)
+        , m_pCommandList(pCommandList)
+    {
+        m_pProfilerHooks->BeginRange(Id, m_pCommandList);
+    }
+
+    ~ProfilerRange()
+    {
+        m_pProfilerHooks->EndRange(m_pCommandList);
+    }
+
+private:
+    const ProfilerHooks* m_pProfilerHooks;
+    void* m_pCommandList;
+};
+
+#define PROFILER_RANGE_SCOPE(COMMAND_LIST, NAME) GFSDK::SSAO::ProfilerRange ProfilerRange_ ## NAME(&m_ProfilerHooks, COMMAND_LIST, GFSDK::SSAO::REGIME_TIME_ ## NAME)
+
+} // namespace SSAO
+} // namespace GFSDK
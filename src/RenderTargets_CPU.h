@@ -0,0 +1,342 @@
+// This code contains NVIDIA Confidential Information and is disclosed to you
+// under a form of NVIDIA software license agreement provided separately to you.
+//
+// Notice
+// NVIDIA Corporation and its licensors retain all intellectual property and
+// proprietary rights in and to this software and related documentation and
+// any modifications thereto. Any use, reproduction, disclosure, or
+// distribution of this software and related documentation without an express
+// license agreement from NVIDIA Corporation is strictly prohibited.
+//
+// ALL NVIDIA DESIGN SPECIFICATIONS, CODE ARE PROVIDED "AS IS.". NVIDIA MAKES
+// NO WARRANTIES, EXPRESSED, IMPLIED, STATUTORY, OR OTHERWISE WITH RESPECT TO
+// THE MATERIALS, AND EXPRESSLY DISCLAIMS ALL IMPLIED WARRANTIES OF NONINFRINGEMENT,
+// MERCHANTABILITY, AND FITNESS FOR A PARTICULAR PURPOSE.
+//
+// Information and code furnished is believed to be accurate and reliable.
+// However, NVIDIA Corporation assumes no responsibility for the consequences of use of such
+// information or for any infringement of patents or other rights of third parties that may
+// result from its use. No license is granted by implication or otherwise under any patent
+// or patent rights of NVIDIA Corporation. Details are subject to change without notice.
+// This code supersedes and replaces all information previously supplied.
+// NVIDIA Corporation products are not authorized for use as critical
+// components in life support devices or systems without express written approval of
+// NVIDIA Corporation.
+//
+// Copyright (c) 2008-2021 NVIDIA Corporation. All rights reserved.
+
+#if SUPPORT_CPU
+
+#pragma once
+#include "Common.h"
+#include "Shaders_CPU.h"
+
+namespace GFSDK
+{
+namespace SSAO
+{
+namespace CPU
+{
+
+//--------------------------------------------------------------------------------
+// Host render target with FP32 or FP16 channels, allocated from the custom heap.
+// The slices of an array texture are stored one after the other.
+//--------------------------------------------------------------------------------
+template<class TexelType>
+class RTTexture2DBase
+{
+public:
+    TexelType* pData;
+    TextureRTV<TexelType> RTV;
+    TextureSRV<TexelType> SRV;
+    UINT m_AllocatedSizeInBytes;
+
+    RTTexture2DBase()
+        : pData(NULL)
+        , m_AllocatedSizeInBytes(0)
+    {
+    }
+
+    UINT GetAllocatedSizeInBytes()
+    {
+        return m_AllocatedSizeInBytes;
+    }
+
+    void CreateOnce(const GFSDK_SSAO_CustomHeap& NewDelete, UINT Width, UINT Height, UINT NumChannels, UINT ArraySize=1)
+    {
+        if (!pData)
+        {
+            // The vector kernels gather FP16 texels with 32-bit loads, which may read past the last texel
+            const UINT SizeInBytes = Width * Height * NumChannels * ArraySize * sizeof(TexelType) + UINT(sizeof(UINT) - sizeof(TexelType));
+
+            pData = (TexelType*)NewDelete.new_(SizeInBytes);
+            THROW_IF(!pData);
+
+            RTV.pData       = pData;
+            RTV.Width       = Width;
+            RTV.Height      = Height;
+            RTV.RowPitch    = Width * NumChannels;
+            RTV.PixelStride = NumChannels;
+            SRV             = RTV;
+
+            m_AllocatedSizeInBytes = SizeInBytes;
+        }
+    }
+
+    void SafeRelease(const GFSDK_SSAO_CustomHeap& NewDelete)
+    {
+        if (pData)
+        {
+            NewDelete.delete_(pData);
+            pData = NULL;
+        }
+
+        RTV = TextureRTV<TexelType>();
+        SRV = TextureSRV<TexelType>();
+
+        m_AllocatedSizeInBytes = 0;
+    }
+};
+
+typedef RTTexture2DBase<FLOAT> RTTexture2D;
+
+//--------------------------------------------------------------------------------
+template<UINT ARRAY_SIZE, class TexelType = FLOAT>
+class RTTexture2DArray : public RTTexture2DBase<TexelType>
+{
+public:
+    TextureRTV<TexelType> RTVs[ARRAY_SIZE];
+    TextureSRV<TexelType> SRVs[ARRAY_SIZE];
+
+    void CreateOnce(const GFSDK_SSAO_CustomHeap& NewDelete, UINT Width, UINT Height, UINT NumChannels);
+    void SafeRelease(const GFSDK_SSAO_CustomHeap& NewDelete);
+};
+
+//--------------------------------------------------------------------------------
+template<UINT ARRAY_SIZE, class TexelType>
+void RTTexture2DArray<ARRAY_SIZE, TexelType>::CreateOnce(const GFSDK_SSAO_CustomHeap& NewDelete, UINT Width, UINT Height, UINT NumChannels)
+{
+    if (!this->pData)
+    {
+        RTTexture2DBase<TexelType>::CreateOnce(NewDelete, Width, Height, NumChannels, ARRAY_SIZE);
+
+        for (UINT SliceId = 0; SliceId < ARRAY_SIZE; ++SliceId)
+        {
+            RTVs[SliceId] = this->RTV;
+            RTVs[SliceId].pData = this->pData + size_t(SliceId) * Width * Height * NumChannels;
+            SRVs[SliceId] = RTVs[SliceId];
+        }
+    }
+}
+
+//--------------------------------------------------------------------------------
+template<UINT ARRAY_SIZE, class TexelType>
+void RTTexture2DArray<ARRAY_SIZE, TexelType>::SafeRelease(const GFSDK_SSAO_CustomHeap& NewDelete)
+{
+    RTTexture2DBase<TexelType>::SafeRelease(NewDelete);
+
+    for (UINT SliceId = 0; SliceId < ARRAY_SIZE; ++SliceId)
+    {
+        RTVs[SliceId] = TextureRTV<TexelType>();
+        SRVs[SliceId] = TextureSRV<TexelType>();
+    }
+}
+
+//--------------------------------------------------------------------------------
+class RenderTargets
+{
+public:
+    RenderTargets(const GFSDK_SSAO_CustomHeap& NewDelete)
+        : m_NewDelete(NewDelete)
+        , m_FullWidth(0)
+        , m_FullHeight(0)
+    {
+    }
+
+    void ReleaseResources()
+    {
+        m_FullResAOTexture.SafeRelease(m_NewDelete);
+        m_FullResAOZTexture2.SafeRelease(m_NewDelete);
+        m_FullResNormalTexture.SafeRelease(m_NewDelete);
+        m_FullResViewDepthTexture.SafeRelease(m_NewDelete);
+        m_FullResViewDepthTexture2.SafeRelease(m_NewDelete);
+        m_QuarterResAOTextureArray.SafeRelease(m_NewDelete);
+        m_QuarterResViewDepthTextureArray.SafeRelease(m_NewDelete);
+        m_QuarterResHalfViewDepthTextureArray.SafeRelease(m_NewDelete);
+    }
+
+    void Release()
+    {
+        ReleaseResources();
+    }
+
+    void SetFullResolution(UINT Width, UINT Height)
+    {
+        m_FullWidth = Width;
+        m_FullHeight = Height;
+    }
+
+    UINT GetFullWidth()
+    {
+        return m_FullWidth;
+    }
+
+    UINT GetFullHeight()
+    {
+        return m_FullHeight;
+    }
+
+    // Sum of the per-direction AO of GFSDK_SSAO_LINE_SWEEP
+    const RTTexture2D* GetFullResAOTexture()
+    {
+        m_FullResAOTexture.CreateOnce(m_NewDelete, m_FullWidth, m_FullHeight, 1);
+        return &m_FullResAOTexture;
+    }
+
+    const RTTexture2D* GetFullResAOZTexture2()
+    {
+        m_FullResAOZTexture2.CreateOnce(m_NewDelete, m_FullWidth, m_FullHeight, 2);
+        return &m_FullResAOZTexture2;
+    }
+
+    const RTTexture2D* GetFullResViewDepthTexture()
+    {
+        m_FullResViewDepthTexture.CreateOnce(m_NewDelete, m_FullWidth, m_FullHeight, 1);
+        return &m_FullResViewDepthTexture;
+    }
+
+    const RTTexture2D* GetFullResViewDepthTexture2()
+    {
+        m_FullResViewDepthTexture2.CreateOnce(m_NewDelete, m_FullWidth, m_FullHeight, 1);
+        return &m_FullResViewDepthTexture2;
+    }
+
+    // Like the D3D path, the dual-layer depths are always stored in R16G16_FLOAT
+    static bool UseHalfViewDepths(const GFSDK_SSAO_Parameters &Options)
+    {
+        return Options.EnableDualLayerAO || Options.DepthStorage == GFSDK_SSAO_FP16_VIEW_DEPTHS;
+    }
+
+    const RTTexture2DArray<16>* GetQuarterResViewDepthTextureArray(const GFSDK_SSAO_Parameters &Options)
+    {
+        ASSERT(!UseHalfViewDepths(Options));
+        m_QuarterResViewDepthTextureArray.CreateOnce(m_NewDelete, iDivUp(m_FullWidth,4), iDivUp(m_FullHeight,4), 1);
+        return &m_QuarterResViewDepthTextureArray;
+    }
+
+    const RTTexture2DArray<16, HALF>* GetQuarterResHalfViewDepthTextureArray(const GFSDK_SSAO_Parameters &Options)
+    {
+        ASSERT(UseHalfViewDepths(Options));
+        m_QuarterResHalfViewDepthTextureArray.CreateOnce(m_NewDelete, iDivUp(m_FullWidth,4), iDivUp(m_FullHeight,4), Options.EnableDualLayerAO ? 2 : 1);
+        return &m_QuarterResHalfViewDepthTextureArray;
+    }
+
+    const RTTexture2DArray<16>* GetQuarterResAOTextureArray()
+    {
+        m_QuarterResAOTextureArray.CreateOnce(m_NewDelete, iDivUp(m_FullWidth,4), iDivUp(m_FullHeight,4), 1);
+        return &m_QuarterResAOTextureArray;
+    }
+
+    const RTTexture2D* GetFullResNormalTexture()
+    {
+        m_FullResNormalTexture.CreateOnce(m_NewDelete, m_FullWidth, m_FullHeight, 3);
+        return &m_FullResNormalTexture;
+    }
+
+    // With input normals, the AO pass linearizes the depths straight into the quarter-res slices,
+    // and the full-res view depths are only created on demand (for DRAW_DEBUG_N or partial render masks),
+    // unless the AO is computed with GFSDK_SSAO_LINE_SWEEP
+    void CreateOnceAll(const GFSDK_SSAO_Parameters &Options, bool InputNormals)
+    {
+        if (Options.Algorithm == GFSDK_SSAO_LINE_SWEEP)
+        {
+            // The lines are swept over the full-res view depths, without any quarter-res textures
+            GetFullResViewDepthTexture();
+            GetFullResAOTexture();
+
+            if (Options.EnableDualLayerAO)
+            {
+                GetFullResViewDepthTexture2();
+            }
+        }
+        else
+        {
+            if (UseHalfViewDepths(Options))
+            {
+                GetQuarterResHalfViewDepthTextureArray(Options);
+            }
+            else
+            {
+                GetQuarterResViewDepthTextureArray(Options);
+            }
+            GetQuarterResAOTextureArray();
+        }
+
+        if (!InputNormals)
+        {
+            GetFullResViewDepthTexture();
+            GetFullResNormalTexture();
+
+            if (Options.EnableDualLayerAO)
+            {
+                GetFullResViewDepthTexture2();
+            }
+        }
+
+        if (Options.Blur.Enable)
+        {
+            GetFullResAOZTexture2();
+        }
+    }
+
+    GFSDK_SSAO_Status PreCreate(const GFSDK_SSAO_Parameters &Options, bool InputNormals)
+    {
+#if ENABLE_EXCEPTIONS
+        try
+        {
+            CreateOnceAll(Options, InputNormals);
+        }
+        catch (...)
+        {
+            ReleaseResources();
+
+            return GFSDK_SSAO_MEMORY_ALLOCATION_FAILED;
+        }
+#else
+        CreateOnceAll(Options, InputNormals);
+#endif
+
+        return GFSDK_SSAO_OK;
+    }
+
+    UINT GetCurrentAllocatedVideoMemoryBytes()
+    {
+        return m_FullResAOTexture.GetAllocatedSizeInBytes() +
+               m_FullResAOZTexture2.GetAllocatedSizeInBytes() +
+               m_FullResNormalTexture.GetAllocatedSizeInBytes() +
+               m_FullResViewDepthTexture.GetAllocatedSizeInBytes() +
+               m_FullResViewDepthTexture2.GetAllocatedSizeInBytes() +
+               m_QuarterResAOTextureArray.GetAllocatedSizeInBytes() +
+               m_QuarterResViewDepthTextureArray.GetAllocatedSizeInBytes() +
+               m_QuarterResHalfViewDepthTextureArray.GetAllocatedSizeInBytes();
+    }
+
+private:
+    GFSDK_SSAO_CustomHeap m_NewDelete;
+    UINT m_FullWidth;
+    UINT m_FullHeight;
+    RTTexture2D m_FullResAOTexture;
+    RTTexture2D m_FullResAOZTexture2;
+    RTTexture2D m_FullResNormalTexture;
+    RTTexture2D m_FullResViewDepthTexture;
+    RTTexture2D m_FullResViewDepthTexture2;
+    RTTexture2DArray<16> m_QuarterResAOTextureArray;
+    RTTexture2DArray<16> m_QuarterResViewDepthTextureArray;
+    RTTexture2DArray<16, HALF> m_QuarterResHalfViewDepthTextureArray;
+};
+
+} // namespace CPU
+} // namespace SSAO
+} // namespace GFSDK
+
+#endif // SUPPORT_CPU
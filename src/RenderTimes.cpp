@@ -0,0 +1,107 @@
+// This code contains NVIDIA Confidential Information and is disclosed to you
+// under a form of NVIDIA software license agreement provided separately to you.
+//
+// Notice
+// NVIDIA Corporation and its licensors retain all intellectual property and
+// proprietary rights in and to this software and related documentation and
+// any modifications thereto. Any use, reproduction, disclosure, or
+// distribution of this software and related documentation without an express
+// license agreement from NVIDIA Corporation is strictly prohibited.
+//
+// ALL NVIDIA DESIGN SPECIFICATIONS, CODE ARE PROVIDED "AS IS.". NVIDIA MAKES
+// NO WARRANTIES, EXPRESSED, IMPLIED, STATUTORY, OR OTHERWISE WITH RESPECT TO
+// THE MATERIALS, AND EXPRESSLY DISCLAIMS ALL IMPLIED WARRANTIES OF NONINFRINGEMENT,
+// MERCHANTABILITY, AND FITNESS FOR A PARTICULAR PURPOSE.
+//
+// Information and code furnished is believed to be accurate and reliable.
+// However, NVIDIA Corporation assumes no responsibility for the consequences of use of such
+// information or for any infringement of patents or other rights of third parties that may
+// result from its use. No license is granted by implication or otherwise under any patent
+// or patent rights of NVIDIA Corporation. Details are subject to change without notice.
+// This code supersedes and replaces all information previously supplied.
+// NVIDIA Corporation products are not authorized for use as critical
+// components in life support devices or systems without express written approval of
+// NVIDIA Corporation.
+//
+// Copyright (c) 2008-2021 NVIDIA Corporation. All rights reserved.
+
+#include "RenderTimes.h"
+#include "ProfilerHooks.h"
+
+#include <algorithm>
+
+//--------------------------------------------------------------------------------
+// Nearest-rank percentile of N sorted values
+static float GetPercentile(const float* pSortedTimes, UINT N, UINT Percent)
+{
+    const UINT Rank = (N * Percent + 99) / 100;
+    return pSortedTimes[(Rank > 0) ? Rank - 1 : 0];
+}
+
+//--------------------------------------------------------------------------------
+void GFSDK::SSAO::GetPassTime(const float* pTimesMS, UINT NumFrames, UINT LastFrame, GFSDK_SSAO_PassTime* pPassTime)
+{
+    *pPassTime = GFSDK_SSAO_PassTime();
+
+    if (!NumFrames)
+    {
+        return;
+    }
+
+    // Until the ring has wrapped around, the frames are stored in [0, NumFrames)
+    float SortedTimes[GFSDK_SSAO_RENDER_TIMES_HISTORY_SIZE];
+    memcpy(SortedTimes, pTimesMS, sizeof(float) * NumFrames);
+    std::sort(SortedTimes, SortedTimes + NumFrames);
+
+    double SumMS = 0.0;
+    for (UINT j = 0; j < NumFrames; ++j)
+    {
+        SumMS += SortedTimes[j];
+    }
+
+    pPassTime->LastMS = pTimesMS[LastFrame];
+    pPassTime->MinMS = SortedTimes[0];
+    pPassTime->AvgMS = float(SumMS / NumFrames);
+    pPassTime->P95MS = GetPercentile(SortedTimes, NumFrames, 95);
+    pPassTime->P99MS = GetPercentile(SortedTimes, NumFrames, 99);
+}
+
+//--------------------------------------------------------------------------------
+void GFSDK::SSAO::RenderTimesHistory::Add(const RenderTimes& Frame)
+{
+    m_GPUTimes.Add(Frame.TimeMS);
+
+    if (m_pProfilerHooks)
+    {
+        for (UINT i = 0; i < REGIME_TIME_COUNT; ++i)
+        {
+            m_pProfilerHooks->Counter(GetRegimeName(GpuTimeRegimeIndex(i)), Frame.TimeMS[i]);
+        }
+    }
+}
+
+//--------------------------------------------------------------------------------
+void GFSDK::SSAO::RenderTimesHistory::Add(const CPUTimes& Frame)
+{
+    m_CPUTimes.Add(Frame.TimeMS);
+
+    if (m_pProfilerHooks)
+    {
+        for (UINT i = 0; i < CPU_TIME_COUNT; ++i)
+        {
+            m_pProfilerHooks->Counter(GetCpuPhaseName(CpuTimeRegimeIndex(i)), Frame.TimeMS[i]);
+        }
+    }
+}
+
+//--------------------------------------------------------------------------------
+void GFSDK::SSAO::RenderTimesHistory::GetRenderTimes(GFSDK_SSAO_RenderTimes* pRenderTimes) const
+{
+    *pRenderTimes = GFSDK_SSAO_RenderTimes();
+
+    pRenderTimes->NumFrames = m_GPUTimes.GetNumFrames();
+    m_GPUTimes.GetPassTimes(pRenderTimes->Passes);
+
+    pRenderTimes->NumCPUFrames = m_CPUTimes.GetNumFrames();
+    m_CPUTimes.GetPassTimes(pRenderTimes->CPUPhases);
+}
@@ -0,0 +1,379 @@
+// This code contains NVIDIA Confidential Information and is disclosed to you
+// under a form of NVIDIA software license agreement provided separately to you.
+//
+// Notice
+// NVIDIA Corporation and its licensors retain all intellectual property and
+// proprietary rights in and to this software and related documentation and
+// any modifications thereto. Any use, reproduction, disclosure, or
+// distribution of this software and related documentation without an express
+// license agreement from NVIDIA Corporation is strictly prohibited.
+//
+// ALL NVIDIA DESIGN SPECIFICATIONS, CODE ARE PROVIDED "AS IS.". NVIDIA MAKES
+// NO WARRANTIES, EXPRESSED, IMPLIED, STATUTORY, OR OTHERWISE WITH RESPECT TO
+// THE MATERIALS, AND EXPRESSLY DISCLAIMS ALL IMPLIED WARRANTIES OF NONINFRINGEMENT,
+// MERCHANTABILITY, AND FITNESS FOR A PARTICULAR PURPOSE.
+//
+// Information and code furnished is believed to be accurate and reliable.
+// However, NVIDIA Corporation assumes no responsibility for the consequences of use of such
+// information or for any infringement of patents or other rights of third parties that may
+// result from its use. No license is granted by implication or otherwise under any patent
+// or patent rights of NVIDIA Corporation. Details are subject to change without notice.
+// This code supersedes and replaces all information previously supplied.
+// NVIDIA Corporation products are not authorized for use as critical
+// components in life support devices or systems without express written approval of
+// NVIDIA Corporation.
+//
+// Copyright (c) 2008-2021 NVIDIA Corporation. All rights reserved.
+
+#pragma once
+#include "Common.h"
+
+#include <chrono>
+
+namespace GFSDK
+{
+namespace SSAO
+{
+
+//--------------------------------------------------------------------------------
+enum GpuTimeRegimeIndex
+{
+    REGIME_TIME_LINEAR_Z        = GFSDK_SSAO_PASS_LINEAR_Z,
+    REGIME_TIME_DEINTERLEAVE_Z  = GFSDK_SSAO_PASS_DEINTERLEAVE_Z,
+    REGIME_TIME_NORMAL          = GFSDK_SSAO_PASS_NORMAL,
+    REGIME_TIME_COARSE_AO       = GFSDK_SSAO_PASS_COARSE_AO,
+    REGIME_TIME_INTERLEAVE_AO   = GFSDK_SSAO_PASS_INTERLEAVE_AO,
+    REGIME_TIME_BLURX           = GFSDK_SSAO_PASS_BLURX,
+    REGIME_TIME_BLURY           = GFSDK_SSAO_PASS_BLURY,
+    REGIME_TIME_TOTAL           = GFSDK_SSAO_PASS_TOTAL,
+    REGIME_TIME_COUNT           = GFSDK_SSAO_PASS_COUNT
+};
+
+//--------------------------------------------------------------------------------
+enum CpuTimeRegimeIndex
+{
+    CPU_TIME_SET_DATA_FLOW      = GFSDK_SSAO_CPU_PHASE_SET_DATA_FLOW,
+    CPU_TIME_SET_AO_PARAMETERS  = GFSDK_SSAO_CPU_PHASE_SET_AO_PARAMETERS,
+    CPU_TIME_SAVE_APP_STATE     = GFSDK_SSAO_CPU_PHASE_SAVE_APP_STATE,
+    CPU_TIME_RENDER             = GFSDK_SSAO_CPU_PHASE_RENDER,
+    CPU_TIME_RESTORE_APP_STATE  = GFSDK_SSAO_CPU_PHASE_RESTORE_APP_STATE,
+    CPU_TIME_TOTAL              = GFSDK_SSAO_CPU_PHASE_TOTAL,
+    CPU_TIME_COUNT              = GFSDK_SSAO_CPU_PHASE_COUNT
+};
+
+//--------------------------------------------------------------------------------
+// Names of the regimes and phases, as reported to GFSDK_SSAO_ProfilerHooks
+inline const char* GetRegimeName(GpuTimeRegimeIndex Id)
+{
+    static const char* s_Names[REGIME_TIME_COUNT] =
+    {
+        "LinearZ",
+        "DeinterleaveZ",
+        "Normal",
+        "CoarseAO",
+        "InterleaveAO",
+        "BlurX",
+        "BlurY",
+        "HBAO+",
+    };
+    return s_Names[Id];
+}
+
+inline const char* GetCpuPhaseName(CpuTimeRegimeIndex Id)
+{
+    static const char* s_Names[CPU_TIME_COUNT] =
+    {
+        "SetDataFlow",
+        "SetAOParameters",
+        "SaveAppState",
+        "Render",
+        "RestoreAppState",
+        "RenderAO",
+    };
+    return s_Names[Id];
+}
+
+//--------------------------------------------------------------------------------
+// Times of one frame, in milliseconds (0.f for the regimes that did not run)
+struct RenderTimes
+{
+    float TimeMS[REGIME_TIME_COUNT];
+
+    RenderTimes()
+    {
+        ZERO_ARRAY(TimeMS);
+    }
+};
+
+//--------------------------------------------------------------------------------
+// Host times of the phases of one RenderAO call, in milliseconds
+struct CPUTimes
+{
+    float TimeMS[CPU_TIME_COUNT];
+
+    CPUTimes()
+    {
+        ZERO_ARRAY(TimeMS);
+    }
+};
+
+//--------------------------------------------------------------------------------
+// Host clock of the times measured on the CPU, in nanoseconds
+inline GFSDK_SSAO_UINT64 GetHostTimeNS()
+{
+    return GFSDK_SSAO_UINT64(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+inline float GetHostTimeMS(GFSDK_SSAO_UINT64 BeginNS, GFSDK_SSAO_UINT64 EndNS)
+{
+    return (EndNS > BeginNS) ? float(double(EndNS - BeginNS) * 1.e-6) : 0.f;
+}
+
+//--------------------------------------------------------------------------------
+// Statistics of the last NumFrames values of a ring of HISTORY_SIZE values
+void GetPassTime(const float* pTimesMS, UINT NumFrames, UINT LastFrame, GFSDK_SSAO_PassTime* pPassTime);
+
+//--------------------------------------------------------------------------------
+// Rolling history of NUM_TIMES times per frame, over the last HISTORY_SIZE frames.
+// The statistics are computed when the application asks for them, not per frame.
+//--------------------------------------------------------------------------------
+template<UINT NUM_TIMES>
+class TimesHistory
+{
+public:
+    static const UINT HISTORY_SIZE = GFSDK_SSAO_RENDER_TIMES_HISTORY_SIZE;
+
+    TimesHistory()
+    {
+        Reset();
+    }
+
+    void Reset()
+    {
+        m_NumFrames = 0;
+        m_NextFrame = 0;
+    }
+
+    void Add(const float (&TimesMS)[NUM_TIMES])
+    {
+        for (UINT i = 0; i < NUM_TIMES; ++i)
+        {
+            m_TimesMS[i][m_NextFrame] = TimesMS[i];
+        }
+
+        m_NextFrame = (m_NextFrame + 1) % HISTORY_SIZE;
+        if (m_NumFrames < HISTORY_SIZE)
+        {
+            ++m_NumFrames;
+        }
+    }
+
+    void GetPassTimes(GFSDK_SSAO_PassTime (&PassTimes)[NUM_TIMES]) const
+    {
+        const UINT LastFrame = (m_NextFrame + HISTORY_SIZE - 1) % HISTORY_SIZE;
+
+        for (UINT i = 0; i < NUM_TIMES; ++i)
+        {
+            GetPassTime(m_TimesMS[i], m_NumFrames, LastFrame, &PassTimes[i]);
+        }
+    }
+
+    UINT GetNumFrames() const
+    {
+        return m_NumFrames;
+    }
+
+private:
+    float m_TimesMS[NUM_TIMES][HISTORY_SIZE];
+    UINT m_NumFrames;
+    UINT m_NextFrame;
+};
+
+class ProfilerHooks;
+
+//--------------------------------------------------------------------------------
+// Rolling histories of the GPU times read back by a context, and of the host times of its RenderAO calls.
+// The two histories are not in sync, since the GPU times lag the RenderAO calls.
+// Each frame added is also reported to the counter_ callback of the profiler hooks, if any.
+//--------------------------------------------------------------------------------
+class RenderTimesHistory
+{
+public:
+    static const UINT HISTORY_SIZE = GFSDK_SSAO_RENDER_TIMES_HISTORY_SIZE;
+
+    RenderTimesHistory()
+        : m_pProfilerHooks(NULL)
+    {
+    }
+
+    void SetProfilerHooks(const ProfilerHooks* pProfilerHooks)
+    {
+        m_pProfilerHooks = pProfilerHooks;
+    }
+
+    void Reset()
+    {
+        m_GPUTimes.Reset();
+        m_CPUTimes.Reset();
+    }
+
+    void Add(const RenderTimes& Frame);
+
+    void Add(const CPUTimes& Frame);
+
+    void GetRenderTimes(GFSDK_SSAO_RenderTimes* pRenderTimes) const;
+
+    UINT GetNumFrames() const
+    {
+        return m_GPUTimes.GetNumFrames();
+    }
+
+    UINT GetNumCPUFrames() const
+    {
+        return m_CPUTimes.GetNumFrames();
+    }
+
+private:
+    TimesHistory<REGIME_TIME_COUNT> m_GPUTimes;
+    TimesHistory<CPU_TIME_COUNT> m_CPUTimes;
+    const ProfilerHooks* m_pProfilerHooks;
+};
+
+//--------------------------------------------------------------------------------
+// Accumulates the host time of a scope into one phase of the current RenderAO call
+class CPUTimer
+{
+public:
+    CPUTimer(CPUTimes* pCPUTimes, CpuTimeRegimeIndex Id)
+        : m_pCPUTimes(pCPUTimes)
+        , m_CpuTimeRegimeIndex(Id)
+        , m_BeginTimeNS(GetHostTimeNS())
+    {
+    }
+
+    ~CPUTimer()
+    {
+        m_pCPUTimes->TimeMS[m_CpuTimeRegimeIndex] += GetHostTimeMS(m_BeginTimeNS, GetHostTimeNS());
+    }
+
+private:
+    CPUTimes* m_pCPUTimes;
+    CpuTimeRegimeIndex m_CpuTimeRegimeIndex;
+    GFSDK_SSAO_UINT64 m_BeginTimeNS;
+};
+
+//--------------------------------------------------------------------------------
+// Times a whole RenderAO call. The phases are added to the history by End,
+// which the renderers only call once RenderAO is about to return GFSDK_SSAO_OK.
+//--------------------------------------------------------------------------------
+class CPUFrameTimer
+{
+public:
+    CPUFrameTimer(CPUTimes* pCPUTimes)
+        : m_pCPUTimes(pCPUTimes)
+        , m_BeginTimeNS(GetHostTimeNS())
+    {
+        *m_pCPUTimes = CPUTimes();
+    }
+
+    void End(RenderTimesHistory* pRenderTimes)
+    {
+        m_pCPUTimes->TimeMS[CPU_TIME_TOTAL] = GetHostTimeMS(m_BeginTimeNS, GetHostTimeNS());
+        pRenderTimes->Add(*m_pCPUTimes);
+    }
+
+private:
+    CPUTimes* m_pCPUTimes;
+    GFSDK_SSAO_UINT64 m_BeginTimeNS;
+};
+
+#if ENABLE_CPU_TIMERS
+#define CPU_TIMER_SCOPE(NAME)       GFSDK::SSAO::CPUTimer CPUTimer_ ## NAME(&m_CPUTimes, GFSDK::SSAO::CPU_TIME_ ## NAME)
+#define CPU_FRAME_TIMER_BEGIN()     GFSDK::SSAO::CPUFrameTimer FrameCPUTimer(&m_CPUTimes)
+#define CPU_FRAME_TIMER_END()       FrameCPUTimer.End(&m_RenderTimes)
+#else
+#define CPU_TIMER_SCOPE(NAME)
+#define CPU_FRAME_TIMER_BEGIN()
+#define CPU_FRAME_TIMER_END()
+#endif
+
+//--------------------------------------------------------------------------------
+// Ring of FRAMES_IN_FLIGHT query sets, one per frame whose timestamps have not been read back yet.
+// Each backend owns the queries of the slots; the ring decides which slot a frame records into,
+// and the slots are read back from the oldest one, in submission order.
+//--------------------------------------------------------------------------------
+class TimestampQueryRing
+{
+public:
+    static const UINT FRAMES_IN_FLIGHT = GFSDK_SSAO_RENDER_TIMES_FRAMES_IN_FLIGHT;
+
+    TimestampQueryRing()
+    {
+        Reset();
+    }
+
+    void Reset()
+    {
+        m_WriteSlot = 0;
+        m_NumInFlight = 0;
+        m_Recording = false;
+    }
+
+    // Returns false if all the slots are in flight, in which case the frame is not timed
+    bool BeginFrame()
+    {
+        m_Recording = (m_NumInFlight < FRAMES_IN_FLIGHT);
+        return m_Recording;
+    }
+
+    // Puts the slot of the recorded frame in flight, unless nothing was recorded in it
+    void EndFrame(bool Submit)
+    {
+        if (m_Recording && Submit)
+        {
+            m_WriteSlot = (m_WriteSlot + 1) % FRAMES_IN_FLIGHT;
+            ++m_NumInFlight;
+        }
+        m_Recording = false;
+    }
+
+    // Frees the oldest slot, once its timestamps have been read back
+    void PopOldestSlot()
+    {
+        ASSERT(m_NumInFlight);
+        --m_NumInFlight;
+    }
+
+    bool IsRecording() const
+    {
+        return m_Recording;
+    }
+
+    UINT GetWriteSlot() const
+    {
+        return m_WriteSlot;
+    }
+
+    UINT GetOldestSlot() const
+    {
+        return (m_WriteSlot + FRAMES_IN_FLIGHT - m_NumInFlight) % FRAMES_IN_FLIGHT;
+    }
+
+    UINT GetNewestSlot() const
+    {
+        return (m_WriteSlot + FRAMES_IN_FLIGHT - 1) % FRAMES_IN_FLIGHT;
+    }
+
+    UINT GetNumInFlight() const
+    {
+        return m_NumInFlight;
+    }
+
+private:
+    UINT m_WriteSlot;
+    UINT m_NumInFlight;
+    bool m_Recording;
+};
+
+} // namespace SSAO
+} // namespace GFSDK
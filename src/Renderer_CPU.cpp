@@ -0,0 +1,734 @@
+// This code contains NVIDIA Confidential Information and is disclosed to you
+// under a form of NVIDIA software license agreement provided separately to you.
+//
+// Notice
+// NVIDIA Corporation and its licensors retain all intellectual property and
+// proprietary rights in and to this software and related documentation and
+// any modifications thereto. Any use, reproduction, disclosure, or
+// distribution of this software and related documentation without an express
+// license agreement from NVIDIA Corporation is strictly prohibited.
+//
+// ALL NVIDIA DESIGN SPECIFICATIONS, CODE ARE PROVIDED "AS IS.". NVIDIA MAKES
+// NO WARRANTIES, EXPRESSED, IMPLIED, STATUTORY, OR OTHERWISE WITH RESPECT TO
+// THE MATERIALS, AND EXPRESSLY DISCLAIMS ALL IMPLIED WARRANTIES OF NONINFRINGEMENT,
+// MERCHANTABILITY, AND FITNESS FOR A PARTICULAR PURPOSE.
+//
+// Information and code furnished is believed to be accurate and reliable.
+// However, NVIDIA Corporation assumes no responsibility for the consequences of use of such
+// information or for any infringement of patents or other rights of third parties that may
+// result from its use. No license is granted by implication or otherwise under any patent
+// or patent rights of NVIDIA Corporation. Details are subject to change without notice.
+// This code supersedes and replaces all information previously supplied.
+// NVIDIA Corporation products are not authorized for use as critical
+// components in life support devices or systems without express written approval of
+// NVIDIA Corporation.
+//
+// Copyright (c) 2008-2021 NVIDIA Corporation. All rights reserved.
+
+#if SUPPORT_CPU
+
+#include "Renderer_CPU.h"
+
+#include <system_error>
+
+//--------------------------------------------------------------------------------
+void GFSDK::SSAO::CPU::Renderer::CreateResources(const GFSDK_SSAO_ContextDesc_CPU& ContextDesc)
+{
+    m_Shaders.Create(ContextDesc.MaxInstructionSet);
+    m_PerPassCBs.Create();
+    m_ThreadPool.Create(m_NewDelete, ContextDesc.NumThreads, ContextDesc.AffinityMask);
+    m_TaskGraph.Create(m_NewDelete, m_ThreadPool.GetNumThreads());
+}
+
+//--------------------------------------------------------------------------------
+void GFSDK::SSAO::CPU::Renderer::ReleaseResources()
+{
+    m_Shaders.Release();
+    m_RTs.Release();
+    m_TaskGraph.Release(m_NewDelete);
+    m_ThreadPool.Release(m_NewDelete);
+}
+
+//--------------------------------------------------------------------------------
+UINT GFSDK::SSAO::CPU::Renderer::DrawLinearDepthPS()
+{
+    LinearizeDepthArgs& Args = m_PassArgs.LinearizeDepth;
+    Args.pGlobalCB = &m_GlobalCB.GetCB();
+    Args.ViewDepths = (m_InputDepth.DepthTextureType == GFSDK_SSAO_VIEW_DEPTHS);
+    Args.DepthTexture[0] = GetSRV(m_InputDepth.Texture0);
+    Args.DepthTexture[1] = GetSRV(m_InputDepth.Texture1);
+    Args.ViewDepthTexture[0] = m_RTs.GetFullResViewDepthTexture()->RTV;
+
+    if (m_Options.EnableDualLayerAO)
+    {
+        Args.ViewDepthTexture[1] = m_RTs.GetFullResViewDepthTexture2()->RTV;
+    }
+
+    return m_TaskGraph.AddPass(m_Shaders.LinearizeDepth_PS.Get(GetDepthLayerCountPermutation()), &Args, 1, UINT(m_Viewports.FullRes.Height), TILE_HEIGHT, REGIME_TIME_LINEAR_Z);
+}
+
+//--------------------------------------------------------------------------------
+UINT GFSDK::SSAO::CPU::Renderer::DrawDeinterleavedDepthPS()
+{
+    DeinterleaveDepthArgs& Args = m_PassArgs.DeinterleaveDepth;
+    Args.pGlobalCB = &m_GlobalCB.GetCB();
+    Args.ViewDepthTexture[0] = m_RTs.GetFullResViewDepthTexture()->SRV;
+    Args.ViewDepthTexture[1] = GetFullResViewDepthTexture2SRV();
+    Args.HalfViewDepths = RenderTargets::UseHalfViewDepths(m_Options);
+
+    for (UINT SliceIndex = 0; SliceIndex < 16; ++SliceIndex)
+    {
+        if (Args.HalfViewDepths)
+        {
+            Args.QuarterResHalfViewDepthTexture[SliceIndex] = m_RTs.GetQuarterResHalfViewDepthTextureArray(m_Options)->RTVs[SliceIndex];
+        }
+        else
+        {
+            Args.QuarterResViewDepthTexture[SliceIndex] = m_RTs.GetQuarterResViewDepthTextureArray(m_Options)->RTVs[SliceIndex];
+        }
+    }
+
+    return m_TaskGraph.AddPass(m_Shaders.DeinterleaveDepth_PS.Get(GetDepthLayerCountPermutation()), &Args, 1, UINT(m_Viewports.QuarterRes.Height), TILE_HEIGHT, REGIME_TIME_DEINTERLEAVE_Z);
+}
+
+//--------------------------------------------------------------------------------
+UINT GFSDK::SSAO::CPU::Renderer::DrawLinearDeinterleavedDepthPS()
+{
+    LinearizeDeinterleaveDepthArgs& Args = m_PassArgs.LinearizeDeinterleaveDepth;
+    Args.pGlobalCB = &m_GlobalCB.GetCB();
+    Args.ViewDepths = (m_InputDepth.DepthTextureType == GFSDK_SSAO_VIEW_DEPTHS);
+    Args.DepthTexture[0] = GetSRV(m_InputDepth.Texture0);
+    Args.DepthTexture[1] = GetSRV(m_InputDepth.Texture1);
+    Args.Width = UINT(m_Viewports.FullRes.Width);
+    Args.Height = UINT(m_Viewports.FullRes.Height);
+    Args.HalfViewDepths = RenderTargets::UseHalfViewDepths(m_Options);
+
+    for (UINT SliceIndex = 0; SliceIndex < 16; ++SliceIndex)
+    {
+        if (Args.HalfViewDepths)
+        {
+            Args.QuarterResHalfViewDepthTexture[SliceIndex] = m_RTs.GetQuarterResHalfViewDepthTextureArray(m_Options)->RTVs[SliceIndex];
+        }
+        else
+        {
+            Args.QuarterResViewDepthTexture[SliceIndex] = m_RTs.GetQuarterResViewDepthTextureArray(m_Options)->RTVs[SliceIndex];
+        }
+    }
+
+    return m_TaskGraph.AddPass(m_Shaders.LinearizeDeinterleaveDepth_PS.Get(GetDepthLayerCountPermutation()), &Args, 1, UINT(m_Viewports.QuarterRes.Height), TILE_HEIGHT, REGIME_TIME_LINEAR_Z);
+}
+
+//--------------------------------------------------------------------------------
+UINT GFSDK::SSAO::CPU::Renderer::DrawReconstructedNormalPS()
+{
+    ReconstructNormalArgs& Args = m_PassArgs.ReconstructNormal;
+    Args.pGlobalCB = &m_GlobalCB.GetCB();
+    Args.DepthClampMode = m_Options.DepthClampMode;
+    Args.ViewDepthTexture = m_RTs.GetFullResViewDepthTexture()->SRV;
+    Args.NormalTexture = m_RTs.GetFullResNormalTexture()->RTV;
+
+    return m_TaskGraph.AddPass(m_Shaders.ReconstructNormal_PS.Get(), &Args, 1, UINT(m_Viewports.FullRes.Height), TILE_HEIGHT, REGIME_TIME_NORMAL);
+}
+
+//--------------------------------------------------------------------------------
+UINT GFSDK::SSAO::CPU::Renderer::DrawDebugNormalsPS()
+{
+    DebugNormalsArgs& Args = m_PassArgs.DebugNormals;
+    Args.pGlobalCB = &m_GlobalCB.GetCB();
+    Args.DepthClampMode = m_Options.DepthClampMode;
+    Args.ViewDepthTexture = m_RTs.GetFullResViewDepthTexture()->SRV;
+    Args.NormalTexture = GetSRV(m_InputNormal.Texture);
+
+    // Blending disabled
+    Args.Output = GetOutputMergerState(GFSDK_SSAO_OVERWRITE_RGB);
+
+    return m_TaskGraph.AddPass(m_Shaders.DebugNormals_PS.Get(GetFetchNormalPermutation()), &Args, 1, UINT(m_InputDepth.Viewport.Height), TILE_HEIGHT, REGIME_TIME_NORMAL);
+}
+
+//--------------------------------------------------------------------------------
+UINT GFSDK::SSAO::CPU::Renderer::DrawCoarseAOPS()
+{
+    // The 16 slices are independent, and are rendered as a single pass of (slice, tile) tasks
+    CoarseAOArgs* Args = m_PassArgs.CoarseAO;
+
+    for (UINT SliceIndex = 0; SliceIndex < 16; ++SliceIndex)
+    {
+        Args[SliceIndex].pGlobalCB = &m_GlobalCB.GetCB();
+        Args[SliceIndex].pPerPassCB = &m_PerPassCBs.GetCB(SliceIndex);
+        Args[SliceIndex].DepthClampMode = m_Options.DepthClampMode;
+        Args[SliceIndex].HalfViewDepths = RenderTargets::UseHalfViewDepths(m_Options);
+        if (Args[SliceIndex].HalfViewDepths)
+        {
+            Args[SliceIndex].QuarterResHalfViewDepthTexture = m_RTs.GetQuarterResHalfViewDepthTextureArray(m_Options)->SRVs[SliceIndex];
+        }
+        else
+        {
+            Args[SliceIndex].QuarterResViewDepthTexture = m_RTs.GetQuarterResViewDepthTextureArray(m_Options)->SRVs[SliceIndex];
+        }
+        Args[SliceIndex].NormalTexture = GetFullResNormalBufferSRV();
+        Args[SliceIndex].AOTexture = m_RTs.GetQuarterResAOTextureArray()->RTVs[SliceIndex];
+    }
+
+    return m_TaskGraph.AddPass(m_Shaders.CoarseAO_PS.Get(GetFetchNormalPermutation(), GetDepthLayerCountPermutation(), GetNumStepsPermutation()), Args, 16, UINT(m_Viewports.QuarterRes.Height), TILE_HEIGHT, REGIME_TIME_COARSE_AO);
+}
+
+//--------------------------------------------------------------------------------
+UINT GFSDK::SSAO::CPU::Renderer::DrawReinterleavedAOPS()
+{
+    ASSERT(!m_Options.Blur.Enable);
+
+    ReinterleaveAOArgs& Args = m_PassArgs.ReinterleaveAO;
+    Args.pGlobalCB = &m_GlobalCB.GetCB();
+    Args.Output = GetOutputMergerState();
+    Args.Width = UINT(m_InputDepth.Viewport.Width);
+    Args.Height = UINT(m_InputDepth.Viewport.Height);
+
+    for (UINT SliceIndex = 0; SliceIndex < 16; ++SliceIndex)
+    {
+        Args.AOTexture[SliceIndex] = m_RTs.GetQuarterResAOTextureArray()->SRVs[SliceIndex];
+    }
+
+    return m_TaskGraph.AddPass(m_Shaders.ReinterleaveAO_PS.Get(GetEnableBlurPermutation(), GetDepthLayerCountPermutation()), &Args, 1, Args.Height, TILE_HEIGHT, REGIME_TIME_INTERLEAVE_AO);
+}
+
+//--------------------------------------------------------------------------------
+UINT GFSDK::SSAO::CPU::Renderer::DrawReinterleavedAOPS_PreBlur(bool FullResViewDepths)
+{
+    ASSERT(m_Options.Blur.Enable);
+
+    ReinterleaveAOArgs& Args = m_PassArgs.ReinterleaveAO;
+    Args.pGlobalCB = &m_GlobalCB.GetCB();
+    Args.DeinterleavedViewDepths = !FullResViewDepths;
+    if (FullResViewDepths)
+    {
+        Args.ViewDepthTexture[0] = m_RTs.GetFullResViewDepthTexture()->SRV;
+        Args.ViewDepthTexture[1] = GetFullResViewDepthTexture2SRV();
+    }
+    else
+    {
+        // With FP16 view depths, the blur weights use the FP16 depths, as read by CoarseAO
+        Args.HalfViewDepths = RenderTargets::UseHalfViewDepths(m_Options);
+
+        for (UINT SliceIndex = 0; SliceIndex < 16; ++SliceIndex)
+        {
+            if (Args.HalfViewDepths)
+            {
+                Args.QuarterResHalfViewDepthTexture[SliceIndex] = m_RTs.GetQuarterResHalfViewDepthTextureArray(m_Options)->SRVs[SliceIndex];
+            }
+            else
+            {
+                Args.QuarterResViewDepthTexture[SliceIndex] = m_RTs.GetQuarterResViewDepthTextureArray(m_Options)->SRVs[SliceIndex];
+            }
+        }
+    }
+    Args.AOZTexture = m_RTs.GetFullResAOZTexture2()->RTV;
+    Args.Width = UINT(m_Viewports.FullRes.Width);
+    Args.Height = UINT(m_Viewports.FullRes.Height);
+
+    for (UINT SliceIndex = 0; SliceIndex < 16; ++SliceIndex)
+    {
+        Args.AOTexture[SliceIndex] = m_RTs.GetQuarterResAOTextureArray()->SRVs[SliceIndex];
+    }
+
+    return m_TaskGraph.AddPass(m_Shaders.ReinterleaveAO_PS.Get(GetEnableBlurPermutation(), GetDepthLayerCountPermutation()), &Args, 1, Args.Height, TILE_HEIGHT, REGIME_TIME_INTERLEAVE_AO);
+}
+
+//--------------------------------------------------------------------------------
+UINT GFSDK::SSAO::CPU::Renderer::DrawBlurPS()
+{
+    BlurArgs& Args = m_PassArgs.Blur;
+    Args.pGlobalCB = &m_GlobalCB.GetCB();
+    Args.AOZTexture = m_RTs.GetFullResAOZTexture2()->SRV;
+    Args.Output = GetOutputMergerState();
+
+    return m_TaskGraph.AddPass(m_Shaders.Blur_PS.Get(GetBlurKernelRadiusPermutation(), GetEnableSharpnessProfilePermutation()), &Args, 1, UINT(m_InputDepth.Viewport.Height), BLUR_TILE_HEIGHT, REGIME_TIME_BLURX);
+}
+
+//--------------------------------------------------------------------------------
+UINT GFSDK::SSAO::CPU::Renderer::DrawLineSweepAOPS(UINT DirectionIndex)
+{
+    LineSweepAOArgs& Args = m_PassArgs.LineSweepAO[DirectionIndex];
+    Args.pGlobalCB = &m_GlobalCB.GetCB();
+    Args.DirectionIndex = DirectionIndex;
+    Args.ViewDepthTexture[0] = m_RTs.GetFullResViewDepthTexture()->SRV;
+    Args.ViewDepthTexture[1] = GetFullResViewDepthTexture2SRV();
+    Args.NormalTexture = GetFullResNormalBufferSRV();
+    Args.AOTexture = m_RTs.GetFullResAOTexture()->RTV;
+
+    // The tasks of this pass are tiles of lines instead of tiles of rows
+    const LineSweepLines Lines(DirectionIndex, UINT(m_Viewports.FullRes.Width), UINT(m_Viewports.FullRes.Height));
+
+    return m_TaskGraph.AddPass(m_Shaders.LineSweepAO_PS.Get(GetFetchNormalPermutation(), GetDepthLayerCountPermutation()), &Args, 1, Lines.GetNumLines(), TILE_HEIGHT, REGIME_TIME_COARSE_AO);
+}
+
+//--------------------------------------------------------------------------------
+UINT GFSDK::SSAO::CPU::Renderer::DrawLineSweepResolvePS()
+{
+    LineSweepResolveArgs& Args = m_PassArgs.LineSweepResolve;
+    Args.pGlobalCB = &m_GlobalCB.GetCB();
+    Args.AOTexture = m_RTs.GetFullResAOTexture()->SRV;
+    Args.ViewDepthTexture = m_RTs.GetFullResViewDepthTexture()->SRV;
+    if (m_Options.Blur.Enable)
+    {
+        Args.AOZTexture = m_RTs.GetFullResAOZTexture2()->RTV;
+    }
+    else
+    {
+        Args.Output = GetOutputMergerState();
+    }
+
+    return m_TaskGraph.AddPass(m_Shaders.LineSweepResolve_PS.Get(GetEnableBlurPermutation(), GetNumStepsPermutation()), &Args, 1, UINT(m_Viewports.FullRes.Height), TILE_HEIGHT, REGIME_TIME_INTERLEAVE_AO);
+}
+
+//--------------------------------------------------------------------------------
+void GFSDK::SSAO::CPU::Renderer::RenderHBAOPlus(GFSDK_SSAO_RenderMask RenderMask)
+{
+    // The passes are recorded into a graph of row tiles, and each tile starts as soon as the tiles
+    // of the previous passes it reads from are written, instead of waiting for full-frame barriers
+    m_TaskGraph.Reset();
+    m_PassArgs = PassArgs();
+
+    const bool FullResViewDepths = NeedsFullResViewDepths(RenderMask);
+
+    UINT LinearDepthPass = TaskGraph::NO_PASS;
+    UINT DeinterleavedDepthPass = TaskGraph::NO_PASS;
+    if (!FullResViewDepths)
+    {
+        DeinterleavedDepthPass = DrawLinearDeinterleavedDepthPS();
+    }
+    else if (RenderMask & GFSDK_SSAO_DRAW_Z)
+    {
+        LinearDepthPass = DrawLinearDepthPS();
+    }
+
+    if (RenderMask & GFSDK_SSAO_DRAW_DEBUG_N)
+    {
+        const UINT DebugNormalsPass = DrawDebugNormalsPS();
+        m_TaskGraph.AddDependency(DebugNormalsPass, LinearDepthPass, 1, 1, 1);
+    }
+
+    if (RenderMask & GFSDK_SSAO_DRAW_AO)
+    {
+        // Quarter-res row Y reads the full-res rows [4*Y, 4*Y+3]
+        if (FullResViewDepths && m_Options.Algorithm != GFSDK_SSAO_LINE_SWEEP)
+        {
+            DeinterleavedDepthPass = DrawDeinterleavedDepthPS();
+            m_TaskGraph.AddDependency(DeinterleavedDepthPass, LinearDepthPass, 4, 1, 0);
+        }
+
+        // The normal of a pixel is reconstructed from its 4 neighbors
+        UINT ReconstructedNormalPass = TaskGraph::NO_PASS;
+        if (!m_InputNormal.Texture.IsSet())
+        {
+            ReconstructedNormalPass = DrawReconstructedNormalPS();
+            m_TaskGraph.AddDependency(ReconstructedNormalPass, LinearDepthPass, 1, 1, 1);
+        }
+
+        if (m_Options.Algorithm == GFSDK_SSAO_LINE_SWEEP)
+        {
+            // Each line crosses the whole image, so the first sweep waits for all the depths and normals,
+            // and the sweeps accumulate into the same AO texture one after the other
+            UINT PrevPass = TaskGraph::NO_PASS;
+            for (UINT DirectionIndex = 0; DirectionIndex < NUM_DIRECTIONS / 2; ++DirectionIndex)
+            {
+                const UINT LineSweepAOPass = DrawLineSweepAOPS(DirectionIndex);
+                if (PrevPass == TaskGraph::NO_PASS)
+                {
+                    m_TaskGraph.AddPassDependency(LineSweepAOPass, LinearDepthPass);
+                    m_TaskGraph.AddPassDependency(LineSweepAOPass, ReconstructedNormalPass);
+                }
+                else
+                {
+                    m_TaskGraph.AddPassDependency(LineSweepAOPass, PrevPass);
+                }
+                PrevPass = LineSweepAOPass;
+            }
+
+            // The lines of the last sweep are not aligned with the rows
+            const UINT ResolvePass = DrawLineSweepResolvePS();
+            m_TaskGraph.AddPassDependency(ResolvePass, PrevPass);
+
+            if (m_Options.Blur.Enable)
+            {
+                const UINT KernelRadius = (m_Options.Blur.Radius == GFSDK_SSAO_BLUR_RADIUS_2) ? 2 : 4;
+                const UINT BlurPass = DrawBlurPS();
+                m_TaskGraph.AddDependency(BlurPass, ResolvePass, 1, 1, KernelRadius);
+            }
+        }
+        else
+        {
+            // The AO rays are not bounded in screen space (RadiusPixels grows as ViewDepth decreases),
+            // so each slice tile waits for the whole deinterleaved-depth pass, but only for the normals
+            // of its own rows
+            const UINT CoarseAOPass = DrawCoarseAOPS();
+            m_TaskGraph.AddPassDependency(CoarseAOPass, DeinterleavedDepthPass);
+            m_TaskGraph.AddDependency(CoarseAOPass, ReconstructedNormalPass, 4, 1, 0);
+
+            // Full-res row Y reads the quarter-res row Y/4 of all the slices
+            if (m_Options.Blur.Enable)
+            {
+                // Without full-res view depths, the depth slices are read after CoarseAO has waited for them
+                const UINT ReinterleavedAOPass = DrawReinterleavedAOPS_PreBlur(FullResViewDepths);
+                m_TaskGraph.AddDependency(ReinterleavedAOPass, CoarseAOPass, 1, 4, 0);
+                m_TaskGraph.AddDependency(ReinterleavedAOPass, LinearDepthPass, 1, 1, 0);
+
+                // The blur reads KernelRadius rows above and below each output row
+                const UINT KernelRadius = (m_Options.Blur.Radius == GFSDK_SSAO_BLUR_RADIUS_2) ? 2 : 4;
+                const UINT BlurPass = DrawBlurPS();
+                m_TaskGraph.AddDependency(BlurPass, ReinterleavedAOPass, 1, 1, KernelRadius);
+            }
+            else
+            {
+                const UINT ReinterleavedAOPass = DrawReinterleavedAOPS();
+                m_TaskGraph.AddDependency(ReinterleavedAOPass, CoarseAOPass, 1, 4, 0);
+            }
+        }
+    }
+
+    ASSERT(m_TaskGraph.GetNumPasses() <= MAX_NUM_GRAPH_PASSES);
+    ASSERT(m_TaskGraph.GetNumDependencies() <= MAX_NUM_GRAPH_DEPENDENCIES);
+
+    m_TaskGraph.Run(m_ThreadPool, m_NewDelete, m_ProfilerHooks);
+}
+
+//--------------------------------------------------------------------------------
+GFSDK_SSAO_Status GFSDK::SSAO::CPU::Renderer::Render(GFSDK_SSAO_RenderMask RenderMask)
+{
+    const GFSDK_SSAO_UINT64 BeginTimeNS = GetHostTimeNS();
+
+    PROFILER_RANGE_SCOPE(NULL, TOTAL);
+
+    m_GlobalCB.UpdateBuffer(RenderMask);
+
+#if ENABLE_EXCEPTIONS
+    try
+    {
+        RenderHBAOPlus(RenderMask);
+    }
+    catch (...)
+    {
+        return GFSDK_SSAO_MEMORY_ALLOCATION_FAILED;
+    }
+#else
+    RenderHBAOPlus(RenderMask);
+#endif
+
+    SSAO::RenderTimes FrameTimes;
+    m_TaskGraph.GetRenderTimes(&FrameTimes);
+    FrameTimes.TimeMS[REGIME_TIME_TOTAL] = GetHostTimeMS(BeginTimeNS, GetHostTimeNS());
+    m_RenderTimes.Add(FrameTimes);
+
+    return GFSDK_SSAO_OK;
+}
+
+//--------------------------------------------------------------------------------
+void GFSDK::SSAO::CPU::Renderer::SetAOResolution(UINT Width, UINT Height)
+{
+    if (Width  != m_RTs.GetFullWidth() ||
+        Height != m_RTs.GetFullHeight())
+    {
+        m_RTs.ReleaseResources();
+        m_RTs.SetFullResolution(Width, Height);
+        m_Viewports.SetFullResolution(Width, Height);
+        m_GlobalCB.SetResolutionConstants(m_Viewports);
+    }
+}
+
+//--------------------------------------------------------------------------------
+void GFSDK::SSAO::CPU::Renderer::SetAOResolution(const SSAO::InputViewport &Viewport)
+{
+    SetAOResolution(UINT(Viewport.Width), UINT(Viewport.Height));
+}
+
+//--------------------------------------------------------------------------------
+GFSDK_SSAO_Status GFSDK::SSAO::CPU::Renderer::PreCreateRTs(
+    const GFSDK_SSAO_Parameters& Parameters,
+    UINT ViewportWidth,
+    UINT ViewportHeight)
+{
+    SetAOResolution(ViewportWidth, ViewportHeight);
+
+    m_Options = Parameters;
+
+    return m_RTs.PreCreate(m_Options, m_InputNormal.Texture.IsSet());
+}
+
+//--------------------------------------------------------------------------------
+GFSDK_SSAO_Status GFSDK::SSAO::CPU::Renderer::GetProjectionMatrixDepthRange(
+    const GFSDK_SSAO_InputData_CPU& InputData,
+    GFSDK_SSAO_ProjectionMatrixDepthRange& OutputDepthRange)
+{
+    GFSDK_SSAO_Status Status;
+
+    SSAO::ProjectionMatrixInfo ProjectionMatrixInfo;
+    Status = ProjectionMatrixInfo.Init(InputData.DepthData.ProjectionMatrix, API_D3D11);
+    if (Status != GFSDK_SSAO_OK)
+    {
+        return Status;
+    }
+
+    ProjectionMatrixInfo.GetDepthRange(&OutputDepthRange);
+
+    return GFSDK_SSAO_OK;
+}
+
+//--------------------------------------------------------------------------------
+GFSDK_SSAO_Status GFSDK::SSAO::CPU::Renderer::RenderAO(
+    const GFSDK_SSAO_InputData_CPU& InputData,
+    const GFSDK_SSAO_Parameters& Parameters,
+    const GFSDK_SSAO_Output_CPU& Output,
+    GFSDK_SSAO_RenderMask RenderMask)
+{
+    GFSDK_SSAO_Status Status;
+
+    CPU_FRAME_TIMER_BEGIN();
+
+    {
+        CPU_TIMER_SCOPE(SET_DATA_FLOW);
+        Status = SetDataFlow(InputData, Parameters, Output);
+    }
+    if (Status != GFSDK_SSAO_OK)
+    {
+        return Status;
+    }
+
+    Status = m_RTs.PreCreate(m_Options, m_InputNormal.Texture.IsSet());
+    if (Status != GFSDK_SSAO_OK)
+    {
+        return Status;
+    }
+
+    {
+        CPU_TIMER_SCOPE(RENDER);
+        Status = Render(RenderMask);
+    }
+    if (Status != GFSDK_SSAO_OK)
+    {
+        return Status;
+    }
+
+    CPU_FRAME_TIMER_END();
+
+    return GFSDK_SSAO_OK;
+}
+
+//--------------------------------------------------------------------------------
+GFSDK_SSAO_Status GFSDK::SSAO::CPU::Renderer::SetInputData(const GFSDK_SSAO_InputData_CPU& InputData)
+{
+    GFSDK_SSAO_Status Status;
+
+    Status = SetInputDepths(InputData.DepthData);
+    if (Status != GFSDK_SSAO_OK)
+    {
+        return Status;
+    }
+
+    Status = SetInputNormals(InputData.NormalData);
+    if (Status != GFSDK_SSAO_OK)
+    {
+        return Status;
+    }
+
+    return GFSDK_SSAO_OK;
+}
+
+//--------------------------------------------------------------------------------
+GFSDK_SSAO_Status GFSDK::SSAO::CPU::Renderer::SetDataFlow(
+    const GFSDK_SSAO_InputData_CPU& InputData,
+    const GFSDK_SSAO_Parameters& Parameters,
+    const GFSDK_SSAO_Output_CPU& Output)
+{
+    GFSDK_SSAO_Status Status;
+
+    Status = SetInputData(InputData);
+    if (Status != GFSDK_SSAO_OK)
+    {
+        return Status;
+    }
+
+    Status = SetAOParameters(Parameters);
+    if (Status != GFSDK_SSAO_OK)
+    {
+        return Status;
+    }
+
+    Status = SetOutput(Output);
+    if (Status != GFSDK_SSAO_OK)
+    {
+        return Status;
+    }
+
+    Status = ValidateDataFlow();
+    if (Status != GFSDK_SSAO_OK)
+    {
+        return Status;
+    }
+
+    return GFSDK_SSAO_OK;
+}
+
+//--------------------------------------------------------------------------------
+GFSDK_SSAO_Status GFSDK::SSAO::CPU::Renderer::SetInputDepths(const GFSDK_SSAO_InputDepthData_CPU& DepthData)
+{
+    m_InputDepth = GFSDK::SSAO::CPU::InputDepthInfo();
+
+    GFSDK_SSAO_Status Status = m_InputDepth.SetData(DepthData);
+    if (Status != GFSDK_SSAO_OK)
+    {
+        return Status;
+    }
+
+    m_GlobalCB.SetDepthData(m_InputDepth);
+
+    SetAOResolution(m_InputDepth.Viewport);
+
+    return GFSDK_SSAO_OK;
+}
+
+//--------------------------------------------------------------------------------
+GFSDK_SSAO_Status GFSDK::SSAO::CPU::Renderer::SetInputNormals(const GFSDK_SSAO_InputNormalData_CPU& NormalData)
+{
+    m_InputNormal = GFSDK::SSAO::CPU::InputNormalInfo();
+
+    if (!NormalData.Enable)
+    {
+        // Input normals disabled. In this case, the lib reconstructs normals from depths.
+        return GFSDK_SSAO_OK;
+    }
+
+    GFSDK_SSAO_Status Status = m_InputNormal.SetData(NormalData);
+    if (Status != GFSDK_SSAO_OK)
+    {
+        return Status;
+    }
+
+    m_GlobalCB.SetNormalData(NormalData);
+
+    return GFSDK_SSAO_OK;
+}
+
+//--------------------------------------------------------------------------------
+GFSDK_SSAO_Status GFSDK::SSAO::CPU::Renderer::SetOutput(const GFSDK_SSAO_Output_CPU& Output)
+{
+    m_Output = GFSDK::SSAO::CPU::OutputInfo();
+
+    GFSDK_SSAO_Status Status = m_Output.Init(Output);
+    if (Status != GFSDK_SSAO_OK)
+    {
+        return Status;
+    }
+
+    return GFSDK_SSAO_OK;
+}
+
+//--------------------------------------------------------------------------------
+GFSDK_SSAO_Status GFSDK::SSAO::CPU::Renderer::ValidateDataFlow()
+{
+    if (m_InputNormal.Texture.IsSet())
+    {
+        if (m_InputNormal.Texture.Width    != m_InputDepth.Texture0.Width ||
+            m_InputNormal.Texture.Height   != m_InputDepth.Texture0.Height)
+        {
+            return GFSDK_SSAO_INVALID_NORMAL_TEXTURE_RESOLUTION;
+        }
+        if (m_InputNormal.Texture.SampleCount != m_InputDepth.Texture0.SampleCount)
+        {
+            return GFSDK_SSAO_INVALID_NORMAL_TEXTURE_SAMPLE_COUNT;
+        }
+    }
+
+    if (m_Options.EnableDualLayerAO && !m_InputDepth.Texture1.IsSet())
+    {
+        return GFSDK_SSAO_NO_SECOND_LAYER_PROVIDED;
+    }
+
+    return GFSDK_SSAO_OK;
+}
+
+//--------------------------------------------------------------------------------
+GFSDK_SSAO_Status GFSDK::SSAO::CPU::Renderer::SetAOParameters(const GFSDK_SSAO_Parameters& Params)
+{
+    if (Params.Blur.Enable != m_Options.Blur.Enable ||
+        Params.DepthStorage != m_Options.DepthStorage ||
+        Params.EnableDualLayerAO != m_Options.EnableDualLayerAO ||
+        Params.Algorithm != m_Options.Algorithm)
+    {
+        m_RTs.ReleaseResources();
+    }
+
+    {
+        CPU_TIMER_SCOPE(SET_AO_PARAMETERS);
+        m_GlobalCB.SetAOParameters(Params, m_InputDepth);
+    }
+    m_Options = Params;
+
+    return GFSDK_SSAO_OK;
+}
+
+//--------------------------------------------------------------------------------
+GFSDK_SSAO_Status GFSDK::SSAO::CPU::Renderer::Create(const GFSDK_SSAO_ContextDesc_CPU& ContextDesc, GFSDK_SSAO_Version HeaderVersion)
+{
+    if (!m_BuildVersion.Match(HeaderVersion))
+    {
+        return GFSDK_SSAO_VERSION_MISMATCH;
+    }
+
+#if ENABLE_EXCEPTIONS
+    try
+    {
+        CreateResources(ContextDesc);
+    }
+    catch (const std::system_error&)
+    {
+        // Thrown by the constructor of std::thread
+        ReleaseResources();
+
+        return GFSDK_SSAO_CPU_THREAD_CREATION_FAILED;
+    }
+    catch (...)
+    {
+        ReleaseResources();
+
+        return GFSDK_SSAO_MEMORY_ALLOCATION_FAILED;
+    }
+#else
+    CreateResources(ContextDesc);
+#endif
+
+    return GFSDK_SSAO_OK;
+}
+
+//--------------------------------------------------------------------------------
+void GFSDK::SSAO::CPU::Renderer::Release()
+{
+    ReleaseResources();
+
+    m_NewDelete.delete_(this);
+}
+
+//--------------------------------------------------------------------------------
+UINT GFSDK::SSAO::CPU::Renderer::GetAllocatedVideoMemoryBytes()
+{
+    return m_RTs.GetCurrentAllocatedVideoMemoryBytes();
+}
+
+//--------------------------------------------------------------------------------
+GFSDK_SSAO_Status GFSDK::SSAO::CPU::Renderer::GetRenderTimes(GFSDK_SSAO_RenderTimes* pRenderTimes)
+{
+    if (!pRenderTimes)
+    {
+        return GFSDK_SSAO_NULL_ARGUMENT;
+    }
+
+    m_RenderTimes.GetRenderTimes(pRenderTimes);
+
+    return GFSDK_SSAO_OK;
+}
+
+//--------------------------------------------------------------------------------
+GFSDK_SSAO_Status GFSDK::SSAO::CPU::Renderer::SetProfilerHooks(const GFSDK_SSAO_ProfilerHooks& ProfilerHooks)
+{
+    return m_ProfilerHooks.Set(ProfilerHooks);
+}
+
+#endif // SUPPORT_CPU
@@ -0,0 +1,264 @@
+// This code contains NVIDIA Confidential Information and is disclosed to you
+// under a form of NVIDIA software license agreement provided separately to you.
+//
+// Notice
+// NVIDIA Corporation and its licensors retain all intellectual property and
+// proprietary rights in and to this software and related documentation and
+// any modifications thereto. Any use, reproduction, disclosure, or
+// distribution of this software and related documentation without an express
+// license agreement from NVIDIA Corporation is strictly prohibited.
+//
+// ALL NVIDIA DESIGN SPECIFICATIONS, CODE ARE PROVIDED "AS IS.". NVIDIA MAKES
+// NO WARRANTIES, EXPRESSED, IMPLIED, STATUTORY, OR OTHERWISE WITH RESPECT TO
+// THE MATERIALS, AND EXPRESSLY DISCLAIMS ALL IMPLIED WARRANTIES OF NONINFRINGEMENT,
+// MERCHANTABILITY, AND FITNESS FOR A PARTICULAR PURPOSE.
+//
+// Information and code furnished is believed to be accurate and reliable.
+// However, NVIDIA Corporation assumes no responsibility for the consequences of use of such
+// information or for any infringement of patents or other rights of third parties that may
+// result from its use. No license is granted by implication or otherwise under any patent
+// or patent rights of NVIDIA Corporation. Details are subject to change without notice.
+// This code supersedes and replaces all information previously supplied.
+// NVIDIA Corporation products are not authorized for use as critical
+// components in life support devices or systems without express written approval of
+// NVIDIA Corporation.
+//
+// Copyright (c) 2008-2021 NVIDIA Corporation. All rights reserved.
+
+#pragma once
+#include "Common.h"
+#include "ConstantBuffers.h"
+#include "InputDepthInfo.h"
+#include "InputNormalInfo.h"
+#include "OutputInfo.h"
+#include "ProjectionMatrixInfo.h"
+#include "RenderTargets_CPU.h"
+#include "Shaders_CPU.h"
+#include "TaskGraph_CPU.h"
+#include "ThreadPool_CPU.h"
+#include "BuildVersion.h"
+#include "ProfilerHooks.h"
+
+namespace GFSDK
+{
+namespace SSAO
+{
+
+//--------------------------------------------------------------------------------
+#if SUPPORT_CPU
+
+namespace CPU
+{
+
+class Renderer : public GFSDK_SSAO_Context_CPU
+{
+public:
+    Renderer(GFSDK_SSAO_CustomHeap NewDelete)
+        : m_RTs(NewDelete)
+        , m_NewDelete(NewDelete)
+    {
+        m_RenderTimes.SetProfilerHooks(&m_ProfilerHooks);
+    }
+
+    //
+    // API
+    //
+
+    GFSDK_SSAO_Status Create(const GFSDK_SSAO_ContextDesc_CPU& ContextDesc, GFSDK_SSAO_Version HeaderVersion);
+
+    void Release();
+
+    GFSDK_SSAO_Status PreCreateRTs(
+        const GFSDK_SSAO_Parameters& Parameters,
+        UINT ViewportWidth,
+        UINT ViewportHeight);
+
+    GFSDK_SSAO_Status GetProjectionMatrixDepthRange(
+        const GFSDK_SSAO_InputData_CPU& InputData,
+        GFSDK_SSAO_ProjectionMatrixDepthRange& OutputDepthRange);
+
+    GFSDK_SSAO_Status RenderAO(
+        const GFSDK_SSAO_InputData_CPU& InputData,
+        const GFSDK_SSAO_Parameters& Parameters,
+        const GFSDK_SSAO_Output_CPU& Output,
+        GFSDK_SSAO_RenderMask RenderMask = GFSDK_SSAO_RENDER_AO);
+
+    UINT GetAllocatedVideoMemoryBytes();
+
+    GFSDK_SSAO_Status GetRenderTimes(GFSDK_SSAO_RenderTimes* pRenderTimes);
+
+    GFSDK_SSAO_Status SetProfilerHooks(const GFSDK_SSAO_ProfilerHooks& ProfilerHooks);
+
+    GFSDK_SSAO_InstructionSet_CPU GetInstructionSet()
+    {
+        return m_Shaders.ActiveInstructionSet;
+    }
+
+private:
+    // Number of rows per task of the task graph. The blur tiles are taller, since each tile
+    // also runs BlurX over the KernelRadius rows above and below it.
+    static const UINT TILE_HEIGHT = 8;
+    static const UINT BLUR_TILE_HEIGHT = 32;
+
+    // Largest graph recorded by RenderHBAOPlus, with Algorithm = LINE_SWEEP: the depths, the debug normals,
+    // the reconstructed normals, one pass per sweep, the resolve and the blur. Each of them depends on one pass,
+    // except the depths, which depend on none, and the first sweep, which also depends on the normals.
+    static const UINT MAX_NUM_GRAPH_PASSES = 5 + NUM_DIRECTIONS / 2;
+    static const UINT MAX_NUM_GRAPH_DEPENDENCIES = 5 + NUM_DIRECTIONS / 2;
+    static_assert(MAX_NUM_GRAPH_PASSES <= TaskGraph::MAX_NUM_PASSES, "TaskGraph::MAX_NUM_PASSES is too small for RenderHBAOPlus");
+    static_assert(MAX_NUM_GRAPH_DEPENDENCIES <= TaskGraph::MAX_NUM_DEPENDENCIES, "TaskGraph::MAX_NUM_DEPENDENCIES is too small for RenderHBAOPlus");
+
+    // Arguments of the passes recorded in the task graph, which must outlive TaskGraph::Run
+    struct PassArgs
+    {
+        LinearizeDepthArgs LinearizeDepth;
+        DeinterleaveDepthArgs DeinterleaveDepth;
+        LinearizeDeinterleaveDepthArgs LinearizeDeinterleaveDepth;
+        ReconstructNormalArgs ReconstructNormal;
+        CoarseAOArgs CoarseAO[16];
+        ReinterleaveAOArgs ReinterleaveAO;
+        BlurArgs Blur;
+        DebugNormalsArgs DebugNormals;
+        LineSweepAOArgs LineSweepAO[NUM_DIRECTIONS / 2];
+        LineSweepResolveArgs LineSweepResolve;
+    };
+
+    ShaderPermutations::NUM_STEPS GetNumStepsPermutation()
+    {
+        return (m_Options.StepCount == GFSDK_SSAO_STEP_COUNT_4) ? ShaderPermutations::NUM_STEPS_4 :
+                                                                  ShaderPermutations::NUM_STEPS_8;
+    }
+    ShaderPermutations::DEPTH_LAYER_COUNT GetDepthLayerCountPermutation()
+    {
+        return (m_Options.EnableDualLayerAO) ? ShaderPermutations::DEPTH_LAYER_COUNT_2 :
+                                               ShaderPermutations::DEPTH_LAYER_COUNT_1;
+    }
+    ShaderPermutations::FETCH_GBUFFER_NORMAL GetFetchNormalPermutation()
+    {
+        return (!m_InputNormal.Texture.IsSet()) ?           ShaderPermutations::FETCH_GBUFFER_NORMAL_0 :
+               (m_InputNormal.Texture.SampleCount == 1)  ?  ShaderPermutations::FETCH_GBUFFER_NORMAL_1 :
+                                                            ShaderPermutations::FETCH_GBUFFER_NORMAL_2;
+    }
+    ShaderPermutations::ENABLE_BLUR GetEnableBlurPermutation()
+    {
+        return (m_Options.Blur.Enable) ? ShaderPermutations::ENABLE_BLUR_1 :
+                                         ShaderPermutations::ENABLE_BLUR_0;
+    }
+    ShaderPermutations::KERNEL_RADIUS GetBlurKernelRadiusPermutation()
+    {
+        return (m_Options.Blur.Radius == GFSDK_SSAO_BLUR_RADIUS_2) ? ShaderPermutations::KERNEL_RADIUS_2 :
+                                                                     ShaderPermutations::KERNEL_RADIUS_4;
+    }
+    ShaderPermutations::ENABLE_SHARPNESS_PROFILE GetEnableSharpnessProfilePermutation()
+    {
+        return (m_Options.Blur.SharpnessProfile.Enable) ? ShaderPermutations::ENABLE_SHARPNESS_PROFILE_1 :
+                                                          ShaderPermutations::ENABLE_SHARPNESS_PROFILE_0;
+    }
+
+    // The full-res view depths are needed to reconstruct normals, to draw debug normals,
+    // and to split DRAW_Z and DRAW_AO across RenderAO calls. Otherwise, the depths are
+    // linearized straight into the quarter-res slices.
+    bool NeedsFullResViewDepths(GFSDK_SSAO_RenderMask RenderMask)
+    {
+        return !m_InputNormal.Texture.IsSet() ||
+               m_Options.Algorithm == GFSDK_SSAO_LINE_SWEEP ||
+               (RenderMask & GFSDK_SSAO_DRAW_DEBUG_N) ||
+               (RenderMask & GFSDK_SSAO_RENDER_AO) != GFSDK_SSAO_RENDER_AO;
+    }
+
+    static ShaderResourceView GetSRV(const UserTextureSRV& Texture)
+    {
+        ShaderResourceView SRV;
+        SRV.pData = Texture.pData;
+        SRV.Width = Texture.Width;
+        SRV.Height = Texture.Height;
+        SRV.RowPitch = Texture.RowPitch;
+        SRV.PixelStride = Texture.PixelStride;
+        return SRV;
+    }
+    ShaderResourceView GetFullResNormalBufferSRV()
+    {
+        return (m_InputNormal.Texture.IsSet()) ? GetSRV(m_InputNormal.Texture) : m_RTs.GetFullResNormalTexture()->SRV;
+    }
+    ShaderResourceView GetFullResViewDepthTexture2SRV()
+    {
+        return m_Options.EnableDualLayerAO ? m_RTs.GetFullResViewDepthTexture2()->SRV : ShaderResourceView();
+    }
+    OutputMergerState GetOutputMergerState(GFSDK_SSAO_BlendMode BlendMode)
+    {
+        OutputMergerState Output;
+        Output.RenderTarget.pData       = m_Output.RenderTarget.pData;
+        Output.RenderTarget.Width       = m_Output.RenderTarget.Width;
+        Output.RenderTarget.Height      = m_Output.RenderTarget.Height;
+        Output.RenderTarget.RowPitch    = m_Output.RenderTarget.RowPitch;
+        Output.RenderTarget.PixelStride = m_Output.RenderTarget.NumChannels;
+        Output.BlendMode                = BlendMode;
+        Output.TopLeftX                 = UINT(m_InputDepth.Viewport.TopLeftX);
+        Output.TopLeftY                 = UINT(m_InputDepth.Viewport.TopLeftY);
+        return Output;
+    }
+    OutputMergerState GetOutputMergerState()
+    {
+        return GetOutputMergerState(m_Output.Blend.Mode);
+    }
+
+    void CreateResources(const GFSDK_SSAO_ContextDesc_CPU& ContextDesc);
+    void ReleaseResources();
+
+    void SetAOResolution(UINT Width, UINT Height);
+    void SetAOResolution(const SSAO::InputViewport &Viewport);
+
+    GFSDK_SSAO_Status SetDataFlow(
+        const GFSDK_SSAO_InputData_CPU& InputData,
+        const GFSDK_SSAO_Parameters& Parameters,
+        const GFSDK_SSAO_Output_CPU& Output);
+
+    GFSDK_SSAO_Status SetInputData(const GFSDK_SSAO_InputData_CPU& InputData);
+    GFSDK_SSAO_Status SetInputDepths(const GFSDK_SSAO_InputDepthData_CPU& DepthData);
+    GFSDK_SSAO_Status SetInputNormals(const GFSDK_SSAO_InputNormalData_CPU& NormalData);
+    GFSDK_SSAO_Status SetAOParameters(const GFSDK_SSAO_Parameters& Parameters);
+    GFSDK_SSAO_Status SetOutput(const GFSDK_SSAO_Output_CPU& Output);
+    GFSDK_SSAO_Status ValidateDataFlow();
+
+    // The Draw methods add a pass to m_TaskGraph and return its index
+    UINT DrawLinearDepthPS();
+    UINT DrawDeinterleavedDepthPS();
+    UINT DrawLinearDeinterleavedDepthPS();
+    UINT DrawReconstructedNormalPS();
+    UINT DrawCoarseAOPS();
+    UINT DrawReinterleavedAOPS();
+    UINT DrawReinterleavedAOPS_PreBlur(bool FullResViewDepths);
+
+    GFSDK_SSAO_Status Render(GFSDK_SSAO_RenderMask RenderMask);
+    void RenderHBAOPlus(GFSDK_SSAO_RenderMask RenderMask);
+
+    UINT DrawBlurPS();
+    UINT DrawLineSweepAOPS(UINT DirectionIndex);
+    UINT DrawLineSweepResolvePS();
+    UINT DrawDebugNormalsPS();
+
+    GFSDK::SSAO::CPU::GlobalConstantBuffer m_GlobalCB;
+    GFSDK::SSAO::CPU::PerPassConstantBuffers m_PerPassCBs;
+    GFSDK::SSAO::CPU::InputDepthInfo m_InputDepth;
+    GFSDK::SSAO::CPU::InputNormalInfo m_InputNormal;
+    GFSDK::SSAO::CPU::OutputInfo m_Output;
+    GFSDK::SSAO::CPU::RenderTargets m_RTs;
+    GFSDK::SSAO::CPU::Shaders m_Shaders;
+    GFSDK::SSAO::CPU::ThreadPool m_ThreadPool;
+    GFSDK::SSAO::CPU::TaskGraph m_TaskGraph;
+    PassArgs m_PassArgs;
+    GFSDK::SSAO::RenderTimesHistory m_RenderTimes;
+    GFSDK::SSAO::CPUTimes m_CPUTimes;
+    GFSDK::SSAO::ProfilerHooks m_ProfilerHooks;
+    GFSDK_SSAO_Parameters m_Options;
+    GFSDK::SSAO::Viewports m_Viewports;
+    GFSDK::SSAO::BuildVersion m_BuildVersion;
+    GFSDK_SSAO_CustomHeap m_NewDelete;
+};
+
+} // namespace CPU
+
+#endif // SUPPORT_CPU
+
+} // namespace SSAO
+} // namespace GFSDK
@@ -29,10 +29,6 @@
 
 #include "Renderer_DX11.h"
 
-#if ENABLE_RENDER_TIMES
-GFSDK::SSAO::RenderTimes GFSDK::SSAO::D3D11::Renderer::s_RenderTimes;
-#endif
-
 #if ENABLE_DEBUG_MODES
 GFSDK::SSAO::D3D11::Renderer::ShaderType GFSDK::SSAO::D3D11::Renderer::s_AOShaderType = NVSDK_HBAO_PLUS_PS;
 #endif
@@ -41,10 +37,19 @@ GFSDK::SSAO::D3D11::Renderer::ShaderType GFSDK::SSAO::D3D11::Renderer::s_AOShade
 void GFSDK::SSAO::D3D11::Renderer::CreateResources(ID3D11Device* pD3DDevice)
 {
     m_States.Create(pD3DDevice);
-    m_Shaders.Create(pD3DDevice);
-#if ENABLE_RENDER_TIMES
+    if (m_ContextDesc.ShaderCreation == GFSDK_SSAO_CREATE_SHADERS_ON_DEMAND)
+    {
+        m_Shaders.Create(DevicePointer(pD3DDevice, true));
+    }
+    else
+    {
+        CreateOnceList CreationList;
+        m_Shaders.Create(DevicePointer(pD3DDevice, false, &CreationList));
+
+        TaskBatch Batch(m_ContextDesc.TaskScheduler, m_ContextDesc.NumCreationThreads);
+        CreationList.Run(Batch);
+    }
     m_TimestampQueries.Create(pD3DDevice);
-#endif
 #if ENABLE_DEBUG_MODES
     m_RandomTexture.Create(pD3DDevice);
     m_DebugShaders.Create(pD3DDevice);
@@ -59,9 +64,7 @@ void GFSDK::SSAO::D3D11::Renderer::ReleaseResources()
     m_States.Release();
     m_Shaders.Release();
     m_RTs.Release();
-#if ENABLE_RENDER_TIMES
     m_TimestampQueries.Release();
-#endif
 #if ENABLE_DEBUG_MODES
     m_RandomTexture.Release();
     m_DebugShaders.Release();
@@ -70,6 +73,102 @@ void GFSDK::SSAO::D3D11::Renderer::ReleaseResources()
     m_PerPassCBs.Release();
 }
 
+//--------------------------------------------------------------------------------
+// Creates the shaders that Render is about to use, if they were not created yet
+//--------------------------------------------------------------------------------
+void GFSDK::SSAO::D3D11::Renderer::CreateShadersOnce(GFSDK_SSAO_RenderMask RenderMask)
+{
+#if ENABLE_DEBUG_MODES
+    if (s_AOShaderType != NVSDK_HBAO_PLUS_PS)
+    {
+        // RenderDebugAO uses a subset of these shaders
+        RenderMask = GFSDK_SSAO_RENDER_AO;
+    }
+#endif
+
+    m_Shaders.FullScreenTriangle_VS.Get().CreateOnce();
+
+    if (RenderMask & GFSDK_SSAO_DRAW_Z)
+    {
+        if (m_InputDepth.DepthTextureType == GFSDK_SSAO_VIEW_DEPTHS)
+        {
+            m_Shaders.CopyDepth_PS.Get(GetResolveDepthPermutation(), GetDepthLayerCountPermutation()).CreateOnce();
+        }
+        else
+        {
+            m_Shaders.LinearizeDepth_PS.Get(GetResolveDepthPermutation(), GetDepthLayerCountPermutation()).CreateOnce();
+        }
+    }
+
+    if (RenderMask & GFSDK_SSAO_DRAW_DEBUG_N)
+    {
+        m_Shaders.DebugNormals_PS.Get(GetFetchNormalPermutation()).CreateOnce();
+    }
+
+    if (RenderMask & GFSDK_SSAO_DRAW_AO)
+    {
+        m_Shaders.DeinterleaveDepth_PS.Get(GetDepthLayerCountPermutation()).CreateOnce();
+
+        if (!m_InputNormal.Texture.IsSet())
+        {
+            m_Shaders.ReconstructNormal_PS.Get().CreateOnce();
+        }
+
+        m_Shaders.CoarseAO_GS.Get().CreateOnce();
+        m_Shaders.CoarseAO_PS.Get(GetFetchNormalPermutation(), GetDepthLayerCountPermutation(), GetNumStepsPermutation()).CreateOnce();
+        m_Shaders.ReinterleaveAO_PS.Get(GetEnableBlurPermutation(), GetDepthLayerCountPermutation()).CreateOnce();
+
+        if (m_Options.Blur.Enable)
+        {
+            m_Shaders.BlurX_PS.Get(GetEnableSharpnessProfilePermutation(), GetBlurKernelRadiusPermutation()).CreateOnce();
+            m_Shaders.BlurY_PS.Get(GetEnableSharpnessProfilePermutation(), GetBlurKernelRadiusPermutation()).CreateOnce();
+        }
+    }
+}
+
+//--------------------------------------------------------------------------------
+// Adds the shaders that RenderAO may use with m_Options, whatever the input data
+//--------------------------------------------------------------------------------
+void GFSDK::SSAO::D3D11::Renderer::AddShadersForAllInputs(CreateOnceList& CreationList)
+{
+    using namespace Generated::ShaderPermutations;
+
+    CreationList.Add(m_Shaders.FullScreenTriangle_VS.Get());
+
+    // The input permutations pruned from the build are skipped
+    for (UINT ResolveDepth = 0; ResolveDepth < RESOLVE_DEPTH_COUNT; ++ResolveDepth)
+    {
+        if (m_Shaders.CopyDepth_PS.IsBuilt(RESOLVE_DEPTH(ResolveDepth), GetDepthLayerCountPermutation()))
+        {
+            CreationList.Add(m_Shaders.CopyDepth_PS.Get(RESOLVE_DEPTH(ResolveDepth), GetDepthLayerCountPermutation()));
+        }
+        if (m_Shaders.LinearizeDepth_PS.IsBuilt(RESOLVE_DEPTH(ResolveDepth), GetDepthLayerCountPermutation()))
+        {
+            CreationList.Add(m_Shaders.LinearizeDepth_PS.Get(RESOLVE_DEPTH(ResolveDepth), GetDepthLayerCountPermutation()));
+        }
+    }
+
+    CreationList.Add(m_Shaders.DeinterleaveDepth_PS.Get(GetDepthLayerCountPermutation()));
+    CreationList.Add(m_Shaders.ReconstructNormal_PS.Get());
+    CreationList.Add(m_Shaders.CoarseAO_GS.Get());
+
+    for (UINT FetchNormal = 0; FetchNormal < FETCH_GBUFFER_NORMAL_COUNT; ++FetchNormal)
+    {
+        if (m_Shaders.CoarseAO_PS.IsBuilt(FETCH_GBUFFER_NORMAL(FetchNormal), GetDepthLayerCountPermutation(), GetNumStepsPermutation()))
+        {
+            CreationList.Add(m_Shaders.CoarseAO_PS.Get(FETCH_GBUFFER_NORMAL(FetchNormal), GetDepthLayerCountPermutation(), GetNumStepsPermutation()));
+        }
+    }
+
+    CreationList.Add(m_Shaders.ReinterleaveAO_PS.Get(GetEnableBlurPermutation(), GetDepthLayerCountPermutation()));
+
+    if (m_Options.Blur.Enable)
+    {
+        CreationList.Add(m_Shaders.BlurX_PS.Get(GetEnableSharpnessProfilePermutation(), GetBlurKernelRadiusPermutation()));
+        CreationList.Add(m_Shaders.BlurY_PS.Get(GetEnableSharpnessProfilePermutation(), GetBlurKernelRadiusPermutation()));
+    }
+}
+
 //--------------------------------------------------------------------------------
 void GFSDK::SSAO::D3D11::Renderer::DrawLinearDepthPS(ID3D11DeviceContext* pDeviceContext)
 {
@@ -77,9 +176,8 @@ void GFSDK::SSAO::D3D11::Renderer::DrawLinearDepthPS(ID3D11DeviceContext* pDevic
     PERF_MARKER_SCOPE(L"DrawLinearDepthPS");
 #endif
 
-#if ENABLE_RENDER_TIMES
     GPU_TIMER_SCOPE(LINEAR_Z);
-#endif
+    PROFILER_RANGE_SCOPE(pDeviceContext, LINEAR_Z);
 
     {
         ID3D11PixelShader* pPS = (m_InputDepth.DepthTextureType == GFSDK_SSAO_VIEW_DEPTHS) ?
@@ -121,9 +219,8 @@ void GFSDK::SSAO::D3D11::Renderer::DrawDeinterleavedDepthPS(ID3D11DeviceContext*
     PERF_MARKER_SCOPE(L"DrawDeinterleavedDepthPS");
 #endif
 
-#if ENABLE_RENDER_TIMES
     GPU_TIMER_SCOPE(DEINTERLEAVE_Z);
-#endif
+    PROFILER_RANGE_SCOPE(pDeviceContext, DEINTERLEAVE_Z);
 
     pDeviceContext->RSSetViewports(1, &m_Viewports.QuarterRes);
     pDeviceContext->PSSetShader(m_Shaders.DeinterleaveDepth_PS.Get(GetDepthLayerCountPermutation()), NULL, 0);
@@ -152,9 +249,8 @@ void GFSDK::SSAO::D3D11::Renderer::DrawReconstructedNormalPS(ID3D11DeviceContext
     PERF_MARKER_SCOPE(L"DrawReconstructedNormalPS");
 #endif
 
-#if ENABLE_RENDER_TIMES
     GPU_TIMER_SCOPE(NORMAL);
-#endif
+    PROFILER_RANGE_SCOPE(pDeviceContext, NORMAL);
 
     pDeviceContext->OMSetRenderTargets(1, &m_RTs.GetFullResNormalTexture()->pRTV, NULL);
     pDeviceContext->RSSetViewports(1, &m_Viewports.FullRes);
@@ -173,9 +269,8 @@ void GFSDK::SSAO::D3D11::Renderer::DrawDebugNormalsPS(ID3D11DeviceContext* pDevi
     PERF_MARKER_SCOPE(L"DrawDebugNormalsPS");
 #endif
 
-#if ENABLE_RENDER_TIMES
     GPU_TIMER_SCOPE(NORMAL);
-#endif
+    PROFILER_RANGE_SCOPE(pDeviceContext, NORMAL);
 
     ID3D11ShaderResourceView* pSRVs[] = 
     {
@@ -200,9 +295,8 @@ void GFSDK::SSAO::D3D11::Renderer::DrawDebugNormalsPS(ID3D11DeviceContext* pDevi
 //--------------------------------------------------------------------------------
 void GFSDK::SSAO::D3D11::Renderer::DrawFullResAOPS(ID3D11DeviceContext* pDeviceContext)
 {
-#if ENABLE_RENDER_TIMES
     GPU_TIMER_SCOPE(COARSE_AO);
-#endif
+    PROFILER_RANGE_SCOPE(pDeviceContext, COARSE_AO);
 
     if (m_Options.Blur.Enable)
     {
@@ -257,9 +351,8 @@ void GFSDK::SSAO::D3D11::Renderer::DrawCoarseAOPS(ID3D11DeviceContext* pDeviceCo
     PERF_MARKER_SCOPE(L"DrawCoarseAOPS");
 #endif
 
-#if ENABLE_RENDER_TIMES
     GPU_TIMER_SCOPE(COARSE_AO);
-#endif
+    PROFILER_RANGE_SCOPE(pDeviceContext, COARSE_AO);
 
     pDeviceContext->GSSetShader(m_Shaders.CoarseAO_GS.Get(), NULL, 0);
 
@@ -296,9 +389,8 @@ void GFSDK::SSAO::D3D11::Renderer::DrawReinterleavedAOPS(ID3D11DeviceContext* pD
     PERF_MARKER_SCOPE(L"DrawReinterleavedAOPS");
 #endif
 
-#if ENABLE_RENDER_TIMES
     GPU_TIMER_SCOPE(INTERLEAVE_AO);
-#endif
+    PROFILER_RANGE_SCOPE(pDeviceContext, INTERLEAVE_AO);
 
     ASSERT(!m_Options.Blur.Enable);
 
@@ -323,9 +415,8 @@ void GFSDK::SSAO::D3D11::Renderer::DrawReinterleavedAOPS_PreBlur(ID3D11DeviceCon
     PERF_MARKER_SCOPE(L"DrawReinterleavedAOPS");
 #endif
 
-#if ENABLE_RENDER_TIMES
     GPU_TIMER_SCOPE(INTERLEAVE_AO);
-#endif
+    PROFILER_RANGE_SCOPE(pDeviceContext, INTERLEAVE_AO);
 
     ASSERT(m_Options.Blur.Enable);
 
@@ -353,9 +444,8 @@ void GFSDK::SSAO::D3D11::Renderer::DrawBlurXPS(ID3D11DeviceContext* pDeviceConte
     PERF_MARKER_SCOPE(L"DrawBlurXPS");
 #endif
 
-#if ENABLE_RENDER_TIMES
     GPU_TIMER_SCOPE(BLURX);
-#endif
+    PROFILER_RANGE_SCOPE(pDeviceContext, BLURX);
 
     ID3D11SamplerState* pSamplers[] =
     {
@@ -380,9 +470,8 @@ void GFSDK::SSAO::D3D11::Renderer::DrawBlurYPS(ID3D11DeviceContext* pDeviceConte
     PERF_MARKER_SCOPE(L"DrawBlurYPS");
 #endif
 
-#if ENABLE_RENDER_TIMES
     GPU_TIMER_SCOPE(BLURY);
-#endif
+    PROFILER_RANGE_SCOPE(pDeviceContext, BLURY);
 
     {
         pDeviceContext->OMSetDepthStencilState(GetOutputDepthStencilState(), GetOutputDepthStencilRef());
@@ -466,9 +555,8 @@ void GFSDK::SSAO::D3D11::Renderer::Render(ID3D11DeviceContext* pDeviceContext, G
     PERF_MARKER_SCOPE(L"HBAO+");
 #endif
 
-#if ENABLE_RENDER_TIMES
     GPU_TIMER_SCOPE(TOTAL);
-#endif
+    PROFILER_RANGE_SCOPE(pDeviceContext, TOTAL);
 
     m_GlobalCB.UpdateBuffer(pDeviceContext, RenderMask);
 
@@ -518,6 +606,62 @@ GFSDK_SSAO_Status GFSDK::SSAO::D3D11::Renderer::PreCreateRTs(
     return m_RTs.PreCreate(m_Options);
 }
 
+//--------------------------------------------------------------------------------
+GFSDK_SSAO_Status GFSDK::SSAO::D3D11::Renderer::PreCreateShaders(
+    const GFSDK_SSAO_Parameters* pParameters,
+    UINT NumParameters)
+{
+    if (!pParameters && NumParameters)
+    {
+        return GFSDK_SSAO_NULL_ARGUMENT;
+    }
+
+    // The permutation getters read m_Options, which must be left unchanged for the next SetAOParameters
+    const GFSDK_SSAO_Parameters Options = m_Options;
+    CreateOnceList CreationList;
+
+#if ENABLE_EXCEPTIONS
+    try
+    {
+        for (UINT Index = 0; Index < NumParameters; ++Index)
+        {
+            m_Options = pParameters[Index];
+            AddShadersForAllInputs(CreationList);
+        }
+    }
+    catch (const PermutationNotBuiltError&)
+    {
+        m_Options = Options;
+        return GFSDK_SSAO_SHADER_PERMUTATION_NOT_BUILT;
+    }
+
+    m_Options = Options;
+
+    try
+    {
+        TaskBatch Batch(m_ContextDesc.TaskScheduler, m_ContextDesc.NumCreationThreads);
+        CreationList.Run(Batch);
+    }
+    catch (...)
+    {
+        return GFSDK_SSAO_D3D_RESOURCE_CREATION_FAILED;
+    }
+#else
+    for (UINT Index = 0; Index < NumParameters; ++Index)
+    {
+        m_Options = pParameters[Index];
+        AddShadersForAllInputs(CreationList);
+    }
+
+    m_Options = Options;
+
+    TaskBatch Batch(m_ContextDesc.TaskScheduler, m_ContextDesc.NumCreationThreads);
+    CreationList.Run(Batch);
+#endif
+
+    return GFSDK_SSAO_OK;
+}
+
 //--------------------------------------------------------------------------------
 GFSDK_SSAO_Status GFSDK::SSAO::D3D11::Renderer::GetProjectionMatrixDepthRange(
     const GFSDK_SSAO_InputData_D3D11& InputData,
@@ -552,7 +696,12 @@ GFSDK_SSAO_Status GFSDK::SSAO::D3D11::Renderer::RenderAO(
         return GFSDK_SSAO_NULL_ARGUMENT;
     }
 
-    Status = SetDataFlow(InputData, Parameters, Output);
+    CPU_FRAME_TIMER_BEGIN();
+
+    {
+        CPU_TIMER_SCOPE(SET_DATA_FLOW);
+        Status = SetDataFlow(InputData, Parameters, Output);
+    }
     if (Status != GFSDK_SSAO_OK)
     {
         return Status;
@@ -564,20 +713,46 @@ GFSDK_SSAO_Status GFSDK::SSAO::D3D11::Renderer::RenderAO(
         return Status;
     }
 
+    // With GFSDK_SSAO_CREATE_ALL_SHADERS, this only checks that the permutations of the parameters were built
+#if ENABLE_EXCEPTIONS
+    try
+    {
+        CreateShadersOnce(RenderMask);
+    }
+    catch (const PermutationNotBuiltError&)
+    {
+        return GFSDK_SSAO_SHADER_PERMUTATION_NOT_BUILT;
+    }
+    catch (...)
+    {
+        return GFSDK_SSAO_D3D_RESOURCE_CREATION_FAILED;
+    }
+#else
+    CreateShadersOnce(RenderMask);
+#endif
+
     GFSDK::SSAO::D3D11::AppState AppState;
-    AppState.Save(pDeviceContext);
+    {
+        CPU_TIMER_SCOPE(SAVE_APP_STATE);
+        AppState.Save(pDeviceContext);
+    }
 
-#if ENABLE_RENDER_TIMES
-    m_TimestampQueries.Begin(pDeviceContext);
-#endif
+    {
+        CPU_TIMER_SCOPE(RENDER);
 
-    Render(pDeviceContext, RenderMask);
+        m_TimestampQueries.Begin(pDeviceContext);
 
-#if ENABLE_RENDER_TIMES
-    m_TimestampQueries.End(pDeviceContext, &s_RenderTimes);
-#endif
+        Render(pDeviceContext, RenderMask);
+
+        m_TimestampQueries.End(pDeviceContext, &m_RenderTimes);
+    }
+
+    {
+        CPU_TIMER_SCOPE(RESTORE_APP_STATE);
+        AppState.Restore(pDeviceContext);
+    }
 
-    AppState.Restore(pDeviceContext);
+    CPU_FRAME_TIMER_END();
 
     return GFSDK_SSAO_OK;
 }
@@ -738,14 +913,17 @@ GFSDK_SSAO_Status GFSDK::SSAO::D3D11::Renderer::SetAOParameters(const GFSDK_SSAO
         m_RTs.ReleaseResources();
     }
 
-    m_GlobalCB.SetAOParameters(Params, m_InputDepth);
+    {
+        CPU_TIMER_SCOPE(SET_AO_PARAMETERS);
+        m_GlobalCB.SetAOParameters(Params, m_InputDepth);
+    }
     m_Options = Params;
 
     return GFSDK_SSAO_OK;
 }
 
 //--------------------------------------------------------------------------------
-GFSDK_SSAO_Status GFSDK::SSAO::D3D11::Renderer::Create(ID3D11Device* pD3DDevice, GFSDK_SSAO_Version HeaderVersion)
+GFSDK_SSAO_Status GFSDK::SSAO::D3D11::Renderer::Create(ID3D11Device* pD3DDevice, const GFSDK_SSAO_ContextDesc_D3D11& ContextDesc, GFSDK_SSAO_Version HeaderVersion)
 {
     if (!m_BuildVersion.Match(HeaderVersion))
     {
@@ -762,6 +940,14 @@ GFSDK_SSAO_Status GFSDK::SSAO::D3D11::Renderer::Create(ID3D11Device* pD3DDevice,
         return GFSDK_SSAO_NULL_ARGUMENT;
     }
 
+    m_ContextDesc = ContextDesc;
+
+    if (pD3DDevice->GetCreationFlags() & D3D11_CREATE_DEVICE_SINGLETHREADED)
+    {
+        m_ContextDesc.TaskScheduler = GFSDK_SSAO_TaskScheduler();
+        m_ContextDesc.NumCreationThreads = 1;
+    }
+
 #if ENABLE_EXCEPTIONS
     try
     {
@@ -796,4 +982,23 @@ UINT GFSDK::SSAO::D3D11::Renderer::GetAllocatedVideoMemoryBytes()
     return m_RTs.GetCurrentAllocatedVideoMemoryBytes();
 }
 
+//--------------------------------------------------------------------------------
+GFSDK_SSAO_Status GFSDK::SSAO::D3D11::Renderer::GetRenderTimes(GFSDK_SSAO_RenderTimes* pRenderTimes)
+{
+    if (!pRenderTimes)
+    {
+        return GFSDK_SSAO_NULL_ARGUMENT;
+    }
+
+    m_RenderTimes.GetRenderTimes(pRenderTimes);
+
+    return GFSDK_SSAO_OK;
+}
+
+//--------------------------------------------------------------------------------
+GFSDK_SSAO_Status GFSDK::SSAO::D3D11::Renderer::SetProfilerHooks(const GFSDK_SSAO_ProfilerHooks& ProfilerHooks)
+{
+    return m_ProfilerHooks.Set(ProfilerHooks);
+}
+
 #endif // SUPPORT_D3D11
@@ -39,6 +39,7 @@
 #include "AppState_DX11.h"
 #include "TimestampQueries.h"
 #include "BuildVersion.h"
+#include "ProfilerHooks.h"
 #include "PerfMarkers.h"
 
 namespace GFSDK
@@ -58,13 +59,14 @@ public:
     Renderer(GFSDK_SSAO_CustomHeap NewDelete)
         : m_NewDelete(NewDelete)
     {
+        m_RenderTimes.SetProfilerHooks(&m_ProfilerHooks);
     }
 
     //
     // API
     //
 
-    GFSDK_SSAO_Status Create(ID3D11Device* pD3DDevice, GFSDK_SSAO_Version HeaderVersion);
+    GFSDK_SSAO_Status Create(ID3D11Device* pD3DDevice, const GFSDK_SSAO_ContextDesc_D3D11& ContextDesc, GFSDK_SSAO_Version HeaderVersion);
 
     void Release();
 
@@ -73,6 +75,10 @@ public:
         UINT ViewportWidth,
         UINT ViewportHeight);
 
+    GFSDK_SSAO_Status PreCreateShaders(
+        const GFSDK_SSAO_Parameters* pParameters,
+        UINT NumParameters);
+
     GFSDK_SSAO_Status GetProjectionMatrixDepthRange(
         const GFSDK_SSAO_InputData_D3D11& InputData,
         GFSDK_SSAO_ProjectionMatrixDepthRange& OutputDepthRange);
@@ -86,14 +92,14 @@ public:
 
     UINT GetAllocatedVideoMemoryBytes();
 
+    GFSDK_SSAO_Status GetRenderTimes(GFSDK_SSAO_RenderTimes* pRenderTimes);
+
+    GFSDK_SSAO_Status SetProfilerHooks(const GFSDK_SSAO_ProfilerHooks& ProfilerHooks);
+
     //
     // Internals
     //
 
-#if ENABLE_RENDER_TIMES
-    static GFSDK::SSAO::RenderTimes s_RenderTimes;
-#endif
-
 #if ENABLE_DEBUG_MODES
     enum ShaderType
     {
@@ -187,6 +193,9 @@ private:
     void CreateResources(ID3D11Device* pD3DDevice);
     void ReleaseResources();
 
+    void CreateShadersOnce(GFSDK_SSAO_RenderMask RenderMask);
+    void AddShadersForAllInputs(CreateOnceList& CreationList);
+
     void SetFullscreenState(ID3D11DeviceContext* pDeviceContext);
     void SetAOResolution(UINT Width, UINT Height);
     void SetAOResolution(const SSAO::InputViewport &Viewport);
@@ -232,12 +241,14 @@ private:
     GFSDK::SSAO::D3D11::Shaders m_Shaders;
     GFSDK::SSAO::D3D11::States m_States;
     GFSDK_SSAO_Parameters m_Options;
+    GFSDK_SSAO_ContextDesc_D3D11 m_ContextDesc;
     GFSDK::SSAO::Viewports m_Viewports;
     GFSDK::SSAO::BuildVersion m_BuildVersion;
     GFSDK_SSAO_CustomHeap m_NewDelete;
-#if ENABLE_RENDER_TIMES
     GFSDK::SSAO::D3D11::TimestampQueries m_TimestampQueries;
-#endif
+    GFSDK::SSAO::RenderTimesHistory m_RenderTimes;
+    GFSDK::SSAO::CPUTimes m_CPUTimes;
+    GFSDK::SSAO::ProfilerHooks m_ProfilerHooks;
 #if ENABLE_DEBUG_MODES
     GFSDK::SSAO::D3D11::DebugShaders m_DebugShaders;
 #endif
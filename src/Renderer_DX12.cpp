@@ -53,18 +53,23 @@ void GFSDK::SSAO::D3D12::Renderer::CreateResources(GFSDK_D3D12_GraphicsContext*
 {
     m_Shaders.Create(pGraphicsContext->pDevice);
 
+    m_PipelineLibrary.Create(pGraphicsContext->pDevice, m_NewDelete);
+    pGraphicsContext->pPipelineLibrary = &m_PipelineLibrary;
+
     m_GlobalCB.Create(pGraphicsContext, eGlobalCB, 0);
     m_PerPassCBs.Create(pGraphicsContext, ePerPassCB);
 
-    m_LinearDepthPSO.Create(pGraphicsContext);
-    m_DebugNormalsPSO.Create(pGraphicsContext, m_States);
-    m_DeinterleavedDepthPSO.Create(pGraphicsContext, m_States);
-    m_CoarseAOPSO.Create(pGraphicsContext, m_States);
-    m_ReinterleavedAOPSO.Create(pGraphicsContext, m_States);
-    m_ReinterleavedAOBlurPSO.Create(pGraphicsContext, m_States);
-    m_ReconstructNormalPSO.Create(pGraphicsContext, m_States);
-    m_BlurXPSO.Create(pGraphicsContext, m_States);
-    m_BlurYPSO.Create(pGraphicsContext, m_States);
+    m_LinearDepthPSO.Create(pGraphicsContext, m_NewDelete);
+    m_DebugNormalsPSO.Create(pGraphicsContext, m_NewDelete, m_States);
+    m_DeinterleavedDepthPSO.Create(pGraphicsContext, m_NewDelete, m_States);
+    m_CoarseAOPSO.Create(pGraphicsContext, m_NewDelete, m_States);
+    m_ReinterleavedAOPSO.Create(pGraphicsContext, m_NewDelete, m_States);
+    m_ReinterleavedAOBlurPSO.Create(pGraphicsContext, m_NewDelete, m_States);
+    m_ReconstructNormalPSO.Create(pGraphicsContext, m_NewDelete, m_States);
+    m_BlurXPSO.Create(pGraphicsContext, m_NewDelete, m_States);
+    m_BlurYPSO.Create(pGraphicsContext, m_NewDelete, m_States);
+
+    m_TimestampQueries.Create(pGraphicsContext);
 }
 
 //--------------------------------------------------------------------------------
@@ -90,6 +95,8 @@ void GFSDK::SSAO::D3D12::Renderer::ReleaseResources()
     m_ReconstructNormalPSO.Release();
     m_BlurXPSO.Release();
     m_BlurYPSO.Release();
+    m_PipelineLibrary.Release();
+    m_TimestampQueries.Release();
 
     m_Shaders.Release();
     m_RTs.Release();
@@ -146,6 +153,7 @@ GFSDK_SSAO_Status GFSDK::SSAO::D3D12::Renderer::Create(
     ID3D12Device* pDevice, 
     GFSDK_SSAO_UINT NodeMask, 
     const GFSDK_SSAO_DescriptorHeaps_D3D12& DescriptorHeaps,
+    const GFSDK_SSAO_ContextDesc_D3D12& ContextDesc,
     GFSDK_SSAO_Version HeaderVersion)
 {
     if (!m_BuildVersion.Match(HeaderVersion))
@@ -153,6 +161,8 @@ GFSDK_SSAO_Status GFSDK::SSAO::D3D12::Renderer::Create(
         return GFSDK_SSAO_VERSION_MISMATCH;
     }
 
+    m_ContextDesc = ContextDesc;
+
     if (!pDevice)
     {
         return GFSDK_SSAO_NULL_ARGUMENT;
@@ -238,13 +248,18 @@ GFSDK_SSAO_Status GFSDK::SSAO::D3D12::Renderer::RenderAO(
         return GFSDK_SSAO_D3D12_INVALID_NODE_MASK;
     }
 
+    CPU_FRAME_TIMER_BEGIN();
+
     SAFE_RELEASE(m_GraphicsContext.pCmdQueue);
 
     m_GraphicsContext.pCmdList = pCmdList;
     m_GraphicsContext.pCmdQueue = pCmdQueue;
     m_GraphicsContext.pCmdQueue->AddRef();
 
-    Status = SetDataFlow(InputData, Parameters, Output);
+    {
+        CPU_TIMER_SCOPE(SET_DATA_FLOW);
+        Status = SetDataFlow(InputData, Parameters, Output);
+    }
     if (Status != GFSDK_SSAO_OK)
     {
         return Status;
@@ -259,8 +274,15 @@ GFSDK_SSAO_Status GFSDK::SSAO::D3D12::Renderer::RenderAO(
 #if ENABLE_EXCEPTIONS
     try
     {
+        CPU_TIMER_SCOPE(RENDER);
         Render(&m_GraphicsContext, RenderMask);
     }
+    catch (const PermutationNotBuiltError&)
+    {
+        m_GraphicsContext.pCmdList = NULL;
+
+        return GFSDK_SSAO_SHADER_PERMUTATION_NOT_BUILT;
+    }
     catch (...)
     {
         ReleaseResources();
@@ -268,7 +290,10 @@ GFSDK_SSAO_Status GFSDK::SSAO::D3D12::Renderer::RenderAO(
         return GFSDK_SSAO_D3D_RESOURCE_CREATION_FAILED;
     }
 #else
-    Render(&m_GraphicsContext, RenderMask);
+    {
+        CPU_TIMER_SCOPE(RENDER);
+        Render(&m_GraphicsContext, RenderMask);
+    }
 #endif
 
     m_GraphicsContext.IncrFenceValue();
@@ -276,6 +301,8 @@ GFSDK_SSAO_Status GFSDK::SSAO::D3D12::Renderer::RenderAO(
     // Make sure that pCmdList is not used outside of RenderAO
     m_GraphicsContext.pCmdList = NULL;
 
+    CPU_FRAME_TIMER_END();
+
     return GFSDK_SSAO_OK;
 }
 
@@ -307,6 +334,176 @@ GFSDK_SSAO_Status GFSDK::SSAO::D3D12::Renderer::PreCreateRTs(ID3D12CommandQueue*
     return m_RTs.PreCreate(m_Options);
 }
 
+//--------------------------------------------------------------------------------
+GFSDK_SSAO_Status GFSDK::SSAO::D3D12::Renderer::PreCreateShaders(
+    const GFSDK_SSAO_Parameters* pParameters,
+    UINT NumParameters,
+    const GFSDK_SSAO_Output_D3D12* pOutput)
+{
+    if (!pParameters && NumParameters)
+    {
+        return GFSDK_SSAO_NULL_ARGUMENT;
+    }
+
+    // Kept apart from m_Output, which only RenderAO sets
+    GFSDK::SSAO::D3D12::OutputInfo Output;
+    if (pOutput)
+    {
+        GFSDK_SSAO_Status Status = Output.Init(*pOutput);
+        if (Status != GFSDK_SSAO_OK)
+        {
+            return Status;
+        }
+    }
+
+    // The permutation getters read m_Options, which is restored before returning
+    const GFSDK_SSAO_Parameters Options = m_Options;
+    PSOCreationList CreationList;
+
+#if ENABLE_EXCEPTIONS
+    try
+    {
+        for (UINT Index = 0; Index < NumParameters; ++Index)
+        {
+            m_Options = pParameters[Index];
+            AddPSOsForAllInputs(&m_GraphicsContext, pOutput ? &Output : NULL, CreationList);
+        }
+    }
+    catch (const PermutationNotBuiltError&)
+    {
+        m_Options = Options;
+        return GFSDK_SSAO_SHADER_PERMUTATION_NOT_BUILT;
+    }
+    catch (...)
+    {
+        // A PSO that did not fit in the list has failed
+        m_Options = Options;
+        return GFSDK_SSAO_D3D_RESOURCE_CREATION_FAILED;
+    }
+
+    m_Options = Options;
+
+    try
+    {
+        TaskBatch Batch(m_ContextDesc.TaskScheduler, m_ContextDesc.NumCreationThreads);
+        CreationList.Run(&m_GraphicsContext, Batch);
+    }
+    catch (...)
+    {
+        return GFSDK_SSAO_D3D_RESOURCE_CREATION_FAILED;
+    }
+#else
+    for (UINT Index = 0; Index < NumParameters; ++Index)
+    {
+        m_Options = pParameters[Index];
+        AddPSOsForAllInputs(&m_GraphicsContext, pOutput ? &Output : NULL, CreationList);
+    }
+
+    m_Options = Options;
+
+    TaskBatch Batch(m_ContextDesc.TaskScheduler, m_ContextDesc.NumCreationThreads);
+    CreationList.Run(&m_GraphicsContext, Batch);
+#endif
+
+    return GFSDK_SSAO_OK;
+}
+
+//--------------------------------------------------------------------------------
+// Adds the PSOs that RenderAO may use with m_Options, whatever the input data,
+// and the PSOs that write to pOutput if it is not NULL
+//--------------------------------------------------------------------------------
+void GFSDK::SSAO::D3D12::Renderer::AddPSOsForAllInputs(GFSDK_D3D12_GraphicsContext* pGraphicsContext, OutputInfo* pOutput, PSOCreationList& CreationList)
+{
+    using namespace Generated::ShaderPermutations;
+
+    // The input permutations pruned from the build are skipped
+    for (UINT ResolveDepth = 0; ResolveDepth < RESOLVE_DEPTH_COUNT; ++ResolveDepth)
+    {
+        if (m_Shaders.CopyDepth_PS.IsBuilt(RESOLVE_DEPTH(ResolveDepth), GetDepthLayerCountPermutation()))
+        {
+            m_LinearDepthPSO.GetPSO(pGraphicsContext, m_Shaders, RESOLVE_DEPTH(ResolveDepth), GetDepthLayerCountPermutation(), GFSDK_SSAO_VIEW_DEPTHS, &CreationList);
+        }
+        if (m_Shaders.LinearizeDepth_PS.IsBuilt(RESOLVE_DEPTH(ResolveDepth), GetDepthLayerCountPermutation()))
+        {
+            m_LinearDepthPSO.GetPSO(pGraphicsContext, m_Shaders, RESOLVE_DEPTH(ResolveDepth), GetDepthLayerCountPermutation(), GFSDK_SSAO_HARDWARE_DEPTHS, &CreationList);
+        }
+    }
+
+    m_DeinterleavedDepthPSO.GetPSO(pGraphicsContext, m_Shaders, m_States, m_RTs, m_Options.DepthStorage, GetDepthLayerCountPermutation(), &CreationList);
+    m_ReconstructNormalPSO.GetPSO(pGraphicsContext, m_Shaders, &CreationList);
+
+    for (UINT FetchNormal = 0; FetchNormal < FETCH_GBUFFER_NORMAL_COUNT; ++FetchNormal)
+    {
+        if (m_Shaders.CoarseAO_PS.IsBuilt(FETCH_GBUFFER_NORMAL(FetchNormal), GetDepthLayerCountPermutation(), GetNumStepsPermutation()))
+        {
+            m_CoarseAOPSO.GetPSO(pGraphicsContext, m_Shaders, FETCH_GBUFFER_NORMAL(FetchNormal), GetDepthLayerCountPermutation(), GetNumStepsPermutation(), &CreationList);
+        }
+    }
+
+    if (m_Options.Blur.Enable)
+    {
+        m_ReinterleavedAOBlurPSO.GetPSO(pGraphicsContext, m_Shaders, GetDepthLayerCountPermutation(), &CreationList);
+        m_BlurXPSO.GetPSO(pGraphicsContext, m_Shaders, GetEnableSharpnessProfilePermutation(), GetBlurKernelRadiusPermutation(), &CreationList);
+
+        if (pOutput)
+        {
+            m_BlurYPSO.GetPSO(pGraphicsContext, m_Shaders, m_States, *pOutput, GetEnableSharpnessProfilePermutation(), GetBlurKernelRadiusPermutation(), &CreationList);
+        }
+    }
+    else if (pOutput)
+    {
+        m_ReinterleavedAOPSO.GetPSO(pGraphicsContext, m_Shaders, m_States, *pOutput, GetDepthLayerCountPermutation(), &CreationList);
+    }
+}
+
+//--------------------------------------------------------------------------------
+GFSDK_SSAO_Status GFSDK::SSAO::D3D12::Renderer::LoadPipelineCache(
+    const void* pData,
+    GFSDK_SSAO_SIZE_T DataSize)
+{
+    if (!pData)
+    {
+        return GFSDK_SSAO_NULL_ARGUMENT;
+    }
+
+#if ENABLE_EXCEPTIONS
+    try
+    {
+        return m_PipelineLibrary.Load(pData, DataSize);
+    }
+    catch (...)
+    {
+        return GFSDK_SSAO_MEMORY_ALLOCATION_FAILED;
+    }
+#else
+    return m_PipelineLibrary.Load(pData, DataSize);
+#endif
+}
+
+//--------------------------------------------------------------------------------
+GFSDK_SSAO_Status GFSDK::SSAO::D3D12::Renderer::GetPipelineCacheData(
+    void* pData,
+    GFSDK_SSAO_SIZE_T* pDataSize)
+{
+    if (!pDataSize)
+    {
+        return GFSDK_SSAO_NULL_ARGUMENT;
+    }
+
+#if ENABLE_EXCEPTIONS
+    try
+    {
+        return m_PipelineLibrary.GetData(pData, pDataSize);
+    }
+    catch (...)
+    {
+        return GFSDK_SSAO_D3D_RESOURCE_CREATION_FAILED;
+    }
+#else
+    return m_PipelineLibrary.GetData(pData, pDataSize);
+#endif
+}
+
 //--------------------------------------------------------------------------------
 GFSDK_SSAO_Status GFSDK::SSAO::D3D12::Renderer::GetProjectionMatrixDepthRange(
     const GFSDK_SSAO_InputData_D3D12& InputData,
@@ -334,6 +531,8 @@ void GFSDK::SSAO::D3D12::Renderer::DrawLinearDepthPS(GFSDK_D3D12_GraphicsContext
 #endif
 
     ID3D12GraphicsCommandList* pCmdList = pGraphicsContext->pCmdList;
+    GPUTimer Timer(&m_TimestampQueries, pCmdList, REGIME_TIME_LINEAR_Z);
+    PROFILER_RANGE_SCOPE(pCmdList, LINEAR_Z);
 
     pCmdList->RSSetViewports(1, &m_Viewports.FullRes);
 
@@ -378,6 +577,8 @@ void GFSDK::SSAO::D3D12::Renderer::DrawDeinterleavedDepthPS(GFSDK_D3D12_Graphics
 #endif
 
     ID3D12GraphicsCommandList* pCmdList = pGraphicsContext->pCmdList;
+    GPUTimer Timer(&m_TimestampQueries, pCmdList, REGIME_TIME_DEINTERLEAVE_Z);
+    PROFILER_RANGE_SCOPE(pCmdList, DEINTERLEAVE_Z);
 
     pCmdList->RSSetViewports(1, &m_Viewports.QuarterRes);
 
@@ -415,6 +616,8 @@ void GFSDK::SSAO::D3D12::Renderer::DrawReconstructedNormalPS(GFSDK_D3D12_Graphic
 #endif
 
     ID3D12GraphicsCommandList* pCmdList = pGraphicsContext->pCmdList;
+    GPUTimer Timer(&m_TimestampQueries, pCmdList, REGIME_TIME_NORMAL);
+    PROFILER_RANGE_SCOPE(pCmdList, NORMAL);
 
     RT_BARRIER_SCOPE(pCmdList, m_RTs.GetFullResNormalTexture()->RTV.pResource);
 
@@ -438,6 +641,8 @@ void GFSDK::SSAO::D3D12::Renderer::DrawDebugNormalsPS(GFSDK_D3D12_GraphicsContex
 #endif
 
     ID3D12GraphicsCommandList* pCmdList = pGraphicsContext->pCmdList;
+    GPUTimer Timer(&m_TimestampQueries, pCmdList, REGIME_TIME_NORMAL);
+    PROFILER_RANGE_SCOPE(pCmdList, NORMAL);
 
     pCmdList->OMSetRenderTargets(1, &m_Output.RenderTarget.RTV.CpuHandle, false, nullptr);
     pCmdList->RSSetViewports(1, &m_InputDepth.Viewport);
@@ -464,6 +669,8 @@ void GFSDK::SSAO::D3D12::Renderer::DrawCoarseAOPS(GFSDK_D3D12_GraphicsContext* p
 #endif
 
     ID3D12GraphicsCommandList* pCmdList = pGraphicsContext->pCmdList;
+    GPUTimer Timer(&m_TimestampQueries, pCmdList, REGIME_TIME_COARSE_AO);
+    PROFILER_RANGE_SCOPE(pCmdList, COARSE_AO);
 
     pCmdList->SetPipelineState(m_CoarseAOPSO.GetPSO(pGraphicsContext, m_Shaders, GetFetchNormalPermutation(), GetDepthLayerCountPermutation(), GetNumStepsPermutation()));
 
@@ -493,6 +700,8 @@ void GFSDK::SSAO::D3D12::Renderer::DrawReinterleavedAOPS_PreBlur(GFSDK_D3D12_Gra
 #endif
 
     ID3D12GraphicsCommandList* pCmdList = pGraphicsContext->pCmdList;
+    GPUTimer Timer(&m_TimestampQueries, pCmdList, REGIME_TIME_INTERLEAVE_AO);
+    PROFILER_RANGE_SCOPE(pCmdList, INTERLEAVE_AO);
 
     RT_BARRIER_SCOPE(pCmdList, m_RTs.GetFullResAOZTexture2()->RTV.pResource);
 
@@ -522,6 +731,8 @@ void GFSDK::SSAO::D3D12::Renderer::DrawReinterleavedAOPS(GFSDK_D3D12_GraphicsCon
 #endif
 
     ID3D12GraphicsCommandList* pCmdList = pGraphicsContext->pCmdList;
+    GPUTimer Timer(&m_TimestampQueries, pCmdList, REGIME_TIME_INTERLEAVE_AO);
+    PROFILER_RANGE_SCOPE(pCmdList, INTERLEAVE_AO);
 
     pCmdList->OMSetRenderTargets(1, &m_Output.RenderTarget.RTV.CpuHandle, false, nullptr);
     pCmdList->RSSetViewports(1, &m_InputDepth.Viewport);
@@ -548,6 +759,8 @@ void GFSDK::SSAO::D3D12::Renderer::DrawBlurXPS(GFSDK_D3D12_GraphicsContext* pGra
 #endif
 
     ID3D12GraphicsCommandList* pCmdList = pGraphicsContext->pCmdList;
+    GPUTimer Timer(&m_TimestampQueries, pCmdList, REGIME_TIME_BLURX);
+    PROFILER_RANGE_SCOPE(pCmdList, BLURX);
 
     RT_BARRIER_SCOPE(pCmdList, m_RTs.GetFullResAOZTexture()->RTV.pResource);
 
@@ -571,6 +784,8 @@ void GFSDK::SSAO::D3D12::Renderer::DrawBlurYPS(GFSDK_D3D12_GraphicsContext* pGra
 #endif
 
     ID3D12GraphicsCommandList* pCmdList = pGraphicsContext->pCmdList;
+    GPUTimer Timer(&m_TimestampQueries, pCmdList, REGIME_TIME_BLURY);
+    PROFILER_RANGE_SCOPE(pCmdList, BLURY);
 
     pCmdList->RSSetViewports(1, &m_InputDepth.Viewport);
 
@@ -645,7 +860,14 @@ void GFSDK::SSAO::D3D12::Renderer::Render(GFSDK_D3D12_GraphicsContext* pGraphics
 
     m_GlobalCB.UpdateBuffer(pGraphicsContext, RenderMask);
 
-    RenderHBAOPlus(pGraphicsContext, RenderMask);
+    m_TimestampQueries.Begin(pGraphicsContext);
+    {
+        GPUTimer Timer(&m_TimestampQueries, pGraphicsContext->pCmdList, REGIME_TIME_TOTAL);
+        PROFILER_RANGE_SCOPE(pGraphicsContext->pCmdList, TOTAL);
+        RenderHBAOPlus(pGraphicsContext, RenderMask);
+    }
+
+    m_TimestampQueries.End(pGraphicsContext, &m_RenderTimes);
 }
 
 //--------------------------------------------------------------------------------
@@ -760,7 +982,10 @@ GFSDK_SSAO_Status GFSDK::SSAO::D3D12::Renderer::SetAOParameters(const GFSDK_SSAO
         m_RTs.ReleaseResources();
     }
 
-    m_GlobalCB.SetAOParameters(Params, m_InputDepth);
+    {
+        CPU_TIMER_SCOPE(SET_AO_PARAMETERS);
+        m_GlobalCB.SetAOParameters(Params, m_InputDepth);
+    }
     m_Options = Params;
 
     return GFSDK_SSAO_OK;
@@ -827,4 +1052,23 @@ UINT GFSDK::SSAO::D3D12::Renderer::GetAllocatedVideoMemoryBytes()
     return m_RTs.GetCurrentAllocatedVideoMemoryBytes();
 }
 
+//--------------------------------------------------------------------------------
+GFSDK_SSAO_Status GFSDK::SSAO::D3D12::Renderer::GetRenderTimes(GFSDK_SSAO_RenderTimes* pRenderTimes)
+{
+    if (!pRenderTimes)
+    {
+        return GFSDK_SSAO_NULL_ARGUMENT;
+    }
+
+    m_RenderTimes.GetRenderTimes(pRenderTimes);
+
+    return GFSDK_SSAO_OK;
+}
+
+//--------------------------------------------------------------------------------
+GFSDK_SSAO_Status GFSDK::SSAO::D3D12::Renderer::SetProfilerHooks(const GFSDK_SSAO_ProfilerHooks& ProfilerHooks)
+{
+    return m_ProfilerHooks.Set(ProfilerHooks);
+}
+
 #endif // SUPPORT_D3D12
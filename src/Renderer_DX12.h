@@ -36,9 +36,11 @@
 #include "RenderTargets_DX12.h"
 #include "Shaders_DX12.h"
 #include "PipelineStateObjects_DX12.h"
+#include "PipelineLibrary_DX12.h"
 #include "States_DX12.h"
 #include "TimestampQueries.h"
 #include "BuildVersion.h"
+#include "ProfilerHooks.h"
 #include "PerfMarkers.h"
 
 namespace GFSDK
@@ -58,6 +60,7 @@ public:
     Renderer(GFSDK_SSAO_CustomHeap NewDelete)
         : m_NewDelete(NewDelete)
     {
+        m_RenderTimes.SetProfilerHooks(&m_ProfilerHooks);
     }
 
     //
@@ -68,6 +71,7 @@ public:
         ID3D12Device* pDevice, 
         GFSDK_SSAO_UINT NodeMask, 
         const GFSDK_SSAO_DescriptorHeaps_D3D12& DescriptorHeaps,
+        const GFSDK_SSAO_ContextDesc_D3D12& ContextDesc,
         GFSDK_SSAO_Version HeaderVersion);
 
     void Release();
@@ -78,10 +82,23 @@ public:
         UINT ViewportWidth,
         UINT ViewportHeight);
 
+    GFSDK_SSAO_Status PreCreateShaders(
+        const GFSDK_SSAO_Parameters* pParameters,
+        UINT NumParameters,
+        const GFSDK_SSAO_Output_D3D12* pOutput = NULL);
+
      GFSDK_SSAO_Status GetProjectionMatrixDepthRange(
          const GFSDK_SSAO_InputData_D3D12& InputData,
          GFSDK_SSAO_ProjectionMatrixDepthRange& OutputDepthRange);
 
+    GFSDK_SSAO_Status LoadPipelineCache(
+        const void* pData,
+        GFSDK_SSAO_SIZE_T DataSize);
+
+    GFSDK_SSAO_Status GetPipelineCacheData(
+        void* pData,
+        GFSDK_SSAO_SIZE_T* pDataSize);
+
     GFSDK_SSAO_Status RenderAO(
         ID3D12CommandQueue* pCmdQueue,
         ID3D12GraphicsCommandList* pCmdList,
@@ -92,6 +109,10 @@ public:
 
     UINT GetAllocatedVideoMemoryBytes();
 
+    GFSDK_SSAO_Status GetRenderTimes(GFSDK_SSAO_RenderTimes* pRenderTimes);
+
+    GFSDK_SSAO_Status SetProfilerHooks(const GFSDK_SSAO_ProfilerHooks& ProfilerHooks);
+
     //
     // Internals
     //
@@ -146,6 +167,7 @@ private:
 
     void CreateResources(GFSDK_D3D12_GraphicsContext* pD3DDevice);
     void ReleaseResources();
+    void AddPSOsForAllInputs(GFSDK_D3D12_GraphicsContext* pGraphicsContext, OutputInfo* pOutput, PSOCreationList& CreationList);
 
     void SetAOResolution(UINT Width, UINT Height);
     void SetAOResolution(const SSAO::InputViewport &Viewport);
@@ -191,6 +213,7 @@ private:
     GFSDK::SSAO::Viewports m_Viewports;
     GFSDK::SSAO::BuildVersion m_BuildVersion;
     GFSDK_SSAO_CustomHeap m_NewDelete;
+    GFSDK_SSAO_ContextDesc_D3D12 m_ContextDesc;
 
     LinearDepthPSO m_LinearDepthPSO;
     DebugNormalsPSO m_DebugNormalsPSO;
@@ -201,6 +224,11 @@ private:
     ReinterleavedAOPSO m_ReinterleavedAOPSO;
     BlurXPSO m_BlurXPSO;
     BlurYPSO m_BlurYPSO;
+    PipelineLibrary m_PipelineLibrary;
+    TimestampQueries m_TimestampQueries;
+    GFSDK::SSAO::RenderTimesHistory m_RenderTimes;
+    GFSDK::SSAO::CPUTimes m_CPUTimes;
+    GFSDK::SSAO::ProfilerHooks m_ProfilerHooks;
 
     GFSDK_D3D12_GraphicsContext m_GraphicsContext;
 };
@@ -29,10 +29,6 @@
 
 #if SUPPORT_GL
 
-#if ENABLE_RENDER_TIMES
-GFSDK::SSAO::RenderTimes GFSDK::SSAO::GL::Renderer::s_RenderTimes;
-#endif
-
 //--------------------------------------------------------------------------------
 GFSDK_SSAO_Status GFSDK::SSAO::GL::Renderer::Create(GFSDK_SSAO_Version HeaderVersion)
 {
@@ -74,9 +70,7 @@ void GFSDK::SSAO::GL::Renderer::CreateResources()
     m_PerPassCBs.Create(m_GL);
     m_Shaders.Create(m_GL);
     m_VAO.Create(m_GL);
-#if ENABLE_RENDER_TIMES
-    m_TimestampQueries.Create();
-#endif
+    m_TimestampQueries.Create(m_GL);
 }
 
 //--------------------------------------------------------------------------------
@@ -87,9 +81,7 @@ void GFSDK::SSAO::GL::Renderer::ReleaseResources()
     m_Shaders.Release(m_GL);
     m_VAO.Release(m_GL);
     m_RTs.Release(m_GL);
-#if ENABLE_RENDER_TIMES
-    m_TimestampQueries.Release();
-#endif
+    m_TimestampQueries.Release(m_GL);
 }
 
 //--------------------------------------------------------------------------------
@@ -133,7 +125,12 @@ GFSDK_SSAO_Status GFSDK::SSAO::GL::Renderer::RenderAO(
 {
     GFSDK_SSAO_Status Status;
 
-    Status = SetDataFlow(InputData, Parameters, Output);
+    CPU_FRAME_TIMER_BEGIN();
+
+    {
+        CPU_TIMER_SCOPE(SET_DATA_FLOW);
+        Status = SetDataFlow(InputData, Parameters, Output);
+    }
     if (Status != GFSDK_SSAO_OK)
     {
         return Status;
@@ -146,16 +143,41 @@ GFSDK_SSAO_Status GFSDK::SSAO::GL::Renderer::RenderAO(
     }
 
     GFSDK::SSAO::GL::AppState AppState;
-    AppState.Save(m_GL);
+    {
+        CPU_TIMER_SCOPE(SAVE_APP_STATE);
+        AppState.Save(m_GL);
+    }
 
-    Render(RenderMask);
+    m_TimestampQueries.Begin();
 
-    AppState.Restore(m_GL);
+#if ENABLE_EXCEPTIONS
+    try
+    {
+        CPU_TIMER_SCOPE(RENDER);
+        Render(RenderMask);
+    }
+    catch (const PermutationNotBuiltError&)
+    {
+        AppState.Restore(m_GL);
 
-#if ENABLE_RENDER_TIMES
-    m_TimestampQueries.GetAvailableTimers(&s_RenderTimes);
+        return GFSDK_SSAO_SHADER_PERMUTATION_NOT_BUILT;
+    }
+#else
+    {
+        CPU_TIMER_SCOPE(RENDER);
+        Render(RenderMask);
+    }
 #endif
 
+    {
+        CPU_TIMER_SCOPE(RESTORE_APP_STATE);
+        AppState.Restore(m_GL);
+    }
+
+    m_TimestampQueries.End(&m_RenderTimes);
+
+    CPU_FRAME_TIMER_END();
+
     return GFSDK_SSAO_OK;
 }
 
@@ -309,7 +331,10 @@ GFSDK_SSAO_Status GFSDK::SSAO::GL::Renderer::SetAOParameters(const GFSDK_SSAO_Pa
         m_RTs.ReleaseResources(m_GL);
     }
 
-    m_GlobalCB.SetAOParameters(Params, m_InputDepth);
+    {
+        CPU_TIMER_SCOPE(SET_AO_PARAMETERS);
+        m_GlobalCB.SetAOParameters(Params, m_InputDepth);
+    }
     m_Options.SetRenderOptions(Params);
 
     return GFSDK_SSAO_OK;
@@ -318,6 +343,9 @@ GFSDK_SSAO_Status GFSDK::SSAO::GL::Renderer::SetAOParameters(const GFSDK_SSAO_Pa
 //--------------------------------------------------------------------------------
 void GFSDK::SSAO::GL::Renderer::Render(GFSDK_SSAO_RenderMask RenderMask)
 {
+    GFSDK::SSAO::GL::GPUTimer timer(&m_TimestampQueries, GFSDK::SSAO::REGIME_TIME_TOTAL);
+    PROFILER_RANGE_SCOPE(NULL, TOTAL);
+
     m_GlobalCB.UpdateBuffer(m_GL, RenderMask);
 
     SetFullscreenState();
@@ -382,9 +410,8 @@ void GFSDK::SSAO::GL::Renderer::RenderHBAOPlus(GFSDK_SSAO_RenderMask RenderMask)
 //--------------------------------------------------------------------------------
 void GFSDK::SSAO::GL::Renderer::DrawLinearDepth(GFSDK::SSAO::GL::GLSLPrograms::CopyDepth_PS& Program)
 {
-#if ENABLE_RENDER_TIMES
     GFSDK::SSAO::GL::GPUTimer timer(&m_TimestampQueries, GFSDK::SSAO::REGIME_TIME_LINEAR_Z);
-#endif
+    PROFILER_RANGE_SCOPE(NULL, LINEAR_Z);
 
     if (m_InputDepth.DepthTextureType == GFSDK_SSAO_VIEW_DEPTHS &&
         m_InputDepth.Texture.SampleCount == 1 &&
@@ -410,9 +437,8 @@ void GFSDK::SSAO::GL::Renderer::DrawLinearDepth(GFSDK::SSAO::GL::GLSLPrograms::C
 //--------------------------------------------------------------------------------
 void GFSDK::SSAO::GL::Renderer::DrawDebugNormals(GLSLPrograms::DebugNormals_PS& Program)
 {
-#if ENABLE_RENDER_TIMES
     GFSDK::SSAO::GL::GPUTimer timer(&m_TimestampQueries, GFSDK::SSAO::REGIME_TIME_NORMAL);
-#endif
+    PROFILER_RANGE_SCOPE(NULL, NORMAL);
 
     m_States.SetBlendStateDisabled(m_GL);
 
@@ -429,9 +455,8 @@ void GFSDK::SSAO::GL::Renderer::DrawDebugNormals(GLSLPrograms::DebugNormals_PS&
 //--------------------------------------------------------------------------------
 void GFSDK::SSAO::GL::Renderer::DrawDeinterleavedDepth(GLSLPrograms::DeinterleaveDepth_PS& Program)
 {
-#if ENABLE_RENDER_TIMES
     GFSDK::SSAO::GL::GPUTimer timer(&m_TimestampQueries, GFSDK::SSAO::REGIME_TIME_DEINTERLEAVE_Z);
-#endif
+    PROFILER_RANGE_SCOPE(NULL, DEINTERLEAVE_Z);
 
     SetQuarterViewport();
 
@@ -453,9 +478,8 @@ void GFSDK::SSAO::GL::Renderer::DrawDeinterleavedDepth(GLSLPrograms::Deinterleav
 //--------------------------------------------------------------------------------
 void GFSDK::SSAO::GL::Renderer::DrawReconstructedNormal(GLSLPrograms::ReconstructNormal_PS& Program)
 {
-#if ENABLE_RENDER_TIMES
     GFSDK::SSAO::GL::GPUTimer timer(&m_TimestampQueries, GFSDK::SSAO::REGIME_TIME_NORMAL);
-#endif
+    PROFILER_RANGE_SCOPE(NULL, NORMAL);
 
     m_GL.glBindFramebuffer(GL_DRAW_FRAMEBUFFER, m_RTs.GetFullResNormalTexture(m_GL)->GetFramebuffer());
 
@@ -469,9 +493,8 @@ void GFSDK::SSAO::GL::Renderer::DrawReconstructedNormal(GLSLPrograms::Reconstruc
 //--------------------------------------------------------------------------------
 void GFSDK::SSAO::GL::Renderer::DrawCoarseAO(GLSLPrograms::CoarseAO_PS& Program)
 {
-#if ENABLE_RENDER_TIMES
     GFSDK::SSAO::GL::GPUTimer timer(&m_TimestampQueries, GFSDK::SSAO::REGIME_TIME_COARSE_AO);
-#endif
+    PROFILER_RANGE_SCOPE(NULL, COARSE_AO);
 
     SetQuarterViewport();
 
@@ -494,9 +517,8 @@ void GFSDK::SSAO::GL::Renderer::DrawCoarseAO(GLSLPrograms::CoarseAO_PS& Program)
 //--------------------------------------------------------------------------------
 void GFSDK::SSAO::GL::Renderer::DrawReinterleavedAO(GLSLPrograms::ReinterleaveAO_PS &Program)
 {
-#if ENABLE_RENDER_TIMES
     GFSDK::SSAO::GL::GPUTimer timer(&m_TimestampQueries, GFSDK::SSAO::REGIME_TIME_INTERLEAVE_AO);
-#endif
+    PROFILER_RANGE_SCOPE(NULL, INTERLEAVE_AO);
 
     ASSERT(!m_Options.Blur.Enable);
 
@@ -514,9 +536,8 @@ void GFSDK::SSAO::GL::Renderer::DrawReinterleavedAO(GLSLPrograms::ReinterleaveAO
 //--------------------------------------------------------------------------------
 void GFSDK::SSAO::GL::Renderer::DrawReinterleavedAO_PreBlur(GLSLPrograms::ReinterleaveAO_PS& Program)
 {
-#if ENABLE_RENDER_TIMES
     GFSDK::SSAO::GL::GPUTimer timer(&m_TimestampQueries, GFSDK::SSAO::REGIME_TIME_INTERLEAVE_AO);
-#endif
+    PROFILER_RANGE_SCOPE(NULL, INTERLEAVE_AO);
 
     ASSERT(m_Options.Blur.Enable);
 
@@ -533,9 +554,8 @@ void GFSDK::SSAO::GL::Renderer::DrawReinterleavedAO_PreBlur(GLSLPrograms::Reinte
 //--------------------------------------------------------------------------------
 void GFSDK::SSAO::GL::Renderer::DrawBlurX(GLSLPrograms::BlurX_PS &Program)
 {
-#if ENABLE_RENDER_TIMES
     GFSDK::SSAO::GL::GPUTimer timer(&m_TimestampQueries, GFSDK::SSAO::REGIME_TIME_BLURX);
-#endif
+    PROFILER_RANGE_SCOPE(NULL, BLURX);
 
     m_GL.glBindFramebuffer(GL_DRAW_FRAMEBUFFER, m_RTs.GetFullResAOZTexture(m_GL)->GetFramebuffer());
 
@@ -549,9 +569,8 @@ void GFSDK::SSAO::GL::Renderer::DrawBlurX(GLSLPrograms::BlurX_PS &Program)
 //--------------------------------------------------------------------------------
 void GFSDK::SSAO::GL::Renderer::DrawBlurY(GLSLPrograms::BlurY_PS &Program)
 {
-#if ENABLE_RENDER_TIMES
     GFSDK::SSAO::GL::GPUTimer timer(&m_TimestampQueries, GFSDK::SSAO::REGIME_TIME_BLURY);
-#endif
+    PROFILER_RANGE_SCOPE(NULL, BLURY);
 
     m_GL.glBindFramebuffer(GL_DRAW_FRAMEBUFFER, m_Output.FboId);
     SetOutputBlendState(m_GL);
@@ -570,4 +589,23 @@ UINT GFSDK::SSAO::GL::Renderer::GetAllocatedVideoMemoryBytes()
     return m_RTs.GetCurrentAllocatedVideoMemoryBytes();
 }
 
+//--------------------------------------------------------------------------------
+GFSDK_SSAO_Status GFSDK::SSAO::GL::Renderer::GetRenderTimes(GFSDK_SSAO_RenderTimes* pRenderTimes)
+{
+    if (!pRenderTimes)
+    {
+        return GFSDK_SSAO_NULL_ARGUMENT;
+    }
+
+    m_RenderTimes.GetRenderTimes(pRenderTimes);
+
+    return GFSDK_SSAO_OK;
+}
+
+//--------------------------------------------------------------------------------
+GFSDK_SSAO_Status GFSDK::SSAO::GL::Renderer::SetProfilerHooks(const GFSDK_SSAO_ProfilerHooks& ProfilerHooks)
+{
+    return m_ProfilerHooks.Set(ProfilerHooks);
+}
+
 #endif // SUPPORT_GL
@@ -41,6 +41,7 @@
 #include "AppState_GL.h"
 #include "TimestampQueries.h"
 #include "BuildVersion.h"
+#include "ProfilerHooks.h"
 #include "VAO_GL.h"
 
 namespace GFSDK
@@ -59,6 +60,7 @@ public:
         , m_NewDelete(NewDelete)
         , m_FullResViewDepthTextureId(0)
     {
+        m_RenderTimes.SetProfilerHooks(&m_ProfilerHooks);
     }
 
     //
@@ -69,6 +71,10 @@ public:
 
     UINT GetAllocatedVideoMemoryBytes();
 
+    GFSDK_SSAO_Status GetRenderTimes(GFSDK_SSAO_RenderTimes* pRenderTimes);
+
+    GFSDK_SSAO_Status SetProfilerHooks(const GFSDK_SSAO_ProfilerHooks& ProfilerHooks);
+
     void Release();
 
     GFSDK_SSAO_Status PreCreateFBOs(
@@ -86,14 +92,6 @@ public:
         const GFSDK_SSAO_Output_GL& Output,
         GFSDK_SSAO_RenderMask RenderMask = GFSDK_SSAO_RENDER_AO);
 
-    //
-    // Internals
-    //
-
-#if ENABLE_RENDER_TIMES
-    static GFSDK::SSAO::RenderTimes s_RenderTimes;
-#endif
-
 private:
     void CreateResources();
     void ReleaseResources();
@@ -228,9 +226,10 @@ private:
     GFSDK_SSAO_CustomHeap m_NewDelete;
     GFSDK_SSAO_GLFunctions m_GL;
     GFSDK::SSAO::BuildVersion m_BuildVersion;
-#if ENABLE_RENDER_TIMES
     GFSDK::SSAO::GL::TimestampQueries m_TimestampQueries;
-#endif
+    GFSDK::SSAO::RenderTimesHistory m_RenderTimes;
+    GFSDK::SSAO::CPUTimes m_CPUTimes;
+    GFSDK::SSAO::ProfilerHooks m_ProfilerHooks;
 };
 
 } // namespace GL
@@ -0,0 +1,308 @@
+// This code contains NVIDIA Confidential Information and is disclosed to you
+// under a form of NVIDIA software license agreement provided separately to you.
+//
+// Notice
+// NVIDIA Corporation and its licensors retain all intellectual property and
+// proprietary rights in and to this software and related documentation and
+// any modifications thereto. Any use, reproduction, disclosure, or
+// distribution of this software and related documentation without an express
+// license agreement from NVIDIA Corporation is strictly prohibited.
+//
+// ALL NVIDIA DESIGN SPECIFICATIONS, CODE ARE PROVIDED "AS IS.". NVIDIA MAKES
+// NO WARRANTIES, EXPRESSED, IMPLIED, STATUTORY, OR OTHERWISE WITH RESPECT TO
+// THE MATERIALS, AND EXPRESSLY DISCLAIMS ALL IMPLIED WARRANTIES OF NONINFRINGEMENT,
+// MERCHANTABILITY, AND FITNESS FOR A PARTICULAR PURPOSE.
+//
+// Information and code furnished is believed to be accurate and reliable.
+// However, NVIDIA Corporation assumes no responsibility for the consequences of use of such
+// information or for any infringement of patents or other rights of third parties that may
+// result from its use. No license is granted by implication or otherwise under any patent
+// or patent rights of NVIDIA Corporation. Details are subject to change without notice.
+// This code supersedes and replaces all information previously supplied.
+// NVIDIA Corporation products are not authorized for use as critical
+// components in life support devices or systems without express written approval of
+// NVIDIA Corporation.
+//
+// Copyright (c) 2008-2021 NVIDIA Corporation. All rights reserved.
+
+#pragma once
+#include "Common.h"
+
+#if defined(__SSE4_2__) || defined(_M_X64) || defined(__AVX2__) || defined(__AVX512F__)
+#include <immintrin.h>
+#endif
+
+// MSVC does not define __SSE4_2__, but accepts the SSE4 intrinsics on any x64 target
+#if defined(__SSE4_2__) || (defined(_MSC_VER) && defined(_M_X64))
+#define SIMD_CPU_SSE42 1
+#endif
+
+namespace GFSDK
+{
+namespace SSAO
+{
+namespace CPU
+{
+namespace SIMD
+{
+
+//--------------------------------------------------------------------------------
+// Thin wrappers over the x86 vector intrinsics, so that the same kernel templates
+// can be instantiated for several vector widths. Each wrapper is only visible in
+// translation units compiled with the corresponding instruction set enabled.
+//
+// Masks follow the D3D "if (Mask) A else B" convention of Select(Mask, A, B).
+// MinF/MaxF return the second operand when the first one is NaN, so that
+// MinF(MaxF(X, 0), 1) maps NaN to 0 like saturate() does on the GPU.
+//
+// FP16 values live in the low 16 bits of the Int lanes. Gather16 loads 32 bits per
+// lane, so the FP16 textures are allocated with 2 bytes of padding at the end.
+//--------------------------------------------------------------------------------
+
+#if SIMD_CPU_SSE42
+
+struct SSE42
+{
+    static const UINT Width = 4;
+
+    typedef __m128 Float;
+    typedef __m128i Int;
+    typedef __m128 Mask;
+
+    static Float Set1(float A)                           { return _mm_set1_ps(A); }
+    static Float LoadU(const FLOAT* pSrc)                { return _mm_loadu_ps(pSrc); }
+    static void StoreU(FLOAT* pDst, Float A)             { _mm_storeu_ps(pDst, A); }
+    static Float Add(Float A, Float B)                   { return _mm_add_ps(A, B); }
+    static Float Sub(Float A, Float B)                   { return _mm_sub_ps(A, B); }
+    static Float Mul(Float A, Float B)                   { return _mm_mul_ps(A, B); }
+    static Float Div(Float A, Float B)                   { return _mm_div_ps(A, B); }
+    static Float Sqrt(Float A)                           { return _mm_sqrt_ps(A); }
+    static Float MinF(Float A, Float B)                  { return _mm_min_ps(A, B); }
+    static Float MaxF(Float A, Float B)                  { return _mm_max_ps(A, B); }
+    static Float Round(Float A)                          { return _mm_round_ps(A, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC); }
+    static Float Floor(Float A)                          { return _mm_round_ps(A, _MM_FROUND_TO_NEG_INF | _MM_FROUND_NO_EXC); }
+    static Float Select(Mask M, Float A, Float B)        { return _mm_blendv_ps(B, A, M); }
+
+    static Mask CmpLT(Float A, Float B)                  { return _mm_cmplt_ps(A, B); }
+    static Mask And(Mask A, Mask B)                      { return _mm_and_ps(A, B); }
+    static Mask AndNot(Mask A, Mask B)                   { return _mm_andnot_ps(B, A); }
+    static bool Any(Mask M)                              { return _mm_movemask_ps(M) != 0; }
+
+    static Int Set1I(int A)                              { return _mm_set1_epi32(A); }
+    static Int IotaI()                                   { return _mm_setr_epi32(0, 1, 2, 3); }
+    static Int LoadI(const int* pSrc)                    { return _mm_loadu_si128((const __m128i*)pSrc); }
+    static void StoreI(int* pDst, Int A)                 { _mm_storeu_si128((__m128i*)pDst, A); }
+    static Int AddI(Int A, Int B)                        { return _mm_add_epi32(A, B); }
+    static Int SubI(Int A, Int B)                        { return _mm_sub_epi32(A, B); }
+    static Int MulI(Int A, Int B)                        { return _mm_mullo_epi32(A, B); }
+    static Int MinI(Int A, Int B)                        { return _mm_min_epi32(A, B); }
+    static Int MaxI(Int A, Int B)                        { return _mm_max_epi32(A, B); }
+    static Int AndI(Int A, Int B)                        { return _mm_and_si128(A, B); }
+    template<int N> static Int ShiftLeftI(Int A)         { return _mm_slli_epi32(A, N); }
+    template<int N> static Int ShiftRightI(Int A)        { return _mm_srai_epi32(A, N); }
+    static Mask CmpGTI(Int A, Int B)                     { return _mm_castsi128_ps(_mm_cmpgt_epi32(A, B)); }
+    static Int ToInt(Float A)                            { return _mm_cvtps_epi32(A); }
+    static Float ToFloat(Int A)                          { return _mm_cvtepi32_ps(A); }
+    static Int AsInt(Float A)                            { return _mm_castps_si128(A); }
+    static Float AsFloat(Int A)                          { return _mm_castsi128_ps(A); }
+
+    // No gathers before AVX2
+    static Float Gather(const FLOAT* pBase, Int Offsets)
+    {
+        return _mm_setr_ps(pBase[_mm_extract_epi32(Offsets, 0)],
+                           pBase[_mm_extract_epi32(Offsets, 1)],
+                           pBase[_mm_extract_epi32(Offsets, 2)],
+                           pBase[_mm_extract_epi32(Offsets, 3)]);
+    }
+    static Int Gather16(const void* pBase, Int Offsets)
+    {
+        const unsigned short* pHalves = (const unsigned short*)pBase;
+        return _mm_setr_epi32(pHalves[_mm_extract_epi32(Offsets, 0)],
+                              pHalves[_mm_extract_epi32(Offsets, 1)],
+                              pHalves[_mm_extract_epi32(Offsets, 2)],
+                              pHalves[_mm_extract_epi32(Offsets, 3)]);
+    }
+
+    // No F16C before AVX2. Same bit manipulations as FloatToHalf and HalfToFloat in Shaders_CPU.h.
+    static Float HalfToFloat(Int A)
+    {
+        const __m128i ShiftedExponent = _mm_set1_epi32(0x7C00 << 13);
+        __m128i Bits = _mm_slli_epi32(_mm_and_si128(A, _mm_set1_epi32(0x7FFF)), 13);
+        const __m128i Exponent = _mm_and_si128(Bits, ShiftedExponent);
+        Bits = _mm_add_epi32(Bits, _mm_set1_epi32((127 - 15) << 23));
+
+        const __m128i InfNaN = _mm_cmpeq_epi32(Exponent, ShiftedExponent);
+        Bits = _mm_add_epi32(Bits, _mm_and_si128(InfNaN, _mm_set1_epi32((128 - 16) << 23)));
+
+        const __m128i Denormal = _mm_cmpeq_epi32(Exponent, _mm_setzero_si128());
+        const __m128 Renormalized = _mm_sub_ps(_mm_castsi128_ps(_mm_add_epi32(Bits, _mm_set1_epi32(1 << 23))), _mm_castsi128_ps(_mm_set1_epi32(113 << 23)));
+        Bits = _mm_blendv_epi8(Bits, _mm_castps_si128(Renormalized), Denormal);
+
+        return _mm_castsi128_ps(_mm_or_si128(Bits, _mm_slli_epi32(_mm_and_si128(A, _mm_set1_epi32(0x8000)), 16)));
+    }
+    static Int FloatToHalf(Float A)
+    {
+        __m128i Bits = _mm_castps_si128(A);
+        const __m128i Sign = _mm_and_si128(_mm_srli_epi32(Bits, 16), _mm_set1_epi32(0x8000));
+        Bits = _mm_and_si128(Bits, _mm_set1_epi32(0x7FFFFFFF));
+
+        const __m128i InfNaN = _mm_cmpgt_epi32(Bits, _mm_set1_epi32(((127 + 16) << 23) - 1));
+        const __m128i NaN = _mm_cmpgt_epi32(Bits, _mm_set1_epi32(255 << 23));
+        const __m128i InfNaNHalf = _mm_blendv_epi8(_mm_set1_epi32(0x7C00), _mm_set1_epi32(0x7E00), NaN);
+
+        const __m128i DenormMagic = _mm_set1_epi32(((127 - 15) + (23 - 10) + 1) << 23);
+        const __m128i Denormal = _mm_cmplt_epi32(Bits, _mm_set1_epi32((127 - 14) << 23));
+        const __m128i DenormHalf = _mm_sub_epi32(_mm_castps_si128(_mm_add_ps(_mm_castsi128_ps(Bits), _mm_castsi128_ps(DenormMagic))), DenormMagic);
+
+        const __m128i MantissaOdd = _mm_and_si128(_mm_srli_epi32(Bits, 13), _mm_set1_epi32(1));
+        const __m128i NormalHalf = _mm_srli_epi32(_mm_add_epi32(_mm_add_epi32(Bits, _mm_set1_epi32(int((UINT(15 - 127) << 23) + 0xFFF))), MantissaOdd), 13);
+
+        __m128i Half = _mm_blendv_epi8(NormalHalf, DenormHalf, Denormal);
+        Half = _mm_blendv_epi8(Half, InfNaNHalf, InfNaN);
+        return _mm_or_si128(Half, Sign);
+    }
+    static void MaskStore(FLOAT* pDst, Mask M, Float A)
+    {
+        const int Bits = _mm_movemask_ps(M);
+        if (Bits == 0xF)
+        {
+            _mm_storeu_ps(pDst, A);
+            return;
+        }
+        FLOAT Lanes[Width];
+        _mm_storeu_ps(Lanes, A);
+        for (UINT Lane = 0; Lane < Width; ++Lane)
+        {
+            if (Bits & (1 << Lane))
+            {
+                pDst[Lane] = Lanes[Lane];
+            }
+        }
+    }
+};
+
+#endif // SIMD_CPU_SSE42
+
+#if defined(__AVX2__)
+
+struct AVX2
+{
+    static const UINT Width = 8;
+
+    typedef __m256 Float;
+    typedef __m256i Int;
+    typedef __m256 Mask;
+
+    static Float Set1(float A)                           { return _mm256_set1_ps(A); }
+    static Float LoadU(const FLOAT* pSrc)                { return _mm256_loadu_ps(pSrc); }
+    static void StoreU(FLOAT* pDst, Float A)             { _mm256_storeu_ps(pDst, A); }
+    static Float Add(Float A, Float B)                   { return _mm256_add_ps(A, B); }
+    static Float Sub(Float A, Float B)                   { return _mm256_sub_ps(A, B); }
+    static Float Mul(Float A, Float B)                   { return _mm256_mul_ps(A, B); }
+    static Float Div(Float A, Float B)                   { return _mm256_div_ps(A, B); }
+    static Float Sqrt(Float A)                           { return _mm256_sqrt_ps(A); }
+    static Float MinF(Float A, Float B)                  { return _mm256_min_ps(A, B); }
+    static Float MaxF(Float A, Float B)                  { return _mm256_max_ps(A, B); }
+    static Float Round(Float A)                          { return _mm256_round_ps(A, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC); }
+    static Float Floor(Float A)                          { return _mm256_round_ps(A, _MM_FROUND_TO_NEG_INF | _MM_FROUND_NO_EXC); }
+    static Float Select(Mask M, Float A, Float B)        { return _mm256_blendv_ps(B, A, M); }
+
+    static Mask CmpLT(Float A, Float B)                  { return _mm256_cmp_ps(A, B, _CMP_LT_OQ); }
+    static Mask And(Mask A, Mask B)                      { return _mm256_and_ps(A, B); }
+    static Mask AndNot(Mask A, Mask B)                   { return _mm256_andnot_ps(B, A); }
+    static bool Any(Mask M)                              { return _mm256_movemask_ps(M) != 0; }
+
+    static Int Set1I(int A)                              { return _mm256_set1_epi32(A); }
+    static Int IotaI()                                   { return _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7); }
+    static Int LoadI(const int* pSrc)                    { return _mm256_loadu_si256((const __m256i*)pSrc); }
+    static void StoreI(int* pDst, Int A)                 { _mm256_storeu_si256((__m256i*)pDst, A); }
+    static Int AddI(Int A, Int B)                        { return _mm256_add_epi32(A, B); }
+    static Int SubI(Int A, Int B)                        { return _mm256_sub_epi32(A, B); }
+    static Int MulI(Int A, Int B)                        { return _mm256_mullo_epi32(A, B); }
+    static Int MinI(Int A, Int B)                        { return _mm256_min_epi32(A, B); }
+    static Int MaxI(Int A, Int B)                        { return _mm256_max_epi32(A, B); }
+    static Int AndI(Int A, Int B)                        { return _mm256_and_si256(A, B); }
+    template<int N> static Int ShiftLeftI(Int A)         { return _mm256_slli_epi32(A, N); }
+    template<int N> static Int ShiftRightI(Int A)        { return _mm256_srai_epi32(A, N); }
+    static Mask CmpGTI(Int A, Int B)                     { return _mm256_castsi256_ps(_mm256_cmpgt_epi32(A, B)); }
+    static Int ToInt(Float A)                            { return _mm256_cvtps_epi32(A); }
+    static Float ToFloat(Int A)                          { return _mm256_cvtepi32_ps(A); }
+    static Int AsInt(Float A)                            { return _mm256_castps_si256(A); }
+    static Float AsFloat(Int A)                          { return _mm256_castsi256_ps(A); }
+
+    static Float Gather(const FLOAT* pBase, Int Offsets) { return _mm256_i32gather_ps(pBase, Offsets, sizeof(FLOAT)); }
+    static Int Gather16(const void* pBase, Int Offsets)  { return _mm256_i32gather_epi32((const int*)pBase, Offsets, 2); }
+    static void MaskStore(FLOAT* pDst, Mask M, Float A)  { _mm256_maskstore_ps(pDst, _mm256_castps_si256(M), A); }
+
+    // F16C
+    static Float HalfToFloat(Int A)
+    {
+        const __m256i Halves = _mm256_and_si256(A, _mm256_set1_epi32(0xFFFF));
+        return _mm256_cvtph_ps(_mm_packus_epi32(_mm256_castsi256_si128(Halves), _mm256_extracti128_si256(Halves, 1)));
+    }
+    static Int FloatToHalf(Float A)                      { return _mm256_cvtepu16_epi32(_mm256_cvtps_ph(A, _MM_FROUND_TO_NEAREST_INT)); }
+};
+
+#endif // __AVX2__
+
+#if defined(__AVX512F__)
+
+struct AVX512
+{
+    static const UINT Width = 16;
+
+    typedef __m512 Float;
+    typedef __m512i Int;
+    typedef __mmask16 Mask;
+
+    static Float Set1(float A)                           { return _mm512_set1_ps(A); }
+    static Float LoadU(const FLOAT* pSrc)                { return _mm512_loadu_ps(pSrc); }
+    static void StoreU(FLOAT* pDst, Float A)             { _mm512_storeu_ps(pDst, A); }
+    static Float Add(Float A, Float B)                   { return _mm512_add_ps(A, B); }
+    static Float Sub(Float A, Float B)                   { return _mm512_sub_ps(A, B); }
+    static Float Mul(Float A, Float B)                   { return _mm512_mul_ps(A, B); }
+    static Float Div(Float A, Float B)                   { return _mm512_div_ps(A, B); }
+    static Float Sqrt(Float A)                           { return _mm512_sqrt_ps(A); }
+    static Float MinF(Float A, Float B)                  { return _mm512_min_ps(A, B); }
+    static Float MaxF(Float A, Float B)                  { return _mm512_max_ps(A, B); }
+    static Float Round(Float A)                          { return _mm512_roundscale_ps(A, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC); }
+    static Float Floor(Float A)                          { return _mm512_roundscale_ps(A, _MM_FROUND_TO_NEG_INF | _MM_FROUND_NO_EXC); }
+    static Float Select(Mask M, Float A, Float B)        { return _mm512_mask_blend_ps(M, B, A); }
+
+    static Mask CmpLT(Float A, Float B)                  { return _mm512_cmp_ps_mask(A, B, _CMP_LT_OQ); }
+    static Mask And(Mask A, Mask B)                      { return Mask(A & B); }
+    static Mask AndNot(Mask A, Mask B)                   { return Mask(A & ~B); }
+    static bool Any(Mask M)                              { return M != 0; }
+
+    static Int Set1I(int A)                              { return _mm512_set1_epi32(A); }
+    static Int IotaI()                                   { return _mm512_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15); }
+    static Int LoadI(const int* pSrc)                    { return _mm512_loadu_si512(pSrc); }
+    static void StoreI(int* pDst, Int A)                 { _mm512_storeu_si512(pDst, A); }
+    static Int AddI(Int A, Int B)                        { return _mm512_add_epi32(A, B); }
+    static Int SubI(Int A, Int B)                        { return _mm512_sub_epi32(A, B); }
+    static Int MulI(Int A, Int B)                        { return _mm512_mullo_epi32(A, B); }
+    static Int MinI(Int A, Int B)                        { return _mm512_min_epi32(A, B); }
+    static Int MaxI(Int A, Int B)                        { return _mm512_max_epi32(A, B); }
+    static Int AndI(Int A, Int B)                        { return _mm512_and_si512(A, B); }
+    template<int N> static Int ShiftLeftI(Int A)         { return _mm512_slli_epi32(A, N); }
+    template<int N> static Int ShiftRightI(Int A)        { return _mm512_srai_epi32(A, N); }
+    static Mask CmpGTI(Int A, Int B)                     { return _mm512_cmpgt_epi32_mask(A, B); }
+    static Int ToInt(Float A)                            { return _mm512_cvtps_epi32(A); }
+    static Float ToFloat(Int A)                          { return _mm512_cvtepi32_ps(A); }
+    static Int AsInt(Float A)                            { return _mm512_castps_si512(A); }
+    static Float AsFloat(Int A)                          { return _mm512_castsi512_ps(A); }
+
+    static Float Gather(const FLOAT* pBase, Int Offsets) { return _mm512_i32gather_ps(Offsets, pBase, sizeof(FLOAT)); }
+    static Int Gather16(const void* pBase, Int Offsets)  { return _mm512_i32gather_epi32(Offsets, pBase, 2); }
+    static void MaskStore(FLOAT* pDst, Mask M, Float A)  { _mm512_mask_storeu_ps(pDst, M, A); }
+
+    static Float HalfToFloat(Int A)                      { return _mm512_cvtph_ps(_mm512_cvtepi32_epi16(A)); }
+    static Int FloatToHalf(Float A)                      { return _mm512_cvtepu16_epi32(_mm512_cvtps_ph(A, _MM_FROUND_TO_NEAREST_INT)); }
+};
+
+#endif // __AVX512F__
+
+} // namespace SIMD
+} // namespace CPU
+} // namespace SSAO
+} // namespace GFSDK
@@ -0,0 +1,185 @@
+// This code contains NVIDIA Confidential Information and is disclosed to you
+// under a form of NVIDIA software license agreement provided separately to you.
+//
+// Notice
+// NVIDIA Corporation and its licensors retain all intellectual property and
+// proprietary rights in and to this software and related documentation and
+// any modifications thereto. Any use, reproduction, disclosure, or
+// distribution of this software and related documentation without an express
+// license agreement from NVIDIA Corporation is strictly prohibited.
+//
+// ALL NVIDIA DESIGN SPECIFICATIONS, CODE ARE PROVIDED "AS IS.". NVIDIA MAKES
+// NO WARRANTIES, EXPRESSED, IMPLIED, STATUTORY, OR OTHERWISE WITH RESPECT TO
+// THE MATERIALS, AND EXPRESSLY DISCLAIMS ALL IMPLIED WARRANTIES OF NONINFRINGEMENT,
+// MERCHANTABILITY, AND FITNESS FOR A PARTICULAR PURPOSE.
+//
+// Information and code furnished is believed to be accurate and reliable.
+// However, NVIDIA Corporation assumes no responsibility for the consequences of use of such
+// information or for any infringement of patents or other rights of third parties that may
+// result from its use. No license is granted by implication or otherwise under any patent
+// or patent rights of NVIDIA Corporation. Details are subject to change without notice.
+// This code supersedes and replaces all information previously supplied.
+// NVIDIA Corporation products are not authorized for use as critical
+// components in life support devices or systems without express written approval of
+// NVIDIA Corporation.
+//
+// Copyright (c) 2008-2021 NVIDIA Corporation. All rights reserved.
+
+#pragma once
+
+#include <assert.h>
+#include <stdlib.h>
+#include <string.h>
+#include <atomic>
+
+//--------------------------------------------------------------------------------
+// GFSDK_SSAO_INCBIN(SYMBOL, FILE) defines "const char SYMBOL[]" with the contents of the
+// file GFSDK_SSAO_SHADER_BLOB_DIR/FILE, through the .incbin directive of the assembler.
+// The shaders generated by ShaderBuildTool --binary use it to link their ENTRY_POINT.bin,
+// with one ShaderBlobEntry per instance, so the includer defines GFSDK_SSAO_SHADER_BLOB_DIR as
+// the absolute path of their output directory first. The build system does not see the .bin files as dependencies of the
+// including source, which must list them itself (e.g. with the OBJECT_DEPENDS property).
+//--------------------------------------------------------------------------------
+
+#if defined(__APPLE__)
+#define GFSDK_SSAO_INCBIN_SECTION ".const_data\n"
+#define GFSDK_SSAO_INCBIN_SYMBOL(SYMBOL) ".private_extern _" #SYMBOL "\n_" #SYMBOL ":\n"
+#define GFSDK_SSAO_INCBIN_END ".text\n"
+#elif defined(__ELF__)
+#define GFSDK_SSAO_INCBIN_SECTION ".pushsection .rodata\n"
+#define GFSDK_SSAO_INCBIN_SYMBOL(SYMBOL) ".global " #SYMBOL "\n.hidden " #SYMBOL "\n.type " #SYMBOL ", %object\n" #SYMBOL ":\n"
+#define GFSDK_SSAO_INCBIN_END ".popsection\n"
+#else
+#error "GFSDK_SSAO_INCBIN requires an ELF or Mach-O target. Generate the shaders without --binary for MSVC."
+#endif
+
+#define GFSDK_SSAO_INCBIN(SYMBOL, FILE) \
+    extern "C" const char SYMBOL[]; \
+    __asm__( \
+        GFSDK_SSAO_INCBIN_SECTION \
+        ".balign 16\n" \
+        GFSDK_SSAO_INCBIN_SYMBOL(SYMBOL) \
+        ".incbin \"" GFSDK_SSAO_SHADER_BLOB_DIR "/" FILE "\"\n" \
+        GFSDK_SSAO_INCBIN_END)
+
+namespace GFSDK
+{
+namespace SSAO
+{
+
+//--------------------------------------------------------------------------------
+// Decodes an LZ4 block (as written by ShaderBuildTool --compress) of exactly DstSize bytes
+//--------------------------------------------------------------------------------
+inline bool DecompressLZ4(const unsigned char* pSrc, size_t SrcSize, unsigned char* pDst, size_t DstSize)
+{
+    const unsigned char* pSrcEnd = pSrc + SrcSize;
+    unsigned char* pOut = pDst;
+    unsigned char* pDstEnd = pDst + DstSize;
+
+    while (pSrc < pSrcEnd)
+    {
+        const unsigned int Token = *pSrc++;
+
+        size_t Length = Token >> 4;
+        if (Length == 15)
+        {
+            unsigned int Byte;
+            do
+            {
+                if (pSrc == pSrcEnd) return false;
+                Byte = *pSrc++;
+                Length += Byte;
+            } while (Byte == 255);
+        }
+        if (Length > size_t(pSrcEnd - pSrc) || Length > size_t(pDstEnd - pOut)) return false;
+        memcpy(pOut, pSrc, Length);
+        pOut += Length;
+        pSrc += Length;
+
+        // The last sequence only has literals
+        if (pSrc == pSrcEnd) break;
+
+        if (pSrcEnd - pSrc < 2) return false;
+        const size_t Offset = size_t(pSrc[0]) | (size_t(pSrc[1]) << 8);
+        pSrc += 2;
+        if (Offset == 0 || Offset > size_t(pOut - pDst)) return false;
+
+        Length = Token & 15;
+        if (Length == 15)
+        {
+            unsigned int Byte;
+            do
+            {
+                if (pSrc == pSrcEnd) return false;
+                Byte = *pSrc++;
+                Length += Byte;
+            } while (Byte == 255);
+        }
+        Length += 4;
+        if (Length > size_t(pDstEnd - pOut)) return false;
+
+        // The match may overlap the bytes it produces
+        const unsigned char* pMatch = pOut - Offset;
+        for (size_t i = 0; i < Length; ++i)
+        {
+            pOut[i] = pMatch[i];
+        }
+        pOut += Length;
+    }
+
+    return pOut == pDstEnd;
+}
+
+//--------------------------------------------------------------------------------
+// One shader instance in a blob linked with GFSDK_SSAO_INCBIN. The instances stored compressed
+// (StoredSize != Size) are decompressed the first time GetData() is called, and stay resident
+// until the library is unloaded. The data is always zero-terminated.
+//--------------------------------------------------------------------------------
+struct ShaderBlobEntry
+{
+    const char* pBlob;
+    unsigned int Offset;
+    unsigned int StoredSize;
+    unsigned int Size;
+    std::atomic<char*> pDecompressed;
+
+    ~ShaderBlobEntry()
+    {
+        free(pDecompressed.load());
+    }
+
+    const char* GetData()
+    {
+        if (StoredSize == Size)
+        {
+            return pBlob + Offset;
+        }
+
+        char* pData = pDecompressed.load(std::memory_order_acquire);
+        if (!pData)
+        {
+            char* pNewData = (char*)malloc(Size + 1);
+            if (!pNewData || !DecompressLZ4((const unsigned char*)pBlob + Offset, StoredSize, (unsigned char*)pNewData, Size))
+            {
+                assert(!"Corrupted shader blob");
+                free(pNewData);
+                return NULL;
+            }
+            pNewData[Size] = 0;
+
+            // Another thread may have decompressed it first
+            if (pDecompressed.compare_exchange_strong(pData, pNewData, std::memory_order_acq_rel))
+            {
+                pData = pNewData;
+            }
+            else
+            {
+                free(pNewData);
+            }
+        }
+        return pData;
+    }
+};
+
+} // namespace SSAO
+} // namespace GFSDK
@@ -0,0 +1,1192 @@
+// This code contains NVIDIA Confidential Information and is disclosed to you
+// under a form of NVIDIA software license agreement provided separately to you.
+//
+// Notice
+// NVIDIA Corporation and its licensors retain all intellectual property and
+// proprietary rights in and to this software and related documentation and
+// any modifications thereto. Any use, reproduction, disclosure, or
+// distribution of this software and related documentation without an express
+// license agreement from NVIDIA Corporation is strictly prohibited.
+//
+// ALL NVIDIA DESIGN SPECIFICATIONS, CODE ARE PROVIDED "AS IS.". NVIDIA MAKES
+// NO WARRANTIES, EXPRESSED, IMPLIED, STATUTORY, OR OTHERWISE WITH RESPECT TO
+// THE MATERIALS, AND EXPRESSLY DISCLAIMS ALL IMPLIED WARRANTIES OF NONINFRINGEMENT,
+// MERCHANTABILITY, AND FITNESS FOR A PARTICULAR PURPOSE.
+//
+// Information and code furnished is believed to be accurate and reliable.
+// However, NVIDIA Corporation assumes no responsibility for the consequences of use of such
+// information or for any infringement of patents or other rights of third parties that may
+// result from its use. No license is granted by implication or otherwise under any patent
+// or patent rights of NVIDIA Corporation. Details are subject to change without notice.
+// This code supersedes and replaces all information previously supplied.
+// NVIDIA Corporation products are not authorized for use as critical
+// components in life support devices or systems without express written approval of
+// NVIDIA Corporation.
+//
+// Copyright (c) 2008-2021 NVIDIA Corporation. All rights reserved.
+
+#if SUPPORT_CPU
+
+#include "Shaders_CPU.h"
+
+#if defined(_MSC_VER) && (ENABLE_CPU_SSE42 || ENABLE_CPU_AVX2 || ENABLE_CPU_AVX512)
+#include <intrin.h>
+#endif
+
+namespace GFSDK
+{
+namespace SSAO
+{
+namespace CPU
+{
+namespace Scalar
+{
+
+//--------------------------------------------------------------------------------
+// HLSL intrinsics
+//--------------------------------------------------------------------------------
+
+// Like the GPU, saturate(NaN) returns 0
+inline float saturate(float x)
+{
+    return (x > 0.f) ? ((x < 1.f) ? x : 1.f) : 0.f;
+}
+
+inline float lerp(float a, float b, float t)
+{
+    return a + (b - a) * t;
+}
+
+inline float dot(const float3& A, const float3& B)
+{
+    return A.X * B.X + A.Y * B.Y + A.Z * B.Z;
+}
+
+inline float3 sub(const float3& A, const float3& B)
+{
+    float3 R = { A.X - B.X, A.Y - B.Y, A.Z - B.Z };
+    return R;
+}
+
+inline float3 cross(const float3& A, const float3& B)
+{
+    float3 R = { A.Y * B.Z - A.Z * B.Y, A.Z * B.X - A.X * B.Z, A.X * B.Y - A.Y * B.X };
+    return R;
+}
+
+inline float3 normalize(const float3& V)
+{
+    const float InvLength = 1.f / sqrtf(dot(V, V));
+    float3 R = { V.X * InvLength, V.Y * InvLength, V.Z * InvLength };
+    return R;
+}
+
+//--------------------------------------------------------------------------------
+// Point sampling with D3D11_TEXTURE_ADDRESS_CLAMP or D3D11_TEXTURE_ADDRESS_BORDER.
+// The border color of the AO depth sampler is (-FLT_MAX,0,0,0), see States_DX11.cpp.
+//--------------------------------------------------------------------------------
+template<class TexelType>
+inline float PointSample(const TextureSRV<TexelType>& Texture, int X, int Y, UINT Channel, GFSDK_SSAO_DepthClampMode ClampMode)
+{
+    if (X < 0 || Y < 0 || X >= int(Texture.Width) || Y >= int(Texture.Height))
+    {
+        if (ClampMode == GFSDK_SSAO_CLAMP_TO_BORDER)
+        {
+            return (Channel == 0) ? -FLT_MAX : 0.f;
+        }
+        X = Clamp(X, 0, int(Texture.Width) - 1);
+        Y = Clamp(Y, 0, int(Texture.Height) - 1);
+    }
+    return DecodeTexel(Texture.Load(UINT(X), UINT(Y))[Channel]);
+}
+
+//--------------------------------------------------------------------------------
+inline float3 UVToView(const SSAO::GlobalConstantBuffer& CB, float U, float V, float ViewDepth)
+{
+    float3 P = { (CB.f2UVToViewA.X * U + CB.f2UVToViewB.X) * ViewDepth,
+                 (CB.f2UVToViewA.Y * V + CB.f2UVToViewB.Y) * ViewDepth,
+                 ViewDepth };
+    return P;
+}
+
+//--------------------------------------------------------------------------------
+// LinearizeDepth_PS.hlsl & CopyDepth_PS.hlsl
+//--------------------------------------------------------------------------------
+inline float ConvertToViewDepth(const SSAO::GlobalConstantBuffer& CB, float HardwareDepth)
+{
+    float NormalizedDepth = saturate(CB.fInverseDepthRangeA * HardwareDepth + CB.fInverseDepthRangeB);
+
+    return 1.f / (NormalizedDepth * CB.fLinearizeDepthA + CB.fLinearizeDepthB);
+}
+
+inline float LoadViewDepth(const SSAO::GlobalConstantBuffer& CB, const ShaderResourceView& DepthTexture, bool ViewDepths, UINT X, UINT Y)
+{
+    const float Depth = DepthTexture.Load(X, Y)[0];
+    return ViewDepths ? Depth : ConvertToViewDepth(CB, Depth);
+}
+
+template<ShaderPermutations::DEPTH_LAYER_COUNT DEPTH_LAYER_COUNT>
+void LinearizeDepth_PS(const LinearizeDepthArgs& Args, UINT RowBegin, UINT RowEnd)
+{
+    const SSAO::GlobalConstantBuffer& CB = *Args.pGlobalCB;
+    const UINT OffsetX = UINT(CB.f2InputViewportTopLeft.X);
+    const UINT OffsetY = UINT(CB.f2InputViewportTopLeft.Y);
+    const UINT Width = Args.ViewDepthTexture[0].Width;
+
+    for (UINT Y = RowBegin; Y < RowEnd; ++Y)
+    {
+        for (UINT X = 0; X < Width; ++X)
+        {
+            const float ViewDepth0 = LoadViewDepth(CB, Args.DepthTexture[0], Args.ViewDepths, X + OffsetX, Y + OffsetY);
+
+            if (DEPTH_LAYER_COUNT == ShaderPermutations::DEPTH_LAYER_COUNT_2)
+            {
+                const float ViewDepth1 = LoadViewDepth(CB, Args.DepthTexture[1], Args.ViewDepths, X + OffsetX, Y + OffsetY);
+
+                *Args.ViewDepthTexture[0].Store(X, Y) = Min(ViewDepth0, ViewDepth1);
+                *Args.ViewDepthTexture[1].Store(X, Y) = Max(ViewDepth0, ViewDepth1);
+            }
+            else
+            {
+                *Args.ViewDepthTexture[0].Store(X, Y) = ViewDepth0;
+            }
+        }
+    }
+}
+
+//--------------------------------------------------------------------------------
+// DeinterleaveDepth_PS.hlsl
+// Slice (I,J) of quarter-res pixel (X,Y) holds full-res pixel (4*X+I, 4*Y+J), with clamp-to-edge
+//--------------------------------------------------------------------------------
+template<ShaderPermutations::DEPTH_LAYER_COUNT DEPTH_LAYER_COUNT, class TexelType>
+void DeinterleaveDepth(const DeinterleaveDepthArgs& Args, const TextureRTV<TexelType>* pSlices, UINT RowBegin, UINT RowEnd)
+{
+    const ShaderResourceView& FullRes0 = Args.ViewDepthTexture[0];
+    const ShaderResourceView& FullRes1 = Args.ViewDepthTexture[1];
+    const UINT QuarterWidth = pSlices[0].Width;
+    const bool DualLayer = (DEPTH_LAYER_COUNT == ShaderPermutations::DEPTH_LAYER_COUNT_2);
+
+    for (UINT Y = RowBegin; Y < RowEnd; ++Y)
+    {
+        for (UINT J = 0; J < 4; ++J)
+        {
+            const UINT FullResY = Min(Y * 4 + J, FullRes0.Height - 1);
+
+            for (UINT X = 0; X < QuarterWidth; ++X)
+            {
+                for (UINT I = 0; I < 4; ++I)
+                {
+                    const UINT FullResX = Min(X * 4 + I, FullRes0.Width - 1);
+                    TexelType* pOut = pSlices[J * 4 + I].Store(X, Y);
+
+                    EncodeTexel(pOut[0], FullRes0.Load(FullResX, FullResY)[0]);
+                    if (DualLayer)
+                    {
+                        EncodeTexel(pOut[1], FullRes1.Load(FullResX, FullResY)[0]);
+                    }
+                }
+            }
+        }
+    }
+}
+
+template<ShaderPermutations::DEPTH_LAYER_COUNT DEPTH_LAYER_COUNT>
+void DeinterleaveDepth_PS(const DeinterleaveDepthArgs& Args, UINT RowBegin, UINT RowEnd)
+{
+    if (Args.HalfViewDepths)
+    {
+        DeinterleaveDepth<DEPTH_LAYER_COUNT>(Args, Args.QuarterResHalfViewDepthTexture, RowBegin, RowEnd);
+    }
+    else
+    {
+        DeinterleaveDepth<DEPTH_LAYER_COUNT>(Args, Args.QuarterResViewDepthTexture, RowBegin, RowEnd);
+    }
+}
+
+//--------------------------------------------------------------------------------
+// LinearizeDepth_PS.hlsl followed by DeinterleaveDepth_PS.hlsl, without the full-res view depths
+//--------------------------------------------------------------------------------
+template<ShaderPermutations::DEPTH_LAYER_COUNT DEPTH_LAYER_COUNT, class TexelType>
+void LinearizeDeinterleaveDepth(const LinearizeDeinterleaveDepthArgs& Args, const TextureRTV<TexelType>* pSlices, UINT RowBegin, UINT RowEnd)
+{
+    const SSAO::GlobalConstantBuffer& CB = *Args.pGlobalCB;
+    const UINT OffsetX = UINT(CB.f2InputViewportTopLeft.X);
+    const UINT OffsetY = UINT(CB.f2InputViewportTopLeft.Y);
+    const UINT QuarterWidth = pSlices[0].Width;
+    const bool DualLayer = (DEPTH_LAYER_COUNT == ShaderPermutations::DEPTH_LAYER_COUNT_2);
+
+    for (UINT Y = RowBegin; Y < RowEnd; ++Y)
+    {
+        for (UINT J = 0; J < 4; ++J)
+        {
+            const UINT FullResY = Min(Y * 4 + J, Args.Height - 1) + OffsetY;
+
+            for (UINT X = 0; X < QuarterWidth; ++X)
+            {
+                for (UINT I = 0; I < 4; ++I)
+                {
+                    const UINT FullResX = Min(X * 4 + I, Args.Width - 1) + OffsetX;
+                    TexelType* pOut = pSlices[J * 4 + I].Store(X, Y);
+
+                    const float ViewDepth0 = LoadViewDepth(CB, Args.DepthTexture[0], Args.ViewDepths, FullResX, FullResY);
+                    if (DualLayer)
+                    {
+                        const float ViewDepth1 = LoadViewDepth(CB, Args.DepthTexture[1], Args.ViewDepths, FullResX, FullResY);
+                        EncodeTexel(pOut[0], Min(ViewDepth0, ViewDepth1));
+                        EncodeTexel(pOut[1], Max(ViewDepth0, ViewDepth1));
+                    }
+                    else
+                    {
+                        EncodeTexel(pOut[0], ViewDepth0);
+                    }
+                }
+            }
+        }
+    }
+}
+
+template<ShaderPermutations::DEPTH_LAYER_COUNT DEPTH_LAYER_COUNT>
+void LinearizeDeinterleaveDepth_PS(const LinearizeDeinterleaveDepthArgs& Args, UINT RowBegin, UINT RowEnd)
+{
+    if (Args.HalfViewDepths)
+    {
+        LinearizeDeinterleaveDepth<DEPTH_LAYER_COUNT>(Args, Args.QuarterResHalfViewDepthTexture, RowBegin, RowEnd);
+    }
+    else
+    {
+        LinearizeDeinterleaveDepth<DEPTH_LAYER_COUNT>(Args, Args.QuarterResViewDepthTexture, RowBegin, RowEnd);
+    }
+}
+
+//--------------------------------------------------------------------------------
+// ReconstructNormal_Common.hlsl
+//--------------------------------------------------------------------------------
+inline float3 FetchFullResViewPos(const SSAO::GlobalConstantBuffer& CB, const ShaderResourceView& ViewDepthTexture, GFSDK_SSAO_DepthClampMode ClampMode, int X, int Y)
+{
+    const float U = (float(X) + 0.5f) * CB.f2InvFullResolution.X;
+    const float V = (float(Y) + 0.5f) * CB.f2InvFullResolution.Y;
+    const float ViewDepth = PointSample(ViewDepthTexture, X, Y, 0, ClampMode);
+    return UVToView(CB, U, V, ViewDepth);
+}
+
+inline float3 MinDiff(const float3& P, const float3& Pr, const float3& Pl)
+{
+    const float3 V1 = sub(Pr, P);
+    const float3 V2 = sub(P, Pl);
+    return (dot(V1,V1) < dot(V2,V2)) ? V1 : V2;
+}
+
+inline float3 ReconstructNormal(const SSAO::GlobalConstantBuffer& CB, const ShaderResourceView& ViewDepthTexture, GFSDK_SSAO_DepthClampMode ClampMode, int X, int Y, const float3& P)
+{
+    const float3 Pr = FetchFullResViewPos(CB, ViewDepthTexture, ClampMode, X + 1, Y);
+    const float3 Pl = FetchFullResViewPos(CB, ViewDepthTexture, ClampMode, X - 1, Y);
+    const float3 Pt = FetchFullResViewPos(CB, ViewDepthTexture, ClampMode, X, Y + 1);
+    const float3 Pb = FetchFullResViewPos(CB, ViewDepthTexture, ClampMode, X, Y - 1);
+    return normalize(cross(MinDiff(P, Pr, Pl), MinDiff(P, Pt, Pb)));
+}
+
+void ReconstructNormal_PS(const ReconstructNormalArgs& Args, UINT RowBegin, UINT RowEnd)
+{
+    const SSAO::GlobalConstantBuffer& CB = *Args.pGlobalCB;
+
+    for (UINT Y = RowBegin; Y < RowEnd; ++Y)
+    {
+        for (UINT X = 0; X < Args.NormalTexture.Width; ++X)
+        {
+            const float3 P = FetchFullResViewPos(CB, Args.ViewDepthTexture, Args.DepthClampMode, int(X), int(Y));
+            const float3 N = ReconstructNormal(CB, Args.ViewDepthTexture, Args.DepthClampMode, int(X), int(Y), P);
+
+            // Stored unencoded in FP32 (the D3D path encodes N*0.5+0.5 in RGBA8)
+            FLOAT* pOut = Args.NormalTexture.Store(X, Y);
+            pOut[0] = N.X;
+            pOut[1] = N.Y;
+            pOut[2] = N.Z;
+        }
+    }
+}
+
+//--------------------------------------------------------------------------------
+// FetchNormal_Common.hlsl
+// (X,Y) are relative to the input viewport
+//--------------------------------------------------------------------------------
+inline float3 FetchFullResViewNormal_GBuffer(const SSAO::GlobalConstantBuffer& CB, const ShaderResourceView& NormalTexture, UINT X, UINT Y)
+{
+    X = Min(X + UINT(CB.f2InputViewportTopLeft.X), NormalTexture.Width - 1);
+    Y = Min(Y + UINT(CB.f2InputViewportTopLeft.Y), NormalTexture.Height - 1);
+
+    const FLOAT* pN = NormalTexture.Load(X, Y);
+    const float3 WorldNormal = { pN[0] * CB.fNormalDecodeScale + CB.fNormalDecodeBias,
+                                 pN[1] * CB.fNormalDecodeScale + CB.fNormalDecodeBias,
+                                 pN[2] * CB.fNormalDecodeScale + CB.fNormalDecodeBias };
+
+    // mul(WorldNormal, (float3x3)g_f44NormalMatrix), with a row-major matrix
+    const float* M = CB.f44NormalMatrix.Data;
+    const float3 ViewNormal = { WorldNormal.X * M[0] + WorldNormal.Y * M[4] + WorldNormal.Z * M[8],
+                                WorldNormal.X * M[1] + WorldNormal.Y * M[5] + WorldNormal.Z * M[9],
+                                WorldNormal.X * M[2] + WorldNormal.Y * M[6] + WorldNormal.Z * M[10] };
+    return normalize(ViewNormal);
+}
+
+//--------------------------------------------------------------------------------
+// CoarseAO_PS.hlsl
+//--------------------------------------------------------------------------------
+struct AORadiusParams
+{
+    float fRadiusPixels;
+    float fNegInvR2;
+};
+
+inline void ScaleAORadius(AORadiusParams& Params, float ScaleFactor)
+{
+    Params.fRadiusPixels *= ScaleFactor;
+    Params.fNegInvR2 *= 1.f / (ScaleFactor * ScaleFactor);
+}
+
+inline AORadiusParams GetAORadiusParams(const SSAO::GlobalConstantBuffer& CB, float ViewDepth)
+{
+    AORadiusParams Params;
+    Params.fRadiusPixels = CB.fRadiusToScreen / ViewDepth;
+    Params.fNegInvR2 = CB.fNegInvR2;
+
+    if (CB.fBackgroundAORadiusPixels != -1.f)
+    {
+        ScaleAORadius(Params, Max(1.f, CB.fBackgroundAORadiusPixels / Params.fRadiusPixels));
+    }
+
+    if (CB.fForegroundAORadiusPixels != -1.f)
+    {
+        ScaleAORadius(Params, Min(1.f, CB.fForegroundAORadiusPixels / Params.fRadiusPixels));
+    }
+
+    return Params;
+}
+
+inline float ComputeAO(const SSAO::GlobalConstantBuffer& CB, const float3& P, const float3& N, const float3& S, const AORadiusParams& Params)
+{
+    const float3 V = sub(S, P);
+    const float VdotV = dot(V, V);
+    const float NdotV = dot(N, V) * (1.f / sqrtf(VdotV));
+
+    return saturate(NdotV - CB.fNDotVBias) * saturate(VdotV * Params.fNegInvR2 + 1.f);
+}
+
+template<ShaderPermutations::FETCH_GBUFFER_NORMAL FETCH_GBUFFER_NORMAL, ShaderPermutations::DEPTH_LAYER_COUNT DEPTH_LAYER_COUNT, ShaderPermutations::NUM_STEPS NUM_STEPS, class TexelType>
+void CoarseAO(const CoarseAOArgs& Args, const TextureSRV<TexelType>& DepthTexture, UINT RowBegin, UINT RowEnd)
+{
+    const SSAO::GlobalConstantBuffer& CB = *Args.pGlobalCB;
+    const SSAO::PerPassConstantStruct& PerPass = *Args.pPerPassCB;
+    const bool DualLayer = (DEPTH_LAYER_COUNT == ShaderPermutations::DEPTH_LAYER_COUNT_2);
+    const int NumSteps = (NUM_STEPS == ShaderPermutations::NUM_STEPS_4) ? 4 : 8;
+
+    const float4 Rand = PerPass.f4Jitter;
+    const float Alpha = 2.f * GFSDK_PI / NUM_DIRECTIONS;
+
+    float2 Directions[NUM_DIRECTIONS];
+    for (int DirectionIndex = 0; DirectionIndex < NUM_DIRECTIONS; ++DirectionIndex)
+    {
+        const float Angle = Alpha * float(DirectionIndex);
+        const float CosA = cosf(Angle);
+        const float SinA = sinf(Angle);
+        Directions[DirectionIndex].X = CosA * Rand.X - SinA * Rand.Y;
+        Directions[DirectionIndex].Y = CosA * Rand.Y + SinA * Rand.X;
+    }
+
+    for (UINT Y = RowBegin; Y < RowEnd; ++Y)
+    {
+        for (UINT X = 0; X < Args.AOTexture.Width; ++X)
+        {
+            // IN.pos.xy = floor(IN.pos.xy) * 4.0 + g_PerPassConstants.f2Offset
+            const float PosX = float(X) * 4.f + PerPass.f2Offset.X;
+            const float PosY = float(Y) * 4.f + PerPass.f2Offset.Y;
+            const float U = PosX * (CB.f2InvQuarterResolution.X / 4.f);
+            const float V = PosY * (CB.f2InvQuarterResolution.Y / 4.f);
+
+            const float3 ViewPosition = UVToView(CB, U, V, DecodeTexel(DepthTexture.Load(X, Y)[0]));
+
+            float3 ViewNormal;
+            const UINT FullResX = UINT(PosX);
+            const UINT FullResY = UINT(PosY);
+            if (FETCH_GBUFFER_NORMAL == ShaderPermutations::FETCH_GBUFFER_NORMAL_0)
+            {
+                const FLOAT* pN = Args.NormalTexture.Load(Min(FullResX, Args.NormalTexture.Width - 1), Min(FullResY, Args.NormalTexture.Height - 1));
+                ViewNormal.X = pN[0];
+                ViewNormal.Y = pN[1];
+                ViewNormal.Z = pN[2];
+            }
+            else
+            {
+                ViewNormal = FetchFullResViewNormal_GBuffer(CB, Args.NormalTexture, FullResX, FullResY);
+            }
+
+            const AORadiusParams Params = GetAORadiusParams(CB, ViewPosition.Z);
+
+            // Early exit if the projected radius is smaller than 1 full-res pixel
+            if (Params.fRadiusPixels < 1.f)
+            {
+                *Args.AOTexture.Store(X, Y) = 1.f;
+                continue;
+            }
+
+            // Divide by NUM_STEPS+1 so that the farthest samples are not fully attenuated
+            const float StepSizePixels = (Params.fRadiusPixels / 4.f) / float(NumSteps + 1);
+
+            float SmallScaleAO = 0.f;
+            float LargeScaleAO = 0.f;
+
+            for (int DirectionIndex = 0; DirectionIndex < NUM_DIRECTIONS; ++DirectionIndex)
+            {
+                const float2 Direction = Directions[DirectionIndex];
+
+                // Jitter starting sample within the first step
+                float RayPixels = (Rand.Z * StepSizePixels + 1.f);
+
+                for (int StepIndex = 0; StepIndex < NumSteps; ++StepIndex)
+                {
+                    // round() is round-to-nearest-even on the GPU, like nearbyintf in the default rounding mode
+                    const float SnappedX = nearbyintf(RayPixels * Direction.X);
+                    const float SnappedY = nearbyintf(RayPixels * Direction.Y);
+                    const float SnappedU = SnappedX * CB.f2InvQuarterResolution.X + U;
+                    const float SnappedV = SnappedY * CB.f2InvQuarterResolution.Y + V;
+                    const int SampleX = int(X) + int(SnappedX);
+                    const int SampleY = int(Y) + int(SnappedY);
+
+                    RayPixels += StepSizePixels;
+
+                    const float3 S0 = UVToView(CB, SnappedU, SnappedV, PointSample(DepthTexture, SampleX, SampleY, 0, Args.DepthClampMode));
+                    float AO = ComputeAO(CB, ViewPosition, ViewNormal, S0, Params);
+
+                    if (DualLayer)
+                    {
+                        const float3 S1 = UVToView(CB, SnappedU, SnappedV, PointSample(DepthTexture, SampleX, SampleY, 1, Args.DepthClampMode));
+                        AO = Max(AO, ComputeAO(CB, ViewPosition, ViewNormal, S1, Params));
+                    }
+
+                    if (StepIndex == 0)
+                    {
+                        SmallScaleAO += AO;
+                    }
+                    else
+                    {
+                        LargeScaleAO += AO;
+                    }
+                }
+            }
+
+            float AO = (SmallScaleAO * CB.fSmallScaleAOAmount) + (LargeScaleAO * CB.fLargeScaleAOAmount);
+
+            AO /= float(NUM_DIRECTIONS * NumSteps);
+
+            if (CB.fViewDepthThresholdSharpness != -1.f)
+            {
+                AO *= saturate((ViewPosition.Z * CB.fViewDepthThresholdNegInv + 1.f) * CB.fViewDepthThresholdSharpness);
+            }
+
+            *Args.AOTexture.Store(X, Y) = saturate(1.f - AO * 2.f);
+        }
+    }
+}
+
+template<ShaderPermutations::FETCH_GBUFFER_NORMAL FETCH_GBUFFER_NORMAL, ShaderPermutations::DEPTH_LAYER_COUNT DEPTH_LAYER_COUNT, ShaderPermutations::NUM_STEPS NUM_STEPS>
+void CoarseAO_PS(const CoarseAOArgs& Args, UINT RowBegin, UINT RowEnd)
+{
+    if (Args.HalfViewDepths)
+    {
+        CoarseAO<FETCH_GBUFFER_NORMAL, DEPTH_LAYER_COUNT, NUM_STEPS>(Args, Args.QuarterResHalfViewDepthTexture, RowBegin, RowEnd);
+    }
+    else
+    {
+        CoarseAO<FETCH_GBUFFER_NORMAL, DEPTH_LAYER_COUNT, NUM_STEPS>(Args, Args.QuarterResViewDepthTexture, RowBegin, RowEnd);
+    }
+}
+
+//--------------------------------------------------------------------------------
+// Writes a color to the user render target at (X,Y) relative to the input viewport,
+// with the OVERWRITE_RGB or MULTIPLY_RGB blend state (alpha preserved)
+//--------------------------------------------------------------------------------
+inline void OutputMerger(const OutputMergerState& Output, UINT X, UINT Y, const float3& Color)
+{
+    X += Output.TopLeftX;
+    Y += Output.TopLeftY;
+    if (X >= Output.RenderTarget.Width || Y >= Output.RenderTarget.Height)
+    {
+        return;
+    }
+
+    FLOAT* pOut = Output.RenderTarget.Store(X, Y);
+    const float RGB[3] = { Color.X, Color.Y, Color.Z };
+    const UINT NumChannels = Min(Output.RenderTarget.PixelStride, 3u);
+
+    if (Output.BlendMode == GFSDK_SSAO_MULTIPLY_RGB)
+    {
+        for (UINT Channel = 0; Channel < NumChannels; ++Channel)
+        {
+            pOut[Channel] *= RGB[Channel];
+        }
+    }
+    else
+    {
+        for (UINT Channel = 0; Channel < NumChannels; ++Channel)
+        {
+            pOut[Channel] = RGB[Channel];
+        }
+    }
+}
+
+inline void OutputMerger(const OutputMergerState& Output, UINT X, UINT Y, float AO)
+{
+    const float3 Color = { AO, AO, AO };
+    OutputMerger(Output, X, Y, Color);
+}
+
+//--------------------------------------------------------------------------------
+// ReinterleaveAO_PS.hlsl
+//--------------------------------------------------------------------------------
+template<ShaderPermutations::ENABLE_BLUR ENABLE_BLUR, ShaderPermutations::DEPTH_LAYER_COUNT DEPTH_LAYER_COUNT>
+void ReinterleaveAO_PS(const ReinterleaveAOArgs& Args, UINT RowBegin, UINT RowEnd)
+{
+    const SSAO::GlobalConstantBuffer& CB = *Args.pGlobalCB;
+
+    for (UINT Y = RowBegin; Y < RowEnd; ++Y)
+    {
+        for (UINT X = 0; X < Args.Width; ++X)
+        {
+            const UINT SliceId = (Y & 3) * 4 + (X & 3);
+            const float AO = *Args.AOTexture[SliceId].Load(X >> 2, Y >> 2);
+
+            if (ENABLE_BLUR == ShaderPermutations::ENABLE_BLUR_1)
+            {
+                float ViewDepth;
+                if (Args.DeinterleavedViewDepths)
+                {
+                    // The first channel of the depth slices is already the min of both layers
+                    ViewDepth = Args.HalfViewDepths ? DecodeTexel(*Args.QuarterResHalfViewDepthTexture[SliceId].Load(X >> 2, Y >> 2))
+                                                    : *Args.QuarterResViewDepthTexture[SliceId].Load(X >> 2, Y >> 2);
+                }
+                else
+                {
+                    ViewDepth = *Args.ViewDepthTexture[0].Load(X, Y);
+                    if (DEPTH_LAYER_COUNT == ShaderPermutations::DEPTH_LAYER_COUNT_2)
+                    {
+                        ViewDepth = Min(ViewDepth, *Args.ViewDepthTexture[1].Load(X, Y));
+                    }
+                }
+
+                FLOAT* pOut = Args.AOZTexture.Store(X, Y);
+                pOut[0] = AO;
+                pOut[1] = ViewDepth;
+            }
+            else
+            {
+                OutputMerger(Args.Output, X, Y, powf(saturate(AO), CB.fPowExponent));
+            }
+        }
+    }
+}
+
+//--------------------------------------------------------------------------------
+// GFSDK_SSAO_LINE_SWEEP
+// Each line is swept forward and backward. At each step, the samples already swept are
+// reduced to their upper convex hull in (Step, 1/ViewDepth) coordinates, which are a projective
+// image of the plane of the line in view space, so the hull vertex tangent to the line from the
+// current sample is its horizon. Finding it pops the vertices hidden below the horizon, which are
+// never visible again from the next samples, so the cost per pixel does not depend on the radius.
+// The AO of a direction is the max of ComputeAO over the visited vertices, so that occluders out of
+// the radius do not hide the closer ones.
+//--------------------------------------------------------------------------------
+struct LineSweepVertex
+{
+    float Step;
+    float InvViewDepth;
+    float3 ViewPosition;
+};
+
+class LineSweepHull
+{
+public:
+    LineSweepHull()
+        : m_Bottom(0)
+        , m_Top(0)
+    {
+    }
+
+    void Clear()
+    {
+        m_Bottom = m_Top;
+    }
+
+    // Returns the AO of the horizon seen from ViewPosition, then pushes Vertex
+    float AddVertex(const SSAO::GlobalConstantBuffer& CB, const LineSweepVertex& Vertex, const float3& ViewPosition, const float3& ViewNormal, const AORadiusParams& Params, bool ComputeOcclusion)
+    {
+        float AO = 0.f;
+
+        while (m_Top - m_Bottom >= 2)
+        {
+            const LineSweepVertex& A = GetVertex(m_Top - 1);
+            const LineSweepVertex& B = GetVertex(m_Top - 2);
+
+            // Stop once B is below the line from Vertex through A
+            if ((B.InvViewDepth - Vertex.InvViewDepth) * (A.Step - Vertex.Step) >
+                (A.InvViewDepth - Vertex.InvViewDepth) * (B.Step - Vertex.Step))
+            {
+                break;
+            }
+
+            if (ComputeOcclusion)
+            {
+                const float SampleAO = ComputeAO(CB, ViewPosition, ViewNormal, A.ViewPosition, Params);
+                AO = Max(AO, SampleAO);
+            }
+            --m_Top;
+        }
+
+        if (m_Top != m_Bottom && ComputeOcclusion)
+        {
+            const float SampleAO = ComputeAO(CB, ViewPosition, ViewNormal, GetVertex(m_Top - 1).ViewPosition, Params);
+            AO = Max(AO, SampleAO);
+        }
+
+        if (m_Top - m_Bottom == LINE_SWEEP_MAX_HULL_SIZE)
+        {
+            ++m_Bottom;
+        }
+        GetVertex(m_Top++) = Vertex;
+
+        return AO;
+    }
+
+private:
+    LineSweepVertex& GetVertex(UINT Index)
+    {
+        return m_Vertices[Index % LINE_SWEEP_MAX_HULL_SIZE];
+    }
+
+    LineSweepVertex m_Vertices[LINE_SWEEP_MAX_HULL_SIZE];
+    UINT m_Bottom;
+    UINT m_Top;
+};
+
+template<ShaderPermutations::FETCH_GBUFFER_NORMAL FETCH_GBUFFER_NORMAL, ShaderPermutations::DEPTH_LAYER_COUNT DEPTH_LAYER_COUNT>
+void LineSweepAO_PS(const LineSweepAOArgs& Args, UINT LineBegin, UINT LineEnd)
+{
+    const SSAO::GlobalConstantBuffer& CB = *Args.pGlobalCB;
+    const bool DualLayer = (DEPTH_LAYER_COUNT == ShaderPermutations::DEPTH_LAYER_COUNT_2);
+    const UINT NumLayers = DualLayer ? 2 : 1;
+    const LineSweepLines Lines(Args.DirectionIndex, Args.AOTexture.Width, Args.AOTexture.Height);
+
+    LineSweepHull Hulls[2];
+
+    for (UINT Line = LineBegin; Line < LineEnd; ++Line)
+    {
+        UINT StepBegin;
+        UINT StepEnd;
+        Lines.GetSteps(Line, StepBegin, StepEnd);
+
+        for (UINT Backward = 0; Backward < 2; ++Backward)
+        {
+            Hulls[0].Clear();
+            Hulls[1].Clear();
+
+            for (UINT StepIndex = StepBegin; StepIndex < StepEnd; ++StepIndex)
+            {
+                const UINT Step = Backward ? (StepEnd - 1 - (StepIndex - StepBegin)) : StepIndex;
+
+                UINT X;
+                UINT Y;
+                Lines.GetPixel(Line, Step, X, Y);
+
+                const float U = (float(X) + 0.5f) * CB.f2InvFullResolution.X;
+                const float V = (float(Y) + 0.5f) * CB.f2InvFullResolution.Y;
+                const float3 ViewPosition = UVToView(CB, U, V, *Args.ViewDepthTexture[0].Load(X, Y));
+
+                // Like CoarseAO_PS, no occlusion if the projected radius is smaller than 1 full-res pixel
+                const AORadiusParams Params = GetAORadiusParams(CB, ViewPosition.Z);
+                const bool ComputeOcclusion = (Params.fRadiusPixels >= 1.f);
+
+                float3 ViewNormal = { 0.f, 0.f, 0.f };
+                if (ComputeOcclusion)
+                {
+                    if (FETCH_GBUFFER_NORMAL == ShaderPermutations::FETCH_GBUFFER_NORMAL_0)
+                    {
+                        const FLOAT* pN = Args.NormalTexture.Load(X, Y);
+                        ViewNormal.X = pN[0];
+                        ViewNormal.Y = pN[1];
+                        ViewNormal.Z = pN[2];
+                    }
+                    else
+                    {
+                        ViewNormal = FetchFullResViewNormal_GBuffer(CB, Args.NormalTexture, X, Y);
+                    }
+                }
+
+                // With dual layers, the samples of the second layer have their own hull,
+                // like the second channel sampled by CoarseAO_PS
+                float AO = 0.f;
+                for (UINT Layer = 0; Layer < NumLayers; ++Layer)
+                {
+                    LineSweepVertex Vertex;
+                    // The steps increase along the sweep, in both directions
+                    Vertex.Step = Backward ? -float(Step) : float(Step);
+                    Vertex.ViewPosition = (Layer == 0) ? ViewPosition : UVToView(CB, U, V, *Args.ViewDepthTexture[1].Load(X, Y));
+                    Vertex.InvViewDepth = 1.f / Vertex.ViewPosition.Z;
+
+                    const float LayerAO = Hulls[Layer].AddVertex(CB, Vertex, ViewPosition, ViewNormal, Params, ComputeOcclusion);
+                    AO = Max(AO, LayerAO);
+                }
+
+                FLOAT* pOut = Args.AOTexture.Store(X, Y);
+                *pOut = (Args.DirectionIndex == 0 && !Backward) ? AO : (*pOut + AO);
+            }
+        }
+    }
+}
+
+//--------------------------------------------------------------------------------
+// Converts the sum of the per-direction AO of LineSweepAO_PS like the end of CoarseAO_PS,
+// then outputs it like ReinterleaveAO_PS
+//--------------------------------------------------------------------------------
+template<ShaderPermutations::ENABLE_BLUR ENABLE_BLUR, ShaderPermutations::NUM_STEPS NUM_STEPS>
+void LineSweepResolve_PS(const LineSweepResolveArgs& Args, UINT RowBegin, UINT RowEnd)
+{
+    const SSAO::GlobalConstantBuffer& CB = *Args.pGlobalCB;
+    const int NumSteps = (NUM_STEPS == ShaderPermutations::NUM_STEPS_4) ? 4 : 8;
+
+    // Weighs each horizon like NumSteps samples of CoarseAO_PS with the same occlusion
+    const float AOScale = (CB.fSmallScaleAOAmount + CB.fLargeScaleAOAmount * float(NumSteps - 1)) / float(NUM_DIRECTIONS * NumSteps);
+
+    for (UINT Y = RowBegin; Y < RowEnd; ++Y)
+    {
+        for (UINT X = 0; X < Args.AOTexture.Width; ++X)
+        {
+            const float ViewDepth = *Args.ViewDepthTexture.Load(X, Y);
+            float AO = *Args.AOTexture.Load(X, Y) * AOScale;
+
+            if (CB.fViewDepthThresholdSharpness != -1.f)
+            {
+                AO *= saturate((ViewDepth * CB.fViewDepthThresholdNegInv + 1.f) * CB.fViewDepthThresholdSharpness);
+            }
+
+            AO = saturate(1.f - AO * 2.f);
+
+            if (ENABLE_BLUR == ShaderPermutations::ENABLE_BLUR_1)
+            {
+                FLOAT* pOut = Args.AOZTexture.Store(X, Y);
+                pOut[0] = AO;
+                pOut[1] = ViewDepth;
+            }
+            else
+            {
+                OutputMerger(Args.Output, X, Y, powf(AO, CB.fPowExponent));
+            }
+        }
+    }
+}
+
+//--------------------------------------------------------------------------------
+// Blur_Common.hlsl
+//--------------------------------------------------------------------------------
+struct CenterPixelData
+{
+    int X;
+    int Y;
+    float Depth;
+    float Sharpness;
+    float Scale;
+    float Bias;
+};
+
+template<ShaderPermutations::KERNEL_RADIUS KERNEL_RADIUS, ShaderPermutations::ENABLE_SHARPNESS_PROFILE ENABLE_SHARPNESS_PROFILE>
+struct BlurKernel
+{
+    static const int KernelRadius = (KERNEL_RADIUS == ShaderPermutations::KERNEL_RADIUS_2) ? 2 : 4;
+
+    const FLOAT* PointSampleAODepth(int X, int Y) const
+    {
+        X = Clamp(X, 0, int(AOZTexture.Width) - 1);
+        Y = Clamp(Y, 0, int(Height) - 1);
+        return AOZTexture.Load(UINT(X), NumRingRows ? UINT(Y) % NumRingRows : UINT(Y));
+    }
+
+    // Bilinear fetch halfway between the texels at R and R+1 (UV = (R + 0.5) * DeltaUV + Center.UV)
+    void LinearSampleAODepth(int X0, int Y0, int DX, int DY, float AOZ[2]) const
+    {
+        const FLOAT* pA = PointSampleAODepth(X0, Y0);
+        const FLOAT* pB = PointSampleAODepth(X0 + DX, Y0 + DY);
+        AOZ[0] = 0.5f * (pA[0] + pB[0]);
+        AOZ[1] = 0.5f * (pA[1] + pB[1]);
+    }
+
+    float CrossBilateralWeight(float R, float SampleDepth, float DepthSlope, const CenterPixelData& Center) const
+    {
+        SampleDepth -= DepthSlope * R;
+
+        const float DeltaZ = SampleDepth * Center.Scale + Center.Bias;
+
+        return exp2f(-R*R*BlurFalloff - DeltaZ*DeltaZ);
+    }
+
+    void ProcessSample(const FLOAT* pAOZ, float R, float DepthSlope, const CenterPixelData& Center, float& TotalAO, float& TotalW) const
+    {
+        const float W = CrossBilateralWeight(R, pAOZ[1], DepthSlope, Center);
+        TotalAO += W * pAOZ[0];
+        TotalW += W;
+    }
+
+    void ProcessRadius(int R0, int DX, int DY, float DepthSlope, const CenterPixelData& Center, float& TotalAO, float& TotalW) const
+    {
+        int R = R0;
+
+        if (KernelRadius >= 4)
+        {
+            // USE_ADAPTIVE_SAMPLING
+            for (; R <= KernelRadius/2; R += 1)
+            {
+                ProcessSample(PointSampleAODepth(Center.X + R*DX, Center.Y + R*DY), float(R), DepthSlope, Center, TotalAO, TotalW);
+            }
+            for (; R <= KernelRadius; R += 2)
+            {
+                float AOZ[2];
+                LinearSampleAODepth(Center.X + R*DX, Center.Y + R*DY, DX, DY, AOZ);
+                ProcessSample(AOZ, float(R), DepthSlope, Center, TotalAO, TotalW);
+            }
+        }
+        else
+        {
+            for (; R <= KernelRadius; R += 1)
+            {
+                ProcessSample(PointSampleAODepth(Center.X + R*DX, Center.Y + R*DY), float(R), DepthSlope, Center, TotalAO, TotalW);
+            }
+        }
+    }
+
+    void ProcessRadius1(int DX, int DY, const CenterPixelData& Center, float& TotalAO, float& TotalW) const
+    {
+        const FLOAT* pAODepth = PointSampleAODepth(Center.X + DX, Center.Y + DY);
+        const float DepthSlope = pAODepth[1] - Center.Depth;
+
+        ProcessSample(pAODepth, 1.f, DepthSlope, Center, TotalAO, TotalW);
+        ProcessRadius(2, DX, DY, DepthSlope, Center, TotalAO, TotalW);
+    }
+
+    float GetSharpness(float ViewDepth) const
+    {
+        if (ENABLE_SHARPNESS_PROFILE == ShaderPermutations::ENABLE_SHARPNESS_PROFILE_1)
+        {
+            const float LerpFactor = (ViewDepth - pGlobalCB->fBlurViewDepth0) / (pGlobalCB->fBlurViewDepth1 - pGlobalCB->fBlurViewDepth0);
+            return lerp(pGlobalCB->fBlurSharpness0, pGlobalCB->fBlurSharpness1, saturate(LerpFactor));
+        }
+        return pGlobalCB->fBlurSharpness1;
+    }
+
+    float ComputeBlur(int X, int Y, int DX, int DY, float& CenterDepth) const
+    {
+        const FLOAT* pAOZ = PointSampleAODepth(X, Y);
+        CenterDepth = pAOZ[1];
+
+        CenterPixelData Center;
+        Center.X = X;
+        Center.Y = Y;
+        Center.Depth = CenterDepth;
+        Center.Sharpness = GetSharpness(CenterDepth);
+        Center.Scale = Center.Sharpness;
+        Center.Bias = -Center.Depth * Center.Sharpness;
+
+        float TotalAO = pAOZ[0];
+        float TotalW = 1.f;
+
+        ProcessRadius1(DX, DY, Center, TotalAO, TotalW);
+        ProcessRadius1(-DX, -DY, Center, TotalAO, TotalW);
+
+        return TotalAO / TotalW;
+    }
+
+    // Samples the full AOZ texture
+    BlurKernel(const BlurArgs& Args)
+        : pGlobalCB(Args.pGlobalCB)
+        , AOZTexture(Args.AOZTexture)
+        , Height(Args.AOZTexture.Height)
+        , NumRingRows(0)
+    {
+        const float BlurSigma = (float(KernelRadius) + 1.f) * 0.5f;
+        BlurFalloff = 1.f / (2.f * BlurSigma * BlurSigma);
+    }
+
+    // Samples a ring of rows of a texture of the given Height, where row Y is stored in row Y % RingBuffer.Height
+    BlurKernel(const BlurArgs& Args, const ShaderResourceView& RingBuffer, UINT TextureHeight)
+        : pGlobalCB(Args.pGlobalCB)
+        , AOZTexture(RingBuffer)
+        , Height(TextureHeight)
+        , NumRingRows(RingBuffer.Height)
+    {
+        const float BlurSigma = (float(KernelRadius) + 1.f) * 0.5f;
+        BlurFalloff = 1.f / (2.f * BlurSigma * BlurSigma);
+    }
+
+    const SSAO::GlobalConstantBuffer* pGlobalCB;
+    const ShaderResourceView& AOZTexture;
+    UINT Height;
+    UINT NumRingRows;
+    float BlurFalloff;
+};
+
+//--------------------------------------------------------------------------------
+// BlurX_PS.hlsl followed by BlurY_PS.hlsl, without the intermediate AOZ texture.
+// The tile is processed in strips of BLUR_STRIP_WIDTH columns. For each strip, BlurX writes into
+// a ring of 2*KernelRadius+1 rows, and BlurY runs as soon as the rows it reads are in the ring.
+//--------------------------------------------------------------------------------
+template<ShaderPermutations::KERNEL_RADIUS KERNEL_RADIUS, ShaderPermutations::ENABLE_SHARPNESS_PROFILE ENABLE_SHARPNESS_PROFILE>
+void Blur_PS(const BlurArgs& Args, UINT RowBegin, UINT RowEnd)
+{
+    typedef BlurKernel<KERNEL_RADIUS, ENABLE_SHARPNESS_PROFILE> Kernel;
+    const Kernel KernelX(Args);
+    const UINT Width = Args.AOZTexture.Width;
+    const UINT Height = Args.AOZTexture.Height;
+
+    FLOAT RingData[BLUR_MAX_RING_ROWS * BLUR_STRIP_WIDTH * 2];
+    ShaderResourceView Ring;
+    Ring.pData = RingData;
+    Ring.Height = 2 * Kernel::KernelRadius + 1;
+    Ring.RowPitch = BLUR_STRIP_WIDTH * 2;
+    Ring.PixelStride = 2;
+
+    for (UINT StripX = 0; StripX < Width; StripX += BLUR_STRIP_WIDTH)
+    {
+        Ring.Width = Min(Width - StripX, BLUR_STRIP_WIDTH);
+        const Kernel KernelY(Args, Ring, Height);
+
+        UINT NextRowX = UINT(Max(int(RowBegin) - Kernel::KernelRadius, 0));
+
+        for (UINT Y = RowBegin; Y < RowEnd; ++Y)
+        {
+            const UINT LastRowX = Min(Y + UINT(Kernel::KernelRadius), Height - 1);
+            for (; NextRowX <= LastRowX; ++NextRowX)
+            {
+                FLOAT* pRow = RingData + (NextRowX % Ring.Height) * Ring.RowPitch;
+
+                for (UINT X = 0; X < Ring.Width; ++X)
+                {
+                    float CenterDepth;
+                    pRow[2 * X + 0] = KernelX.ComputeBlur(int(StripX + X), int(NextRowX), 1, 0, CenterDepth);
+                    pRow[2 * X + 1] = CenterDepth;
+                }
+            }
+
+            for (UINT X = 0; X < Ring.Width; ++X)
+            {
+                float CenterDepth;
+                const float AO = KernelY.ComputeBlur(int(X), int(Y), 0, 1, CenterDepth);
+
+                OutputMerger(Args.Output, StripX + X, Y, powf(saturate(AO), Args.pGlobalCB->fPowExponent));
+            }
+        }
+    }
+}
+
+//--------------------------------------------------------------------------------
+// DebugNormals_PS.hlsl
+//--------------------------------------------------------------------------------
+template<ShaderPermutations::FETCH_GBUFFER_NORMAL FETCH_GBUFFER_NORMAL>
+void DebugNormals_PS(const DebugNormalsArgs& Args, UINT RowBegin, UINT RowEnd)
+{
+    const SSAO::GlobalConstantBuffer& CB = *Args.pGlobalCB;
+
+    for (UINT Y = RowBegin; Y < RowEnd; ++Y)
+    {
+        for (UINT X = 0; X < Args.ViewDepthTexture.Width; ++X)
+        {
+            float3 ViewNormal;
+            if (FETCH_GBUFFER_NORMAL == ShaderPermutations::FETCH_GBUFFER_NORMAL_0)
+            {
+                const float3 ViewPosition = FetchFullResViewPos(CB, Args.ViewDepthTexture, Args.DepthClampMode, int(X), int(Y));
+                ViewNormal = ReconstructNormal(CB, Args.ViewDepthTexture, Args.DepthClampMode, int(X), int(Y), ViewPosition);
+            }
+            else
+            {
+                ViewNormal = FetchFullResViewNormal_GBuffer(CB, Args.NormalTexture, X, Y);
+            }
+            ViewNormal.X = -ViewNormal.X;
+            ViewNormal.Y = -ViewNormal.Y;
+            ViewNormal.Z = -ViewNormal.Z;
+
+            const float3 OutColor = 
+                (CB.iDebugNormalComponent == 0) ? float3{ ViewNormal.X, ViewNormal.X, ViewNormal.X } :
+                (CB.iDebugNormalComponent == 1) ? float3{ ViewNormal.Y, ViewNormal.Y, ViewNormal.Y } :
+                (CB.iDebugNormalComponent == 2) ? float3{ ViewNormal.Z, ViewNormal.Z, ViewNormal.Z } :
+                ViewNormal;
+
+            OutputMerger(Args.Output, X, Y, OutColor);
+        }
+    }
+}
+
+//--------------------------------------------------------------------------------
+const KernelTable& GetKernelTable()
+{
+    using namespace ShaderPermutations;
+
+    static constexpr KernelTable Table =
+    {
+        { { &LinearizeDepth_PS<DEPTH_LAYER_COUNT_1>, &LinearizeDepth_PS<DEPTH_LAYER_COUNT_2> } },
+        { { &DeinterleaveDepth_PS<DEPTH_LAYER_COUNT_1>, &DeinterleaveDepth_PS<DEPTH_LAYER_COUNT_2> } },
+        { { &LinearizeDeinterleaveDepth_PS<DEPTH_LAYER_COUNT_1>, &LinearizeDeinterleaveDepth_PS<DEPTH_LAYER_COUNT_2> } },
+        { &ReconstructNormal_PS },
+        { {
+            { { &CoarseAO_PS<FETCH_GBUFFER_NORMAL_0, DEPTH_LAYER_COUNT_1, NUM_STEPS_4>, &CoarseAO_PS<FETCH_GBUFFER_NORMAL_0, DEPTH_LAYER_COUNT_1, NUM_STEPS_8> },
+              { &CoarseAO_PS<FETCH_GBUFFER_NORMAL_0, DEPTH_LAYER_COUNT_2, NUM_STEPS_4>, &CoarseAO_PS<FETCH_GBUFFER_NORMAL_0, DEPTH_LAYER_COUNT_2, NUM_STEPS_8> } },
+            { { &CoarseAO_PS<FETCH_GBUFFER_NORMAL_1, DEPTH_LAYER_COUNT_1, NUM_STEPS_4>, &CoarseAO_PS<FETCH_GBUFFER_NORMAL_1, DEPTH_LAYER_COUNT_1, NUM_STEPS_8> },
+              { &CoarseAO_PS<FETCH_GBUFFER_NORMAL_1, DEPTH_LAYER_COUNT_2, NUM_STEPS_4>, &CoarseAO_PS<FETCH_GBUFFER_NORMAL_1, DEPTH_LAYER_COUNT_2, NUM_STEPS_8> } },
+            { { &CoarseAO_PS<FETCH_GBUFFER_NORMAL_2, DEPTH_LAYER_COUNT_1, NUM_STEPS_4>, &CoarseAO_PS<FETCH_GBUFFER_NORMAL_2, DEPTH_LAYER_COUNT_1, NUM_STEPS_8> },
+              { &CoarseAO_PS<FETCH_GBUFFER_NORMAL_2, DEPTH_LAYER_COUNT_2, NUM_STEPS_4>, &CoarseAO_PS<FETCH_GBUFFER_NORMAL_2, DEPTH_LAYER_COUNT_2, NUM_STEPS_8> } },
+        } },
+        { {
+            { &ReinterleaveAO_PS<ENABLE_BLUR_0, DEPTH_LAYER_COUNT_1>, &ReinterleaveAO_PS<ENABLE_BLUR_0, DEPTH_LAYER_COUNT_2> },
+            { &ReinterleaveAO_PS<ENABLE_BLUR_1, DEPTH_LAYER_COUNT_1>, &ReinterleaveAO_PS<ENABLE_BLUR_1, DEPTH_LAYER_COUNT_2> },
+        } },
+        { {
+            { &Blur_PS<KERNEL_RADIUS_2, ENABLE_SHARPNESS_PROFILE_0>, &Blur_PS<KERNEL_RADIUS_2, ENABLE_SHARPNESS_PROFILE_1> },
+            { &Blur_PS<KERNEL_RADIUS_4, ENABLE_SHARPNESS_PROFILE_0>, &Blur_PS<KERNEL_RADIUS_4, ENABLE_SHARPNESS_PROFILE_1> },
+        } },
+    };
+    return Table;
+}
+
+//--------------------------------------------------------------------------------
+static constexpr Kernels::DebugNormals_PS DebugNormalsKernels =
+{
+    { &DebugNormals_PS<ShaderPermutations::FETCH_GBUFFER_NORMAL_0>,
+      &DebugNormals_PS<ShaderPermutations::FETCH_GBUFFER_NORMAL_1>,
+      &DebugNormals_PS<ShaderPermutations::FETCH_GBUFFER_NORMAL_2> }
+};
+
+//--------------------------------------------------------------------------------
+static constexpr Kernels::LineSweepAO_PS LineSweepAOKernels =
+{
+    { { &LineSweepAO_PS<ShaderPermutations::FETCH_GBUFFER_NORMAL_0, ShaderPermutations::DEPTH_LAYER_COUNT_1>,
+        &LineSweepAO_PS<ShaderPermutations::FETCH_GBUFFER_NORMAL_0, ShaderPermutations::DEPTH_LAYER_COUNT_2> },
+      { &LineSweepAO_PS<ShaderPermutations::FETCH_GBUFFER_NORMAL_1, ShaderPermutations::DEPTH_LAYER_COUNT_1>,
+        &LineSweepAO_PS<ShaderPermutations::FETCH_GBUFFER_NORMAL_1, ShaderPermutations::DEPTH_LAYER_COUNT_2> },
+      { &LineSweepAO_PS<ShaderPermutations::FETCH_GBUFFER_NORMAL_2, ShaderPermutations::DEPTH_LAYER_COUNT_1>,
+        &LineSweepAO_PS<ShaderPermutations::FETCH_GBUFFER_NORMAL_2, ShaderPermutations::DEPTH_LAYER_COUNT_2> } }
+};
+
+static constexpr Kernels::LineSweepResolve_PS LineSweepResolveKernels =
+{
+    { { &LineSweepResolve_PS<ShaderPermutations::ENABLE_BLUR_0, ShaderPermutations::NUM_STEPS_4>,
+        &LineSweepResolve_PS<ShaderPermutations::ENABLE_BLUR_0, ShaderPermutations::NUM_STEPS_8> },
+      { &LineSweepResolve_PS<ShaderPermutations::ENABLE_BLUR_1, ShaderPermutations::NUM_STEPS_4>,
+        &LineSweepResolve_PS<ShaderPermutations::ENABLE_BLUR_1, ShaderPermutations::NUM_STEPS_8> } }
+};
+
+} // namespace Scalar
+} // namespace CPU
+} // namespace SSAO
+} // namespace GFSDK
+
+//--------------------------------------------------------------------------------
+GFSDK_SSAO_InstructionSet_CPU GFSDK::SSAO::CPU::Shaders::GetSupportedInstructionSet()
+{
+    // The AVX2 and AVX-512 kernels are both compiled with FMA and F16C, and the AVX-512 ones also with AVX2
+#if defined(_MSC_VER) && (ENABLE_CPU_SSE42 || ENABLE_CPU_AVX2 || ENABLE_CPU_AVX512)
+    int Info[4];
+    __cpuid(Info, 0);
+    const int MaxLeaf = Info[0];
+
+    __cpuid(Info, 1);
+    const bool HasSSE42 = (Info[2] & (1 << 20)) != 0;
+    const bool HasFMA = (Info[2] & (1 << 12)) != 0;
+    const bool HasF16C = (Info[2] & (1 << 29)) != 0;
+
+    // The OS must save the YMM (and ZMM) registers on context switches
+    const bool OSXSave = (Info[2] & (1 << 27)) != 0;
+    const unsigned long long XCR0 = OSXSave ? _xgetbv(0) : 0;
+
+    bool HasAVX2 = false;
+    bool HasAVX512 = false;
+    if (MaxLeaf >= 7)
+    {
+        __cpuidex(Info, 7, 0);
+        HasAVX2 = (Info[1] & (1 << 5)) != 0 && HasFMA && HasF16C && (XCR0 & 0x06) == 0x06;
+        HasAVX512 = (Info[1] & (1 << 16)) != 0 && HasAVX2 && (XCR0 & 0xE6) == 0xE6;
+    }
+#elif defined(__GNUC__) && (ENABLE_CPU_SSE42 || ENABLE_CPU_AVX2 || ENABLE_CPU_AVX512)
+    __builtin_cpu_init();
+    const bool HasSSE42 = __builtin_cpu_supports("sse4.2") != 0;
+    const bool HasAVX2 = __builtin_cpu_supports("avx2") != 0 && __builtin_cpu_supports("fma") != 0 && __builtin_cpu_supports("f16c") != 0;
+    const bool HasAVX512 = __builtin_cpu_supports("avx512f") != 0 && HasAVX2;
+#else
+    const bool HasSSE42 = false;
+    const bool HasAVX2 = false;
+    const bool HasAVX512 = false;
+#endif
+
+#if ENABLE_CPU_AVX512
+    if (HasAVX512)
+    {
+        return GFSDK_SSAO_CPU_AVX512;
+    }
+#endif
+
+#if ENABLE_CPU_AVX2
+    if (HasAVX2)
+    {
+        return GFSDK_SSAO_CPU_AVX2;
+    }
+#endif
+
+#if ENABLE_CPU_SSE42
+    if (HasSSE42)
+    {
+        return GFSDK_SSAO_CPU_SSE42;
+    }
+#endif
+
+    (void)HasSSE42;
+    (void)HasAVX2;
+    (void)HasAVX512;
+    return GFSDK_SSAO_CPU_SCALAR;
+}
+
+//--------------------------------------------------------------------------------
+#define SET_CPU_KERNEL_TABLE(ISA) \
+    static_cast<KernelTable&>(*this) = ISA::GetKernelTable();
+
+void GFSDK::SSAO::CPU::Shaders::Create(GFSDK_SSAO_InstructionSet_CPU MaxInstructionSet)
+{
+    SET_CPU_KERNEL_TABLE(Scalar)
+    DebugNormals_PS = Scalar::DebugNormalsKernels;
+    LineSweepAO_PS = Scalar::LineSweepAOKernels;
+    LineSweepResolve_PS = Scalar::LineSweepResolveKernels;
+
+    ActiveInstructionSet = Min(MaxInstructionSet, GetSupportedInstructionSet());
+
+    switch (ActiveInstructionSet)
+    {
+#if ENABLE_CPU_AVX512
+    case GFSDK_SSAO_CPU_AVX512:
+        SET_CPU_KERNEL_TABLE(AVX512)
+        break;
+#endif
+#if ENABLE_CPU_AVX2
+    case GFSDK_SSAO_CPU_AVX2:
+        SET_CPU_KERNEL_TABLE(AVX2)
+        break;
+#endif
+#if ENABLE_CPU_SSE42
+    case GFSDK_SSAO_CPU_SSE42:
+        SET_CPU_KERNEL_TABLE(SSE42)
+        break;
+#endif
+    default:
+        ActiveInstructionSet = GFSDK_SSAO_CPU_SCALAR;
+        break;
+    }
+}
+
+#undef SET_CPU_KERNEL_TABLE
+
+//--------------------------------------------------------------------------------
+void GFSDK::SSAO::CPU::Shaders::Release()
+{
+    ZERO_STRUCT(*this);
+}
+
+#endif // SUPPORT_CPU
@@ -0,0 +1,666 @@
+// This code contains NVIDIA Confidential Information and is disclosed to you
+// under a form of NVIDIA software license agreement provided separately to you.
+//
+// Notice
+// NVIDIA Corporation and its licensors retain all intellectual property and
+// proprietary rights in and to this software and related documentation and
+// any modifications thereto. Any use, reproduction, disclosure, or
+// distribution of this software and related documentation without an express
+// license agreement from NVIDIA Corporation is strictly prohibited.
+//
+// ALL NVIDIA DESIGN SPECIFICATIONS, CODE ARE PROVIDED "AS IS.". NVIDIA MAKES
+// NO WARRANTIES, EXPRESSED, IMPLIED, STATUTORY, OR OTHERWISE WITH RESPECT TO
+// THE MATERIALS, AND EXPRESSLY DISCLAIMS ALL IMPLIED WARRANTIES OF NONINFRINGEMENT,
+// MERCHANTABILITY, AND FITNESS FOR A PARTICULAR PURPOSE.
+//
+// Information and code furnished is believed to be accurate and reliable.
+// However, NVIDIA Corporation assumes no responsibility for the consequences of use of such
+// information or for any infringement of patents or other rights of third parties that may
+// result from its use. No license is granted by implication or otherwise under any patent
+// or patent rights of NVIDIA Corporation. Details are subject to change without notice.
+// This code supersedes and replaces all information previously supplied.
+// NVIDIA Corporation products are not authorized for use as critical
+// components in life support devices or systems without express written approval of
+// NVIDIA Corporation.
+//
+// Copyright (c) 2008-2021 NVIDIA Corporation. All rights reserved.
+
+#if SUPPORT_CPU
+
+#pragma once
+#include "Common.h"
+#include "ConstantBuffers.h"
+
+// The vector kernels are built for x86-64 only, and selected at runtime based on CPUID
+#if defined(_M_X64) || defined(__x86_64__)
+#ifndef ENABLE_CPU_SSE42
+#define ENABLE_CPU_SSE42 1
+#endif
+#ifndef ENABLE_CPU_AVX2
+#define ENABLE_CPU_AVX2 1
+#endif
+#ifndef ENABLE_CPU_AVX512
+#define ENABLE_CPU_AVX512 1
+#endif
+#endif
+
+namespace GFSDK
+{
+namespace SSAO
+{
+namespace CPU
+{
+
+//--------------------------------------------------------------------------------
+// Host counterparts of the #permutation values declared in shaders/src/*.hlsl
+//--------------------------------------------------------------------------------
+namespace ShaderPermutations
+{
+    enum DEPTH_LAYER_COUNT
+    {
+        DEPTH_LAYER_COUNT_1,
+        DEPTH_LAYER_COUNT_2,
+        DEPTH_LAYER_COUNT_COUNT,
+    };
+
+    enum FETCH_GBUFFER_NORMAL
+    {
+        FETCH_GBUFFER_NORMAL_0,
+        FETCH_GBUFFER_NORMAL_1,
+        FETCH_GBUFFER_NORMAL_2,
+        FETCH_GBUFFER_NORMAL_COUNT,
+    };
+
+    enum NUM_STEPS
+    {
+        NUM_STEPS_4,
+        NUM_STEPS_8,
+        NUM_STEPS_COUNT,
+    };
+
+    enum ENABLE_BLUR
+    {
+        ENABLE_BLUR_0,
+        ENABLE_BLUR_1,
+        ENABLE_BLUR_COUNT,
+    };
+
+    enum KERNEL_RADIUS
+    {
+        KERNEL_RADIUS_2,
+        KERNEL_RADIUS_4,
+        KERNEL_RADIUS_COUNT,
+    };
+
+    enum ENABLE_SHARPNESS_PROFILE
+    {
+        ENABLE_SHARPNESS_PROFILE_0,
+        ENABLE_SHARPNESS_PROFILE_1,
+        ENABLE_SHARPNESS_PROFILE_COUNT,
+    };
+}
+
+//--------------------------------------------------------------------------------
+// Texel types of the host textures. The FP16 textures hold the deinterleaved view depths
+// with GFSDK_SSAO_FP16_VIEW_DEPTHS or dual-layer AO, like R16_FLOAT and R16G16_FLOAT on the GPU.
+//--------------------------------------------------------------------------------
+typedef unsigned short HALF;
+
+// Round-to-nearest-even, like F16C. Values above the FP16 range become Inf, NaNs stay NaNs.
+inline HALF FloatToHalf(float Value)
+{
+    UINT Bits;
+    memcpy(&Bits, &Value, sizeof(Bits));
+
+    const UINT Sign = (Bits >> 16) & 0x8000;
+    Bits &= 0x7FFFFFFF;
+
+    UINT Half;
+    if (Bits >= ((127 + 16) << 23))
+    {
+        // Inf or NaN
+        Half = (Bits > (255 << 23)) ? 0x7E00 : 0x7C00;
+    }
+    else if (Bits < ((127 - 14) << 23))
+    {
+        // Denormal or zero. Adding 0.5 aligns the 10 mantissa bits at the bottom of the float,
+        // with the rounding done by the FP32 addition.
+        const UINT DenormMagicBits = ((127 - 15) + (23 - 10) + 1) << 23;
+        float DenormMagic;
+        float Shifted;
+        memcpy(&DenormMagic, &DenormMagicBits, sizeof(DenormMagic));
+        memcpy(&Shifted, &Bits, sizeof(Shifted));
+        Shifted += DenormMagic;
+        memcpy(&Bits, &Shifted, sizeof(Bits));
+        Half = Bits - DenormMagicBits;
+    }
+    else
+    {
+        // Rebias the exponent and round the 13 dropped mantissa bits
+        const UINT MantissaOdd = (Bits >> 13) & 1;
+        Bits += (UINT(15 - 127) << 23) + 0xFFF + MantissaOdd;
+        Half = Bits >> 13;
+    }
+
+    return HALF(Half | Sign);
+}
+
+inline float HalfToFloat(HALF Value)
+{
+    const UINT ShiftedExponent = 0x7C00 << 13;
+
+    UINT Bits = UINT(Value & 0x7FFF) << 13;
+    const UINT Exponent = Bits & ShiftedExponent;
+    Bits += (127 - 15) << 23;
+
+    if (Exponent == ShiftedExponent)
+    {
+        // Inf or NaN
+        Bits += (128 - 16) << 23;
+    }
+    else if (Exponent == 0)
+    {
+        // Denormal or zero, renormalized by an FP32 subtraction
+        const UINT MagicBits = 113 << 23;
+        float Magic;
+        float Renormalized;
+        Bits += 1 << 23;
+        memcpy(&Magic, &MagicBits, sizeof(Magic));
+        memcpy(&Renormalized, &Bits, sizeof(Renormalized));
+        Renormalized -= Magic;
+        memcpy(&Bits, &Renormalized, sizeof(Bits));
+    }
+
+    Bits |= UINT(Value & 0x8000) << 16;
+
+    float Result;
+    memcpy(&Result, &Bits, sizeof(Result));
+    return Result;
+}
+
+inline float DecodeTexel(FLOAT Texel)
+{
+    return Texel;
+}
+
+inline float DecodeTexel(HALF Texel)
+{
+    return HalfToFloat(Texel);
+}
+
+inline void EncodeTexel(FLOAT& Texel, float Value)
+{
+    Texel = Value;
+}
+
+inline void EncodeTexel(HALF& Texel, float Value)
+{
+    Texel = FloatToHalf(Value);
+}
+
+//--------------------------------------------------------------------------------
+// Read-only view of a host texture. Texel(X,Y) = pData + Y * RowPitch + X * PixelStride,
+// with RowPitch and PixelStride counted in texels.
+// For MSAA user textures, PixelStride skips the samples after sample 0 (g_iSampleIndex).
+//--------------------------------------------------------------------------------
+template<class TexelType>
+struct TextureSRV
+{
+    typedef TexelType Texel;
+
+    TextureSRV()
+    {
+        ZERO_STRUCT(*this);
+    }
+
+    const TexelType* Load(UINT X, UINT Y) const
+    {
+        ASSERT(X < Width && Y < Height);
+        return pData + size_t(Y) * RowPitch + size_t(X) * PixelStride;
+    }
+
+    const TexelType* pData;
+    UINT Width;
+    UINT Height;
+    UINT RowPitch;
+    UINT PixelStride;
+};
+
+//--------------------------------------------------------------------------------
+template<class TexelType>
+struct TextureRTV
+{
+    typedef TexelType Texel;
+
+    TextureRTV()
+    {
+        ZERO_STRUCT(*this);
+    }
+
+    TexelType* Store(UINT X, UINT Y) const
+    {
+        ASSERT(X < Width && Y < Height);
+        return pData + size_t(Y) * RowPitch + size_t(X) * PixelStride;
+    }
+
+    operator TextureSRV<TexelType>() const
+    {
+        TextureSRV<TexelType> SRV;
+        SRV.pData = pData;
+        SRV.Width = Width;
+        SRV.Height = Height;
+        SRV.RowPitch = RowPitch;
+        SRV.PixelStride = PixelStride;
+        return SRV;
+    }
+
+    TexelType* pData;
+    UINT Width;
+    UINT Height;
+    UINT RowPitch;
+    UINT PixelStride;
+};
+
+typedef TextureSRV<FLOAT> ShaderResourceView;
+typedef TextureRTV<FLOAT> RenderTargetView;
+typedef TextureSRV<HALF> HalfShaderResourceView;
+typedef TextureRTV<HALF> HalfRenderTargetView;
+
+//--------------------------------------------------------------------------------
+// Output merger state for the passes that write to the user render target.
+// Only the RGB channels are written (the alpha channel is preserved).
+//--------------------------------------------------------------------------------
+struct OutputMergerState
+{
+    RenderTargetView RenderTarget;
+    GFSDK_SSAO_BlendMode BlendMode;
+    UINT TopLeftX;
+    UINT TopLeftY;
+};
+
+//--------------------------------------------------------------------------------
+// Per-pass bindings. Each kernel processes the rows [RowBegin,RowEnd) of its render target,
+// with the same per-pixel math as the corresponding pixel shader.
+//--------------------------------------------------------------------------------
+struct LinearizeDepthArgs
+{
+    const SSAO::GlobalConstantBuffer* pGlobalCB;
+    bool ViewDepths;                                    // CopyDepth_PS instead of LinearizeDepth_PS
+    ShaderResourceView DepthTexture[2];
+    RenderTargetView ViewDepthTexture[2];
+};
+
+struct DeinterleaveDepthArgs
+{
+    const SSAO::GlobalConstantBuffer* pGlobalCB;
+    bool HalfViewDepths;                                // Write QuarterResHalfViewDepthTexture instead of QuarterResViewDepthTexture
+    ShaderResourceView ViewDepthTexture[2];
+    RenderTargetView QuarterResViewDepthTexture[16];
+    HalfRenderTargetView QuarterResHalfViewDepthTexture[16];
+};
+
+struct LinearizeDeinterleaveDepthArgs
+{
+    const SSAO::GlobalConstantBuffer* pGlobalCB;
+    bool ViewDepths;                                    // CopyDepth_PS instead of LinearizeDepth_PS
+    bool HalfViewDepths;                                // Write QuarterResHalfViewDepthTexture instead of QuarterResViewDepthTexture
+    ShaderResourceView DepthTexture[2];
+    RenderTargetView QuarterResViewDepthTexture[16];
+    HalfRenderTargetView QuarterResHalfViewDepthTexture[16];
+    UINT Width;                                         // Full-res viewport
+    UINT Height;
+};
+
+struct ReconstructNormalArgs
+{
+    const SSAO::GlobalConstantBuffer* pGlobalCB;
+    GFSDK_SSAO_DepthClampMode DepthClampMode;
+    ShaderResourceView ViewDepthTexture;
+    RenderTargetView NormalTexture;
+};
+
+struct CoarseAOArgs
+{
+    const SSAO::GlobalConstantBuffer* pGlobalCB;
+    const SSAO::PerPassConstantStruct* pPerPassCB;
+    GFSDK_SSAO_DepthClampMode DepthClampMode;
+    bool HalfViewDepths;                                // Read QuarterResHalfViewDepthTexture instead of QuarterResViewDepthTexture
+    ShaderResourceView QuarterResViewDepthTexture;
+    HalfShaderResourceView QuarterResHalfViewDepthTexture;
+    ShaderResourceView NormalTexture;                   // Reconstructed view-space normals, or GBuffer world-space normals
+    RenderTargetView AOTexture;
+};
+
+// GFSDK_SSAO_LINE_SWEEP: each line keeps at most LINE_SWEEP_MAX_HULL_SIZE horizon candidates on the stack,
+// dropping the farthest ones first
+static const UINT LINE_SWEEP_MAX_HULL_SIZE = 256;
+
+struct LineSweepAOArgs
+{
+    const SSAO::GlobalConstantBuffer* pGlobalCB;
+    UINT DirectionIndex;                                // Sweeps the directions DirectionIndex and DirectionIndex + NUM_DIRECTIONS/2
+    ShaderResourceView ViewDepthTexture[2];
+    ShaderResourceView NormalTexture;                   // Reconstructed view-space normals, or GBuffer world-space normals
+    RenderTargetView AOTexture;                         // Sum of the AO of the directions swept so far
+};
+
+struct LineSweepResolveArgs
+{
+    const SSAO::GlobalConstantBuffer* pGlobalCB;
+    ShaderResourceView AOTexture;
+    ShaderResourceView ViewDepthTexture;
+    RenderTargetView AOZTexture;                        // ENABLE_BLUR_1
+    OutputMergerState Output;                           // ENABLE_BLUR_0
+};
+
+//--------------------------------------------------------------------------------
+// Partition of a full-res image into parallel lines along the directions DirectionIndex and
+// DirectionIndex + NUM_DIRECTIONS/2. Each line advances by one pixel per step along the major axis
+// of the direction, and step J of line L is at minor coordinate L - MaxOffset + round(Slope * J),
+// so that each pixel belongs to exactly one line.
+//--------------------------------------------------------------------------------
+class LineSweepLines
+{
+public:
+    LineSweepLines(UINT DirectionIndex, UINT Width, UINT Height)
+    {
+        const float Angle = 2.f * GFSDK_PI * float(DirectionIndex) / NUM_DIRECTIONS;
+        const float DirX = cosf(Angle);
+        const float DirY = sinf(Angle);
+
+        m_MajorX = fabsf(DirX) >= fabsf(DirY);
+        m_MajorSize = m_MajorX ? Width : Height;
+        m_MinorSize = m_MajorX ? Height : Width;
+        m_Slope = m_MajorX ? (DirY / DirX) : (DirX / DirY);
+
+        const int LastOffset = GetOffset(m_MajorSize - 1);
+        m_MinOffset = Min(LastOffset, 0);
+        m_MaxOffset = Max(LastOffset, 0);
+    }
+
+    UINT GetNumLines() const
+    {
+        return m_MinorSize + UINT(m_MaxOffset - m_MinOffset);
+    }
+
+    // Range of steps of Line that are inside the image
+    void GetSteps(UINT Line, UINT& StepBegin, UINT& StepEnd) const
+    {
+        const int MinorBegin = m_MaxOffset - int(Line);
+        const int MinorEnd = MinorBegin + int(m_MinorSize);
+        if (m_Slope >= 0.f)
+        {
+            StepBegin = FindStep(MinorBegin);
+            StepEnd = FindStep(MinorEnd);
+        }
+        else
+        {
+            StepBegin = FindStep(MinorEnd - 1);
+            StepEnd = FindStep(MinorBegin - 1);
+        }
+    }
+
+    void GetPixel(UINT Line, UINT Step, UINT& X, UINT& Y) const
+    {
+        const UINT Minor = UINT(int(Line) - m_MaxOffset + GetOffset(Step));
+        X = m_MajorX ? Step : Minor;
+        Y = m_MajorX ? Minor : Step;
+    }
+
+private:
+    int GetOffset(UINT Step) const
+    {
+        return int(floorf(m_Slope * float(Step) + 0.5f));
+    }
+
+    // First step whose offset has reached Offset, in the direction of the slope
+    UINT FindStep(int Offset) const
+    {
+        UINT Begin = 0;
+        UINT End = m_MajorSize;
+        while (Begin < End)
+        {
+            const UINT Mid = (Begin + End) / 2;
+            const bool Reached = (m_Slope >= 0.f) ? (GetOffset(Mid) >= Offset) : (GetOffset(Mid) <= Offset);
+            if (Reached)
+            {
+                End = Mid;
+            }
+            else
+            {
+                Begin = Mid + 1;
+            }
+        }
+        return Begin;
+    }
+
+    bool m_MajorX;
+    UINT m_MajorSize;
+    UINT m_MinorSize;
+    float m_Slope;
+    int m_MinOffset;
+    int m_MaxOffset;
+};
+
+struct ReinterleaveAOArgs
+{
+    const SSAO::GlobalConstantBuffer* pGlobalCB;
+    ShaderResourceView AOTexture[16];
+    bool DeinterleavedViewDepths;                       // Read the view depths from the depth slices instead of ViewDepthTexture
+    bool HalfViewDepths;                                // The depth slices are QuarterResHalfViewDepthTexture
+    ShaderResourceView ViewDepthTexture[2];
+    ShaderResourceView QuarterResViewDepthTexture[16];
+    HalfShaderResourceView QuarterResHalfViewDepthTexture[16];
+    RenderTargetView AOZTexture;                        // ENABLE_BLUR_1
+    OutputMergerState Output;                           // ENABLE_BLUR_0
+    UINT Width;
+    UINT Height;
+};
+
+// Blur_PS runs BlurX and BlurY over strips of BLUR_STRIP_WIDTH columns, through a ring of rows on the stack
+static const UINT BLUR_STRIP_WIDTH = 256;
+static const UINT BLUR_MAX_RING_ROWS = 2 * 4 + 1;
+
+struct BlurArgs
+{
+    const SSAO::GlobalConstantBuffer* pGlobalCB;
+    ShaderResourceView AOZTexture;
+    OutputMergerState Output;
+};
+
+struct DebugNormalsArgs
+{
+    const SSAO::GlobalConstantBuffer* pGlobalCB;
+    GFSDK_SSAO_DepthClampMode DepthClampMode;
+    ShaderResourceView ViewDepthTexture;
+    ShaderResourceView NormalTexture;
+    OutputMergerState Output;
+};
+
+//--------------------------------------------------------------------------------
+// Kernel entry points. The #permutation values are template parameters of the kernels,
+// not Args fields: like the GPU shaders, each kernel is compiled once per combination.
+//--------------------------------------------------------------------------------
+typedef void (*LinearizeDepthFunc)(const LinearizeDepthArgs& Args, UINT RowBegin, UINT RowEnd);
+typedef void (*DeinterleaveDepthFunc)(const DeinterleaveDepthArgs& Args, UINT RowBegin, UINT RowEnd);
+typedef void (*LinearizeDeinterleaveDepthFunc)(const LinearizeDeinterleaveDepthArgs& Args, UINT RowBegin, UINT RowEnd);
+typedef void (*ReconstructNormalFunc)(const ReconstructNormalArgs& Args, UINT RowBegin, UINT RowEnd);
+typedef void (*CoarseAOFunc)(const CoarseAOArgs& Args, UINT RowBegin, UINT RowEnd);
+typedef void (*ReinterleaveAOFunc)(const ReinterleaveAOArgs& Args, UINT RowBegin, UINT RowEnd);
+typedef void (*BlurFunc)(const BlurArgs& Args, UINT RowBegin, UINT RowEnd);
+typedef void (*DebugNormalsFunc)(const DebugNormalsArgs& Args, UINT RowBegin, UINT RowEnd);
+typedef void (*LineSweepAOFunc)(const LineSweepAOArgs& Args, UINT LineBegin, UINT LineEnd);
+typedef void (*LineSweepResolveFunc)(const LineSweepResolveArgs& Args, UINT RowBegin, UINT RowEnd);
+
+//--------------------------------------------------------------------------------
+// Kernel instantiations indexed by #permutation values, mirroring the shader classes
+// generated in shaders/out (e.g. Generated::D3D11::CoarseAO_PS)
+//--------------------------------------------------------------------------------
+namespace Kernels
+{
+    struct LinearizeDepth_PS
+    {
+        LinearizeDepthFunc Get(ShaderPermutations::DEPTH_LAYER_COUNT A) const
+        {
+            return m_Kernel[A];
+        }
+        LinearizeDepthFunc m_Kernel[ShaderPermutations::DEPTH_LAYER_COUNT_COUNT];
+    };
+
+    struct DeinterleaveDepth_PS
+    {
+        DeinterleaveDepthFunc Get(ShaderPermutations::DEPTH_LAYER_COUNT A) const
+        {
+            return m_Kernel[A];
+        }
+        DeinterleaveDepthFunc m_Kernel[ShaderPermutations::DEPTH_LAYER_COUNT_COUNT];
+    };
+
+    struct LinearizeDeinterleaveDepth_PS
+    {
+        LinearizeDeinterleaveDepthFunc Get(ShaderPermutations::DEPTH_LAYER_COUNT A) const
+        {
+            return m_Kernel[A];
+        }
+        LinearizeDeinterleaveDepthFunc m_Kernel[ShaderPermutations::DEPTH_LAYER_COUNT_COUNT];
+    };
+
+    struct ReconstructNormal_PS
+    {
+        ReconstructNormalFunc Get() const
+        {
+            return m_Kernel;
+        }
+        ReconstructNormalFunc m_Kernel;
+    };
+
+    struct CoarseAO_PS
+    {
+        CoarseAOFunc Get(ShaderPermutations::FETCH_GBUFFER_NORMAL A, ShaderPermutations::DEPTH_LAYER_COUNT B, ShaderPermutations::NUM_STEPS C) const
+        {
+            return m_Kernel[A][B][C];
+        }
+        CoarseAOFunc m_Kernel[ShaderPermutations::FETCH_GBUFFER_NORMAL_COUNT][ShaderPermutations::DEPTH_LAYER_COUNT_COUNT][ShaderPermutations::NUM_STEPS_COUNT];
+    };
+
+    struct ReinterleaveAO_PS
+    {
+        ReinterleaveAOFunc Get(ShaderPermutations::ENABLE_BLUR A, ShaderPermutations::DEPTH_LAYER_COUNT B) const
+        {
+            return m_Kernel[A][B];
+        }
+        ReinterleaveAOFunc m_Kernel[ShaderPermutations::ENABLE_BLUR_COUNT][ShaderPermutations::DEPTH_LAYER_COUNT_COUNT];
+    };
+
+    struct Blur_PS
+    {
+        BlurFunc Get(ShaderPermutations::KERNEL_RADIUS A, ShaderPermutations::ENABLE_SHARPNESS_PROFILE B) const
+        {
+            return m_Kernel[A][B];
+        }
+        BlurFunc m_Kernel[ShaderPermutations::KERNEL_RADIUS_COUNT][ShaderPermutations::ENABLE_SHARPNESS_PROFILE_COUNT];
+    };
+
+    struct DebugNormals_PS
+    {
+        DebugNormalsFunc Get(ShaderPermutations::FETCH_GBUFFER_NORMAL A) const
+        {
+            return m_Kernel[A];
+        }
+        DebugNormalsFunc m_Kernel[ShaderPermutations::FETCH_GBUFFER_NORMAL_COUNT];
+    };
+
+    struct LineSweepAO_PS
+    {
+        LineSweepAOFunc Get(ShaderPermutations::FETCH_GBUFFER_NORMAL A, ShaderPermutations::DEPTH_LAYER_COUNT B) const
+        {
+            return m_Kernel[A][B];
+        }
+        LineSweepAOFunc m_Kernel[ShaderPermutations::FETCH_GBUFFER_NORMAL_COUNT][ShaderPermutations::DEPTH_LAYER_COUNT_COUNT];
+    };
+
+    struct LineSweepResolve_PS
+    {
+        LineSweepResolveFunc Get(ShaderPermutations::ENABLE_BLUR A, ShaderPermutations::NUM_STEPS B) const
+        {
+            return m_Kernel[A][B];
+        }
+        LineSweepResolveFunc m_Kernel[ShaderPermutations::ENABLE_BLUR_COUNT][ShaderPermutations::NUM_STEPS_COUNT];
+    };
+}
+
+//--------------------------------------------------------------------------------
+// All the kernels of one instruction set, built at compile time.
+// DebugNormals_PS is only used for debugging and always runs the scalar version, like the
+// line-sweep kernels, which are sequential along each line.
+//--------------------------------------------------------------------------------
+struct KernelTable
+{
+    Kernels::LinearizeDepth_PS LinearizeDepth_PS;
+    Kernels::DeinterleaveDepth_PS DeinterleaveDepth_PS;
+    Kernels::LinearizeDeinterleaveDepth_PS LinearizeDeinterleaveDepth_PS;
+    Kernels::ReconstructNormal_PS ReconstructNormal_PS;
+    Kernels::CoarseAO_PS CoarseAO_PS;
+    Kernels::ReinterleaveAO_PS ReinterleaveAO_PS;
+    Kernels::Blur_PS Blur_PS;
+};
+
+// Scalar kernels, defined in Shaders_CPU.cpp. Vector kernels, defined in Shaders_CPU_<ISA>.cpp.
+#define DECLARE_CPU_KERNEL_TABLE() \
+    const KernelTable& GetKernelTable();
+
+namespace Scalar
+{
+    DECLARE_CPU_KERNEL_TABLE()
+}
+
+#if ENABLE_CPU_SSE42
+namespace SSE42
+{
+    DECLARE_CPU_KERNEL_TABLE()
+}
+#endif
+
+#if ENABLE_CPU_AVX2
+namespace AVX2
+{
+    DECLARE_CPU_KERNEL_TABLE()
+}
+#endif
+
+#if ENABLE_CPU_AVX512
+namespace AVX512
+{
+    DECLARE_CPU_KERNEL_TABLE()
+}
+#endif
+
+//--------------------------------------------------------------------------------
+// Host implementations of the HBAO+ pixel shaders
+//--------------------------------------------------------------------------------
+class Shaders : public KernelTable
+{
+public:
+    Shaders()
+    {
+        ZERO_STRUCT(*this);
+    }
+
+    // Selects the widest kernels supported by both the build and the running CPU, up to MaxInstructionSet
+    void Create(GFSDK_SSAO_InstructionSet_CPU MaxInstructionSet = GFSDK_SSAO_CPU_AVX512);
+    void Release();
+
+    static GFSDK_SSAO_InstructionSet_CPU GetSupportedInstructionSet();
+
+    GFSDK_SSAO_InstructionSet_CPU ActiveInstructionSet;
+
+    Kernels::DebugNormals_PS DebugNormals_PS;
+    Kernels::LineSweepAO_PS LineSweepAO_PS;
+    Kernels::LineSweepResolve_PS LineSweepResolve_PS;
+};
+
+} // namespace CPU
+} // namespace SSAO
+} // namespace GFSDK
+
+#endif // SUPPORT_CPU
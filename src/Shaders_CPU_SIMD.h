@@ -0,0 +1,1082 @@
+// This code contains NVIDIA Confidential Information and is disclosed to you
+// under a form of NVIDIA software license agreement provided separately to you.
+//
+// Notice
+// NVIDIA Corporation and its licensors retain all intellectual property and
+// proprietary rights in and to this software and related documentation and
+// any modifications thereto. Any use, reproduction, disclosure, or
+// distribution of this software and related documentation without an express
+// license agreement from NVIDIA Corporation is strictly prohibited.
+//
+// ALL NVIDIA DESIGN SPECIFICATIONS, CODE ARE PROVIDED "AS IS.". NVIDIA MAKES
+// NO WARRANTIES, EXPRESSED, IMPLIED, STATUTORY, OR OTHERWISE WITH RESPECT TO
+// THE MATERIALS, AND EXPRESSLY DISCLAIMS ALL IMPLIED WARRANTIES OF NONINFRINGEMENT,
+// MERCHANTABILITY, AND FITNESS FOR A PARTICULAR PURPOSE.
+//
+// Information and code furnished is believed to be accurate and reliable.
+// However, NVIDIA Corporation assumes no responsibility for the consequences of use of such
+// information or for any infringement of patents or other rights of third parties that may
+// result from its use. No license is granted by implication or otherwise under any patent
+// or patent rights of NVIDIA Corporation. Details are subject to change without notice.
+// This code supersedes and replaces all information previously supplied.
+// NVIDIA Corporation products are not authorized for use as critical
+// components in life support devices or systems without express written approval of
+// NVIDIA Corporation.
+//
+// Copyright (c) 2008-2021 NVIDIA Corporation. All rights reserved.
+
+#if SUPPORT_CPU
+
+#pragma once
+#include "Shaders_CPU.h"
+#include "SIMD_CPU.h"
+
+namespace GFSDK
+{
+namespace SSAO
+{
+namespace CPU
+{
+namespace SIMD
+{
+
+//--------------------------------------------------------------------------------
+// Vector ports of the HBAO+ kernels. Each lane processes one pixel, and the lanes
+// of a vector are consecutive pixels of the same row. The per-pixel math is the
+// same as in Shaders_CPU.cpp, so the results match the scalar kernels up to the
+// floating-point contraction done by the compiler.
+//--------------------------------------------------------------------------------
+template<class V>
+struct Float3
+{
+    typename V::Float X, Y, Z;
+};
+
+template<class V>
+inline typename V::Float Saturate(typename V::Float A)
+{
+    return V::MinF(V::MaxF(A, V::Set1(0.f)), V::Set1(1.f));
+}
+
+template<class V>
+inline typename V::Float Dot(const Float3<V>& A, const Float3<V>& B)
+{
+    return V::Add(V::Add(V::Mul(A.X, B.X), V::Mul(A.Y, B.Y)), V::Mul(A.Z, B.Z));
+}
+
+template<class V>
+inline Float3<V> Normalize(const Float3<V>& A)
+{
+    const typename V::Float InvLength = V::Div(V::Set1(1.f), V::Sqrt(Dot<V>(A, A)));
+    Float3<V> R = { V::Mul(A.X, InvLength), V::Mul(A.Y, InvLength), V::Mul(A.Z, InvLength) };
+    return R;
+}
+
+template<class V>
+inline Float3<V> UVToView(const SSAO::GlobalConstantBuffer& CB, typename V::Float U, typename V::Float Vc, typename V::Float ViewDepth)
+{
+    Float3<V> P = { V::Mul(V::Add(V::Mul(V::Set1(CB.f2UVToViewA.X), U), V::Set1(CB.f2UVToViewB.X)), ViewDepth),
+                    V::Mul(V::Add(V::Mul(V::Set1(CB.f2UVToViewA.Y), Vc), V::Set1(CB.f2UVToViewB.Y)), ViewDepth),
+                    ViewDepth };
+    return P;
+}
+
+//--------------------------------------------------------------------------------
+// Texel offsets (in channels) of the pixels (X,Y), clamped to the texture dimensions
+//--------------------------------------------------------------------------------
+template<class V, class TexelType>
+inline typename V::Int ClampedTexelOffsets(const TextureSRV<TexelType>& Texture, typename V::Int X, typename V::Int Y)
+{
+    X = V::MaxI(V::MinI(X, V::Set1I(int(Texture.Width) - 1)), V::Set1I(0));
+    Y = V::MaxI(V::MinI(Y, V::Set1I(int(Texture.Height) - 1)), V::Set1I(0));
+    return V::AddI(V::MulI(Y, V::Set1I(int(Texture.RowPitch))), V::MulI(X, V::Set1I(int(Texture.PixelStride))));
+}
+
+template<class V, class TexelType>
+inline typename V::Mask InBounds(const TextureSRV<TexelType>& Texture, typename V::Int X, typename V::Int Y)
+{
+    const typename V::Int MinusOne = V::Set1I(-1);
+    return V::And(V::And(V::CmpGTI(X, MinusOne), V::CmpGTI(V::Set1I(int(Texture.Width)), X)),
+                  V::And(V::CmpGTI(Y, MinusOne), V::CmpGTI(V::Set1I(int(Texture.Height)), Y)));
+}
+
+//--------------------------------------------------------------------------------
+// Channel of the texels at the given offsets, converted to FP32
+//--------------------------------------------------------------------------------
+template<class V>
+inline typename V::Float GatherTexels(const ShaderResourceView& Texture, typename V::Int Offsets, UINT Channel)
+{
+    return V::Gather(Texture.pData + Channel, Offsets);
+}
+
+template<class V>
+inline typename V::Float GatherTexels(const HalfShaderResourceView& Texture, typename V::Int Offsets, UINT Channel)
+{
+    return V::HalfToFloat(V::Gather16(Texture.pData + Channel, Offsets));
+}
+
+//--------------------------------------------------------------------------------
+// Channel 0 of the texels (X0+Lane,Y), with the same addressing as Scalar::PointSample.
+// Rows fully inside a single-channel texture are loaded without gathering.
+//--------------------------------------------------------------------------------
+template<class V>
+inline typename V::Float SampleRow(const ShaderResourceView& Texture, int X0, int Y, GFSDK_SSAO_DepthClampMode ClampMode)
+{
+    if (Texture.PixelStride == 1 && X0 >= 0 && X0 + int(V::Width) <= int(Texture.Width) && Y >= 0 && Y < int(Texture.Height))
+    {
+        return V::LoadU(Texture.Load(UINT(X0), UINT(Y)));
+    }
+
+    const typename V::Int X = V::AddI(V::Set1I(X0), V::IotaI());
+    const typename V::Int YV = V::Set1I(Y);
+    const typename V::Float Texel = V::Gather(Texture.pData, ClampedTexelOffsets<V>(Texture, X, YV));
+
+    if (ClampMode == GFSDK_SSAO_CLAMP_TO_BORDER)
+    {
+        return V::Select(InBounds<V>(Texture, X, YV), Texel, V::Set1(-FLT_MAX));
+    }
+    return Texel;
+}
+
+//--------------------------------------------------------------------------------
+// Writes the first NumLanes pixels of NumChannels vectors to (X0+Lane,Y)
+//--------------------------------------------------------------------------------
+template<class V>
+inline void StoreChannels(const RenderTargetView& Texture, UINT X0, UINT Y, UINT NumLanes, const typename V::Float* pChannels, UINT NumChannels)
+{
+    FLOAT* pOut = Texture.Store(X0, Y);
+
+    if (NumChannels == 1 && Texture.PixelStride == 1)
+    {
+        V::MaskStore(pOut, V::CmpGTI(V::Set1I(int(NumLanes)), V::IotaI()), pChannels[0]);
+        return;
+    }
+
+    FLOAT Lanes[4][V::Width];
+    for (UINT Channel = 0; Channel < NumChannels; ++Channel)
+    {
+        V::StoreU(Lanes[Channel], pChannels[Channel]);
+    }
+    for (UINT Lane = 0; Lane < NumLanes; ++Lane, pOut += Texture.PixelStride)
+    {
+        for (UINT Channel = 0; Channel < NumChannels; ++Channel)
+        {
+            pOut[Channel] = Lanes[Channel][Lane];
+        }
+    }
+}
+
+template<class V>
+inline void StoreChannels(const HalfRenderTargetView& Texture, UINT X0, UINT Y, UINT NumLanes, const typename V::Float* pChannels, UINT NumChannels)
+{
+    HALF* pOut = Texture.Store(X0, Y);
+
+    int Lanes[4][V::Width];
+    for (UINT Channel = 0; Channel < NumChannels; ++Channel)
+    {
+        V::StoreI(Lanes[Channel], V::FloatToHalf(pChannels[Channel]));
+    }
+    for (UINT Lane = 0; Lane < NumLanes; ++Lane, pOut += Texture.PixelStride)
+    {
+        for (UINT Channel = 0; Channel < NumChannels; ++Channel)
+        {
+            pOut[Channel] = HALF(Lanes[Channel][Lane]);
+        }
+    }
+}
+
+//--------------------------------------------------------------------------------
+// exp2, log2 and pow, with Cephes polynomials (relative error below 2 ulps).
+// Exp2 clamps its input to the range of normalized floats.
+//--------------------------------------------------------------------------------
+template<class V>
+inline typename V::Float Exp2(typename V::Float X)
+{
+    X = V::MinF(V::MaxF(X, V::Set1(-126.f)), V::Set1(127.f));
+
+    const typename V::Float I = V::Round(X);
+    const typename V::Float F = V::Sub(X, I);
+
+    typename V::Float P = V::Set1(1.535336188319500e-4f);
+    P = V::Add(V::Mul(P, F), V::Set1(1.339887440266574e-3f));
+    P = V::Add(V::Mul(P, F), V::Set1(9.618437357674640e-3f));
+    P = V::Add(V::Mul(P, F), V::Set1(5.550332471162809e-2f));
+    P = V::Add(V::Mul(P, F), V::Set1(2.402264791363012e-1f));
+    P = V::Add(V::Mul(P, F), V::Set1(6.931472028550421e-1f));
+    P = V::Add(V::Mul(P, F), V::Set1(1.f));
+
+    const typename V::Int Exponent = V::template ShiftLeftI<23>(V::AddI(V::ToInt(I), V::Set1I(127)));
+    return V::Mul(P, V::AsFloat(Exponent));
+}
+
+// Only valid for positive normalized inputs
+template<class V>
+inline typename V::Float Log2(typename V::Float X)
+{
+    const typename V::Int Bits = V::AsInt(X);
+    typename V::Float E = V::ToFloat(V::SubI(V::template ShiftRightI<23>(Bits), V::Set1I(127)));
+    typename V::Float M = V::AsFloat(V::AddI(V::AndI(Bits, V::Set1I(0x007FFFFF)), V::Set1I(0x3F800000)));
+
+    // Keep the mantissa in [sqrt(0.5), sqrt(2)]
+    const typename V::Mask Large = V::CmpLT(V::Set1(1.41421356f), M);
+    M = V::Select(Large, V::Mul(M, V::Set1(0.5f)), M);
+    E = V::Select(Large, V::Add(E, V::Set1(1.f)), E);
+
+    const typename V::Float F = V::Sub(M, V::Set1(1.f));
+    const typename V::Float Z = V::Mul(F, F);
+
+    typename V::Float P = V::Set1(7.0376836292e-2f);
+    P = V::Add(V::Mul(P, F), V::Set1(-1.1514610310e-1f));
+    P = V::Add(V::Mul(P, F), V::Set1(1.1676998740e-1f));
+    P = V::Add(V::Mul(P, F), V::Set1(-1.2420140846e-1f));
+    P = V::Add(V::Mul(P, F), V::Set1(1.4249322787e-1f));
+    P = V::Add(V::Mul(P, F), V::Set1(-1.6668057665e-1f));
+    P = V::Add(V::Mul(P, F), V::Set1(2.0000714765e-1f));
+    P = V::Add(V::Mul(P, F), V::Set1(-2.4999993993e-1f));
+    P = V::Add(V::Mul(P, F), V::Set1(3.3333331174e-1f));
+
+    // ln(1+F) = F - F^2/2 + F^3 * P(F)
+    const typename V::Float Ln = V::Add(V::Sub(V::Mul(V::Mul(P, Z), F), V::Mul(Z, V::Set1(0.5f))), F);
+    return V::Add(V::Mul(Ln, V::Set1(1.44269504f)), E);
+}
+
+// pow(X, Exponent) for X in [0,1], as used for the AO power exponent
+template<class V>
+inline typename V::Float PowSaturated(typename V::Float X, float Exponent)
+{
+    if (Exponent == 0.f)
+    {
+        return V::Set1(1.f);
+    }
+    const typename V::Float Zero = V::Set1(0.f);
+    const typename V::Float Result = Exp2<V>(V::Mul(Log2<V>(V::MaxF(X, V::Set1(FLT_MIN))), V::Set1(Exponent)));
+    return V::Select(V::CmpLT(Zero, X), Result, Zero);
+}
+
+//--------------------------------------------------------------------------------
+// Writes a color to the user render target, like Scalar::OutputMerger
+//--------------------------------------------------------------------------------
+template<class V>
+inline void OutputMerger(const OutputMergerState& Output, UINT X0, UINT Y, UINT NumLanes, const Float3<V>& Color)
+{
+    X0 += Output.TopLeftX;
+    Y += Output.TopLeftY;
+    if (X0 >= Output.RenderTarget.Width || Y >= Output.RenderTarget.Height)
+    {
+        return;
+    }
+    NumLanes = Min(NumLanes, Output.RenderTarget.Width - X0);
+
+    FLOAT RGB[3][V::Width];
+    V::StoreU(RGB[0], Color.X);
+    V::StoreU(RGB[1], Color.Y);
+    V::StoreU(RGB[2], Color.Z);
+
+    FLOAT* pOut = Output.RenderTarget.Store(X0, Y);
+    const UINT NumChannels = Min(Output.RenderTarget.PixelStride, 3u);
+
+    for (UINT Lane = 0; Lane < NumLanes; ++Lane, pOut += Output.RenderTarget.PixelStride)
+    {
+        for (UINT Channel = 0; Channel < NumChannels; ++Channel)
+        {
+            if (Output.BlendMode == GFSDK_SSAO_MULTIPLY_RGB)
+            {
+                pOut[Channel] *= RGB[Channel][Lane];
+            }
+            else
+            {
+                pOut[Channel] = RGB[Channel][Lane];
+            }
+        }
+    }
+}
+
+template<class V>
+inline void OutputMerger(const OutputMergerState& Output, UINT X0, UINT Y, UINT NumLanes, typename V::Float AO)
+{
+    const Float3<V> Color = { AO, AO, AO };
+    OutputMerger<V>(Output, X0, Y, NumLanes, Color);
+}
+
+//--------------------------------------------------------------------------------
+// LinearizeDepth_PS.hlsl & CopyDepth_PS.hlsl
+//--------------------------------------------------------------------------------
+template<class V>
+inline typename V::Float ConvertToViewDepth(const SSAO::GlobalConstantBuffer& CB, typename V::Float HardwareDepth)
+{
+    const typename V::Float NormalizedDepth = Saturate<V>(V::Add(V::Mul(V::Set1(CB.fInverseDepthRangeA), HardwareDepth), V::Set1(CB.fInverseDepthRangeB)));
+
+    return V::Div(V::Set1(1.f), V::Add(V::Mul(NormalizedDepth, V::Set1(CB.fLinearizeDepthA)), V::Set1(CB.fLinearizeDepthB)));
+}
+
+template<class V, ShaderPermutations::DEPTH_LAYER_COUNT DEPTH_LAYER_COUNT>
+void LinearizeDepth_PS(const LinearizeDepthArgs& Args, UINT RowBegin, UINT RowEnd)
+{
+    typedef typename V::Float Float;
+
+    const SSAO::GlobalConstantBuffer& CB = *Args.pGlobalCB;
+    const int OffsetX = int(CB.f2InputViewportTopLeft.X);
+    const int OffsetY = int(CB.f2InputViewportTopLeft.Y);
+    const UINT Width = Args.ViewDepthTexture[0].Width;
+    const bool DualLayer = (DEPTH_LAYER_COUNT == ShaderPermutations::DEPTH_LAYER_COUNT_2);
+
+    for (UINT Y = RowBegin; Y < RowEnd; ++Y)
+    {
+        for (UINT X0 = 0; X0 < Width; X0 += V::Width)
+        {
+            const UINT NumLanes = Min(Width - X0, V::Width);
+
+            Float ViewDepth0 = SampleRow<V>(Args.DepthTexture[0], int(X0) + OffsetX, int(Y) + OffsetY, GFSDK_SSAO_CLAMP_TO_EDGE);
+            if (!Args.ViewDepths)
+            {
+                ViewDepth0 = ConvertToViewDepth<V>(CB, ViewDepth0);
+            }
+
+            if (DualLayer)
+            {
+                Float ViewDepth1 = SampleRow<V>(Args.DepthTexture[1], int(X0) + OffsetX, int(Y) + OffsetY, GFSDK_SSAO_CLAMP_TO_EDGE);
+                if (!Args.ViewDepths)
+                {
+                    ViewDepth1 = ConvertToViewDepth<V>(CB, ViewDepth1);
+                }
+
+                const Float MinDepth = V::MinF(ViewDepth0, ViewDepth1);
+                const Float MaxDepth = V::MaxF(ViewDepth0, ViewDepth1);
+                StoreChannels<V>(Args.ViewDepthTexture[0], X0, Y, NumLanes, &MinDepth, 1);
+                StoreChannels<V>(Args.ViewDepthTexture[1], X0, Y, NumLanes, &MaxDepth, 1);
+            }
+            else
+            {
+                StoreChannels<V>(Args.ViewDepthTexture[0], X0, Y, NumLanes, &ViewDepth0, 1);
+            }
+        }
+    }
+}
+
+//--------------------------------------------------------------------------------
+// DeinterleaveDepth_PS.hlsl
+//--------------------------------------------------------------------------------
+template<class V, ShaderPermutations::DEPTH_LAYER_COUNT DEPTH_LAYER_COUNT, class TexelType>
+void DeinterleaveDepth(const DeinterleaveDepthArgs& Args, const TextureRTV<TexelType>* pSlices, UINT RowBegin, UINT RowEnd)
+{
+    typedef typename V::Float Float;
+    typedef typename V::Int Int;
+
+    const ShaderResourceView& FullRes0 = Args.ViewDepthTexture[0];
+    const ShaderResourceView& FullRes1 = Args.ViewDepthTexture[1];
+    const UINT QuarterWidth = pSlices[0].Width;
+    const bool DualLayer = (DEPTH_LAYER_COUNT == ShaderPermutations::DEPTH_LAYER_COUNT_2);
+    const UINT NumChannels = DualLayer ? 2 : 1;
+    const Int MaxFullResX = V::Set1I(int(FullRes0.Width) - 1);
+    ASSERT(FullRes0.PixelStride == 1 && (!DualLayer || (FullRes1.PixelStride == 1 && FullRes0.RowPitch == FullRes1.RowPitch)));
+
+    for (UINT Y = RowBegin; Y < RowEnd; ++Y)
+    {
+        for (UINT J = 0; J < 4; ++J)
+        {
+            const UINT FullResY = Min(Y * 4 + J, FullRes0.Height - 1);
+            const Int RowOffset = V::Set1I(int(FullResY * FullRes0.RowPitch));
+
+            for (UINT X0 = 0; X0 < QuarterWidth; X0 += V::Width)
+            {
+                const UINT NumLanes = Min(QuarterWidth - X0, V::Width);
+                const Int FullResX0 = V::template ShiftLeftI<2>(V::AddI(V::Set1I(int(X0)), V::IotaI()));
+
+                for (UINT I = 0; I < 4; ++I)
+                {
+                    const Int Offsets = V::AddI(RowOffset, V::MinI(V::AddI(FullResX0, V::Set1I(int(I))), MaxFullResX));
+
+                    const Float Depths[2] = { V::Gather(FullRes0.pData, Offsets),
+                                              DualLayer ? V::Gather(FullRes1.pData, Offsets) : V::Set1(0.f) };
+                    StoreChannels<V>(pSlices[J * 4 + I], X0, Y, NumLanes, Depths, NumChannels);
+                }
+            }
+        }
+    }
+}
+
+template<class V, ShaderPermutations::DEPTH_LAYER_COUNT DEPTH_LAYER_COUNT>
+void DeinterleaveDepth_PS(const DeinterleaveDepthArgs& Args, UINT RowBegin, UINT RowEnd)
+{
+    if (Args.HalfViewDepths)
+    {
+        DeinterleaveDepth<V, DEPTH_LAYER_COUNT>(Args, Args.QuarterResHalfViewDepthTexture, RowBegin, RowEnd);
+    }
+    else
+    {
+        DeinterleaveDepth<V, DEPTH_LAYER_COUNT>(Args, Args.QuarterResViewDepthTexture, RowBegin, RowEnd);
+    }
+}
+
+//--------------------------------------------------------------------------------
+// LinearizeDepth_PS.hlsl followed by DeinterleaveDepth_PS.hlsl, without the full-res view depths
+//--------------------------------------------------------------------------------
+template<class V>
+inline typename V::Float GatherViewDepths(const SSAO::GlobalConstantBuffer& CB, const ShaderResourceView& DepthTexture, bool ViewDepths, int Y, typename V::Int X)
+{
+    const typename V::Int Offsets = V::AddI(V::Set1I(Y * int(DepthTexture.RowPitch)), V::MulI(X, V::Set1I(int(DepthTexture.PixelStride))));
+    const typename V::Float Depths = V::Gather(DepthTexture.pData, Offsets);
+
+    return ViewDepths ? Depths : ConvertToViewDepth<V>(CB, Depths);
+}
+
+template<class V, ShaderPermutations::DEPTH_LAYER_COUNT DEPTH_LAYER_COUNT, class TexelType>
+void LinearizeDeinterleaveDepth(const LinearizeDeinterleaveDepthArgs& Args, const TextureRTV<TexelType>* pSlices, UINT RowBegin, UINT RowEnd)
+{
+    typedef typename V::Float Float;
+    typedef typename V::Int Int;
+
+    const SSAO::GlobalConstantBuffer& CB = *Args.pGlobalCB;
+    const int OffsetX = int(CB.f2InputViewportTopLeft.X);
+    const int OffsetY = int(CB.f2InputViewportTopLeft.Y);
+    const UINT QuarterWidth = pSlices[0].Width;
+    const bool DualLayer = (DEPTH_LAYER_COUNT == ShaderPermutations::DEPTH_LAYER_COUNT_2);
+    const UINT NumChannels = DualLayer ? 2 : 1;
+    const Int MaxFullResX = V::Set1I(int(Args.Width) - 1);
+
+    for (UINT Y = RowBegin; Y < RowEnd; ++Y)
+    {
+        for (UINT J = 0; J < 4; ++J)
+        {
+            const int FullResY = int(Min(Y * 4 + J, Args.Height - 1)) + OffsetY;
+
+            for (UINT X0 = 0; X0 < QuarterWidth; X0 += V::Width)
+            {
+                const UINT NumLanes = Min(QuarterWidth - X0, V::Width);
+                const Int FullResX0 = V::template ShiftLeftI<2>(V::AddI(V::Set1I(int(X0)), V::IotaI()));
+
+                for (UINT I = 0; I < 4; ++I)
+                {
+                    const Int FullResX = V::AddI(V::MinI(V::AddI(FullResX0, V::Set1I(int(I))), MaxFullResX), V::Set1I(OffsetX));
+
+                    const Float ViewDepth0 = GatherViewDepths<V>(CB, Args.DepthTexture[0], Args.ViewDepths, FullResY, FullResX);
+                    const Float ViewDepth1 = DualLayer ? GatherViewDepths<V>(CB, Args.DepthTexture[1], Args.ViewDepths, FullResY, FullResX) : ViewDepth0;
+
+                    const Float Depths[2] = { V::MinF(ViewDepth0, ViewDepth1), V::MaxF(ViewDepth0, ViewDepth1) };
+                    StoreChannels<V>(pSlices[J * 4 + I], X0, Y, NumLanes, Depths, NumChannels);
+                }
+            }
+        }
+    }
+}
+
+template<class V, ShaderPermutations::DEPTH_LAYER_COUNT DEPTH_LAYER_COUNT>
+void LinearizeDeinterleaveDepth_PS(const LinearizeDeinterleaveDepthArgs& Args, UINT RowBegin, UINT RowEnd)
+{
+    if (Args.HalfViewDepths)
+    {
+        LinearizeDeinterleaveDepth<V, DEPTH_LAYER_COUNT>(Args, Args.QuarterResHalfViewDepthTexture, RowBegin, RowEnd);
+    }
+    else
+    {
+        LinearizeDeinterleaveDepth<V, DEPTH_LAYER_COUNT>(Args, Args.QuarterResViewDepthTexture, RowBegin, RowEnd);
+    }
+}
+
+//--------------------------------------------------------------------------------
+// ReconstructNormal_Common.hlsl
+//--------------------------------------------------------------------------------
+template<class V>
+inline Float3<V> FetchFullResViewPos(const SSAO::GlobalConstantBuffer& CB, const ShaderResourceView& ViewDepthTexture, GFSDK_SSAO_DepthClampMode ClampMode, int X0, int Y)
+{
+    const typename V::Float X = V::ToFloat(V::AddI(V::Set1I(X0), V::IotaI()));
+    const typename V::Float U = V::Mul(V::Add(X, V::Set1(0.5f)), V::Set1(CB.f2InvFullResolution.X));
+    const typename V::Float Vc = V::Set1((float(Y) + 0.5f) * CB.f2InvFullResolution.Y);
+    const typename V::Float ViewDepth = SampleRow<V>(ViewDepthTexture, X0, Y, ClampMode);
+    return UVToView<V>(CB, U, Vc, ViewDepth);
+}
+
+template<class V>
+inline Float3<V> MinDiff(const Float3<V>& P, const Float3<V>& Pr, const Float3<V>& Pl)
+{
+    const Float3<V> V1 = { V::Sub(Pr.X, P.X), V::Sub(Pr.Y, P.Y), V::Sub(Pr.Z, P.Z) };
+    const Float3<V> V2 = { V::Sub(P.X, Pl.X), V::Sub(P.Y, Pl.Y), V::Sub(P.Z, Pl.Z) };
+    const typename V::Mask UseV1 = V::CmpLT(Dot<V>(V1, V1), Dot<V>(V2, V2));
+    const Float3<V> R = { V::Select(UseV1, V1.X, V2.X), V::Select(UseV1, V1.Y, V2.Y), V::Select(UseV1, V1.Z, V2.Z) };
+    return R;
+}
+
+template<class V>
+inline Float3<V> Cross(const Float3<V>& A, const Float3<V>& B)
+{
+    const Float3<V> R = { V::Sub(V::Mul(A.Y, B.Z), V::Mul(A.Z, B.Y)),
+                          V::Sub(V::Mul(A.Z, B.X), V::Mul(A.X, B.Z)),
+                          V::Sub(V::Mul(A.X, B.Y), V::Mul(A.Y, B.X)) };
+    return R;
+}
+
+template<class V>
+void ReconstructNormal_PS(const ReconstructNormalArgs& Args, UINT RowBegin, UINT RowEnd)
+{
+    const SSAO::GlobalConstantBuffer& CB = *Args.pGlobalCB;
+    const ShaderResourceView& ViewDepthTexture = Args.ViewDepthTexture;
+    const GFSDK_SSAO_DepthClampMode ClampMode = Args.DepthClampMode;
+    const UINT Width = Args.NormalTexture.Width;
+
+    for (UINT Y = RowBegin; Y < RowEnd; ++Y)
+    {
+        for (UINT X0 = 0; X0 < Width; X0 += V::Width)
+        {
+            const int X = int(X0);
+            const Float3<V> P  = FetchFullResViewPos<V>(CB, ViewDepthTexture, ClampMode, X, int(Y));
+            const Float3<V> Pr = FetchFullResViewPos<V>(CB, ViewDepthTexture, ClampMode, X + 1, int(Y));
+            const Float3<V> Pl = FetchFullResViewPos<V>(CB, ViewDepthTexture, ClampMode, X - 1, int(Y));
+            const Float3<V> Pt = FetchFullResViewPos<V>(CB, ViewDepthTexture, ClampMode, X, int(Y) + 1);
+            const Float3<V> Pb = FetchFullResViewPos<V>(CB, ViewDepthTexture, ClampMode, X, int(Y) - 1);
+            const Float3<V> N = Normalize<V>(Cross<V>(MinDiff<V>(P, Pr, Pl), MinDiff<V>(P, Pt, Pb)));
+
+            const typename V::Float Channels[3] = { N.X, N.Y, N.Z };
+            StoreChannels<V>(Args.NormalTexture, X0, Y, Min(Width - X0, V::Width), Channels, 3);
+        }
+    }
+}
+
+//--------------------------------------------------------------------------------
+// CoarseAO_PS.hlsl
+//--------------------------------------------------------------------------------
+template<class V>
+inline typename V::Float ComputeAO(const SSAO::GlobalConstantBuffer& CB, const Float3<V>& P, const Float3<V>& N, const Float3<V>& S, typename V::Float NegInvR2)
+{
+    const Float3<V> Vec = { V::Sub(S.X, P.X), V::Sub(S.Y, P.Y), V::Sub(S.Z, P.Z) };
+    const typename V::Float VdotV = Dot<V>(Vec, Vec);
+    const typename V::Float NdotV = V::Mul(Dot<V>(N, Vec), V::Div(V::Set1(1.f), V::Sqrt(VdotV)));
+
+    return V::Mul(Saturate<V>(V::Sub(NdotV, V::Set1(CB.fNDotVBias))),
+                  Saturate<V>(V::Add(V::Mul(VdotV, NegInvR2), V::Set1(1.f))));
+}
+
+template<class V, ShaderPermutations::FETCH_GBUFFER_NORMAL FETCH_GBUFFER_NORMAL, ShaderPermutations::DEPTH_LAYER_COUNT DEPTH_LAYER_COUNT, ShaderPermutations::NUM_STEPS NUM_STEPS, class TexelType>
+void CoarseAO(const CoarseAOArgs& Args, const TextureSRV<TexelType>& DepthTexture, UINT RowBegin, UINT RowEnd)
+{
+    typedef typename V::Float Float;
+    typedef typename V::Int Int;
+    typedef typename V::Mask Mask;
+
+    const SSAO::GlobalConstantBuffer& CB = *Args.pGlobalCB;
+    const SSAO::PerPassConstantStruct& PerPass = *Args.pPerPassCB;
+    const ShaderResourceView& NormalTexture = Args.NormalTexture;
+    const bool DualLayer = (DEPTH_LAYER_COUNT == ShaderPermutations::DEPTH_LAYER_COUNT_2);
+    const bool BorderMode = (Args.DepthClampMode == GFSDK_SSAO_CLAMP_TO_BORDER);
+    const int NumSteps = (NUM_STEPS == ShaderPermutations::NUM_STEPS_4) ? 4 : 8;
+    const UINT Width = Args.AOTexture.Width;
+    ASSERT(Args.AOTexture.PixelStride == 1);
+
+    const float4 Rand = PerPass.f4Jitter;
+    const float Alpha = 2.f * GFSDK_PI / NUM_DIRECTIONS;
+
+    float2 Directions[NUM_DIRECTIONS];
+    for (int DirectionIndex = 0; DirectionIndex < NUM_DIRECTIONS; ++DirectionIndex)
+    {
+        const float Angle = Alpha * float(DirectionIndex);
+        const float CosA = cosf(Angle);
+        const float SinA = sinf(Angle);
+        Directions[DirectionIndex].X = CosA * Rand.X - SinA * Rand.Y;
+        Directions[DirectionIndex].Y = CosA * Rand.Y + SinA * Rand.X;
+    }
+
+    const Float InvQuarterResX = V::Set1(CB.f2InvQuarterResolution.X);
+    const Float InvQuarterResY = V::Set1(CB.f2InvQuarterResolution.Y);
+    const Float Zero = V::Set1(0.f);
+    const Float One = V::Set1(1.f);
+    const Float Border = V::Set1(-FLT_MAX);
+    const Int Iota = V::IotaI();
+
+    for (UINT Y = RowBegin; Y < RowEnd; ++Y)
+    {
+        const Int PixelY = V::Set1I(int(Y));
+        const float PosY = float(Y) * 4.f + PerPass.f2Offset.Y;
+        const Float Vc = V::Set1(PosY * (CB.f2InvQuarterResolution.Y / 4.f));
+
+        for (UINT X0 = 0; X0 < Width; X0 += V::Width)
+        {
+            const Int PixelX = V::AddI(V::Set1I(int(X0)), Iota);
+            const Mask Valid = V::CmpGTI(V::Set1I(int(Width)), PixelX);
+
+            // IN.pos.xy = floor(IN.pos.xy) * 4.0 + g_PerPassConstants.f2Offset
+            const Float PosX = V::Add(V::Mul(V::ToFloat(PixelX), V::Set1(4.f)), V::Set1(PerPass.f2Offset.X));
+            const Float U = V::Mul(PosX, V::Set1(CB.f2InvQuarterResolution.X / 4.f));
+
+            const Float ViewDepth = GatherTexels<V>(DepthTexture, ClampedTexelOffsets<V>(DepthTexture, PixelX, PixelY), 0);
+            const Float3<V> ViewPosition = UVToView<V>(CB, U, Vc, ViewDepth);
+
+            const Int FullResX = V::AddI(V::MulI(PixelX, V::Set1I(4)), V::Set1I(int(PerPass.f2Offset.X)));
+            const Int FullResY = V::Set1I(int(Y) * 4 + int(PerPass.f2Offset.Y));
+
+            Float3<V> ViewNormal;
+            if (FETCH_GBUFFER_NORMAL == ShaderPermutations::FETCH_GBUFFER_NORMAL_0)
+            {
+                const Int Offsets = ClampedTexelOffsets<V>(NormalTexture, FullResX, FullResY);
+                ViewNormal.X = V::Gather(NormalTexture.pData + 0, Offsets);
+                ViewNormal.Y = V::Gather(NormalTexture.pData + 1, Offsets);
+                ViewNormal.Z = V::Gather(NormalTexture.pData + 2, Offsets);
+            }
+            else
+            {
+                // FetchFullResViewNormal_GBuffer
+                const Int Offsets = ClampedTexelOffsets<V>(NormalTexture,
+                    V::AddI(FullResX, V::Set1I(int(CB.f2InputViewportTopLeft.X))),
+                    V::AddI(FullResY, V::Set1I(int(CB.f2InputViewportTopLeft.Y))));
+                const Float DecodeScale = V::Set1(CB.fNormalDecodeScale);
+                const Float DecodeBias = V::Set1(CB.fNormalDecodeBias);
+                const Float3<V> N = { V::Add(V::Mul(V::Gather(NormalTexture.pData + 0, Offsets), DecodeScale), DecodeBias),
+                                      V::Add(V::Mul(V::Gather(NormalTexture.pData + 1, Offsets), DecodeScale), DecodeBias),
+                                      V::Add(V::Mul(V::Gather(NormalTexture.pData + 2, Offsets), DecodeScale), DecodeBias) };
+
+                const float* M = CB.f44NormalMatrix.Data;
+                Float3<V> WorldToView;
+                WorldToView.X = V::Add(V::Add(V::Mul(N.X, V::Set1(M[0])), V::Mul(N.Y, V::Set1(M[4]))), V::Mul(N.Z, V::Set1(M[8])));
+                WorldToView.Y = V::Add(V::Add(V::Mul(N.X, V::Set1(M[1])), V::Mul(N.Y, V::Set1(M[5]))), V::Mul(N.Z, V::Set1(M[9])));
+                WorldToView.Z = V::Add(V::Add(V::Mul(N.X, V::Set1(M[2])), V::Mul(N.Y, V::Set1(M[6]))), V::Mul(N.Z, V::Set1(M[10])));
+                ViewNormal = Normalize<V>(WorldToView);
+            }
+
+            // GetAORadiusParams
+            Float RadiusPixels = V::Div(V::Set1(CB.fRadiusToScreen), ViewDepth);
+            Float NegInvR2 = V::Set1(CB.fNegInvR2);
+
+            if (CB.fBackgroundAORadiusPixels != -1.f)
+            {
+                const Float ScaleFactor = V::MaxF(V::Div(V::Set1(CB.fBackgroundAORadiusPixels), RadiusPixels), One);
+                RadiusPixels = V::Mul(RadiusPixels, ScaleFactor);
+                NegInvR2 = V::Mul(NegInvR2, V::Div(One, V::Mul(ScaleFactor, ScaleFactor)));
+            }
+
+            if (CB.fForegroundAORadiusPixels != -1.f)
+            {
+                const Float ScaleFactor = V::MinF(V::Div(V::Set1(CB.fForegroundAORadiusPixels), RadiusPixels), One);
+                RadiusPixels = V::Mul(RadiusPixels, ScaleFactor);
+                NegInvR2 = V::Mul(NegInvR2, V::Div(One, V::Mul(ScaleFactor, ScaleFactor)));
+            }
+
+            // Early exit if the projected radius is smaller than 1 full-res pixel
+            const Mask EarlyExit = V::CmpLT(RadiusPixels, One);
+            FLOAT* pOut = Args.AOTexture.Store(0, Y) + X0;
+
+            if (!V::Any(V::AndNot(Valid, EarlyExit)))
+            {
+                V::MaskStore(pOut, Valid, One);
+                continue;
+            }
+
+            // Divide by NUM_STEPS+1 so that the farthest samples are not fully attenuated
+            const Float StepSizePixels = V::Div(V::Mul(RadiusPixels, V::Set1(0.25f)), V::Set1(float(NumSteps + 1)));
+
+            Float SmallScaleAO = Zero;
+            Float LargeScaleAO = Zero;
+
+            for (int DirectionIndex = 0; DirectionIndex < NUM_DIRECTIONS; ++DirectionIndex)
+            {
+                const Float DirectionX = V::Set1(Directions[DirectionIndex].X);
+                const Float DirectionY = V::Set1(Directions[DirectionIndex].Y);
+
+                // Jitter starting sample within the first step
+                Float RayPixels = V::Add(V::Mul(V::Set1(Rand.Z), StepSizePixels), One);
+
+                for (int StepIndex = 0; StepIndex < NumSteps; ++StepIndex)
+                {
+                    const Float SnappedX = V::Round(V::Mul(RayPixels, DirectionX));
+                    const Float SnappedY = V::Round(V::Mul(RayPixels, DirectionY));
+                    const Float SnappedU = V::Add(V::Mul(SnappedX, InvQuarterResX), U);
+                    const Float SnappedV = V::Add(V::Mul(SnappedY, InvQuarterResY), Vc);
+                    const Int SampleX = V::AddI(PixelX, V::ToInt(SnappedX));
+                    const Int SampleY = V::AddI(PixelY, V::ToInt(SnappedY));
+
+                    RayPixels = V::Add(RayPixels, StepSizePixels);
+
+                    const Int Offsets = ClampedTexelOffsets<V>(DepthTexture, SampleX, SampleY);
+
+                    Float SampleDepth0 = GatherTexels<V>(DepthTexture, Offsets, 0);
+                    Float SampleDepth1 = DualLayer ? GatherTexels<V>(DepthTexture, Offsets, 1) : Zero;
+
+                    if (BorderMode)
+                    {
+                        const Mask Inside = InBounds<V>(DepthTexture, SampleX, SampleY);
+                        SampleDepth0 = V::Select(Inside, SampleDepth0, Border);
+                        SampleDepth1 = V::Select(Inside, SampleDepth1, Zero);
+                    }
+
+                    const Float3<V> S0 = UVToView<V>(CB, SnappedU, SnappedV, SampleDepth0);
+                    Float AO = ComputeAO<V>(CB, ViewPosition, ViewNormal, S0, NegInvR2);
+
+                    if (DualLayer)
+                    {
+                        const Float3<V> S1 = UVToView<V>(CB, SnappedU, SnappedV, SampleDepth1);
+                        AO = V::MaxF(AO, ComputeAO<V>(CB, ViewPosition, ViewNormal, S1, NegInvR2));
+                    }
+
+                    if (StepIndex == 0)
+                    {
+                        SmallScaleAO = V::Add(SmallScaleAO, AO);
+                    }
+                    else
+                    {
+                        LargeScaleAO = V::Add(LargeScaleAO, AO);
+                    }
+                }
+            }
+
+            Float AO = V::Add(V::Mul(SmallScaleAO, V::Set1(CB.fSmallScaleAOAmount)), V::Mul(LargeScaleAO, V::Set1(CB.fLargeScaleAOAmount)));
+
+            AO = V::Div(AO, V::Set1(float(NUM_DIRECTIONS * NumSteps)));
+
+            if (CB.fViewDepthThresholdSharpness != -1.f)
+            {
+                AO = V::Mul(AO, Saturate<V>(V::Mul(V::Add(V::Mul(ViewDepth, V::Set1(CB.fViewDepthThresholdNegInv)), One), V::Set1(CB.fViewDepthThresholdSharpness))));
+            }
+
+            AO = Saturate<V>(V::Sub(One, V::Mul(AO, V::Set1(2.f))));
+
+            V::MaskStore(pOut, Valid, V::Select(EarlyExit, One, AO));
+        }
+    }
+}
+
+template<class V, ShaderPermutations::FETCH_GBUFFER_NORMAL FETCH_GBUFFER_NORMAL, ShaderPermutations::DEPTH_LAYER_COUNT DEPTH_LAYER_COUNT, ShaderPermutations::NUM_STEPS NUM_STEPS>
+void CoarseAO_PS(const CoarseAOArgs& Args, UINT RowBegin, UINT RowEnd)
+{
+    if (Args.HalfViewDepths)
+    {
+        CoarseAO<V, FETCH_GBUFFER_NORMAL, DEPTH_LAYER_COUNT, NUM_STEPS>(Args, Args.QuarterResHalfViewDepthTexture, RowBegin, RowEnd);
+    }
+    else
+    {
+        CoarseAO<V, FETCH_GBUFFER_NORMAL, DEPTH_LAYER_COUNT, NUM_STEPS>(Args, Args.QuarterResViewDepthTexture, RowBegin, RowEnd);
+    }
+}
+
+//--------------------------------------------------------------------------------
+// ReinterleaveAO_PS.hlsl
+//--------------------------------------------------------------------------------
+template<class V, ShaderPermutations::ENABLE_BLUR ENABLE_BLUR, ShaderPermutations::DEPTH_LAYER_COUNT DEPTH_LAYER_COUNT>
+void ReinterleaveAO_PS(const ReinterleaveAOArgs& Args, UINT RowBegin, UINT RowEnd)
+{
+    typedef typename V::Float Float;
+    typedef typename V::Int Int;
+
+    const SSAO::GlobalConstantBuffer& CB = *Args.pGlobalCB;
+    const bool EnableBlur = (ENABLE_BLUR == ShaderPermutations::ENABLE_BLUR_1);
+    const bool DualLayer = (DEPTH_LAYER_COUNT == ShaderPermutations::DEPTH_LAYER_COUNT_2);
+    const FLOAT* pSlices = Args.AOTexture[0].pData;
+    const UINT PixelStride = Args.AOTexture[0].PixelStride;
+    const ShaderResourceView& DepthSlices = Args.QuarterResViewDepthTexture[0];
+    const HalfShaderResourceView& HalfDepthSlices = Args.QuarterResHalfViewDepthTexture[0];
+    const UINT DepthPixelStride = Args.HalfViewDepths ? HalfDepthSlices.PixelStride : DepthSlices.PixelStride;
+    const Int MaxX = V::Set1I(int(Args.Width) - 1);
+
+    for (UINT Y = RowBegin; Y < RowEnd; ++Y)
+    {
+        // The slices are sub-ranges of the same texture array, and lane L reads slice (Y&3)*4 + (L&3)
+        int SliceOffsets[V::Width];
+        int DepthSliceOffsets[V::Width];
+        for (UINT Lane = 0; Lane < V::Width; ++Lane)
+        {
+            const UINT SliceId = (Y & 3) * 4 + (Lane & 3);
+            SliceOffsets[Lane] = int(Args.AOTexture[SliceId].Load(0, Y >> 2) - pSlices);
+            DepthSliceOffsets[Lane] = !Args.DeinterleavedViewDepths ? 0 :
+                                      Args.HalfViewDepths ? int(Args.QuarterResHalfViewDepthTexture[SliceId].Load(0, Y >> 2) - HalfDepthSlices.pData) :
+                                                            int(Args.QuarterResViewDepthTexture[SliceId].Load(0, Y >> 2) - DepthSlices.pData);
+        }
+        const Int RowOffsets = V::LoadI(SliceOffsets);
+        const Int DepthRowOffsets = V::LoadI(DepthSliceOffsets);
+
+        for (UINT X0 = 0; X0 < Args.Width; X0 += V::Width)
+        {
+            const UINT NumLanes = Min(Args.Width - X0, V::Width);
+            const Int X = V::MinI(V::AddI(V::Set1I(int(X0)), V::IotaI()), MaxX);
+            const Int Offsets = V::AddI(RowOffsets, V::MulI(V::template ShiftRightI<2>(X), V::Set1I(int(PixelStride))));
+            const Float AO = V::Gather(pSlices, Offsets);
+
+            if (EnableBlur)
+            {
+                Float ViewDepth;
+                if (Args.DeinterleavedViewDepths)
+                {
+                    // The first channel of the depth slices is already the min of both layers
+                    const Int DepthOffsets = V::AddI(DepthRowOffsets, V::MulI(V::template ShiftRightI<2>(X), V::Set1I(int(DepthPixelStride))));
+                    ViewDepth = Args.HalfViewDepths ? GatherTexels<V>(HalfDepthSlices, DepthOffsets, 0) : GatherTexels<V>(DepthSlices, DepthOffsets, 0);
+                }
+                else
+                {
+                    ViewDepth = SampleRow<V>(Args.ViewDepthTexture[0], int(X0), int(Y), GFSDK_SSAO_CLAMP_TO_EDGE);
+                    if (DualLayer)
+                    {
+                        ViewDepth = V::MinF(ViewDepth, SampleRow<V>(Args.ViewDepthTexture[1], int(X0), int(Y), GFSDK_SSAO_CLAMP_TO_EDGE));
+                    }
+                }
+
+                const Float AOZ[2] = { AO, ViewDepth };
+                StoreChannels<V>(Args.AOZTexture, X0, Y, NumLanes, AOZ, 2);
+            }
+            else
+            {
+                OutputMerger<V>(Args.Output, X0, Y, NumLanes, PowSaturated<V>(Saturate<V>(AO), CB.fPowExponent));
+            }
+        }
+    }
+}
+
+//--------------------------------------------------------------------------------
+// Blur_Common.hlsl
+// Vector version of Scalar::BlurKernel, where the lanes are consecutive pixels of a row
+//--------------------------------------------------------------------------------
+template<class V, ShaderPermutations::KERNEL_RADIUS KERNEL_RADIUS, ShaderPermutations::ENABLE_SHARPNESS_PROFILE ENABLE_SHARPNESS_PROFILE>
+struct BlurKernel
+{
+    typedef typename V::Float Float;
+    typedef typename V::Int Int;
+
+    static const int KernelRadius = (KERNEL_RADIUS == ShaderPermutations::KERNEL_RADIUS_2) ? 2 : 4;
+
+    // All the lanes are in the same row
+    struct CenterPixelData
+    {
+        Int X;
+        int Y;
+        Float Depth;
+        Float Scale;
+        Float Bias;
+    };
+
+    void PointSampleAODepth(Int X, int Y, Float& AO, Float& Z) const
+    {
+        Y = Clamp(Y, 0, int(Height) - 1);
+        const UINT Row = NumRingRows ? UINT(Y) % NumRingRows : UINT(Y);
+
+        X = V::MinI(V::MaxI(X, V::Set1I(0)), V::Set1I(int(AOZTexture.Width) - 1));
+        const Int Offsets = V::AddI(V::Set1I(int(Row * AOZTexture.RowPitch)), V::MulI(X, V::Set1I(int(AOZTexture.PixelStride))));
+        AO = V::Gather(AOZTexture.pData, Offsets);
+        Z = V::Gather(AOZTexture.pData + 1, Offsets);
+    }
+
+    void PointSampleAODepth(const CenterPixelData& Center, int R, int DX, int DY, Float& AO, Float& Z) const
+    {
+        PointSampleAODepth(V::AddI(Center.X, V::Set1I(R * DX)), Center.Y + R * DY, AO, Z);
+    }
+
+    Float CrossBilateralWeight(float R, Float SampleDepth, Float DepthSlope, const CenterPixelData& Center) const
+    {
+        SampleDepth = V::Sub(SampleDepth, V::Mul(DepthSlope, V::Set1(R)));
+
+        const Float DeltaZ = V::Add(V::Mul(SampleDepth, Center.Scale), Center.Bias);
+
+        return Exp2<V>(V::Sub(V::Set1(-R*R*BlurFalloff), V::Mul(DeltaZ, DeltaZ)));
+    }
+
+    void ProcessSample(Float AO, Float Z, float R, Float DepthSlope, const CenterPixelData& Center, Float& TotalAO, Float& TotalW) const
+    {
+        const Float W = CrossBilateralWeight(R, Z, DepthSlope, Center);
+        TotalAO = V::Add(TotalAO, V::Mul(W, AO));
+        TotalW = V::Add(TotalW, W);
+    }
+
+    void ProcessRadius(int R0, int DX, int DY, Float DepthSlope, const CenterPixelData& Center, Float& TotalAO, Float& TotalW) const
+    {
+        int R = R0;
+        Float AO, Z;
+
+        if (KernelRadius >= 4)
+        {
+            // USE_ADAPTIVE_SAMPLING
+            for (; R <= KernelRadius/2; R += 1)
+            {
+                PointSampleAODepth(Center, R, DX, DY, AO, Z);
+                ProcessSample(AO, Z, float(R), DepthSlope, Center, TotalAO, TotalW);
+            }
+            for (; R <= KernelRadius; R += 2)
+            {
+                Float AO1, Z1;
+                PointSampleAODepth(Center, R, DX, DY, AO, Z);
+                PointSampleAODepth(Center, R + 1, DX, DY, AO1, Z1);
+                AO = V::Mul(V::Set1(0.5f), V::Add(AO, AO1));
+                Z = V::Mul(V::Set1(0.5f), V::Add(Z, Z1));
+                ProcessSample(AO, Z, float(R), DepthSlope, Center, TotalAO, TotalW);
+            }
+        }
+        else
+        {
+            for (; R <= KernelRadius; R += 1)
+            {
+                PointSampleAODepth(Center, R, DX, DY, AO, Z);
+                ProcessSample(AO, Z, float(R), DepthSlope, Center, TotalAO, TotalW);
+            }
+        }
+    }
+
+    void ProcessRadius1(int DX, int DY, const CenterPixelData& Center, Float& TotalAO, Float& TotalW) const
+    {
+        Float AO, Z;
+        PointSampleAODepth(Center, 1, DX, DY, AO, Z);
+        const Float DepthSlope = V::Sub(Z, Center.Depth);
+
+        ProcessSample(AO, Z, 1.f, DepthSlope, Center, TotalAO, TotalW);
+        ProcessRadius(2, DX, DY, DepthSlope, Center, TotalAO, TotalW);
+    }
+
+    Float GetSharpness(Float ViewDepth) const
+    {
+        if (ENABLE_SHARPNESS_PROFILE == ShaderPermutations::ENABLE_SHARPNESS_PROFILE_1)
+        {
+            const Float Range = V::Set1(pGlobalCB->fBlurViewDepth1 - pGlobalCB->fBlurViewDepth0);
+            const Float LerpFactor = Saturate<V>(V::Div(V::Sub(ViewDepth, V::Set1(pGlobalCB->fBlurViewDepth0)), Range));
+            return V::Add(V::Set1(pGlobalCB->fBlurSharpness0), V::Mul(V::Set1(pGlobalCB->fBlurSharpness1 - pGlobalCB->fBlurSharpness0), LerpFactor));
+        }
+        return V::Set1(pGlobalCB->fBlurSharpness1);
+    }
+
+    Float ComputeBlur(int X0, int Y, int DX, int DY, Float& CenterDepth) const
+    {
+        CenterPixelData Center;
+        Center.X = V::AddI(V::Set1I(X0), V::IotaI());
+        Center.Y = Y;
+
+        Float CenterAO;
+        PointSampleAODepth(Center.X, Center.Y, CenterAO, CenterDepth);
+
+        const Float Sharpness = GetSharpness(CenterDepth);
+        Center.Depth = CenterDepth;
+        Center.Scale = Sharpness;
+        Center.Bias = V::Sub(V::Set1(0.f), V::Mul(CenterDepth, Sharpness));
+
+        Float TotalAO = CenterAO;
+        Float TotalW = V::Set1(1.f);
+
+        ProcessRadius1(DX, DY, Center, TotalAO, TotalW);
+        ProcessRadius1(-DX, -DY, Center, TotalAO, TotalW);
+
+        return V::Div(TotalAO, TotalW);
+    }
+
+    // Samples the full AOZ texture
+    BlurKernel(const BlurArgs& Args)
+        : pGlobalCB(Args.pGlobalCB)
+        , AOZTexture(Args.AOZTexture)
+        , Height(Args.AOZTexture.Height)
+        , NumRingRows(0)
+    {
+        const float BlurSigma = (float(KernelRadius) + 1.f) * 0.5f;
+        BlurFalloff = 1.f / (2.f * BlurSigma * BlurSigma);
+    }
+
+    // Samples a ring of rows of a texture of the given Height, where row Y is stored in row Y % RingBuffer.Height
+    BlurKernel(const BlurArgs& Args, const ShaderResourceView& RingBuffer, UINT TextureHeight)
+        : pGlobalCB(Args.pGlobalCB)
+        , AOZTexture(RingBuffer)
+        , Height(TextureHeight)
+        , NumRingRows(RingBuffer.Height)
+    {
+        const float BlurSigma = (float(KernelRadius) + 1.f) * 0.5f;
+        BlurFalloff = 1.f / (2.f * BlurSigma * BlurSigma);
+    }
+
+    const SSAO::GlobalConstantBuffer* pGlobalCB;
+    const ShaderResourceView& AOZTexture;
+    UINT Height;
+    UINT NumRingRows;
+    float BlurFalloff;
+};
+
+//--------------------------------------------------------------------------------
+// BlurX_PS.hlsl followed by BlurY_PS.hlsl, see Scalar::Blur_PS
+//--------------------------------------------------------------------------------
+template<class V, ShaderPermutations::KERNEL_RADIUS KERNEL_RADIUS, ShaderPermutations::ENABLE_SHARPNESS_PROFILE ENABLE_SHARPNESS_PROFILE>
+void Blur_PS(const BlurArgs& Args, UINT RowBegin, UINT RowEnd)
+{
+    typedef typename V::Float Float;
+    typedef BlurKernel<V, KERNEL_RADIUS, ENABLE_SHARPNESS_PROFILE> Kernel;
+
+    const Kernel KernelX(Args);
+    const UINT Width = Args.AOZTexture.Width;
+    const UINT Height = Args.AOZTexture.Height;
+
+    FLOAT RingData[BLUR_MAX_RING_ROWS * BLUR_STRIP_WIDTH * 2];
+    RenderTargetView Ring;
+    Ring.pData = RingData;
+    Ring.Height = 2 * Kernel::KernelRadius + 1;
+    Ring.RowPitch = BLUR_STRIP_WIDTH * 2;
+    Ring.PixelStride = 2;
+
+    for (UINT StripX = 0; StripX < Width; StripX += BLUR_STRIP_WIDTH)
+    {
+        Ring.Width = Min(Width - StripX, BLUR_STRIP_WIDTH);
+        const ShaderResourceView RingSRV = Ring;
+        const Kernel KernelY(Args, RingSRV, Height);
+
+        UINT NextRowX = UINT(Max(int(RowBegin) - Kernel::KernelRadius, 0));
+
+        for (UINT Y = RowBegin; Y < RowEnd; ++Y)
+        {
+            const UINT LastRowX = Min(Y + UINT(Kernel::KernelRadius), Height - 1);
+            for (; NextRowX <= LastRowX; ++NextRowX)
+            {
+                for (UINT X0 = 0; X0 < Ring.Width; X0 += V::Width)
+                {
+                    Float AOZ[2];
+                    AOZ[0] = KernelX.ComputeBlur(int(StripX + X0), int(NextRowX), 1, 0, AOZ[1]);
+
+                    StoreChannels<V>(Ring, X0, NextRowX % Ring.Height, Min(Ring.Width - X0, V::Width), AOZ, 2);
+                }
+            }
+
+            for (UINT X0 = 0; X0 < Ring.Width; X0 += V::Width)
+            {
+                Float CenterDepth;
+                const Float AO = KernelY.ComputeBlur(int(X0), int(Y), 0, 1, CenterDepth);
+
+                OutputMerger<V>(Args.Output, StripX + X0, Y, Min(Ring.Width - X0, V::Width), PowSaturated<V>(Saturate<V>(AO), Args.pGlobalCB->fPowExponent));
+            }
+        }
+    }
+}
+
+//--------------------------------------------------------------------------------
+// Kernel table of one instruction set, see Scalar::GetKernelTable
+//--------------------------------------------------------------------------------
+template<class V>
+constexpr KernelTable MakeKernelTable()
+{
+    using namespace ShaderPermutations;
+
+    return KernelTable
+    {
+        { { &LinearizeDepth_PS<V, DEPTH_LAYER_COUNT_1>, &LinearizeDepth_PS<V, DEPTH_LAYER_COUNT_2> } },
+        { { &DeinterleaveDepth_PS<V, DEPTH_LAYER_COUNT_1>, &DeinterleaveDepth_PS<V, DEPTH_LAYER_COUNT_2> } },
+        { { &LinearizeDeinterleaveDepth_PS<V, DEPTH_LAYER_COUNT_1>, &LinearizeDeinterleaveDepth_PS<V, DEPTH_LAYER_COUNT_2> } },
+        { &ReconstructNormal_PS<V> },
+        { {
+            { { &CoarseAO_PS<V, FETCH_GBUFFER_NORMAL_0, DEPTH_LAYER_COUNT_1, NUM_STEPS_4>, &CoarseAO_PS<V, FETCH_GBUFFER_NORMAL_0, DEPTH_LAYER_COUNT_1, NUM_STEPS_8> },
+              { &CoarseAO_PS<V, FETCH_GBUFFER_NORMAL_0, DEPTH_LAYER_COUNT_2, NUM_STEPS_4>, &CoarseAO_PS<V, FETCH_GBUFFER_NORMAL_0, DEPTH_LAYER_COUNT_2, NUM_STEPS_8> } },
+            { { &CoarseAO_PS<V, FETCH_GBUFFER_NORMAL_1, DEPTH_LAYER_COUNT_1, NUM_STEPS_4>, &CoarseAO_PS<V, FETCH_GBUFFER_NORMAL_1, DEPTH_LAYER_COUNT_1, NUM_STEPS_8> },
+              { &CoarseAO_PS<V, FETCH_GBUFFER_NORMAL_1, DEPTH_LAYER_COUNT_2, NUM_STEPS_4>, &CoarseAO_PS<V, FETCH_GBUFFER_NORMAL_1, DEPTH_LAYER_COUNT_2, NUM_STEPS_8> } },
+            { { &CoarseAO_PS<V, FETCH_GBUFFER_NORMAL_2, DEPTH_LAYER_COUNT_1, NUM_STEPS_4>, &CoarseAO_PS<V, FETCH_GBUFFER_NORMAL_2, DEPTH_LAYER_COUNT_1, NUM_STEPS_8> },
+              { &CoarseAO_PS<V, FETCH_GBUFFER_NORMAL_2, DEPTH_LAYER_COUNT_2, NUM_STEPS_4>, &CoarseAO_PS<V, FETCH_GBUFFER_NORMAL_2, DEPTH_LAYER_COUNT_2, NUM_STEPS_8> } },
+        } },
+        { {
+            { &ReinterleaveAO_PS<V, ENABLE_BLUR_0, DEPTH_LAYER_COUNT_1>, &ReinterleaveAO_PS<V, ENABLE_BLUR_0, DEPTH_LAYER_COUNT_2> },
+            { &ReinterleaveAO_PS<V, ENABLE_BLUR_1, DEPTH_LAYER_COUNT_1>, &ReinterleaveAO_PS<V, ENABLE_BLUR_1, DEPTH_LAYER_COUNT_2> },
+        } },
+        { {
+            { &Blur_PS<V, KERNEL_RADIUS_2, ENABLE_SHARPNESS_PROFILE_0>, &Blur_PS<V, KERNEL_RADIUS_2, ENABLE_SHARPNESS_PROFILE_1> },
+            { &Blur_PS<V, KERNEL_RADIUS_4, ENABLE_SHARPNESS_PROFILE_0>, &Blur_PS<V, KERNEL_RADIUS_4, ENABLE_SHARPNESS_PROFILE_1> },
+        } },
+    };
+}
+
+//--------------------------------------------------------------------------------
+// Defines the kernel table declared in Shaders_CPU.h for one instruction set, and the storage
+// of ISA::Width, which Min() may bind to a reference
+//--------------------------------------------------------------------------------
+#define DEFINE_CPU_SIMD_KERNELS(ISA) \
+    const UINT GFSDK::SSAO::CPU::SIMD::ISA::Width; \
+    \
+    const GFSDK::SSAO::CPU::KernelTable& GFSDK::SSAO::CPU::ISA::GetKernelTable() \
+    { \
+        static constexpr KernelTable Table = SIMD::MakeKernelTable<SIMD::ISA>(); \
+        return Table; \
+    }
+
+} // namespace SIMD
+} // namespace CPU
+} // namespace SSAO
+} // namespace GFSDK
+
+#endif // SUPPORT_CPU
@@ -29,6 +29,7 @@
 
 #pragma once
 #include "Common.h"
+#include "TaskBatch.h"
 
 namespace GFSDK
 {
@@ -37,6 +38,80 @@ namespace SSAO
 namespace D3D11
 {
 
+//--------------------------------------------------------------------------------
+// The shaders are created by their Create call, or by their first CreateOnce call if CreateOnDemand is set.
+// If pCreationList is set, their creation is added to the list, to run all of them concurrently.
+//--------------------------------------------------------------------------------
+struct DevicePointer
+{
+    DevicePointer(ID3D11Device* pDeviceIn, bool CreateOnDemandIn = false, CreateOnceList* pCreationListIn = NULL)
+        : pDevice(pDeviceIn)
+        , CreateOnDemand(CreateOnDemandIn)
+        , pCreationList(pCreationListIn)
+    {
+    }
+
+    DevicePointer()
+        : pDevice(NULL)
+        , CreateOnDemand(false)
+        , pCreationList(NULL)
+    {
+    }
+
+    operator ID3D11Device*() const
+    {
+        return pDevice;
+    }
+
+    template<typename ShaderType>
+    void Create(ShaderType& Shader) const
+    {
+        if (CreateOnDemand)
+        {
+            return;
+        }
+
+        if (pCreationList)
+        {
+            pCreationList->Add(Shader);
+        }
+        else
+        {
+            Shader.CreateOnce();
+        }
+    }
+
+private:
+    ID3D11Device* pDevice;
+    bool CreateOnDemand;
+    CreateOnceList* pCreationList;
+};
+
+//--------------------------------------------------------------------------------
+// The bytecode of a shader that may not be created yet.
+// The bytecode arrays are static, so only pointers to them are kept.
+//--------------------------------------------------------------------------------
+struct ShaderBytecode
+{
+    ShaderBytecode()
+        : pDevice(NULL)
+        , pShaderBytecode(NULL)
+        , BytecodeLength(0)
+    {
+    }
+
+    ShaderBytecode(ID3D11Device* pDeviceIn, const void *pShaderBytecodeIn, SIZE_T BytecodeLengthIn)
+        : pDevice(pDeviceIn)
+        , pShaderBytecode(pShaderBytecodeIn)
+        , BytecodeLength(BytecodeLengthIn)
+    {
+    }
+
+    ID3D11Device* pDevice;
+    const void *pShaderBytecode;
+    SIZE_T BytecodeLength;
+};
+
 //--------------------------------------------------------------------------------
 struct VertexShader
 {
@@ -44,23 +119,41 @@ struct VertexShader
     {
     }
 
-    void Create(ID3D11Device* pD3DDevice, const void *pShaderBytecode, SIZE_T BytecodeLength)
+    void Create(DevicePointer Device, const void *pShaderBytecode, SIZE_T BytecodeLength)
     {
-        THROW_IF_FAILED(pD3DDevice->CreateVertexShader(pShaderBytecode, BytecodeLength, NULL, &VS));
+        m_Bytecode = ShaderBytecode(Device, pShaderBytecode, BytecodeLength);
+        Device.Create(*this);
     }
 
-    void Release(ID3D11Device*)
+    bool IsCreated() const
+    {
+        return VS != NULL;
+    }
+
+    void CreateOnce()
+    {
+        if (!VS)
+        {
+            ASSERT(m_Bytecode.pDevice);
+            THROW_IF_FAILED(m_Bytecode.pDevice->CreateVertexShader(m_Bytecode.pShaderBytecode, m_Bytecode.BytecodeLength, NULL, &VS));
+        }
+    }
+
+    void Release(DevicePointer)
     {
         SAFE_RELEASE(VS);
+        m_Bytecode = ShaderBytecode();
     }
 
     operator ID3D11VertexShader*() const
     {
+        ASSERT(VS);
         return VS;
     }
 
 private:
     ID3D11VertexShader* VS;
+    ShaderBytecode m_Bytecode;
 };
 
 //--------------------------------------------------------------------------------
@@ -70,23 +163,41 @@ struct GeometryShader
     {
     }
 
-    void Create(ID3D11Device* pD3DDevice, const void *pShaderBytecode, SIZE_T BytecodeLength)
+    void Create(DevicePointer Device, const void *pShaderBytecode, SIZE_T BytecodeLength)
+    {
+        m_Bytecode = ShaderBytecode(Device, pShaderBytecode, BytecodeLength);
+        Device.Create(*this);
+    }
+
+    bool IsCreated() const
     {
-        THROW_IF_FAILED(pD3DDevice->CreateGeometryShader(pShaderBytecode, BytecodeLength, NULL, &GS));
+        return GS != NULL;
     }
 
-    void Release(ID3D11Device*)
+    void CreateOnce()
+    {
+        if (!GS)
+        {
+            ASSERT(m_Bytecode.pDevice);
+            THROW_IF_FAILED(m_Bytecode.pDevice->CreateGeometryShader(m_Bytecode.pShaderBytecode, m_Bytecode.BytecodeLength, NULL, &GS));
+        }
+    }
+
+    void Release(DevicePointer)
     {
         SAFE_RELEASE(GS);
+        m_Bytecode = ShaderBytecode();
     }
 
     operator ID3D11GeometryShader*() const
     {
+        ASSERT(GS);
         return GS;
     }
 
 private:
     ID3D11GeometryShader* GS;
+    ShaderBytecode m_Bytecode;
 };
 
 //--------------------------------------------------------------------------------
@@ -96,43 +207,41 @@ struct PixelShader
     {
     }
 
-    void Create(ID3D11Device* pD3DDevice, const void *pShaderBytecode, SIZE_T BytecodeLength)
+    void Create(DevicePointer Device, const void *pShaderBytecode, SIZE_T BytecodeLength)
     {
-        THROW_IF_FAILED(pD3DDevice->CreatePixelShader(pShaderBytecode, BytecodeLength, NULL, &PS));
+        m_Bytecode = ShaderBytecode(Device, pShaderBytecode, BytecodeLength);
+        Device.Create(*this);
     }
 
-    void Release(ID3D11Device*)
+    bool IsCreated() const
     {
-        SAFE_RELEASE(PS);
+        return PS != NULL;
     }
 
-    operator ID3D11PixelShader*() const
+    void CreateOnce()
     {
-        return PS;
+        if (!PS)
+        {
+            ASSERT(m_Bytecode.pDevice);
+            THROW_IF_FAILED(m_Bytecode.pDevice->CreatePixelShader(m_Bytecode.pShaderBytecode, m_Bytecode.BytecodeLength, NULL, &PS));
+        }
     }
 
-private:
-    ID3D11PixelShader* PS;
-};
-
-//--------------------------------------------------------------------------------
-struct DevicePointer
-{
-    DevicePointer(ID3D11Device* pDeviceIn) : pDevice(pDeviceIn)
-    {
-    }
-
-    DevicePointer() : pDevice(NULL)
+    void Release(DevicePointer)
     {
+        SAFE_RELEASE(PS);
+        m_Bytecode = ShaderBytecode();
     }
 
-    operator ID3D11Device*() const
+    operator ID3D11PixelShader*() const
     {
-        return pDevice;
+        ASSERT(PS);
+        return PS;
     }
 
 private:
-    ID3D11Device* pDevice;
+    ID3D11PixelShader* PS;
+    ShaderBytecode m_Bytecode;
 };
 
 //--------------------------------------------------------------------------------
@@ -151,19 +260,19 @@ private:
 //--------------------------------------------------------------------------------
 struct Shaders
 {
-    void Create(ID3D11Device* pDevice)
+    void Create(const DevicePointer& Device)
     {
-        FullScreenTriangle_VS.Create(DevicePointer(pDevice));
-        CopyDepth_PS.Create(DevicePointer(pDevice));
-        LinearizeDepth_PS.Create(DevicePointer(pDevice));
-        DeinterleaveDepth_PS.Create(DevicePointer(pDevice));
-        DebugNormals_PS.Create(DevicePointer(pDevice));
-        ReconstructNormal_PS.Create(DevicePointer(pDevice));
-        ReinterleaveAO_PS.Create(DevicePointer(pDevice));
-        BlurX_PS.Create(DevicePointer(pDevice));
-        BlurY_PS.Create(DevicePointer(pDevice));
-        CoarseAO_PS.Create(DevicePointer(pDevice));
-        CoarseAO_GS.Create(DevicePointer(pDevice));
+        FullScreenTriangle_VS.Create(Device);
+        CopyDepth_PS.Create(Device);
+        LinearizeDepth_PS.Create(Device);
+        DeinterleaveDepth_PS.Create(Device);
+        DebugNormals_PS.Create(Device);
+        ReconstructNormal_PS.Create(Device);
+        ReinterleaveAO_PS.Create(Device);
+        BlurX_PS.Create(Device);
+        BlurY_PS.Create(Device);
+        CoarseAO_PS.Create(Device);
+        CoarseAO_GS.Create(Device);
     }
 
     void Release()
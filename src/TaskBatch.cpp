@@ -0,0 +1,175 @@
+// This code contains NVIDIA Confidential Information and is disclosed to you
+// under a form of NVIDIA software license agreement provided separately to you.
+//
+// Notice
+// NVIDIA Corporation and its licensors retain all intellectual property and
+// proprietary rights in and to this software and related documentation and
+// any modifications thereto. Any use, reproduction, disclosure, or
+// distribution of this software and related documentation without an express
+// license agreement from NVIDIA Corporation is strictly prohibited.
+//
+// ALL NVIDIA DESIGN SPECIFICATIONS, CODE ARE PROVIDED "AS IS.". NVIDIA MAKES
+// NO WARRANTIES, EXPRESSED, IMPLIED, STATUTORY, OR OTHERWISE WITH RESPECT TO
+// THE MATERIALS, AND EXPRESSLY DISCLAIMS ALL IMPLIED WARRANTIES OF NONINFRINGEMENT,
+// MERCHANTABILITY, AND FITNESS FOR A PARTICULAR PURPOSE.
+//
+// Information and code furnished is believed to be accurate and reliable.
+// However, NVIDIA Corporation assumes no responsibility for the consequences of use of such
+// information or for any infringement of patents or other rights of third parties that may
+// result from its use. No license is granted by implication or otherwise under any patent
+// or patent rights of NVIDIA Corporation. Details are subject to change without notice.
+// This code supersedes and replaces all information previously supplied.
+// NVIDIA Corporation products are not authorized for use as critical
+// components in life support devices or systems without express written approval of
+// NVIDIA Corporation.
+//
+// Copyright (c) 2008-2021 NVIDIA Corporation. All rights reserved.
+
+#include "TaskBatch.h"
+
+#include <thread>
+
+const UINT GFSDK::SSAO::TaskBatch::MAX_NUM_THREADS;
+
+//--------------------------------------------------------------------------------
+GFSDK::SSAO::TaskBatch::TaskBatch(const GFSDK_SSAO_TaskScheduler& Scheduler, UINT NumThreads)
+    : m_Scheduler(Scheduler)
+    , m_NumThreads(NumThreads)
+    , m_NumLogicalProcessors(Max(std::thread::hardware_concurrency(), 1u))
+    , m_pTaskFunc(NULL)
+    , m_pUserData(NULL)
+    , m_NumTasks(0)
+    , m_NextTaskIndex(0)
+    , m_TaskFailed(false)
+    , m_NumRunningWorkers(0)
+{
+    if (m_NumThreads == 0)
+    {
+        m_NumThreads = m_NumLogicalProcessors;
+    }
+    m_NumThreads = Min(m_NumThreads, MAX_NUM_THREADS);
+}
+
+//--------------------------------------------------------------------------------
+void GFSDK::SSAO::TaskBatch::Run(TaskFunc pTaskFunc, void* pUserData, UINT NumTasks)
+{
+    m_pTaskFunc = pTaskFunc;
+    m_pUserData = pUserData;
+    m_NumTasks = NumTasks;
+    m_NextTaskIndex = 0;
+    m_TaskFailed = false;
+
+    if (m_Scheduler.submit_)
+    {
+        RunOnScheduler();
+    }
+    else
+    {
+        RunOnThreads();
+    }
+
+    THROW_IF(m_TaskFailed);
+}
+
+//--------------------------------------------------------------------------------
+void GFSDK::SSAO::TaskBatch::RunTasks()
+{
+    for (;;)
+    {
+        const UINT TaskIndex = m_NextTaskIndex++;
+        if (TaskIndex >= m_NumTasks)
+        {
+            break;
+        }
+
+#if ENABLE_EXCEPTIONS
+        try
+        {
+            m_pTaskFunc(m_pUserData, TaskIndex);
+        }
+        catch (...)
+        {
+            m_TaskFailed = true;
+        }
+#else
+        m_pTaskFunc(m_pUserData, TaskIndex);
+#endif
+    }
+}
+
+//--------------------------------------------------------------------------------
+void GFSDK::SSAO::TaskBatch::WorkerMain(void* pBatch)
+{
+    TaskBatch& Batch = *static_cast<TaskBatch*>(pBatch);
+
+    Batch.RunTasks();
+
+    // The batch may be destroyed as soon as the lock is released
+    std::lock_guard<std::mutex> Lock(Batch.m_Lock);
+    if (--Batch.m_NumRunningWorkers == 0)
+    {
+        Batch.m_WorkerCompleted.notify_one();
+    }
+}
+
+//--------------------------------------------------------------------------------
+void GFSDK::SSAO::TaskBatch::RunOnScheduler()
+{
+    // Each submitted task runs batch tasks until there are none left, so submitting more tasks
+    // than the scheduler can run concurrently only adds tasks that find no work left.
+    // The scheduler cannot run more tasks at once than there are logical processors.
+    const UINT NumWorkers = Min(m_NumLogicalProcessors, Max(m_NumTasks, 1u)) - 1;
+
+    {
+        std::lock_guard<std::mutex> Lock(m_Lock);
+        m_NumRunningWorkers = NumWorkers;
+    }
+
+    for (UINT WorkerIndex = 0; WorkerIndex < NumWorkers; ++WorkerIndex)
+    {
+        m_Scheduler.submit_(WorkerMain, this, m_Scheduler.pUserData);
+    }
+
+    RunTasks();
+
+    std::unique_lock<std::mutex> Lock(m_Lock);
+    m_WorkerCompleted.wait(Lock, [this] { return m_NumRunningWorkers == 0; });
+}
+
+//--------------------------------------------------------------------------------
+void GFSDK::SSAO::TaskBatch::RunOnThreads()
+{
+    const UINT NumWorkers = Min(m_NumThreads, Max(m_NumTasks, 1u)) - 1;
+
+    {
+        std::lock_guard<std::mutex> Lock(m_Lock);
+        m_NumRunningWorkers = NumWorkers;
+    }
+
+    std::thread Workers[MAX_NUM_THREADS];
+    UINT NumStartedWorkers = 0;
+
+    for (; NumStartedWorkers < NumWorkers; ++NumStartedWorkers)
+    {
+#if ENABLE_EXCEPTIONS
+        // If a thread cannot be created, the tasks are run by fewer threads
+        try
+        {
+            Workers[NumStartedWorkers] = std::thread(WorkerMain, this);
+        }
+        catch (...)
+        {
+            break;
+        }
+#else
+        Workers[NumStartedWorkers] = std::thread(WorkerMain, this);
+#endif
+    }
+
+    RunTasks();
+
+    for (UINT WorkerIndex = 0; WorkerIndex < NumStartedWorkers; ++WorkerIndex)
+    {
+        Workers[WorkerIndex].join();
+    }
+}
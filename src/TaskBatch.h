@@ -0,0 +1,162 @@
+// This code contains NVIDIA Confidential Information and is disclosed to you
+// under a form of NVIDIA software license agreement provided separately to you.
+//
+// Notice
+// NVIDIA Corporation and its licensors retain all intellectual property and
+// proprietary rights in and to this software and related documentation and
+// any modifications thereto. Any use, reproduction, disclosure, or
+// distribution of this software and related documentation without an express
+// license agreement from NVIDIA Corporation is strictly prohibited.
+//
+// ALL NVIDIA DESIGN SPECIFICATIONS, CODE ARE PROVIDED "AS IS.". NVIDIA MAKES
+// NO WARRANTIES, EXPRESSED, IMPLIED, STATUTORY, OR OTHERWISE WITH RESPECT TO
+// THE MATERIALS, AND EXPRESSLY DISCLAIMS ALL IMPLIED WARRANTIES OF NONINFRINGEMENT,
+// MERCHANTABILITY, AND FITNESS FOR A PARTICULAR PURPOSE.
+//
+// Information and code furnished is believed to be accurate and reliable.
+// However, NVIDIA Corporation assumes no responsibility for the consequences of use of such
+// information or for any infringement of patents or other rights of third parties that may
+// result from its use. No license is granted by implication or otherwise under any patent
+// or patent rights of NVIDIA Corporation. Details are subject to change without notice.
+// This code supersedes and replaces all information previously supplied.
+// NVIDIA Corporation products are not authorized for use as critical
+// components in life support devices or systems without express written approval of
+// NVIDIA Corporation.
+//
+// Copyright (c) 2008-2021 NVIDIA Corporation. All rights reserved.
+
+#pragma once
+#include "Common.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+
+namespace GFSDK
+{
+namespace SSAO
+{
+
+//--------------------------------------------------------------------------------
+// Runs a batch of independent tasks, either on the application's task scheduler
+// or on short-lived internal threads, and returns when all of them are complete.
+//
+// The calling thread runs tasks too. If a task throws, the other tasks still run,
+// and Run throws on the calling thread once the whole batch is complete.
+//--------------------------------------------------------------------------------
+class TaskBatch
+{
+public:
+    typedef void (*TaskFunc)(void* pUserData, UINT TaskIndex);
+
+    static const UINT MAX_NUM_THREADS = 64;
+
+    // If Scheduler.submit_ is NULL, the tasks are run by NumThreads threads,
+    // including the calling thread (0 = one per logical processor).
+    // Otherwise, the tasks are run by at most one submitted task per logical processor, minus the calling thread.
+    TaskBatch(const GFSDK_SSAO_TaskScheduler& Scheduler, UINT NumThreads);
+
+    void Run(TaskFunc pTaskFunc, void* pUserData, UINT NumTasks);
+
+private:
+    TaskBatch(const TaskBatch&);
+    TaskBatch& operator=(const TaskBatch&);
+
+    static void WorkerMain(void* pBatch);
+    void RunTasks();
+    void RunOnScheduler();
+    void RunOnThreads();
+
+    GFSDK_SSAO_TaskScheduler m_Scheduler;
+    UINT m_NumThreads;
+    UINT m_NumLogicalProcessors;
+
+    TaskFunc m_pTaskFunc;
+    void* m_pUserData;
+    UINT m_NumTasks;
+    std::atomic<UINT> m_NextTaskIndex;
+    std::atomic<bool> m_TaskFailed;
+
+    std::mutex m_Lock;
+    std::condition_variable m_WorkerCompleted;
+    UINT m_NumRunningWorkers;
+};
+
+//--------------------------------------------------------------------------------
+// Objects whose CreateOnce() is deferred, to call it concurrently with a TaskBatch.
+// Adding an object that is already created or listed is a no-op,
+// and the objects that do not fit in the list are created right away.
+//--------------------------------------------------------------------------------
+class CreateOnceList
+{
+public:
+    static const UINT MAX_NUM_OBJECTS = 256;
+
+    CreateOnceList()
+        : m_NumObjects(0)
+    {
+    }
+
+    template<typename ObjectType>
+    void Add(ObjectType& Object)
+    {
+        if (Object.IsCreated())
+        {
+            return;
+        }
+
+        for (UINT Index = 0; Index < m_NumObjects; ++Index)
+        {
+            if (m_Objects[Index].pObject == &Object)
+            {
+                return;
+            }
+        }
+
+        if (m_NumObjects == MAX_NUM_OBJECTS)
+        {
+            Object.CreateOnce();
+            return;
+        }
+
+        m_Objects[m_NumObjects].pCreateOnce = &CreateOnce<ObjectType>;
+        m_Objects[m_NumObjects].pObject = &Object;
+        ++m_NumObjects;
+    }
+
+    UINT GetCount() const
+    {
+        return m_NumObjects;
+    }
+
+    void Run(TaskBatch& Batch)
+    {
+        Batch.Run(CreateTask, this, m_NumObjects);
+        m_NumObjects = 0;
+    }
+
+private:
+    template<typename ObjectType>
+    static void CreateOnce(void* pObject)
+    {
+        static_cast<ObjectType*>(pObject)->CreateOnce();
+    }
+
+    static void CreateTask(void* pUserData, UINT TaskIndex)
+    {
+        const Entry& Object = static_cast<CreateOnceList*>(pUserData)->m_Objects[TaskIndex];
+        Object.pCreateOnce(Object.pObject);
+    }
+
+    struct Entry
+    {
+        void (*pCreateOnce)(void*);
+        void* pObject;
+    };
+
+    Entry m_Objects[MAX_NUM_OBJECTS];
+    UINT m_NumObjects;
+};
+
+} // namespace SSAO
+} // namespace GFSDK
@@ -0,0 +1,510 @@
+// This code contains NVIDIA Confidential Information and is disclosed to you
+// under a form of NVIDIA software license agreement provided separately to you.
+//
+// Notice
+// NVIDIA Corporation and its licensors retain all intellectual property and
+// proprietary rights in and to this software and related documentation and
+// any modifications thereto. Any use, reproduction, disclosure, or
+// distribution of this software and related documentation without an express
+// license agreement from NVIDIA Corporation is strictly prohibited.
+//
+// ALL NVIDIA DESIGN SPECIFICATIONS, CODE ARE PROVIDED "AS IS.". NVIDIA MAKES
+// NO WARRANTIES, EXPRESSED, IMPLIED, STATUTORY, OR OTHERWISE WITH RESPECT TO
+// THE MATERIALS, AND EXPRESSLY DISCLAIMS ALL IMPLIED WARRANTIES OF NONINFRINGEMENT,
+// MERCHANTABILITY, AND FITNESS FOR A PARTICULAR PURPOSE.
+//
+// Information and code furnished is believed to be accurate and reliable.
+// However, NVIDIA Corporation assumes no responsibility for the consequences of use of such
+// information or for any infringement of patents or other rights of third parties that may
+// result from its use. No license is granted by implication or otherwise under any patent
+// or patent rights of NVIDIA Corporation. Details are subject to change without notice.
+// This code supersedes and replaces all information previously supplied.
+// NVIDIA Corporation products are not authorized for use as critical
+// components in life support devices or systems without express written approval of
+// NVIDIA Corporation.
+//
+// Copyright (c) 2008-2021 NVIDIA Corporation. All rights reserved.
+
+#if SUPPORT_CPU
+
+#include "TaskGraph_CPU.h"
+
+#include <utility>
+
+//--------------------------------------------------------------------------------
+void GFSDK::SSAO::CPU::TaskGraph::Create(const GFSDK_SSAO_CustomHeap& NewDelete, UINT NumThreads)
+{
+    m_pQueues = (TaskQueue*)NewDelete.new_(sizeof(TaskQueue) * NumThreads);
+    THROW_IF(!m_pQueues);
+
+    for (UINT ThreadIndex = 0; ThreadIndex < NumThreads; ++ThreadIndex)
+    {
+        new(&m_pQueues[ThreadIndex]) TaskQueue();
+    }
+    m_NumQueues = NumThreads;
+}
+
+//--------------------------------------------------------------------------------
+void GFSDK::SSAO::CPU::TaskGraph::Release(const GFSDK_SSAO_CustomHeap& NewDelete)
+{
+    if (m_pQueues)
+    {
+        for (UINT ThreadIndex = 0; ThreadIndex < m_NumQueues; ++ThreadIndex)
+        {
+            m_pQueues[ThreadIndex].~TaskQueue();
+        }
+
+        NewDelete.delete_(m_pQueues);
+        m_pQueues = NULL;
+    }
+    m_NumQueues = 0;
+
+    if (m_pScratch)
+    {
+        NewDelete.delete_(m_pScratch);
+        m_pScratch = NULL;
+    }
+    m_ScratchSize = 0;
+
+    Reset();
+}
+
+//--------------------------------------------------------------------------------
+void GFSDK::SSAO::CPU::TaskGraph::AddDependency(UINT Consumer, UINT Producer, UINT Num, UINT Den, UINT Halo)
+{
+    if (Consumer == NO_PASS || Producer == NO_PASS)
+    {
+        return;
+    }
+
+    ASSERT(Producer < Consumer);
+    ASSERT(m_NumDependencies < MAX_NUM_DEPENDENCIES);
+
+    Dependency& D = m_Dependencies[m_NumDependencies++];
+    D.Consumer = Consumer;
+    D.Producer = Producer;
+    D.Num = Num;
+    D.Den = Den;
+    D.Halo = Halo;
+    D.WholePass = false;
+    D.pConsumerTiles = NULL;
+}
+
+//--------------------------------------------------------------------------------
+void GFSDK::SSAO::CPU::TaskGraph::AddPassDependency(UINT Consumer, UINT Producer)
+{
+    if (Consumer == NO_PASS || Producer == NO_PASS)
+    {
+        return;
+    }
+
+    ASSERT(Producer < Consumer);
+    ASSERT(m_NumDependencies < MAX_NUM_DEPENDENCIES);
+
+    Dependency& D = m_Dependencies[m_NumDependencies++];
+    D.Consumer = Consumer;
+    D.Producer = Producer;
+    D.Num = 1;
+    D.Den = 1;
+    D.Halo = 0;
+    D.WholePass = true;
+    D.pConsumerTiles = NULL;
+}
+
+//--------------------------------------------------------------------------------
+void GFSDK::SSAO::CPU::TaskGraph::GetProducerTiles(const Dependency& D, UINT ConsumerTile, UINT& FirstTile, UINT& LastTile) const
+{
+    const Pass& Consumer = m_Passes[D.Consumer];
+    const Pass& Producer = m_Passes[D.Producer];
+
+    const UINT RowBegin = ConsumerTile * Consumer.TileHeight;
+    const UINT RowEnd = Min(RowBegin + Consumer.TileHeight, Consumer.NumRows);
+
+    const UINT FirstRow = (Max(RowBegin, D.Halo) - D.Halo) * D.Num / D.Den;
+    const UINT LastRow = ((RowEnd - 1 + D.Halo) * D.Num + D.Num - 1) / D.Den;
+
+    FirstTile = Min(FirstRow, Producer.NumRows - 1) / Producer.TileHeight;
+    LastTile = Min(LastRow, Producer.NumRows - 1) / Producer.TileHeight;
+}
+
+//--------------------------------------------------------------------------------
+void GFSDK::SSAO::CPU::TaskGraph::AllocateScratch(const GFSDK_SSAO_CustomHeap& NewDelete, size_t SizeInBytes)
+{
+    if (SizeInBytes > m_ScratchSize)
+    {
+        if (m_pScratch)
+        {
+            NewDelete.delete_(m_pScratch);
+            m_ScratchSize = 0;
+        }
+
+        m_pScratch = NewDelete.new_(SizeInBytes);
+        THROW_IF(!m_pScratch);
+
+        m_ScratchSize = SizeInBytes;
+    }
+}
+
+//--------------------------------------------------------------------------------
+void GFSDK::SSAO::CPU::TaskGraph::Run(ThreadPool& Pool, const GFSDK_SSAO_CustomHeap& NewDelete, const ProfilerHooks& Hooks)
+{
+    m_pProfilerHooks = &Hooks;
+
+    UINT NumTasks = 0;
+    for (UINT PassIndex = 0; PassIndex < m_NumPasses; ++PassIndex)
+    {
+        Pass& P = m_Passes[PassIndex];
+        P.FirstTask = NumTasks;
+        P.NumPendingTasks = P.NumArgs * P.NumTiles;
+        P.BeginTimeNS = ~GFSDK_SSAO_UINT64(0);
+        P.EndTimeNS = 0;
+        NumTasks += P.NumArgs * P.NumTiles;
+    }
+
+    if (!NumTasks)
+    {
+        return;
+    }
+
+    ASSERT(Pool.GetNumThreads() == m_NumQueues);
+    const UINT NumThreads = m_NumQueues;
+
+    // Scratch layout: per-task dependency counters, consumer-tile ranges of the row dependencies,
+    // and one array of task indices per queue
+    size_t SizeInBytes = sizeof(std::atomic<UINT>) * NumTasks;
+    for (UINT DependencyIndex = 0; DependencyIndex < m_NumDependencies; ++DependencyIndex)
+    {
+        const Dependency& D = m_Dependencies[DependencyIndex];
+        if (!D.WholePass)
+        {
+            SizeInBytes += sizeof(UINT) * 2 * m_Passes[D.Producer].NumTiles;
+        }
+    }
+    SizeInBytes += sizeof(UINT) * NumTasks * NumThreads;
+
+    AllocateScratch(NewDelete, SizeInBytes);
+
+    m_pNumPendingDependencies = (std::atomic<UINT>*)m_pScratch;
+    for (UINT Task = 0; Task < NumTasks; ++Task)
+    {
+        new(&m_pNumPendingDependencies[Task]) std::atomic<UINT>(0);
+    }
+
+    UINT* pScratch = (UINT*)(m_pNumPendingDependencies + NumTasks);
+    for (UINT DependencyIndex = 0; DependencyIndex < m_NumDependencies; ++DependencyIndex)
+    {
+        Dependency& D = m_Dependencies[DependencyIndex];
+        const Pass& Consumer = m_Passes[D.Consumer];
+        const Pass& Producer = m_Passes[D.Producer];
+
+        if (D.WholePass)
+        {
+            for (UINT Task = 0; Task < Consumer.NumArgs * Consumer.NumTiles; ++Task)
+            {
+                m_pNumPendingDependencies[Consumer.FirstTask + Task] += 1;
+            }
+            continue;
+        }
+
+        D.pConsumerTiles = pScratch;
+        pScratch += 2 * Producer.NumTiles;
+
+        for (UINT Tile = 0; Tile < Producer.NumTiles; ++Tile)
+        {
+            D.pConsumerTiles[2 * Tile + 0] = ~0u;
+            D.pConsumerTiles[2 * Tile + 1] = 0;
+        }
+
+        for (UINT Tile = 0; Tile < Consumer.NumTiles; ++Tile)
+        {
+            UINT FirstTile, LastTile;
+            GetProducerTiles(D, Tile, FirstTile, LastTile);
+
+            for (UINT ArgsIndex = 0; ArgsIndex < Consumer.NumArgs; ++ArgsIndex)
+            {
+                m_pNumPendingDependencies[Consumer.FirstTask + ArgsIndex * Consumer.NumTiles + Tile] += (LastTile - FirstTile + 1) * Producer.NumArgs;
+            }
+
+            for (UINT ProducerTile = FirstTile; ProducerTile <= LastTile; ++ProducerTile)
+            {
+                D.pConsumerTiles[2 * ProducerTile + 0] = Min(D.pConsumerTiles[2 * ProducerTile + 0], Tile);
+                D.pConsumerTiles[2 * ProducerTile + 1] = Max(D.pConsumerTiles[2 * ProducerTile + 1], Tile);
+            }
+        }
+    }
+
+    // The workers are all idle here, so the queues can be written without locking.
+    // The initial tasks are dealt round-robin, in pass order.
+    for (UINT ThreadIndex = 0; ThreadIndex < NumThreads; ++ThreadIndex)
+    {
+        m_pQueues[ThreadIndex].pTasks = pScratch + ThreadIndex * NumTasks;
+        m_pQueues[ThreadIndex].Head = 0;
+        m_pQueues[ThreadIndex].Tail = 0;
+    }
+
+    UINT NumReadyTasks = 0;
+    for (UINT Task = 0; Task < NumTasks; ++Task)
+    {
+        if (m_pNumPendingDependencies[Task] == 0)
+        {
+            TaskQueue& Queue = m_pQueues[NumReadyTasks++ % NumThreads];
+            Queue.pTasks[Queue.Tail++] = Task;
+        }
+    }
+
+    // Runs the tasks of each queue in reverse order, so reverse them to start from the top of the frame
+    for (UINT ThreadIndex = 0; ThreadIndex < NumThreads; ++ThreadIndex)
+    {
+        TaskQueue& Queue = m_pQueues[ThreadIndex];
+        for (UINT i = 0, j = Queue.Tail; i + 1 < j; ++i, --j)
+        {
+            std::swap(Queue.pTasks[i], Queue.pTasks[j - 1]);
+        }
+    }
+
+    m_NumPendingTasks = NumTasks;
+    m_NumPushedTasks = 0;
+    m_NumWaitingThreads = 0;
+
+    Pool.Run(WorkerMain, this, NumThreads);
+
+    ASSERT(m_NumPendingTasks == 0);
+}
+
+//--------------------------------------------------------------------------------
+void GFSDK::SSAO::CPU::TaskGraph::GetRenderTimes(SSAO::RenderTimes* pRenderTimes) const
+{
+    GFSDK_SSAO_UINT64 BeginTimeNS[REGIME_TIME_COUNT];
+    GFSDK_SSAO_UINT64 EndTimeNS[REGIME_TIME_COUNT];
+    for (UINT i = 0; i < REGIME_TIME_COUNT; ++i)
+    {
+        BeginTimeNS[i] = ~GFSDK_SSAO_UINT64(0);
+        EndTimeNS[i] = 0;
+    }
+
+    // Passes without tasks keep an empty span
+    for (UINT PassIndex = 0; PassIndex < m_NumPasses; ++PassIndex)
+    {
+        const Pass& P = m_Passes[PassIndex];
+        BeginTimeNS[P.Regime] = Min(BeginTimeNS[P.Regime], GFSDK_SSAO_UINT64(P.BeginTimeNS));
+        EndTimeNS[P.Regime] = Max(EndTimeNS[P.Regime], GFSDK_SSAO_UINT64(P.EndTimeNS));
+    }
+
+    for (UINT i = 0; i < REGIME_TIME_COUNT; ++i)
+    {
+        pRenderTimes->TimeMS[i] = GetHostTimeMS(BeginTimeNS[i], EndTimeNS[i]);
+    }
+}
+
+//--------------------------------------------------------------------------------
+void GFSDK::SSAO::CPU::TaskGraph::WorkerMain(const void* pUserData, UINT ThreadIndex)
+{
+    TaskGraph& Graph = *(TaskGraph*)pUserData;
+
+    UINT NumIdleSpins = 0;
+    while (Graph.m_NumPendingTasks.load(std::memory_order_acquire) != 0)
+    {
+        // Read before looking for a task, so that a task pushed after the queues were found empty wakes this thread
+        const UINT NumPushedTasks = Graph.m_NumPushedTasks.load();
+
+        UINT Task;
+        if (Graph.PopTask(ThreadIndex, Task) || Graph.StealTask(ThreadIndex, Task))
+        {
+            Graph.RunTask(Task, ThreadIndex);
+            NumIdleSpins = 0;
+        }
+        else if (NumIdleSpins < MAX_NUM_IDLE_SPINS)
+        {
+            // The pending tasks are waiting for tasks running on other threads, which usually complete soon
+            std::this_thread::yield();
+            ++NumIdleSpins;
+        }
+        else
+        {
+            Graph.WaitForTask(NumPushedTasks);
+            NumIdleSpins = 0;
+        }
+    }
+}
+
+//--------------------------------------------------------------------------------
+void GFSDK::SSAO::CPU::TaskGraph::WaitForTask(UINT NumPushedTasks)
+{
+    std::unique_lock<std::mutex> Lock(m_WaitLock);
+
+    // Sequentially consistent with the increment of m_NumPushedTasks in PushTask,
+    // so that either the pusher sees this thread waiting, or this thread sees the push
+    m_NumWaitingThreads.fetch_add(1);
+    m_TaskPushed.wait(Lock, [this, NumPushedTasks]
+    {
+        return m_NumPushedTasks.load() != NumPushedTasks || m_NumPendingTasks.load() == 0;
+    });
+    m_NumWaitingThreads.fetch_sub(1);
+}
+
+//--------------------------------------------------------------------------------
+void GFSDK::SSAO::CPU::TaskGraph::WakeWaitingThreads(bool AllThreads)
+{
+    if (m_NumWaitingThreads.load() == 0)
+    {
+        return;
+    }
+
+    // Taking the lock guarantees that a thread that has checked the wait predicate is now waiting
+    {
+        std::lock_guard<std::mutex> Lock(m_WaitLock);
+    }
+
+    if (AllThreads)
+    {
+        m_TaskPushed.notify_all();
+    }
+    else
+    {
+        m_TaskPushed.notify_one();
+    }
+}
+
+//--------------------------------------------------------------------------------
+static void AtomicMin(std::atomic<GFSDK_SSAO_UINT64>& Value, GFSDK_SSAO_UINT64 NewValue)
+{
+    GFSDK_SSAO_UINT64 OldValue = Value.load(std::memory_order_relaxed);
+    while (NewValue < OldValue && !Value.compare_exchange_weak(OldValue, NewValue, std::memory_order_relaxed))
+    {
+    }
+}
+
+static void AtomicMax(std::atomic<GFSDK_SSAO_UINT64>& Value, GFSDK_SSAO_UINT64 NewValue)
+{
+    GFSDK_SSAO_UINT64 OldValue = Value.load(std::memory_order_relaxed);
+    while (NewValue > OldValue && !Value.compare_exchange_weak(OldValue, NewValue, std::memory_order_relaxed))
+    {
+    }
+}
+
+//--------------------------------------------------------------------------------
+void GFSDK::SSAO::CPU::TaskGraph::RunTask(UINT Task, UINT ThreadIndex)
+{
+    UINT PassIndex = 0;
+    while (Task >= m_Passes[PassIndex].FirstTask + m_Passes[PassIndex].NumArgs * m_Passes[PassIndex].NumTiles)
+    {
+        ++PassIndex;
+    }
+
+    Pass& P = m_Passes[PassIndex];
+    const UINT ArgsIndex = (Task - P.FirstTask) / P.NumTiles;
+    const UINT Tile = (Task - P.FirstTask) % P.NumTiles;
+    const UINT RowBegin = Tile * P.TileHeight;
+    const UINT RowEnd = Min(RowBegin + P.TileHeight, P.NumRows);
+
+    const GFSDK_SSAO_UINT64 BeginTimeNS = GetHostTimeNS();
+
+    {
+        ProfilerRange Range(m_pProfilerHooks, NULL, P.Regime);
+        P.pRunTile(P, ArgsIndex, RowBegin, RowEnd);
+    }
+
+    AtomicMin(P.BeginTimeNS, BeginTimeNS);
+    AtomicMax(P.EndTimeNS, GetHostTimeNS());
+
+    const bool LastTaskOfPass = (P.NumPendingTasks.fetch_sub(1, std::memory_order_acq_rel) == 1);
+
+    for (UINT DependencyIndex = 0; DependencyIndex < m_NumDependencies; ++DependencyIndex)
+    {
+        const Dependency& D = m_Dependencies[DependencyIndex];
+        if (D.Producer != PassIndex)
+        {
+            continue;
+        }
+
+        const Pass& Consumer = m_Passes[D.Consumer];
+
+        if (D.WholePass)
+        {
+            if (LastTaskOfPass)
+            {
+                for (UINT ConsumerTask = 0; ConsumerTask < Consumer.NumArgs * Consumer.NumTiles; ++ConsumerTask)
+                {
+                    SignalTask(Consumer.FirstTask + ConsumerTask, ThreadIndex);
+                }
+            }
+            continue;
+        }
+
+        const UINT FirstTile = D.pConsumerTiles[2 * Tile + 0];
+        const UINT LastTile = D.pConsumerTiles[2 * Tile + 1];
+
+        for (UINT ConsumerArgsIndex = 0; ConsumerArgsIndex < Consumer.NumArgs; ++ConsumerArgsIndex)
+        {
+            for (UINT ConsumerTile = FirstTile; ConsumerTile <= LastTile; ++ConsumerTile)
+            {
+                SignalTask(Consumer.FirstTask + ConsumerArgsIndex * Consumer.NumTiles + ConsumerTile, ThreadIndex);
+            }
+        }
+    }
+
+    if (m_NumPendingTasks.fetch_sub(1) == 1)
+    {
+        WakeWaitingThreads(true);
+    }
+}
+
+//--------------------------------------------------------------------------------
+void GFSDK::SSAO::CPU::TaskGraph::SignalTask(UINT Task, UINT ThreadIndex)
+{
+    if (m_pNumPendingDependencies[Task].fetch_sub(1, std::memory_order_acq_rel) == 1)
+    {
+        PushTask(Task, ThreadIndex);
+    }
+}
+
+//--------------------------------------------------------------------------------
+void GFSDK::SSAO::CPU::TaskGraph::PushTask(UINT Task, UINT ThreadIndex)
+{
+    {
+        TaskQueue& Queue = m_pQueues[ThreadIndex];
+        std::lock_guard<std::mutex> Lock(Queue.Lock);
+
+        Queue.pTasks[Queue.Tail++] = Task;
+    }
+
+    m_NumPushedTasks.fetch_add(1);
+    WakeWaitingThreads(false);
+}
+
+//--------------------------------------------------------------------------------
+bool GFSDK::SSAO::CPU::TaskGraph::PopTask(UINT ThreadIndex, UINT& Task)
+{
+    TaskQueue& Queue = m_pQueues[ThreadIndex];
+    std::lock_guard<std::mutex> Lock(Queue.Lock);
+
+    if (Queue.Head == Queue.Tail)
+    {
+        return false;
+    }
+
+    // Newest first, as its inputs were just written by this thread
+    Task = Queue.pTasks[--Queue.Tail];
+    return true;
+}
+
+//--------------------------------------------------------------------------------
+bool GFSDK::SSAO::CPU::TaskGraph::StealTask(UINT ThreadIndex, UINT& Task)
+{
+    for (UINT Offset = 1; Offset < m_NumQueues; ++Offset)
+    {
+        TaskQueue& Victim = m_pQueues[(ThreadIndex + Offset) % m_NumQueues];
+        std::lock_guard<std::mutex> Lock(Victim.Lock);
+
+        if (Victim.Head != Victim.Tail)
+        {
+            // Oldest first, as it is the least likely to be in the cache of the victim
+            Task = Victim.pTasks[Victim.Head++];
+            return true;
+        }
+    }
+
+    return false;
+}
+
+#endif // SUPPORT_CPU
@@ -0,0 +1,215 @@
+// This code contains NVIDIA Confidential Information and is disclosed to you
+// under a form of NVIDIA software license agreement provided separately to you.
+//
+// Notice
+// NVIDIA Corporation and its licensors retain all intellectual property and
+// proprietary rights in and to this software and related documentation and
+// any modifications thereto. Any use, reproduction, disclosure, or
+// distribution of this software and related documentation without an express
+// license agreement from NVIDIA Corporation is strictly prohibited.
+//
+// ALL NVIDIA DESIGN SPECIFICATIONS, CODE ARE PROVIDED "AS IS.". NVIDIA MAKES
+// NO WARRANTIES, EXPRESSED, IMPLIED, STATUTORY, OR OTHERWISE WITH RESPECT TO
+// THE MATERIALS, AND EXPRESSLY DISCLAIMS ALL IMPLIED WARRANTIES OF NONINFRINGEMENT,
+// MERCHANTABILITY, AND FITNESS FOR A PARTICULAR PURPOSE.
+//
+// Information and code furnished is believed to be accurate and reliable.
+// However, NVIDIA Corporation assumes no responsibility for the consequences of use of such
+// information or for any infringement of patents or other rights of third parties that may
+// result from its use. No license is granted by implication or otherwise under any patent
+// or patent rights of NVIDIA Corporation. Details are subject to change without notice.
+// This code supersedes and replaces all information previously supplied.
+// NVIDIA Corporation products are not authorized for use as critical
+// components in life support devices or systems without express written approval of
+// NVIDIA Corporation.
+//
+// Copyright (c) 2008-2021 NVIDIA Corporation. All rights reserved.
+
+#pragma once
+
+#if SUPPORT_CPU
+
+#include "Common.h"
+#include "ProfilerHooks.h"
+#include "RenderTimes.h"
+#include "ThreadPool_CPU.h"
+
+namespace GFSDK
+{
+namespace SSAO
+{
+namespace CPU
+{
+
+//--------------------------------------------------------------------------------
+// Graph of tiled passes, with dependencies between tiles instead of barriers between passes.
+//
+// A pass runs a row-range kernel over NumArgs images of NumRows rows, with one task per band
+// of TileHeight rows of each image. A task becomes ready once all the producer tiles it
+// depends on have completed. The tasks made ready by a thread are pushed to its own queue,
+// so that consumers tend to run on the core that has their inputs in cache, and idle threads
+// steal the oldest tasks of the other queues. A thread that finds no ready task yields a few
+// times, and then sleeps until a task is pushed or the graph completes.
+//
+// Each pass is timed from the start of its first tile to the end of its last tile, and
+// reported under the regime it was added with. The spans of different passes overlap.
+// Each tile is also reported as a range of its regime to the profiler hooks, on the thread running it.
+//--------------------------------------------------------------------------------
+class TaskGraph
+{
+public:
+    static const UINT MAX_NUM_PASSES = 16;
+    static const UINT MAX_NUM_DEPENDENCIES = 16;
+    static const UINT NO_PASS = ~0u;
+
+    // Number of times an idle thread yields before going to sleep
+    static const UINT MAX_NUM_IDLE_SPINS = 16;
+
+    TaskGraph()
+        : m_pQueues(NULL)
+        , m_NumQueues(0)
+        , m_pScratch(NULL)
+        , m_ScratchSize(0)
+        , m_NumPasses(0)
+        , m_NumDependencies(0)
+        , m_pProfilerHooks(NULL)
+    {
+    }
+
+    void Create(const GFSDK_SSAO_CustomHeap& NewDelete, UINT NumThreads);
+    void Release(const GFSDK_SSAO_CustomHeap& NewDelete);
+
+    void Reset()
+    {
+        m_NumPasses = 0;
+        m_NumDependencies = 0;
+    }
+
+    template<class ArgsType>
+    UINT AddPass(void (*pKernel)(const ArgsType&, UINT, UINT), const ArgsType* pArgs, UINT NumArgs, UINT NumRows, UINT TileHeight, GpuTimeRegimeIndex Regime)
+    {
+        ASSERT(m_NumPasses < MAX_NUM_PASSES);
+
+        Pass& P = m_Passes[m_NumPasses];
+        P.pRunTile = RunTile<ArgsType>;
+        P.pKernel = reinterpret_cast<GenericKernel>(pKernel);
+        P.pArgs = pArgs;
+        P.NumArgs = NumArgs;
+        P.NumRows = NumRows;
+        P.TileHeight = TileHeight;
+        P.NumTiles = (NumRows + TileHeight - 1) / TileHeight;
+        P.Regime = Regime;
+
+        return m_NumPasses++;
+    }
+
+    UINT GetNumPasses() const
+    {
+        return m_NumPasses;
+    }
+
+    UINT GetNumDependencies() const
+    {
+        return m_NumDependencies;
+    }
+
+    // Each tile of Consumer waits for the tiles of Producer (in all its images) covering the rows
+    // [(Y - Halo) * Num / Den, ((Y + Halo) * Num + Num - 1) / Den] for each row Y of the tile
+    void AddDependency(UINT Consumer, UINT Producer, UINT Num, UINT Den, UINT Halo);
+
+    // Each tile of Consumer waits for all the tiles of Producer
+    void AddPassDependency(UINT Consumer, UINT Producer);
+
+    // Runs all the passes, and returns when they are complete
+    void Run(ThreadPool& Pool, const GFSDK_SSAO_CustomHeap& NewDelete, const ProfilerHooks& Hooks);
+
+    // Gets the span of the passes of each regime in the last Run, and 0 for the regimes without passes
+    void GetRenderTimes(SSAO::RenderTimes* pRenderTimes) const;
+
+private:
+    typedef void (*GenericKernel)();
+
+    struct Pass
+    {
+        void (*pRunTile)(const Pass& P, UINT ArgsIndex, UINT RowBegin, UINT RowEnd);
+        GenericKernel pKernel;
+        const void* pArgs;
+        UINT NumArgs;
+        UINT NumRows;
+        UINT TileHeight;
+        UINT NumTiles;
+        UINT FirstTask;
+        GpuTimeRegimeIndex Regime;
+        std::atomic<UINT> NumPendingTasks;
+        std::atomic<GFSDK_SSAO_UINT64> BeginTimeNS;
+        std::atomic<GFSDK_SSAO_UINT64> EndTimeNS;
+    };
+
+    struct Dependency
+    {
+        UINT Consumer;
+        UINT Producer;
+        UINT Num;
+        UINT Den;
+        UINT Halo;
+        bool WholePass;
+        UINT* pConsumerTiles;   // [2*k, 2*k+1] = first and last consumer tiles waiting for producer tile k
+    };
+
+    // Tasks made ready by one thread. Each task is pushed only once per Run,
+    // so the array has room for all of them and never wraps around.
+    struct TaskQueue
+    {
+        std::mutex Lock;
+        UINT* pTasks;
+        UINT Head;
+        UINT Tail;
+        char Padding[64];
+    };
+
+    template<class ArgsType>
+    static void RunTile(const Pass& P, UINT ArgsIndex, UINT RowBegin, UINT RowEnd)
+    {
+        typedef void (*Kernel)(const ArgsType&, UINT, UINT);
+        reinterpret_cast<Kernel>(P.pKernel)(static_cast<const ArgsType*>(P.pArgs)[ArgsIndex], RowBegin, RowEnd);
+    }
+
+    void GetProducerTiles(const Dependency& D, UINT ConsumerTile, UINT& FirstTile, UINT& LastTile) const;
+    void AllocateScratch(const GFSDK_SSAO_CustomHeap& NewDelete, size_t SizeInBytes);
+
+    static void WorkerMain(const void* pUserData, UINT ThreadIndex);
+    void RunTask(UINT Task, UINT ThreadIndex);
+    void SignalTask(UINT Task, UINT ThreadIndex);
+    void PushTask(UINT Task, UINT ThreadIndex);
+    bool PopTask(UINT ThreadIndex, UINT& Task);
+    bool StealTask(UINT ThreadIndex, UINT& Task);
+    void WaitForTask(UINT NumPushedTasks);
+    void WakeWaitingThreads(bool AllThreads);
+
+    TaskQueue* m_pQueues;
+    UINT m_NumQueues;
+
+    void* m_pScratch;
+    size_t m_ScratchSize;
+    std::atomic<UINT>* m_pNumPendingDependencies;
+    std::atomic<UINT> m_NumPendingTasks;
+
+    // Idle threads sleep on m_TaskPushed until m_NumPushedTasks changes or m_NumPendingTasks reaches 0
+    std::mutex m_WaitLock;
+    std::condition_variable m_TaskPushed;
+    std::atomic<UINT> m_NumPushedTasks;
+    std::atomic<UINT> m_NumWaitingThreads;
+
+    Pass m_Passes[MAX_NUM_PASSES];
+    UINT m_NumPasses;
+    Dependency m_Dependencies[MAX_NUM_DEPENDENCIES];
+    UINT m_NumDependencies;
+
+    const ProfilerHooks* m_pProfilerHooks;
+};
+
+} // namespace CPU
+} // namespace SSAO
+} // namespace GFSDK
+
+#endif // SUPPORT_CPU
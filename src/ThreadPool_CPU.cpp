@@ -0,0 +1,292 @@
+// This code contains NVIDIA Confidential Information and is disclosed to you
+// under a form of NVIDIA software license agreement provided separately to you.
+//
+// Notice
+// NVIDIA Corporation and its licensors retain all intellectual property and
+// proprietary rights in and to this software and related documentation and
+// any modifications thereto. Any use, reproduction, disclosure, or
+// distribution of this software and related documentation without an express
+// license agreement from NVIDIA Corporation is strictly prohibited.
+//
+// ALL NVIDIA DESIGN SPECIFICATIONS, CODE ARE PROVIDED "AS IS.". NVIDIA MAKES
+// NO WARRANTIES, EXPRESSED, IMPLIED, STATUTORY, OR OTHERWISE WITH RESPECT TO
+// THE MATERIALS, AND EXPRESSLY DISCLAIMS ALL IMPLIED WARRANTIES OF NONINFRINGEMENT,
+// MERCHANTABILITY, AND FITNESS FOR A PARTICULAR PURPOSE.
+//
+// Information and code furnished is believed to be accurate and reliable.
+// However, NVIDIA Corporation assumes no responsibility for the consequences of use of such
+// information or for any infringement of patents or other rights of third parties that may
+// result from its use. No license is granted by implication or otherwise under any patent
+// or patent rights of NVIDIA Corporation. Details are subject to change without notice.
+// This code supersedes and replaces all information previously supplied.
+// NVIDIA Corporation products are not authorized for use as critical
+// components in life support devices or systems without express written approval of
+// NVIDIA Corporation.
+//
+// Copyright (c) 2008-2021 NVIDIA Corporation. All rights reserved.
+
+#if SUPPORT_CPU
+
+#include "ThreadPool_CPU.h"
+
+#if _WIN32
+#include <windows.h>
+#elif defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+//--------------------------------------------------------------------------------
+static void SetThreadAffinity(std::thread& Thread, UINT CpuIndex)
+{
+#if _WIN32
+    SetThreadAffinityMask(Thread.native_handle(), DWORD_PTR(1) << CpuIndex);
+#elif defined(__linux__)
+    cpu_set_t CpuSet;
+    CPU_ZERO(&CpuSet);
+    CPU_SET(CpuIndex, &CpuSet);
+    pthread_setaffinity_np(Thread.native_handle(), sizeof(CpuSet), &CpuSet);
+#else
+    (void)Thread;
+    (void)CpuIndex;
+#endif
+}
+
+//--------------------------------------------------------------------------------
+void GFSDK::SSAO::CPU::ThreadPool::Create(const GFSDK_SSAO_CustomHeap& NewDelete, UINT NumThreads, GFSDK_SSAO_UINT64 AffinityMask)
+{
+    if (NumThreads == 0)
+    {
+        NumThreads = Max(std::thread::hardware_concurrency(), 1u);
+    }
+
+    m_pQueues = (TaskQueue*)NewDelete.new_(sizeof(TaskQueue) * NumThreads);
+    THROW_IF(!m_pQueues);
+
+    for (UINT ThreadIndex = 0; ThreadIndex < NumThreads; ++ThreadIndex)
+    {
+        new(&m_pQueues[ThreadIndex]) TaskQueue();
+        m_pQueues[ThreadIndex].Begin = 0;
+        m_pQueues[ThreadIndex].End = 0;
+    }
+    m_NumThreads = NumThreads;
+
+    if (NumThreads == 1)
+    {
+        return;
+    }
+
+    m_pThreads = (std::thread*)NewDelete.new_(sizeof(std::thread) * NumThreads);
+    THROW_IF(!m_pThreads);
+
+    for (UINT ThreadIndex = 0; ThreadIndex < NumThreads; ++ThreadIndex)
+    {
+        new(&m_pThreads[ThreadIndex]) std::thread();
+    }
+
+    m_Exit = false;
+    m_BatchIndex = 0;
+
+    UINT CpuIndex = 0;
+    for (UINT ThreadIndex = 1; ThreadIndex < NumThreads; ++ThreadIndex)
+    {
+        m_pThreads[ThreadIndex] = std::thread(&ThreadPool::WorkerMain, this, ThreadIndex);
+
+        if (AffinityMask)
+        {
+            while (!(AffinityMask & (GFSDK_SSAO_UINT64(1) << CpuIndex)))
+            {
+                CpuIndex = (CpuIndex + 1) % 64;
+            }
+            SetThreadAffinity(m_pThreads[ThreadIndex], CpuIndex);
+            CpuIndex = (CpuIndex + 1) % 64;
+        }
+    }
+}
+
+//--------------------------------------------------------------------------------
+void GFSDK::SSAO::CPU::ThreadPool::Release(const GFSDK_SSAO_CustomHeap& NewDelete)
+{
+    if (m_pThreads)
+    {
+        {
+            std::lock_guard<std::mutex> Lock(m_Lock);
+            m_Exit = true;
+        }
+        m_BatchStarted.notify_all();
+
+        for (UINT ThreadIndex = 0; ThreadIndex < m_NumThreads; ++ThreadIndex)
+        {
+            if (m_pThreads[ThreadIndex].joinable())
+            {
+                m_pThreads[ThreadIndex].join();
+            }
+            m_pThreads[ThreadIndex].~thread();
+        }
+
+        NewDelete.delete_(m_pThreads);
+        m_pThreads = NULL;
+    }
+
+    if (m_pQueues)
+    {
+        for (UINT ThreadIndex = 0; ThreadIndex < m_NumThreads; ++ThreadIndex)
+        {
+            m_pQueues[ThreadIndex].~TaskQueue();
+        }
+
+        NewDelete.delete_(m_pQueues);
+        m_pQueues = NULL;
+    }
+
+    m_NumThreads = 1;
+}
+
+//--------------------------------------------------------------------------------
+void GFSDK::SSAO::CPU::ThreadPool::Run(TaskFunc pTaskFunc, const void* pUserData, UINT NumTasks)
+{
+    if (!m_pThreads || NumTasks <= 1)
+    {
+        for (UINT TaskIndex = 0; TaskIndex < NumTasks; ++TaskIndex)
+        {
+            pTaskFunc(pUserData, TaskIndex);
+        }
+        return;
+    }
+
+    // The workers are all idle here, so the queues can be written without locking
+    for (UINT ThreadIndex = 0; ThreadIndex < m_NumThreads; ++ThreadIndex)
+    {
+        m_pQueues[ThreadIndex].Begin = UINT(GFSDK_SSAO_UINT64(NumTasks) * ThreadIndex / m_NumThreads);
+        m_pQueues[ThreadIndex].End = UINT(GFSDK_SSAO_UINT64(NumTasks) * (ThreadIndex + 1) / m_NumThreads);
+    }
+
+    m_pTaskFunc = pTaskFunc;
+    m_pUserData = pUserData;
+
+    {
+        std::lock_guard<std::mutex> Lock(m_Lock);
+        m_NumRunningThreads = m_NumThreads - 1;
+        ++m_BatchIndex;
+    }
+    m_BatchStarted.notify_all();
+
+    RunTasks(0);
+
+    // Once no range is left to steal from, the remaining tasks are owned by running workers
+    std::unique_lock<std::mutex> Lock(m_Lock);
+    m_BatchCompleted.wait(Lock, [this] { return m_NumRunningThreads == 0; });
+}
+
+//--------------------------------------------------------------------------------
+void GFSDK::SSAO::CPU::ThreadPool::WorkerMain(UINT ThreadIndex)
+{
+    UINT BatchIndex = 0;
+
+    for (;;)
+    {
+        {
+            std::unique_lock<std::mutex> Lock(m_Lock);
+            m_BatchStarted.wait(Lock, [this, BatchIndex] { return m_Exit || m_BatchIndex != BatchIndex; });
+
+            if (m_Exit)
+            {
+                return;
+            }
+            BatchIndex = m_BatchIndex;
+        }
+
+        RunTasks(ThreadIndex);
+
+        bool LastThread;
+        {
+            std::lock_guard<std::mutex> Lock(m_Lock);
+            LastThread = (--m_NumRunningThreads == 0);
+        }
+        if (LastThread)
+        {
+            m_BatchCompleted.notify_one();
+        }
+    }
+}
+
+//--------------------------------------------------------------------------------
+void GFSDK::SSAO::CPU::ThreadPool::RunTasks(UINT ThreadIndex)
+{
+    do
+    {
+        UINT TaskIndex;
+        while (PopTask(ThreadIndex, TaskIndex))
+        {
+            m_pTaskFunc(m_pUserData, TaskIndex);
+        }
+    }
+    while (StealTasks(ThreadIndex));
+}
+
+//--------------------------------------------------------------------------------
+bool GFSDK::SSAO::CPU::ThreadPool::PopTask(UINT ThreadIndex, UINT& TaskIndex)
+{
+    TaskQueue& Queue = m_pQueues[ThreadIndex];
+    std::lock_guard<std::mutex> Lock(Queue.Lock);
+
+    if (Queue.Begin == Queue.End)
+    {
+        return false;
+    }
+
+    TaskIndex = Queue.Begin++;
+    return true;
+}
+
+//--------------------------------------------------------------------------------
+bool GFSDK::SSAO::CPU::ThreadPool::StealTasks(UINT ThreadIndex)
+{
+    for (;;)
+    {
+        // Pick the victim with the most tasks left. The sizes are read without locking,
+        // and checked again once the victim is locked.
+        UINT VictimIndex = ThreadIndex;
+        UINT MaxNumTasks = 0;
+        for (UINT Offset = 1; Offset < m_NumThreads; ++Offset)
+        {
+            const UINT Index = (ThreadIndex + Offset) % m_NumThreads;
+            const UINT Begin = m_pQueues[Index].Begin.load(std::memory_order_relaxed);
+            const UINT End = m_pQueues[Index].End.load(std::memory_order_relaxed);
+            const UINT NumTasks = (End > Begin) ? End - Begin : 0;
+            if (NumTasks > MaxNumTasks)
+            {
+                MaxNumTasks = NumTasks;
+                VictimIndex = Index;
+            }
+        }
+
+        if (VictimIndex == ThreadIndex)
+        {
+            return false;
+        }
+
+        UINT Begin, End;
+        {
+            TaskQueue& Victim = m_pQueues[VictimIndex];
+            std::lock_guard<std::mutex> Lock(Victim.Lock);
+
+            if (Victim.Begin == Victim.End)
+            {
+                continue;
+            }
+
+            End = Victim.End;
+            Begin = End - (End - Victim.Begin + 1) / 2;
+            Victim.End = Begin;
+        }
+
+        TaskQueue& Queue = m_pQueues[ThreadIndex];
+        std::lock_guard<std::mutex> Lock(Queue.Lock);
+        Queue.Begin = Begin;
+        Queue.End = End;
+        return true;
+    }
+}
+
+#endif // SUPPORT_CPU
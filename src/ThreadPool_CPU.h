@@ -0,0 +1,118 @@
+// This code contains NVIDIA Confidential Information and is disclosed to you
+// under a form of NVIDIA software license agreement provided separately to you.
+//
+// Notice
+// NVIDIA Corporation and its licensors retain all intellectual property and
+// proprietary rights in and to this software and related documentation and
+// any modifications thereto. Any use, reproduction, disclosure, or
+// distribution of this software and related documentation without an express
+// license agreement from NVIDIA Corporation is strictly prohibited.
+//
+// ALL NVIDIA DESIGN SPECIFICATIONS, CODE ARE PROVIDED "AS IS.". NVIDIA MAKES
+// NO WARRANTIES, EXPRESSED, IMPLIED, STATUTORY, OR OTHERWISE WITH RESPECT TO
+// THE MATERIALS, AND EXPRESSLY DISCLAIMS ALL IMPLIED WARRANTIES OF NONINFRINGEMENT,
+// MERCHANTABILITY, AND FITNESS FOR A PARTICULAR PURPOSE.
+//
+// Information and code furnished is believed to be accurate and reliable.
+// However, NVIDIA Corporation assumes no responsibility for the consequences of use of such
+// information or for any infringement of patents or other rights of third parties that may
+// result from its use. No license is granted by implication or otherwise under any patent
+// or patent rights of NVIDIA Corporation. Details are subject to change without notice.
+// This code supersedes and replaces all information previously supplied.
+// NVIDIA Corporation products are not authorized for use as critical
+// components in life support devices or systems without express written approval of
+// NVIDIA Corporation.
+//
+// Copyright (c) 2008-2021 NVIDIA Corporation. All rights reserved.
+
+#pragma once
+
+#if SUPPORT_CPU
+
+#include "Common.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+namespace GFSDK
+{
+namespace SSAO
+{
+namespace CPU
+{
+
+//--------------------------------------------------------------------------------
+// Persistent pool of threads executing batches of independent tasks.
+//
+// The tasks of a batch start evenly split into one contiguous range per thread.
+// A thread pops tasks from the front of its own range, and when it runs out of work,
+// steals the back half of the largest range left to another thread.
+// The thread calling Run takes part as thread 0 and returns when all tasks are complete.
+//--------------------------------------------------------------------------------
+class ThreadPool
+{
+public:
+    typedef void (*TaskFunc)(const void* pUserData, UINT TaskIndex);
+
+    ThreadPool()
+        : m_pQueues(NULL)
+        , m_pThreads(NULL)
+        , m_NumThreads(1)
+        , m_NumRunningThreads(0)
+        , m_BatchIndex(0)
+        , m_Exit(false)
+        , m_pTaskFunc(NULL)
+        , m_pUserData(NULL)
+    {
+    }
+
+    // NumThreads includes the calling thread; 0 means one thread per logical core.
+    // If AffinityMask is non-zero, the worker threads are pinned round-robin to its set bits.
+    void Create(const GFSDK_SSAO_CustomHeap& NewDelete, UINT NumThreads, GFSDK_SSAO_UINT64 AffinityMask);
+    void Release(const GFSDK_SSAO_CustomHeap& NewDelete);
+
+    UINT GetNumThreads() const
+    {
+        return m_NumThreads;
+    }
+
+    void Run(TaskFunc pTaskFunc, const void* pUserData, UINT NumTasks);
+
+private:
+    // Range of tasks left to one thread, padded to avoid false sharing.
+    // Begin and End are only modified with Lock held, but may be read without it.
+    struct TaskQueue
+    {
+        std::mutex Lock;
+        std::atomic<UINT> Begin;
+        std::atomic<UINT> End;
+        char Padding[64];
+    };
+
+    void WorkerMain(UINT ThreadIndex);
+    void RunTasks(UINT ThreadIndex);
+    bool PopTask(UINT ThreadIndex, UINT& TaskIndex);
+    bool StealTasks(UINT ThreadIndex);
+
+    TaskQueue* m_pQueues;
+    std::thread* m_pThreads;
+    UINT m_NumThreads;
+
+    std::mutex m_Lock;
+    std::condition_variable m_BatchStarted;
+    std::condition_variable m_BatchCompleted;
+    UINT m_NumRunningThreads;
+    UINT m_BatchIndex;
+    bool m_Exit;
+
+    TaskFunc m_pTaskFunc;
+    const void* m_pUserData;
+};
+
+} // namespace CPU
+} // namespace SSAO
+} // namespace GFSDK
+
+#endif // SUPPORT_CPU
@@ -25,10 +25,13 @@
 //
 // Copyright (c) 2008-2021 NVIDIA Corporation. All rights reserved.
 
-#if ENABLE_RENDER_TIMES
-
 #pragma once
 #include "Common.h"
+#include "RenderTimes.h"
+
+#if SUPPORT_GL
+#include "Common_GL.h"
+#endif
 
 namespace GFSDK
 {
@@ -36,24 +39,12 @@ namespace SSAO
 {
 
 //--------------------------------------------------------------------------------
-
-enum GpuTimeRegimeIndex
-{
-    REGIME_TIME_LINEAR_Z,
-    REGIME_TIME_DEINTERLEAVE_Z,
-    REGIME_TIME_NORMAL,
-    REGIME_TIME_COARSE_AO,
-    REGIME_TIME_INTERLEAVE_AO,
-    REGIME_TIME_BLURX,
-    REGIME_TIME_BLURY,
-    REGIME_TIME_TOTAL,
-    REGIME_TIME_COUNT
-};
-
-struct RenderTimes
-{
-    float GPUTimeMS[REGIME_TIME_COUNT];
-};
+// GPU timestamps of the regimes of the RenderAO calls.
+//
+// The timestamps are never read back with a blocking call. Each frame records into its own slot
+// of a TimestampQueryRing, and End adds the times of every slot whose timestamps have become
+// available to the history, oldest first.
+//--------------------------------------------------------------------------------
 
 #if SUPPORT_D3D11
 
@@ -64,104 +55,138 @@ namespace D3D11
 class TimestampQueries
 {
 public:
+    TimestampQueries()
+    {
+        ZERO_ARRAY(m_Frames);
+    }
+
     void Create(ID3D11Device* pD3DDevice)
     {
         D3D11_QUERY_DESC queryDesc;
         queryDesc.MiscFlags = 0;
 
-        queryDesc.Query = D3D11_QUERY_TIMESTAMP_DISJOINT;
-        SAFE_D3D_CALL( pD3DDevice->CreateQuery(&queryDesc, &m_pDisjointTimestampQuery) );
-        m_DisjointQueryInFlight = false;
-
-        queryDesc.Query = D3D11_QUERY_TIMESTAMP;
-        for (UINT i = 0; i < REGIME_TIME_COUNT; ++i)
+        for (UINT Slot = 0; Slot < TimestampQueryRing::FRAMES_IN_FLIGHT; ++Slot)
         {
-            SAFE_D3D_CALL( pD3DDevice->CreateQuery(&queryDesc, &m_pTimestampQueriesBegin[i]) );
-            SAFE_D3D_CALL( pD3DDevice->CreateQuery(&queryDesc, &m_pTimestampQueriesEnd[i]) );
-            m_TimestampQueryInFlight[i] = false;
+            FrameQueries& Frame = m_Frames[Slot];
+
+            queryDesc.Query = D3D11_QUERY_TIMESTAMP_DISJOINT;
+            SAFE_D3D_CALL( pD3DDevice->CreateQuery(&queryDesc, &Frame.pDisjointTimestampQuery) );
+
+            queryDesc.Query = D3D11_QUERY_TIMESTAMP;
+            for (UINT i = 0; i < REGIME_TIME_COUNT; ++i)
+            {
+                SAFE_D3D_CALL( pD3DDevice->CreateQuery(&queryDesc, &Frame.pTimestampQueriesBegin[i]) );
+                SAFE_D3D_CALL( pD3DDevice->CreateQuery(&queryDesc, &Frame.pTimestampQueriesEnd[i]) );
+            }
+            ZERO_ARRAY(Frame.TimestampQueryUsed);
         }
+
+        m_Ring.Reset();
     }
 
     void Release()
     {
-        SAFE_RELEASE(m_pDisjointTimestampQuery);
-
-        for (UINT i = 0; i < REGIME_TIME_COUNT; ++i)
+        for (UINT Slot = 0; Slot < TimestampQueryRing::FRAMES_IN_FLIGHT; ++Slot)
         {
-            SAFE_RELEASE(m_pTimestampQueriesBegin[i]);
-            SAFE_RELEASE(m_pTimestampQueriesEnd[i]);
+            FrameQueries& Frame = m_Frames[Slot];
+
+            SAFE_RELEASE(Frame.pDisjointTimestampQuery);
+
+            for (UINT i = 0; i < REGIME_TIME_COUNT; ++i)
+            {
+                SAFE_RELEASE(Frame.pTimestampQueriesBegin[i]);
+                SAFE_RELEASE(Frame.pTimestampQueriesEnd[i]);
+            }
         }
     }
 
     void Begin(ID3D11DeviceContext* pDeviceContext)
     {
-        if (!m_DisjointQueryInFlight)
+        if (m_Ring.BeginFrame())
         {
-            pDeviceContext->Begin(m_pDisjointTimestampQuery);
+            FrameQueries& Frame = m_Frames[m_Ring.GetWriteSlot()];
+            ZERO_ARRAY(Frame.TimestampQueryUsed);
+            pDeviceContext->Begin(Frame.pDisjointTimestampQuery);
         }
     }
 
-    void End(ID3D11DeviceContext* pDeviceContext, SSAO::RenderTimes* pRenderTimes)
+    void End(ID3D11DeviceContext* pDeviceContext, SSAO::RenderTimesHistory* pRenderTimes)
     {
-        if (!m_DisjointQueryInFlight)
+        if (m_Ring.IsRecording())
         {
-            pDeviceContext->End(m_pDisjointTimestampQuery);
+            pDeviceContext->End(m_Frames[m_Ring.GetWriteSlot()].pDisjointTimestampQuery);
         }
-        m_DisjointQueryInFlight = true;
+        m_Ring.EndFrame(true);
 
-        D3D11_QUERY_DATA_TIMESTAMP_DISJOINT disjointTimestampValue;
-        if (pDeviceContext->GetData(m_pDisjointTimestampQuery, &disjointTimestampValue, sizeof(disjointTimestampValue), D3D11_ASYNC_GETDATA_DONOTFLUSH) == S_OK)
+        while (m_Ring.GetNumInFlight())
         {
-            m_DisjointQueryInFlight = false;
+            FrameQueries& Frame = m_Frames[m_Ring.GetOldestSlot()];
 
-            if (!disjointTimestampValue.Disjoint)
+            D3D11_QUERY_DATA_TIMESTAMP_DISJOINT disjointTimestampValue;
+            if (pDeviceContext->GetData(Frame.pDisjointTimestampQuery, &disjointTimestampValue, sizeof(disjointTimestampValue), D3D11_ASYNC_GETDATA_DONOTFLUSH) != S_OK)
             {
-                double InvFrequencyMS = 1000.0 / disjointTimestampValue.Frequency;
-                for (UINT i = 0; i < REGIME_TIME_COUNT; ++i)
+                break;
+            }
+
+            // The timestamps were all issued before the end of the disjoint query, so they are available too
+            m_Ring.PopOldestSlot();
+
+            // The timestamps are unreliable if the GPU frequency changed during the frame
+            if (disjointTimestampValue.Disjoint)
+            {
+                continue;
+            }
+
+            SSAO::RenderTimes FrameTimes;
+
+            const double InvFrequencyMS = 1000.0 / disjointTimestampValue.Frequency;
+            for (UINT i = 0; i < REGIME_TIME_COUNT; ++i)
+            {
+                if (Frame.TimestampQueryUsed[i])
                 {
-                    if (m_TimestampQueryInFlight[i])
-                    {
-                        UINT64 TimestampValueBegin;
-                        UINT64 TimestampValueEnd;
-                        if ((pDeviceContext->GetData(m_pTimestampQueriesBegin[i], &TimestampValueBegin, sizeof(UINT64), D3D11_ASYNC_GETDATA_DONOTFLUSH) == S_OK) &&
-                            (pDeviceContext->GetData(m_pTimestampQueriesEnd[i],   &TimestampValueEnd,   sizeof(UINT64), D3D11_ASYNC_GETDATA_DONOTFLUSH) == S_OK))
-                        {
-                            m_TimestampQueryInFlight[i] = false;
-                            pRenderTimes->GPUTimeMS[i] = float(double(TimestampValueEnd - TimestampValueBegin) * InvFrequencyMS);
-                        }
-                    }
-                    else
+                    UINT64 TimestampValueBegin;
+                    UINT64 TimestampValueEnd;
+                    if ((pDeviceContext->GetData(Frame.pTimestampQueriesBegin[i], &TimestampValueBegin, sizeof(UINT64), D3D11_ASYNC_GETDATA_DONOTFLUSH) == S_OK) &&
+                        (pDeviceContext->GetData(Frame.pTimestampQueriesEnd[i],   &TimestampValueEnd,   sizeof(UINT64), D3D11_ASYNC_GETDATA_DONOTFLUSH) == S_OK))
                     {
-                        pRenderTimes->GPUTimeMS[i] = 0.f;
+                        FrameTimes.TimeMS[i] = float(double(TimestampValueEnd - TimestampValueBegin) * InvFrequencyMS);
                     }
                 }
             }
+
+            pRenderTimes->Add(FrameTimes);
         }
     }
 
     void StartTimer(ID3D11DeviceContext* pDeviceContext, GpuTimeRegimeIndex Id)
     {
-        if (!m_TimestampQueryInFlight[Id])
+        if (m_Ring.IsRecording())
         {
-            pDeviceContext->End(m_pTimestampQueriesBegin[Id]);
+            pDeviceContext->End(m_Frames[m_Ring.GetWriteSlot()].pTimestampQueriesBegin[Id]);
         }
     }
 
     void StopTimer(ID3D11DeviceContext* pDeviceContext, GpuTimeRegimeIndex Id)
     {
-        if (!m_TimestampQueryInFlight[Id])
+        if (m_Ring.IsRecording())
         {
-            pDeviceContext->End(m_pTimestampQueriesEnd[Id]);
+            FrameQueries& Frame = m_Frames[m_Ring.GetWriteSlot()];
+            pDeviceContext->End(Frame.pTimestampQueriesEnd[Id]);
+            Frame.TimestampQueryUsed[Id] = true;
         }
-        m_TimestampQueryInFlight[Id] = true;
     }
 
 private:
-    bool m_DisjointQueryInFlight;
-    bool m_TimestampQueryInFlight[REGIME_TIME_COUNT];
-    ID3D11Query* m_pDisjointTimestampQuery;
-    ID3D11Query* m_pTimestampQueriesBegin[REGIME_TIME_COUNT];
-    ID3D11Query* m_pTimestampQueriesEnd[REGIME_TIME_COUNT];
+    struct FrameQueries
+    {
+        bool TimestampQueryUsed[REGIME_TIME_COUNT];
+        ID3D11Query* pDisjointTimestampQuery;
+        ID3D11Query* pTimestampQueriesBegin[REGIME_TIME_COUNT];
+        ID3D11Query* pTimestampQueriesEnd[REGIME_TIME_COUNT];
+    };
+
+    TimestampQueryRing m_Ring;
+    FrameQueries m_Frames[TimestampQueryRing::FRAMES_IN_FLIGHT];
 };
 
 //--------------------------------------------------------------------------------
@@ -193,7 +218,421 @@ private:
 
 #endif //SUPPORT_D3D11
 
+#if SUPPORT_D3D12
+
+namespace D3D12
+{
+
+//--------------------------------------------------------------------------------
+// One query heap and one readback buffer hold the timestamps of all the slots of the ring.
+// The timestamps of a slot are resolved into the readback buffer at the end of the command list of RenderAO.
+// Since the library does not execute that command list, the next RenderAO call signals a fence of its own
+// on the queue, and the slot is read once the GPU has reached that fence value.
+// The app may not have executed the command list by then (RenderAO recorded twice into one command list,
+// or frames recorded ahead), so the slot is cleared when it is recycled, and a slot whose resolved
+// timestamps are missing is fenced again by the next RenderAO call, up to MAX_READBACK_ATTEMPTS times.
+//--------------------------------------------------------------------------------
+class TimestampQueries
+{
+public:
+    TimestampQueries()
+        : m_pQueryHeap(NULL)
+        , m_pReadbackBuffer(NULL)
+        , m_pReadbackFence(NULL)
+    {
+    }
+
+    void Create(GFSDK_D3D12_GraphicsContext* pGraphicsContext)
+    {
+        D3D12_QUERY_HEAP_DESC QueryHeapDesc = {};
+        QueryHeapDesc.Type = D3D12_QUERY_HEAP_TYPE_TIMESTAMP;
+        QueryHeapDesc.Count = TimestampQueryRing::FRAMES_IN_FLIGHT * 2 * REGIME_TIME_COUNT;
+        QueryHeapDesc.NodeMask = pGraphicsContext->NodeMask;
+        THROW_IF_FAILED(pGraphicsContext->pDevice->CreateQueryHeap(&QueryHeapDesc, IID_PPV_ARGS(&m_pQueryHeap)));
+
+        THROW_IF_FAILED(pGraphicsContext->pDevice->CreateCommittedResource(
+            &CD3DX12_HEAP_PROPERTIES(D3D12_HEAP_TYPE_READBACK, pGraphicsContext->NodeMask, pGraphicsContext->NodeMask),
+            D3D12_HEAP_FLAG_NONE,
+            &CD3DX12_RESOURCE_DESC::Buffer(sizeof(UINT64) * TimestampQueryRing::FRAMES_IN_FLIGHT * 2 * REGIME_TIME_COUNT),
+            D3D12_RESOURCE_STATE_COPY_DEST,
+            nullptr,
+            IID_PPV_ARGS(&m_pReadbackBuffer)));
+
+        THROW_IF_FAILED(pGraphicsContext->pDevice->CreateFence(0, D3D12_FENCE_FLAG_NONE, IID_PPV_ARGS(&m_pReadbackFence)));
+
+#if _DEBUG
+        m_pQueryHeap->SetName(L"SSAOTimestampQueryHeap");
+        m_pReadbackBuffer->SetName(L"SSAOTimestampReadbackBuffer");
+        m_pReadbackFence->SetName(L"SSAOTimestampReadbackFence");
+#endif
+
+        m_Ring.Reset();
+        m_Frequency = 0;
+        m_ReadbackFenceValue = 0;
+        ZERO_ARRAY(m_Frames);
+    }
+
+    void Release()
+    {
+        SAFE_RELEASE(m_pQueryHeap);
+        SAFE_RELEASE(m_pReadbackBuffer);
+        SAFE_RELEASE(m_pReadbackFence);
+    }
+
+    void Begin(GFSDK_D3D12_GraphicsContext* pGraphicsContext)
+    {
+        // Fence the slots recorded since the previous signal, and the ones to read again
+        bool Signal = false;
+        for (UINT i = 0; i < m_Ring.GetNumInFlight(); ++i)
+        {
+            FrameQueries& Frame = m_Frames[(m_Ring.GetOldestSlot() + i) % TimestampQueryRing::FRAMES_IN_FLIGHT];
+            if (!Frame.ReadbackFenceValue)
+            {
+                Frame.ReadbackFenceValue = m_ReadbackFenceValue + 1;
+                Signal = true;
+            }
+        }
+
+        if (Signal)
+        {
+            ++m_ReadbackFenceValue;
+            THROW_IF_FAILED(pGraphicsContext->pCmdQueue->Signal(m_pReadbackFence, m_ReadbackFenceValue));
+        }
+
+        if (m_Ring.BeginFrame())
+        {
+            const UINT Slot = m_Ring.GetWriteSlot();
+            ZERO_ARRAY(m_Frames[Slot].TimestampQueryUsed);
+            m_Frames[Slot].NumReadbackAttempts = 0;
+
+            // Zero timestamps mark the queries as not resolved yet
+            UINT64* pTimestamps = NULL;
+            D3D12_RANGE ReadRange = { 0, 0 };
+            THROW_IF_FAILED(m_pReadbackBuffer->Map(0, &ReadRange, (void**)&pTimestamps));
+            memset(pTimestamps + GetQueryIndex(Slot, 0), 0, GetSlotSize());
+            D3D12_RANGE WrittenRange = GetSlotRange(Slot);
+            m_pReadbackBuffer->Unmap(0, &WrittenRange);
+        }
+    }
+
+    void End(GFSDK_D3D12_GraphicsContext* pGraphicsContext, SSAO::RenderTimesHistory* pRenderTimes)
+    {
+        if (m_Ring.IsRecording())
+        {
+            const UINT Slot = m_Ring.GetWriteSlot();
+            FrameQueries& Frame = m_Frames[Slot];
+
+            bool Submit = false;
+            for (UINT i = 0; i < REGIME_TIME_COUNT; ++i)
+            {
+                if (Frame.TimestampQueryUsed[i])
+                {
+                    const UINT QueryIndex = GetQueryIndex(Slot, i);
+                    pGraphicsContext->pCmdList->ResolveQueryData(m_pQueryHeap, D3D12_QUERY_TYPE_TIMESTAMP, QueryIndex, 2, m_pReadbackBuffer, sizeof(UINT64) * QueryIndex);
+                    Submit = true;
+                }
+            }
+
+            if (Submit)
+            {
+                THROW_IF_FAILED(pGraphicsContext->pCmdQueue->GetTimestampFrequency(&m_Frequency));
+            }
+            Frame.ReadbackFenceValue = 0;
+            m_Ring.EndFrame(Submit);
+        }
+
+        while (m_Ring.GetNumInFlight())
+        {
+            const UINT Slot = m_Ring.GetOldestSlot();
+            FrameQueries& Frame = m_Frames[Slot];
+
+            if (!Frame.ReadbackFenceValue ||
+                m_pReadbackFence->GetCompletedValue() < Frame.ReadbackFenceValue)
+            {
+                break;
+            }
+
+            SSAO::RenderTimes FrameTimes;
+            bool Resolved = true;
+
+            UINT64* pTimestamps = NULL;
+            D3D12_RANGE ReadRange = GetSlotRange(Slot);
+            THROW_IF_FAILED(m_pReadbackBuffer->Map(0, &ReadRange, (void**)&pTimestamps));
+
+            const double InvFrequencyMS = 1000.0 / m_Frequency;
+            for (UINT i = 0; i < REGIME_TIME_COUNT; ++i)
+            {
+                if (Frame.TimestampQueryUsed[i])
+                {
+                    const UINT QueryIndex = GetQueryIndex(Slot, i);
+                    const UINT64 BeginTimestamp = pTimestamps[QueryIndex];
+                    const UINT64 EndTimestamp = pTimestamps[QueryIndex + 1];
+                    if (!BeginTimestamp || EndTimestamp < BeginTimestamp)
+                    {
+                        Resolved = false;
+                        break;
+                    }
+                    FrameTimes.TimeMS[i] = float(double(EndTimestamp - BeginTimestamp) * InvFrequencyMS);
+                }
+            }
+
+            D3D12_RANGE WrittenRange = { 0, 0 };
+            m_pReadbackBuffer->Unmap(0, &WrittenRange);
+
+            if (!Resolved && ++Frame.NumReadbackAttempts < MAX_READBACK_ATTEMPTS)
+            {
+                // The command list was not executed before the fence, try again after the next one
+                Frame.ReadbackFenceValue = 0;
+                break;
+            }
+
+            m_Ring.PopOldestSlot();
+
+            if (Resolved)
+            {
+                pRenderTimes->Add(FrameTimes);
+            }
+        }
+    }
+
+    void StartTimer(ID3D12GraphicsCommandList* pCmdList, GpuTimeRegimeIndex Id)
+    {
+        if (m_Ring.IsRecording())
+        {
+            pCmdList->EndQuery(m_pQueryHeap, D3D12_QUERY_TYPE_TIMESTAMP, GetQueryIndex(m_Ring.GetWriteSlot(), Id));
+        }
+    }
+
+    void StopTimer(ID3D12GraphicsCommandList* pCmdList, GpuTimeRegimeIndex Id)
+    {
+        if (m_Ring.IsRecording())
+        {
+            pCmdList->EndQuery(m_pQueryHeap, D3D12_QUERY_TYPE_TIMESTAMP, GetQueryIndex(m_Ring.GetWriteSlot(), Id) + 1);
+            m_Frames[m_Ring.GetWriteSlot()].TimestampQueryUsed[Id] = true;
+        }
+    }
+
+private:
+    static const UINT MAX_READBACK_ATTEMPTS = TimestampQueryRing::FRAMES_IN_FLIGHT;
+
+    // Index of the begin timestamp of a regime in the query heap, followed by its end timestamp
+    static UINT GetQueryIndex(UINT Slot, UINT Id)
+    {
+        return 2 * (Slot * REGIME_TIME_COUNT + Id);
+    }
+
+    static SIZE_T GetSlotSize()
+    {
+        return sizeof(UINT64) * 2 * REGIME_TIME_COUNT;
+    }
+
+    static D3D12_RANGE GetSlotRange(UINT Slot)
+    {
+        const SIZE_T SlotOffset = sizeof(UINT64) * GetQueryIndex(Slot, 0);
+        D3D12_RANGE Range = { SlotOffset, SlotOffset + GetSlotSize() };
+        return Range;
+    }
+
+    struct FrameQueries
+    {
+        bool TimestampQueryUsed[REGIME_TIME_COUNT];
+        UINT64 ReadbackFenceValue;
+        UINT NumReadbackAttempts;
+    };
+
+    TimestampQueryRing m_Ring;
+    FrameQueries m_Frames[TimestampQueryRing::FRAMES_IN_FLIGHT];
+    UINT64 m_Frequency;
+    UINT64 m_ReadbackFenceValue;
+    ID3D12QueryHeap* m_pQueryHeap;
+    ID3D12Resource* m_pReadbackBuffer;
+    ID3D12Fence* m_pReadbackFence;
+};
+
+//--------------------------------------------------------------------------------
+class GPUTimer
+{
+public:
+    GPUTimer(TimestampQueries* pTimestampQueries, ID3D12GraphicsCommandList* pCmdList, GpuTimeRegimeIndex Id)
+        : m_pTimestampQueries(pTimestampQueries)
+        , m_pCmdList(pCmdList)
+        , m_GpuTimeRegimeIndex(Id)
+    {
+        m_pTimestampQueries->StartTimer(m_pCmdList, m_GpuTimeRegimeIndex);
+    }
+
+    ~GPUTimer()
+    {
+        m_pTimestampQueries->StopTimer(m_pCmdList, m_GpuTimeRegimeIndex);
+    }
+
+private:
+    TimestampQueries* m_pTimestampQueries;
+    ID3D12GraphicsCommandList* m_pCmdList;
+    GpuTimeRegimeIndex m_GpuTimeRegimeIndex;
+};
+
+} //namespace D3D12
+
+#endif //SUPPORT_D3D12
+
+#if SUPPORT_GL
+
+namespace GL
+{
+
+//--------------------------------------------------------------------------------
+// GL_TIMESTAMP queries (GL 3.3 or ARB_timer_query). GL has no disjoint query, so a slot
+// is read back once the end timestamps of all its regimes are available.
+//--------------------------------------------------------------------------------
+class TimestampQueries
+{
+public:
+    TimestampQueries()
+        : m_pGL(NULL)
+    {
+    }
+
+    void Create(const GFSDK_SSAO_GLFunctions& GL)
+    {
+        m_pGL = &GL;
+
+        for (UINT Slot = 0; Slot < TimestampQueryRing::FRAMES_IN_FLIGHT; ++Slot)
+        {
+            FrameQueries& Frame = m_Frames[Slot];
+            GL.glGenQueries(REGIME_TIME_COUNT, Frame.TimestampQueriesBegin);
+            GL.glGenQueries(REGIME_TIME_COUNT, Frame.TimestampQueriesEnd);
+            ZERO_ARRAY(Frame.TimestampQueryUsed);
+        }
+
+        m_Ring.Reset();
+    }
+
+    void Release(const GFSDK_SSAO_GLFunctions& GL)
+    {
+        for (UINT Slot = 0; Slot < TimestampQueryRing::FRAMES_IN_FLIGHT; ++Slot)
+        {
+            FrameQueries& Frame = m_Frames[Slot];
+            GL.glDeleteQueries(REGIME_TIME_COUNT, Frame.TimestampQueriesBegin);
+            GL.glDeleteQueries(REGIME_TIME_COUNT, Frame.TimestampQueriesEnd);
+        }
+        m_pGL = NULL;
+    }
+
+    void Begin()
+    {
+        if (m_Ring.BeginFrame())
+        {
+            ZERO_ARRAY(m_Frames[m_Ring.GetWriteSlot()].TimestampQueryUsed);
+        }
+    }
+
+    void End(SSAO::RenderTimesHistory* pRenderTimes)
+    {
+        if (m_Ring.IsRecording())
+        {
+            bool Submit = false;
+            for (UINT i = 0; i < REGIME_TIME_COUNT; ++i)
+            {
+                Submit = Submit || m_Frames[m_Ring.GetWriteSlot()].TimestampQueryUsed[i];
+            }
+            m_Ring.EndFrame(Submit);
+        }
+
+        while (m_Ring.GetNumInFlight())
+        {
+            FrameQueries& Frame = m_Frames[m_Ring.GetOldestSlot()];
+
+            for (UINT i = 0; i < REGIME_TIME_COUNT; ++i)
+            {
+                if (Frame.TimestampQueryUsed[i])
+                {
+                    GLint Available = GL_FALSE;
+                    m_pGL->glGetQueryObjectiv(Frame.TimestampQueriesEnd[i], GL_QUERY_RESULT_AVAILABLE, &Available);
+                    if (!Available)
+                    {
+                        return;
+                    }
+                }
+            }
+
+            m_Ring.PopOldestSlot();
+
+            SSAO::RenderTimes FrameTimes;
+
+            for (UINT i = 0; i < REGIME_TIME_COUNT; ++i)
+            {
+                if (Frame.TimestampQueryUsed[i])
+                {
+                    GLuint64 TimestampValueBegin = 0;
+                    GLuint64 TimestampValueEnd = 0;
+                    m_pGL->glGetQueryObjectui64v(Frame.TimestampQueriesBegin[i], GL_QUERY_RESULT, &TimestampValueBegin);
+                    m_pGL->glGetQueryObjectui64v(Frame.TimestampQueriesEnd[i], GL_QUERY_RESULT, &TimestampValueEnd);
+
+                    // GL timestamps are in nanoseconds
+                    FrameTimes.TimeMS[i] = float(double(TimestampValueEnd - TimestampValueBegin) * 1.e-6);
+                }
+            }
+
+            pRenderTimes->Add(FrameTimes);
+        }
+    }
+
+    void StartTimer(GpuTimeRegimeIndex Id)
+    {
+        if (m_Ring.IsRecording())
+        {
+            m_pGL->glQueryCounter(m_Frames[m_Ring.GetWriteSlot()].TimestampQueriesBegin[Id], GL_TIMESTAMP);
+        }
+    }
+
+    void StopTimer(GpuTimeRegimeIndex Id)
+    {
+        if (m_Ring.IsRecording())
+        {
+            FrameQueries& Frame = m_Frames[m_Ring.GetWriteSlot()];
+            m_pGL->glQueryCounter(Frame.TimestampQueriesEnd[Id], GL_TIMESTAMP);
+            Frame.TimestampQueryUsed[Id] = true;
+        }
+    }
+
+private:
+    struct FrameQueries
+    {
+        bool TimestampQueryUsed[REGIME_TIME_COUNT];
+        GLuint TimestampQueriesBegin[REGIME_TIME_COUNT];
+        GLuint TimestampQueriesEnd[REGIME_TIME_COUNT];
+    };
+
+    const GFSDK_SSAO_GLFunctions* m_pGL;
+    TimestampQueryRing m_Ring;
+    FrameQueries m_Frames[TimestampQueryRing::FRAMES_IN_FLIGHT];
+};
+
+//--------------------------------------------------------------------------------
+class GPUTimer
+{
+public:
+    GPUTimer(TimestampQueries* pTimestampQueries, GpuTimeRegimeIndex Id)
+        : m_pTimestampQueries(pTimestampQueries)
+        , m_GpuTimeRegimeIndex(Id)
+    {
+        m_pTimestampQueries->StartTimer(m_GpuTimeRegimeIndex);
+    }
+
+    ~GPUTimer()
+    {
+        m_pTimestampQueries->StopTimer(m_GpuTimeRegimeIndex);
+    }
+
+private:
+    TimestampQueries* m_pTimestampQueries;
+    GpuTimeRegimeIndex m_GpuTimeRegimeIndex;
+};
+
+} //namespace GL
+
+#endif //SUPPORT_GL
+
 } // namespace SSAO
 } // namespace GFSDK
-
-#endif // ENABLE_RENDER_TIMES
@@ -228,5 +228,116 @@ struct UserTextureRTV : public SSAO::UserTextureDesc
 } // namespace D3D12
 #endif // SUPPORT_D3D12
 
+//--------------------------------------------------------------------------------
+#if SUPPORT_CPU
+namespace CPU
+{
+
+//--------------------------------------------------------------------------------
+// Host texels are addressed in floats: Texel(X,Y) = pData + Y * RowPitch + X * PixelStride
+//--------------------------------------------------------------------------------
+struct UserTextureSRV : public SSAO::UserTextureDesc
+{
+    UserTextureSRV()
+        : pData(NULL)
+        , RowPitch(0)
+        , PixelStride(0)
+        , NumChannels(0)
+    {
+    }
+
+    GFSDK_SSAO_Status Init(const GFSDK_SSAO_ShaderResourceView_CPU* pInputSRV, UINT MinNumChannels = 1)
+    {
+        if (!pInputSRV || !pInputSRV->pData)
+        {
+            return GFSDK_SSAO_NULL_ARGUMENT;
+        }
+
+        const UINT NumSamples = Max(pInputSRV->SampleCount, 1u);
+        if (pInputSRV->NumChannels < MinNumChannels)
+        {
+            return GFSDK_SSAO_CPU_INVALID_TEXTURE_LAYOUT;
+        }
+
+        const UINT PackedRowPitch = pInputSRV->Width * NumSamples * pInputSRV->NumChannels;
+        if (pInputSRV->RowPitch % sizeof(FLOAT) != 0 ||
+            (pInputSRV->RowPitch != 0 && pInputSRV->RowPitch / sizeof(FLOAT) < PackedRowPitch))
+        {
+            return GFSDK_SSAO_CPU_INVALID_TEXTURE_LAYOUT;
+        }
+
+        pData = pInputSRV->pData;
+        Width = pInputSRV->Width;
+        Height = pInputSRV->Height;
+        SampleCount = NumSamples;
+        NumChannels = pInputSRV->NumChannels;
+        PixelStride = NumSamples * NumChannels;
+        RowPitch = pInputSRV->RowPitch ? UINT(pInputSRV->RowPitch / sizeof(FLOAT)) : PackedRowPitch;
+
+        return GFSDK_SSAO_OK;
+    }
+
+    bool IsSet() const
+    {
+        return (pData != NULL);
+    }
+
+    const FLOAT* pData;
+    UINT RowPitch;
+    UINT PixelStride;
+    UINT NumChannels;
+};
+
+struct UserTextureRTV : public SSAO::UserTextureDesc
+{
+    UserTextureRTV()
+        : pData(NULL)
+        , RowPitch(0)
+        , NumChannels(0)
+    {
+    }
+
+    GFSDK_SSAO_Status Init(GFSDK_SSAO_RenderTargetView_CPU* pInputRTV)
+    {
+        if (!pInputRTV || !pInputRTV->pData)
+        {
+            return GFSDK_SSAO_NULL_ARGUMENT;
+        }
+
+        if (pInputRTV->NumChannels < 1 || pInputRTV->NumChannels > 4)
+        {
+            return GFSDK_SSAO_CPU_INVALID_TEXTURE_LAYOUT;
+        }
+
+        const UINT PackedRowPitch = pInputRTV->Width * pInputRTV->NumChannels;
+        if (pInputRTV->RowPitch % sizeof(FLOAT) != 0 ||
+            (pInputRTV->RowPitch != 0 && pInputRTV->RowPitch / sizeof(FLOAT) < PackedRowPitch))
+        {
+            return GFSDK_SSAO_CPU_INVALID_TEXTURE_LAYOUT;
+        }
+
+        pData = pInputRTV->pData;
+        Width = pInputRTV->Width;
+        Height = pInputRTV->Height;
+        SampleCount = 1;
+        NumChannels = pInputRTV->NumChannels;
+        RowPitch = pInputRTV->RowPitch ? UINT(pInputRTV->RowPitch / sizeof(FLOAT)) : PackedRowPitch;
+
+        return GFSDK_SSAO_OK;
+    }
+
+    bool IsSet() const
+    {
+        return (pData != NULL);
+    }
+
+    FLOAT* pData;
+    UINT RowPitch;
+    UINT NumChannels;
+};
+
+} // namespace CPU
+#endif // SUPPORT_CPU
+
 } // namespace SSAO
 } // namespace GFSDK
@@ -0,0 +1,111 @@
+#!/bin/sh
+# Regenerates the shader permutations of src/*.hlsl with dxc and spirv-cross, for the platforms
+# that cannot run fxc.exe and HLSLcc.exe:
+#   out/DXIL   DXIL bytecode (API_D3D12)
+#   out/SPIRV  SPIR-V bytecode (API_VK)
+#   out/GLSL   GLSL 150 cross-compiled from the SPIR-V (API_GL, GLSLPrograms:: classes)
+#
+# Usage: build_shaders.sh [--jobs N] [--no-cache] [--cpp | --compress] [--permutations FILE] [dxil] [spirv] [glsl]
+#
+# All the targets are built by default. Each shader is written as ENTRY_POINT.h, ENTRY_POINT.bin
+# with the raw outputs, and a small ENTRY_POINT.cpp that links the .bin with GFSDK_SSAO_INCBIN
+# (src/ShaderBlob.h). --compress stores the .bin instances LZ4-compressed, and --cpp writes the
+# outputs as C++ arrays instead, for compilers without .incbin such as MSVC. The tools are found in PATH unless overridden with
+# SHADER_BUILD_TOOL, STRINGIFY, DXC and SPIRV_CROSS. SHADER_MODEL (default 6_0) and DXC_FLAGS
+# select the dxc target, for instance SHADER_MODEL=6_2 DXC_FLAGS=-enable-16bit-types.
+# SHADER_OUTPUT_DIR overrides the output root (default: the out directory next to this script).
+# --permutations only builds the values listed in FILE ("KEY VALUE..." lines) for these #permutation keys.
+
+SHADER_DIR=$(cd "$(dirname "$0")" && pwd)
+SHADER_OUTPUT_DIR=${SHADER_OUTPUT_DIR:-$SHADER_DIR/out}
+SHADER_MODEL=${SHADER_MODEL:-6_0}
+
+SBT_OPTIONS=--binary
+TARGETS=
+while [ $# -gt 0 ]; do
+    case "$1" in
+        --jobs) SBT_OPTIONS="$SBT_OPTIONS --jobs $2"; shift ;;
+        --no-cache) SBT_OPTIONS="$SBT_OPTIONS --no-cache" ;;
+        --cpp) SBT_OPTIONS=${SBT_OPTIONS#--binary} ;;
+        --compress) SBT_OPTIONS="$SBT_OPTIONS --compress" ;;
+        --permutations) SBT_OPTIONS="$SBT_OPTIONS --permutations $(cd "$(dirname "$2")" && pwd)/$(basename "$2")"; shift ;;
+        dxil|spirv|glsl) TARGETS="$TARGETS $1" ;;
+        *) echo "Usage: $0 [--jobs N] [--no-cache] [--cpp | --compress] [--permutations FILE] [dxil] [spirv] [glsl]" >&2; exit 1 ;;
+    esac
+    shift
+done
+TARGETS=${TARGETS:-dxil spirv glsl}
+
+# Resolves a tool to an absolute path, so that the compile tools and the cache see the same file
+find_tool()
+{
+    if ! command -v "$2" >/dev/null 2>&1; then
+        echo "$0: $2 not found (set $1)" >&2
+        exit 1
+    fi
+    command -v "$2"
+}
+
+SHADER_BUILD_TOOL=$(find_tool SHADER_BUILD_TOOL "${SHADER_BUILD_TOOL:-ShaderBuildTool}") || exit 1
+STRINGIFY=$(find_tool STRINGIFY "${STRINGIFY:-Stringify}") || exit 1
+DXC=$(find_tool DXC "${DXC:-dxc}") || exit 1
+export STRINGIFY DXC
+
+# PROFILE ENTRY_POINT of the D3D shaders, and ENTRY_POINT of the GL ones (as in the vcxproj files)
+D3D_SHADERS="
+vs FullScreenTriangle_VS
+ps CopyDepth_PS
+ps LinearizeDepth_PS
+ps DeinterleaveDepth_PS
+ps DebugNormals_PS
+ps ReconstructNormal_PS
+ps ReinterleaveAO_PS
+ps BlurX_PS
+ps BlurY_PS
+ps CoarseAO_PS
+gs CoarseAO_GS
+ps DebugAO_PS
+"
+GL_SHADERS="
+CopyDepth_PS
+LinearizeDepth_PS
+DeinterleaveDepth_PS
+DebugNormals_PS
+ReconstructNormal_PS
+ReinterleaveAO_PS
+BlurX_PS
+BlurY_PS
+CoarseAO_PS
+"
+
+# build_shader PROFILE ENTRY_POINT OUTPUT_DIR COMPILE_TOOL API [CLASS_NAME] [--compiler FILE]...
+build_shader()
+{
+    PROFILE=$1 ENTRY_POINT=$2 OUTPUT_DIR=$3 COMPILE_TOOL=$4 API=$5 CLASS_NAME=$6
+    shift 6
+    mkdir -p "$OUTPUT_DIR" &&
+    "$SHADER_BUILD_TOOL" $SBT_OPTIONS \
+        --compiler "$DXC" --compiler "$STRINGIFY" --compiler "$SHADER_DIR/helper_dxc.sh" --compiler "$SHADER_DIR/$COMPILE_TOOL" "$@" \
+        "$PROFILE" "$SHADER_DIR/src/$ENTRY_POINT.hlsl" "$ENTRY_POINT" "$OUTPUT_DIR" \
+        "sh '$SHADER_DIR/$COMPILE_TOOL' $DXC_FLAGS" "$API" $CLASS_NAME
+}
+
+for TARGET in $TARGETS; do
+    case "$TARGET" in
+        dxil|spirv)
+            if [ "$TARGET" = dxil ]; then API=D3D12; OUTPUT_DIR=$SHADER_OUTPUT_DIR/DXIL; else API=VK; OUTPUT_DIR=$SHADER_OUTPUT_DIR/SPIRV; fi
+            echo "$D3D_SHADERS" | while read -r STAGE ENTRY_POINT; do
+                [ -n "$ENTRY_POINT" ] || continue
+                build_shader "${STAGE}_$SHADER_MODEL" "$ENTRY_POINT" "$OUTPUT_DIR" "compile_$TARGET.sh" "$API" "" || exit 1
+            done || exit 1
+            ;;
+        glsl)
+            SPIRV_CROSS=$(find_tool SPIRV_CROSS "${SPIRV_CROSS:-spirv-cross}") || exit 1
+            export SPIRV_CROSS
+            for ENTRY_POINT in $GL_SHADERS; do
+                build_shader "ps_$SHADER_MODEL" "$ENTRY_POINT" "$SHADER_OUTPUT_DIR/GLSL" compile_glsl.sh GL "GLSLPrograms::$ENTRY_POINT" \
+                    --compiler "$SPIRV_CROSS" || exit 1
+            done
+            ;;
+    esac
+done
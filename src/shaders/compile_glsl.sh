@@ -0,0 +1,23 @@
+#!/bin/sh
+# ShaderBuildTool compile tool: compiles a shader instance to SPIR-V with dxc, cross-compiles it
+# to GLSL 150 with spirv-cross, and writes the source text to SBT_OUTPUT as a string named
+# SBT_VARIABLE_NAME (or as is, with SBT_FORMAT=BINARY). The arguments are passed on to dxc.
+
+SPIRV_CROSS=${SPIRV_CROSS:-spirv-cross}
+STRINGIFY=${STRINGIFY:-Stringify}
+OUTPUT_OBJ=$SBT_OUTPUT.spv
+OUTPUT_GLSL=$SBT_OUTPUT.glsl
+
+. "$(dirname "$0")/helper_dxc.sh"
+
+run_dxc -spirv -Fo "$OUTPUT_OBJ" "$@" &&
+"$SPIRV_CROSS" --version 150 --no-es --no-420pack-extension --output "$OUTPUT_GLSL" "$OUTPUT_OBJ" &&
+if [ "$SBT_FORMAT" = BINARY ]; then
+    mv "$OUTPUT_GLSL" "$SBT_OUTPUT"
+else
+    "$STRINGIFY" "$OUTPUT_GLSL" "$SBT_VARIABLE_NAME" "$SBT_OUTPUT"
+fi
+RESULT=$?
+
+rm -f "$OUTPUT_OBJ" "$OUTPUT_GLSL"
+exit $RESULT
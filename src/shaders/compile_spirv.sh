@@ -0,0 +1,21 @@
+#!/bin/sh
+# ShaderBuildTool compile tool: compiles a shader instance to SPIR-V with dxc, and writes it to
+# SBT_OUTPUT as an array named SBT_VARIABLE_NAME (or as is, with SBT_FORMAT=BINARY).
+# The arguments are passed on to dxc.
+
+STRINGIFY=${STRINGIFY:-Stringify}
+OUTPUT_OBJ=$SBT_OUTPUT.spv
+
+. "$(dirname "$0")/helper_dxc.sh"
+
+if [ "$SBT_FORMAT" = BINARY ]; then
+    run_dxc -spirv -Fo "$SBT_OUTPUT" "$@"
+    exit $?
+fi
+
+run_dxc -spirv -Fo "$OUTPUT_OBJ" "$@" &&
+"$STRINGIFY" --binary "$OUTPUT_OBJ" "$SBT_VARIABLE_NAME" "$SBT_OUTPUT"
+RESULT=$?
+
+rm -f "$OUTPUT_OBJ"
+exit $RESULT
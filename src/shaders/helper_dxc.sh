@@ -0,0 +1,23 @@
+# Sourced by the compile_*.sh tools of ShaderBuildTool. run_dxc compiles the SBT_* shader
+# instance with dxc, after mapping the fxc profile and /D defines to their dxc equivalents.
+# The arguments of run_dxc (output file, -spirv, ...) are appended to the dxc command line.
+
+DXC=${DXC:-dxc}
+
+run_dxc()
+{
+    # dxc starts at shader model 6.0
+    case "$SBT_PROFILE" in
+        *_4_0|*_4_1|*_5_0|*_5_1) DXC_PROFILE="${SBT_PROFILE%%_*}_6_0" ;;
+        *) DXC_PROFILE=$SBT_PROFILE ;;
+    esac
+
+    DXC_DEFINES=
+    for DEFINE in $SBT_DEFINES; do
+        DXC_DEFINES="$DXC_DEFINES -D ${DEFINE#/D}"
+    done
+
+    # HLSL 2018 keeps the fxc semantics the shaders were written for (no short-circuiting, vector ?:)
+    echo "dxc -T $DXC_PROFILE $SBT_INPUT -E $SBT_ENTRY_POINT$DXC_DEFINES $*"
+    "$DXC" -nologo -HV 2018 -O3 -T "$DXC_PROFILE" "$SBT_INPUT" -E "$SBT_ENTRY_POINT" $DXC_DEFINES "$@" >/dev/null
+}
@@ -33,6 +33,11 @@ struct BlurX_PS
 {
     void Create(DevicePointer Device);
     void Release(DevicePointer Device);
+    static bool IsBuilt(ShaderPermutations::ENABLE_SHARPNESS_PROFILE A, ShaderPermutations::KERNEL_RADIUS B)
+    {
+        return ((0x3u >> A) & (0x3u >> B) & 1) != 0;
+    }
+
     PixelShader& Get(ShaderPermutations::ENABLE_SHARPNESS_PROFILE A, ShaderPermutations::KERNEL_RADIUS B)
     {
         return m_Shader[A][B];
@@ -13,6 +13,11 @@ struct CoarseAO_GS
 {
     void Create(DevicePointer Device);
     void Release(DevicePointer Device);
+    static bool IsBuilt()
+    {
+        return true;
+    }
+
     GeometryShader& Get()
     {
         return m_Shader;
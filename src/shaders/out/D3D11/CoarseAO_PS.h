@@ -44,6 +44,11 @@ struct CoarseAO_PS
 {
     void Create(DevicePointer Device);
     void Release(DevicePointer Device);
+    static bool IsBuilt(ShaderPermutations::FETCH_GBUFFER_NORMAL A, ShaderPermutations::DEPTH_LAYER_COUNT B, ShaderPermutations::NUM_STEPS C)
+    {
+        return ((0x7u >> A) & (0x3u >> B) & (0x3u >> C) & 1) != 0;
+    }
+
     PixelShader& Get(ShaderPermutations::FETCH_GBUFFER_NORMAL A, ShaderPermutations::DEPTH_LAYER_COUNT B, ShaderPermutations::NUM_STEPS C)
     {
         return m_Shader[A][B][C];
@@ -24,6 +24,11 @@ struct DebugNormals_PS
 {
     void Create(DevicePointer Device);
     void Release(DevicePointer Device);
+    static bool IsBuilt(ShaderPermutations::FETCH_GBUFFER_NORMAL A)
+    {
+        return ((0x7u >> A) & 1) != 0;
+    }
+
     PixelShader& Get(ShaderPermutations::FETCH_GBUFFER_NORMAL A)
     {
         return m_Shader[A];
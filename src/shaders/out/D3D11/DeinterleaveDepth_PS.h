@@ -23,6 +23,11 @@ struct DeinterleaveDepth_PS
 {
     void Create(DevicePointer Device);
     void Release(DevicePointer Device);
+    static bool IsBuilt(ShaderPermutations::DEPTH_LAYER_COUNT A)
+    {
+        return ((0x3u >> A) & 1) != 0;
+    }
+
     PixelShader& Get(ShaderPermutations::DEPTH_LAYER_COUNT A)
     {
         return m_Shader[A];
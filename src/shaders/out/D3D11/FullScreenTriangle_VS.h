@@ -13,6 +13,11 @@ struct FullScreenTriangle_VS
 {
     void Create(DevicePointer Device);
     void Release(DevicePointer Device);
+    static bool IsBuilt()
+    {
+        return true;
+    }
+
     VertexShader& Get()
     {
         return m_Shader;
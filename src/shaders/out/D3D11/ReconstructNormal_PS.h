@@ -13,6 +13,11 @@ struct ReconstructNormal_PS
 {
     void Create(DevicePointer Device);
     void Release(DevicePointer Device);
+    static bool IsBuilt()
+    {
+        return true;
+    }
+
     PixelShader& Get()
     {
         return m_Shader;
@@ -33,6 +33,11 @@ struct ReinterleaveAO_PS
 {
     void Create(DevicePointer Device);
     void Release(DevicePointer Device);
+    static bool IsBuilt(ShaderPermutations::ENABLE_BLUR A, ShaderPermutations::DEPTH_LAYER_COUNT B)
+    {
+        return ((0x3u >> A) & (0x3u >> B) & 1) != 0;
+    }
+
     PixelShader& Get(ShaderPermutations::ENABLE_BLUR A, ShaderPermutations::DEPTH_LAYER_COUNT B)
     {
         return m_Shader[A][B];
@@ -23,6 +23,11 @@ struct CopyDepth_PS
 {
     void Create(DevicePointer Device);
     void Release(DevicePointer Device);
+    static bool IsBuilt(ShaderPermutations::RESOLVE_DEPTH A)
+    {
+        return ((0x3u >> A) & 1) != 0;
+    }
+
     GLSLPrograms::CopyDepth_PS& Get(ShaderPermutations::RESOLVE_DEPTH A)
     {
         return m_Shader[A];
@@ -13,6 +13,11 @@ struct DeinterleaveDepth_PS
 {
     void Create(DevicePointer Device);
     void Release(DevicePointer Device);
+    static bool IsBuilt()
+    {
+        return true;
+    }
+
     GLSLPrograms::DeinterleaveDepth_PS& Get()
     {
         return m_Shader;
@@ -23,6 +23,11 @@ struct ReinterleaveAO_PS
 {
     void Create(DevicePointer Device);
     void Release(DevicePointer Device);
+    static bool IsBuilt(ShaderPermutations::ENABLE_BLUR A)
+    {
+        return ((0x3u >> A) & 1) != 0;
+    }
+
     GLSLPrograms::ReinterleaveAO_PS& Get(ShaderPermutations::ENABLE_BLUR A)
     {
         return m_Shader[A];
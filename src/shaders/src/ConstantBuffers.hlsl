@@ -45,7 +45,7 @@ namespace SSAO {
 #else // __cplusplus
 
 #define CBUFFER cbuffer
-#define REGISTER(SLOT) : register(##SLOT##)
+#define REGISTER(SLOT) : register(SLOT)
 #define DECLARE_CONSTANT(TYPE, VARIABLE) TYPE g_##VARIABLE
 #define PAD_FLOAT
 #define PAD_FLOAT2
@@ -0,0 +1,193 @@
+// This code contains NVIDIA Confidential Information and is disclosed to you
+// under a form of NVIDIA software license agreement provided separately to you.
+//
+// Notice
+// NVIDIA Corporation and its licensors retain all intellectual property and
+// proprietary rights in and to this software and related documentation and
+// any modifications thereto. Any use, reproduction, disclosure, or
+// distribution of this software and related documentation without an express
+// license agreement from NVIDIA Corporation is strictly prohibited.
+//
+// ALL NVIDIA DESIGN SPECIFICATIONS, CODE ARE PROVIDED "AS IS.". NVIDIA MAKES
+// NO WARRANTIES, EXPRESSED, IMPLIED, STATUTORY, OR OTHERWISE WITH RESPECT TO
+// THE MATERIALS, AND EXPRESSLY DISCLAIMS ALL IMPLIED WARRANTIES OF NONINFRINGEMENT,
+// MERCHANTABILITY, AND FITNESS FOR A PARTICULAR PURPOSE.
+//
+// Information and code furnished is believed to be accurate and reliable.
+// However, NVIDIA Corporation assumes no responsibility for the consequences of use of such
+// information or for any infringement of patents or other rights of third parties that may
+// result from its use. No license is granted by implication or otherwise under any patent
+// or patent rights of NVIDIA Corporation. Details are subject to change without notice.
+// This code supersedes and replaces all information previously supplied.
+// NVIDIA Corporation products are not authorized for use as critical
+// components in life support devices or systems without express written approval of
+// NVIDIA Corporation.
+//
+// Copyright (c) 2008-2021 NVIDIA Corporation. All rights reserved.
+
+#include "TestScene.h"
+#include "ChromeTrace.h"
+
+#include <algorithm>
+#include <chrono>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+
+//--------------------------------------------------------------------------------
+// Times RenderAO on the CPU context for a few typical configurations.
+// Usage: GFSDK_SSAO_Benchmark_CPU [--width W] [--height H] [--frames N] [--threads T] [--trace FILE]
+// --trace writes the passes of every timed frame to FILE as Chrome trace-event JSON,
+// with one track per configuration, for chrome://tracing or ui.perfetto.dev.
+//--------------------------------------------------------------------------------
+
+struct BenchmarkConfig
+{
+    const char* pName;
+    GFSDK_SSAO_Algorithm Algorithm;
+    GFSDK_SSAO_DepthStorage DepthStorage;
+    bool EnableBlur;
+    bool EnableDualLayerAO;
+    bool EnableNormals;
+};
+
+static const BenchmarkConfig s_Configs[] =
+{
+    { "HBAO+",                  GFSDK_SSAO_HBAO_PLUS,  GFSDK_SSAO_FP16_VIEW_DEPTHS, false, false, false },
+    { "HBAO+ Blur",             GFSDK_SSAO_HBAO_PLUS,  GFSDK_SSAO_FP16_VIEW_DEPTHS, true,  false, false },
+    { "HBAO+ Blur FP32",        GFSDK_SSAO_HBAO_PLUS,  GFSDK_SSAO_FP32_VIEW_DEPTHS, true,  false, false },
+    { "HBAO+ Blur Normals",     GFSDK_SSAO_HBAO_PLUS,  GFSDK_SSAO_FP16_VIEW_DEPTHS, true,  false, true  },
+    { "HBAO+ Blur DualLayer",   GFSDK_SSAO_HBAO_PLUS,  GFSDK_SSAO_FP16_VIEW_DEPTHS, true,  true,  false },
+    { "LineSweep Blur",         GFSDK_SSAO_LINE_SWEEP, GFSDK_SSAO_FP32_VIEW_DEPTHS, true,  false, false },
+};
+
+//--------------------------------------------------------------------------------
+static bool ParseArgument(int argc, char** argv, int& ArgIndex, const char* pName, GFSDK_SSAO_UINT& Value)
+{
+    if (strcmp(argv[ArgIndex], pName) || ArgIndex + 1 >= argc)
+    {
+        return false;
+    }
+    Value = GFSDK_SSAO_UINT(atoi(argv[ArgIndex + 1]));
+    ArgIndex += 2;
+    return true;
+}
+
+//--------------------------------------------------------------------------------
+static bool ParseArgument(int argc, char** argv, int& ArgIndex, const char* pName, const char*& pValue)
+{
+    if (strcmp(argv[ArgIndex], pName) || ArgIndex + 1 >= argc)
+    {
+        return false;
+    }
+    pValue = argv[ArgIndex + 1];
+    ArgIndex += 2;
+    return true;
+}
+
+//--------------------------------------------------------------------------------
+int main(int argc, char** argv)
+{
+    GFSDK_SSAO_UINT Width = 1920;
+    GFSDK_SSAO_UINT Height = 1080;
+    GFSDK_SSAO_UINT NumFrames = 20;
+    GFSDK_SSAO_UINT NumThreads = 0;
+    const char* pTraceFileName = NULL;
+
+    for (int ArgIndex = 1; ArgIndex < argc; )
+    {
+        if (!ParseArgument(argc, argv, ArgIndex, "--width", Width) &&
+            !ParseArgument(argc, argv, ArgIndex, "--height", Height) &&
+            !ParseArgument(argc, argv, ArgIndex, "--frames", NumFrames) &&
+            !ParseArgument(argc, argv, ArgIndex, "--threads", NumThreads) &&
+            !ParseArgument(argc, argv, ArgIndex, "--trace", pTraceFileName))
+        {
+            fprintf(stderr, "Usage: %s [--width W] [--height H] [--frames N] [--threads T] [--trace FILE]\n", argv[0]);
+            return 1;
+        }
+    }
+    NumFrames = std::max(NumFrames, 1u);
+
+    const TestScene Scene(TestScene::CORNER, Width, Height);
+
+    GFSDK_SSAO_ContextDesc_CPU ContextDesc;
+    ContextDesc.NumThreads = NumThreads;
+
+    GFSDK_SSAO_Context_CPU* pAOContext = NULL;
+    GFSDK_SSAO_Status Status = GFSDK_SSAO_CreateContext_CPU(ContextDesc, &pAOContext);
+    if (Status != GFSDK_SSAO_OK)
+    {
+        fprintf(stderr, "GFSDK_SSAO_CreateContext_CPU failed (%d)\n", int(Status));
+        if (pAOContext)
+        {
+            pAOContext->Release();
+        }
+        return 1;
+    }
+
+    static const char* s_InstructionSetNames[] = { "Scalar", "SSE4.2", "AVX2", "AVX-512" };
+    printf("%ux%u, %u frames, %s kernels\n", Width, Height, NumFrames, s_InstructionSetNames[pAOContext->GetInstructionSet()]);
+    printf("%-24s %12s %12s %12s\n", "Configuration", "Min (ms)", "Median (ms)", "Max (ms)");
+
+    std::vector<float> Pixels(Width * Height * 4);
+    GFSDK_SSAO_RenderTargetView_CPU RenderTarget;
+    RenderTarget.pData = &Pixels[0];
+    RenderTarget.Width = Width;
+    RenderTarget.Height = Height;
+
+    GFSDK_SSAO_Output_CPU Output;
+    Output.pRenderTargetView = &RenderTarget;
+
+    ChromeTraceWriter Trace;
+
+    for (size_t ConfigIndex = 0; ConfigIndex < sizeof(s_Configs) / sizeof(s_Configs[0]); ++ConfigIndex)
+    {
+        const BenchmarkConfig& Config = s_Configs[ConfigIndex];
+
+        GFSDK_SSAO_Parameters Params;
+        Params.Radius = 2.f;
+        Params.Algorithm = Config.Algorithm;
+        Params.DepthStorage = Config.DepthStorage;
+        Params.Blur.Enable = Config.EnableBlur;
+        Params.EnableDualLayerAO = Config.EnableDualLayerAO;
+
+        const GFSDK_SSAO_InputData_CPU InputData = Scene.GetInputData(Config.EnableNormals);
+
+        // The first frame allocates the internal buffers
+        Status = pAOContext->RenderAO(InputData, Params, Output);
+        if (Status != GFSDK_SSAO_OK)
+        {
+            fprintf(stderr, "RenderAO failed for %s (%d)\n", Config.pName, int(Status));
+            pAOContext->Release();
+            return 1;
+        }
+
+        if (pTraceFileName)
+        {
+            pAOContext->SetProfilerHooks(Trace.AddContext(Config.pName));
+        }
+
+        std::vector<double> Times(NumFrames);
+        for (GFSDK_SSAO_UINT Frame = 0; Frame < NumFrames; ++Frame)
+        {
+            const std::chrono::high_resolution_clock::time_point Start = std::chrono::high_resolution_clock::now();
+            pAOContext->RenderAO(InputData, Params, Output);
+            const std::chrono::high_resolution_clock::time_point End = std::chrono::high_resolution_clock::now();
+            Times[Frame] = std::chrono::duration<double, std::milli>(End - Start).count();
+        }
+
+        std::sort(Times.begin(), Times.end());
+        printf("%-24s %12.2f %12.2f %12.2f\n", Config.pName, Times.front(), Times[Times.size() / 2], Times.back());
+    }
+
+    pAOContext->Release();
+
+    if (pTraceFileName && !Trace.Write(pTraceFileName))
+    {
+        fprintf(stderr, "Failed to write %s\n", pTraceFileName);
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,98 @@
+#
+# Runs src/shaders/build_shaders.sh with stand-ins for dxc and spirv-cross, and checks that every
+# target gets all its shaders, with the shader classes and arrays that the backends expect.
+# Then builds ShaderBlob_Test.cpp, which links the binary outputs with GFSDK_SSAO_INCBIN,
+# uncompressed and compressed.
+# Usage: cmake -DSHADER_BUILD_TOOL=... -DSTRINGIFY=... -DCXX=... -DSOURCE_DIR=... -DWORK_DIR=... -P BuildShaders_Test.cmake
+#
+file(REMOVE_RECURSE ${WORK_DIR})
+
+function(build_shaders OUTPUT_DIR)
+    execute_process(
+        COMMAND ${CMAKE_COMMAND} -E env
+                SHADER_BUILD_TOOL=${SHADER_BUILD_TOOL} STRINGIFY=${STRINGIFY} SHADER_OUTPUT_DIR=${OUTPUT_DIR}
+                DXC=${SOURCE_DIR}/test/FakeDxc.sh SPIRV_CROSS=${SOURCE_DIR}/test/FakeSpirvCross.sh
+                sh ${SOURCE_DIR}/src/shaders/build_shaders.sh --jobs 2 ${ARGN}
+        OUTPUT_QUIET
+        RESULT_VARIABLE RESULT)
+    if(NOT RESULT EQUAL 0)
+        message(FATAL_ERROR "build_shaders.sh failed: ${RESULT}")
+    endif()
+endfunction()
+
+function(check_file FILE REGEX EXPECTED_COUNT)
+    file(READ ${FILE} CONTENTS)
+    string(REGEX MATCHALL "${REGEX}" MATCHES "${CONTENTS}")
+    list(LENGTH MATCHES COUNT)
+    if(NOT COUNT EQUAL EXPECTED_COUNT)
+        message(FATAL_ERROR "Expected ${EXPECTED_COUNT} match(es) of ${REGEX} in ${FILE}, got ${COUNT}")
+    endif()
+endfunction()
+
+#--------------------------------------------------------------------------------
+# C++ arrays (--cpp)
+#--------------------------------------------------------------------------------
+build_shaders(${WORK_DIR}/cpp --cpp)
+set(OUT ${WORK_DIR}/cpp)
+
+foreach(DIR DXIL SPIRV)
+    file(GLOB HEADERS ${OUT}/${DIR}/*.h)
+    list(LENGTH HEADERS NUM_HEADERS)
+    if(NOT NUM_HEADERS EQUAL 12)
+        message(FATAL_ERROR "Expected 12 shaders in ${DIR}, got ${NUM_HEADERS}")
+    endif()
+    check_file(${OUT}/${DIR}/FullScreenTriangle_VS.h "VertexShader m_Shader" 1)
+    check_file(${OUT}/${DIR}/CoarseAO_GS.h "GeometryShader m_Shader" 1)
+endforeach()
+
+# The bytecode arrays have no terminating zero, and start with the (fake) "ps_6_0" profile
+check_file(${OUT}/DXIL/CoarseAO_PS.cpp "static const unsigned char g_CoarseAO_PS_[A-Z_0-9]+_D3D12\\[\\] =\n{0x70, 0x73, 0x5F, 0x36, 0x5F, 0x30, " 12)
+check_file(${OUT}/DXIL/CoarseAO_PS.cpp "\\.Create\\(Device, g_CoarseAO_PS_[A-Z_0-9]+_D3D12" 12)
+check_file(${OUT}/DXIL/CoarseAO_PS.cpp "0xA, }" 12)
+check_file(${OUT}/SPIRV/BlurX_PS.cpp "static const unsigned char g_BlurX_PS_[A-Z_0-9]+_VK\\[\\]" 4)
+
+file(GLOB HEADERS ${OUT}/GLSL/*.h)
+list(LENGTH HEADERS NUM_HEADERS)
+if(NOT NUM_HEADERS EQUAL 9)
+    message(FATAL_ERROR "Expected 9 shaders in GLSL, got ${NUM_HEADERS}")
+endif()
+check_file(${OUT}/GLSL/BlurX_PS.h "GLSLPrograms::BlurX_PS m_Shader" 1)
+check_file(${OUT}/GLSL/BlurX_PS.cpp "static const char g_BlurX_PS_[A-Z_0-9]+_GL\\[\\]" 4)
+check_file(${OUT}/GLSL/BlurX_PS.cpp "0xA, 0x0, }" 4)
+
+#--------------------------------------------------------------------------------
+# Binary outputs, linked with GFSDK_SSAO_INCBIN, and LZ4-compressed (--compress)
+#--------------------------------------------------------------------------------
+function(run_shader_blob_test OUT)
+    foreach(FILE DXIL/CoarseAO_PS.bin SPIRV/FullScreenTriangle_VS.bin GLSL/BlurX_PS.bin)
+        if(NOT EXISTS ${OUT}/${FILE})
+            message(FATAL_ERROR "Missing ${FILE}")
+        endif()
+    endforeach()
+    check_file(${OUT}/DXIL/CoarseAO_PS.cpp "GFSDK_SSAO_INCBIN\\(g_CoarseAO_PS_D3D12, \"CoarseAO_PS.bin\"\\)" 1)
+    check_file(${OUT}/DXIL/CoarseAO_PS.cpp "\\.Create\\(Device, g_CoarseAO_PS_D3D12_Index\\[[0-9]+\\]\\.GetData\\(\\)" 12)
+
+    execute_process(
+        COMMAND ${CXX} -O2 -I${SOURCE_DIR}/src -I${OUT} -DSHADER_OUTPUT_DIR="${OUT}"
+                ${SOURCE_DIR}/test/ShaderBlob_Test.cpp -o ${OUT}/ShaderBlob_Test
+        RESULT_VARIABLE RESULT)
+    if(NOT RESULT EQUAL 0)
+        message(FATAL_ERROR "Failed to build ShaderBlob_Test.cpp: ${RESULT}")
+    endif()
+    execute_process(COMMAND ${OUT}/ShaderBlob_Test RESULT_VARIABLE RESULT)
+    if(NOT RESULT EQUAL 0)
+        message(FATAL_ERROR "ShaderBlob_Test failed: ${RESULT}")
+    endif()
+endfunction()
+
+build_shaders(${WORK_DIR}/bin)
+run_shader_blob_test(${WORK_DIR}/bin)
+
+build_shaders(${WORK_DIR}/lz4 --compress)
+run_shader_blob_test(${WORK_DIR}/lz4)
+
+file(SIZE ${WORK_DIR}/bin/DXIL/CoarseAO_PS.bin SIZE)
+file(SIZE ${WORK_DIR}/lz4/DXIL/CoarseAO_PS.bin COMPRESSED_SIZE)
+if(NOT COMPRESSED_SIZE LESS SIZE)
+    message(FATAL_ERROR "CoarseAO_PS.bin is not compressed: ${COMPRESSED_SIZE} bytes, ${SIZE} uncompressed")
+endif()
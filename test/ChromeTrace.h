@@ -0,0 +1,234 @@
+// This code contains NVIDIA Confidential Information and is disclosed to you
+// under a form of NVIDIA software license agreement provided separately to you.
+//
+// Notice
+// NVIDIA Corporation and its licensors retain all intellectual property and
+// proprietary rights in and to this software and related documentation and
+// any modifications thereto. Any use, reproduction, disclosure, or
+// distribution of this software and related documentation without an express
+// license agreement from NVIDIA Corporation is strictly prohibited.
+//
+// ALL NVIDIA DESIGN SPECIFICATIONS, CODE ARE PROVIDED "AS IS.". NVIDIA MAKES
+// NO WARRANTIES, EXPRESSED, IMPLIED, STATUTORY, OR OTHERWISE WITH RESPECT TO
+// THE MATERIALS, AND EXPRESSLY DISCLAIMS ALL IMPLIED WARRANTIES OF NONINFRINGEMENT,
+// MERCHANTABILITY, AND FITNESS FOR A PARTICULAR PURPOSE.
+//
+// Information and code furnished is believed to be accurate and reliable.
+// However, NVIDIA Corporation assumes no responsibility for the consequences of use of such
+// information or for any infringement of patents or other rights of third parties that may
+// result from its use. No license is granted by implication or otherwise under any patent
+// or patent rights of NVIDIA Corporation. Details are subject to change without notice.
+// This code supersedes and replaces all information previously supplied.
+// NVIDIA Corporation products are not authorized for use as critical
+// components in life support devices or systems without express written approval of
+// NVIDIA Corporation.
+//
+// Copyright (c) 2008-2021 NVIDIA Corporation. All rights reserved.
+
+#pragma once
+#include "GFSDK_SSAO.h"
+
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <stdio.h>
+#include <string>
+#include <thread>
+#include <vector>
+
+//--------------------------------------------------------------------------------
+// Records the ranges and counters reported by the profiler hooks of one or more contexts,
+// and writes them as Chrome trace-event JSON, which chrome://tracing and ui.perfetto.dev open.
+//
+// Each context gets its own track (a trace "process"), with one row per thread that ran its
+// passes, and one counter row per pass time and per CPU phase (GFSDK_SSAO_ProfilerHooks::counter_).
+// The timestamps are host times, in microseconds since the writer was created.
+//--------------------------------------------------------------------------------
+class ChromeTraceWriter
+{
+public:
+    ChromeTraceWriter()
+        : m_StartTime(std::chrono::steady_clock::now())
+    {
+    }
+
+    // Returns the hooks to pass to GFSDK_SSAO_Context::SetProfilerHooks. They must not outlive the writer.
+    GFSDK_SSAO_ProfilerHooks AddContext(const char* pTrackName)
+    {
+        std::lock_guard<std::mutex> Guard(m_Lock);
+
+        m_Tracks.push_back(std::unique_ptr<Track>(new Track()));
+        Track& T = *m_Tracks.back();
+        T.pWriter = this;
+        T.Id = GFSDK_SSAO_UINT(m_Tracks.size());
+        T.Name = pTrackName;
+
+        GFSDK_SSAO_ProfilerHooks Hooks;
+        Hooks.begin_range_ = BeginRange;
+        Hooks.end_range_ = EndRange;
+        Hooks.counter_ = Counter;
+        Hooks.pUserData = &T;
+        return Hooks;
+    }
+
+    size_t GetNumEvents() const
+    {
+        std::lock_guard<std::mutex> Guard(m_Lock);
+        return m_Events.size();
+    }
+
+    bool Write(const char* pFileName) const
+    {
+        FILE* pFile = fopen(pFileName, "w");
+        if (!pFile)
+        {
+            return false;
+        }
+
+        std::lock_guard<std::mutex> Guard(m_Lock);
+
+        fprintf(pFile, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+
+        const char* pSeparator = "";
+        for (size_t TrackIndex = 0; TrackIndex < m_Tracks.size(); ++TrackIndex)
+        {
+            const Track& T = *m_Tracks[TrackIndex];
+            fprintf(pFile, "%s{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":%u,\"tid\":0,\"args\":{\"name\":\"%s\"}}",
+                pSeparator, T.Id, Escape(T.Name).c_str());
+            pSeparator = ",\n";
+        }
+
+        for (size_t ThreadIndex = 0; ThreadIndex < m_Threads.size(); ++ThreadIndex)
+        {
+            for (size_t TrackIndex = 0; TrackIndex < m_Tracks.size(); ++TrackIndex)
+            {
+                fprintf(pFile, "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":%u,\"tid\":%u,\"args\":{\"name\":\"Thread %u\"}}",
+                    pSeparator, m_Tracks[TrackIndex]->Id, GFSDK_SSAO_UINT(ThreadIndex + 1), GFSDK_SSAO_UINT(ThreadIndex + 1));
+            }
+        }
+
+        for (size_t EventIndex = 0; EventIndex < m_Events.size(); ++EventIndex)
+        {
+            const Event& E = m_Events[EventIndex];
+            switch (E.Phase)
+            {
+            case 'B':
+                fprintf(pFile, "%s{\"name\":\"%s\",\"ph\":\"B\",\"ts\":%.3f,\"pid\":%u,\"tid\":%u,\"args\":{\"color\":\"0x%08x\"}}",
+                    pSeparator, Escape(E.pName).c_str(), E.TimeUS, E.TrackId, E.ThreadId, E.Color);
+                break;
+            case 'E':
+                fprintf(pFile, "%s{\"ph\":\"E\",\"ts\":%.3f,\"pid\":%u,\"tid\":%u}",
+                    pSeparator, E.TimeUS, E.TrackId, E.ThreadId);
+                break;
+            case 'C':
+                fprintf(pFile, "%s{\"name\":\"%s\",\"ph\":\"C\",\"ts\":%.3f,\"pid\":%u,\"args\":{\"ms\":%.6f}}",
+                    pSeparator, Escape(E.pName).c_str(), E.TimeUS, E.TrackId, E.Value);
+                break;
+            }
+        }
+
+        fprintf(pFile, "\n]}\n");
+
+        return (fclose(pFile) == 0);
+    }
+
+private:
+    struct Track
+    {
+        ChromeTraceWriter* pWriter;
+        GFSDK_SSAO_UINT Id;
+        std::string Name;
+    };
+
+    struct Event
+    {
+        char Phase;             // 'B'egin, 'E'nd or 'C'ounter
+        const char* pName;      // Static string from the library
+        double TimeUS;
+        GFSDK_SSAO_UINT TrackId;
+        GFSDK_SSAO_UINT ThreadId;
+        GFSDK_SSAO_UINT Color;
+        float Value;
+    };
+
+    static void BeginRange(const char* pName, GFSDK_SSAO_UINT Color, void* /*pCommandList*/, void* pUserData)
+    {
+        const Track& T = *static_cast<const Track*>(pUserData);
+        T.pWriter->AddEvent('B', pName, T.Id, Color, 0.f);
+    }
+
+    static void EndRange(void* /*pCommandList*/, void* pUserData)
+    {
+        const Track& T = *static_cast<const Track*>(pUserData);
+        T.pWriter->AddEvent('E', "", T.Id, 0, 0.f);
+    }
+
+    static void Counter(const char* pName, GFSDK_SSAO_FLOAT Value, void* pUserData)
+    {
+        const Track& T = *static_cast<const Track*>(pUserData);
+        T.pWriter->AddEvent('C', pName, T.Id, 0, Value);
+    }
+
+    void AddEvent(char Phase, const char* pName, GFSDK_SSAO_UINT TrackId, GFSDK_SSAO_UINT Color, float Value)
+    {
+        const double TimeUS = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - m_StartTime).count();
+
+        std::lock_guard<std::mutex> Guard(m_Lock);
+
+        Event E;
+        E.Phase = Phase;
+        E.pName = pName;
+        E.TimeUS = TimeUS;
+        E.TrackId = TrackId;
+        E.ThreadId = GetThreadId();
+        E.Color = Color;
+        E.Value = Value;
+        m_Events.push_back(E);
+    }
+
+    // Small thread ids, in the order the threads first reported an event
+    GFSDK_SSAO_UINT GetThreadId()
+    {
+        const std::thread::id Id = std::this_thread::get_id();
+        for (size_t ThreadIndex = 0; ThreadIndex < m_Threads.size(); ++ThreadIndex)
+        {
+            if (m_Threads[ThreadIndex] == Id)
+            {
+                return GFSDK_SSAO_UINT(ThreadIndex + 1);
+            }
+        }
+        m_Threads.push_back(Id);
+        return GFSDK_SSAO_UINT(m_Threads.size());
+    }
+
+    static std::string Escape(const std::string& Text)
+    {
+        std::string Escaped;
+        for (size_t i = 0; i < Text.size(); ++i)
+        {
+            const unsigned char c = (unsigned char)Text[i];
+            if (c == '"' || c == '\\')
+            {
+                Escaped += '\\';
+                Escaped += char(c);
+            }
+            else if (c < 0x20)
+            {
+                char Code[8];
+                snprintf(Code, sizeof(Code), "\\u%04x", c);
+                Escaped += Code;
+            }
+            else
+            {
+                Escaped += char(c);
+            }
+        }
+        return Escaped;
+    }
+
+    const std::chrono::steady_clock::time_point m_StartTime;
+    mutable std::mutex m_Lock;
+    std::vector<std::unique_ptr<Track>> m_Tracks;
+    std::vector<std::thread::id> m_Threads;
+    std::vector<Event> m_Events;
+};
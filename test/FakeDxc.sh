@@ -0,0 +1,26 @@
+#!/bin/sh
+# Stand-in for dxc in the build_shaders.sh test: checks the profile and the defines, and writes
+# the shader instance to the -Fo file instead of compiling it, followed by filler that compresses.
+while [ $# -gt 0 ]; do
+    case "$1" in
+        -T) PROFILE=$2; shift ;;
+        -D) DEFINES="$DEFINES $2"; shift ;;
+        -Fo) OUTPUT=$2; shift ;;
+        -spirv) SPIRV=1 ;;
+    esac
+    shift
+done
+case "$PROFILE" in
+    [vpg]s_6_[0-9]) ;;
+    *) echo "FakeDxc: unexpected profile $PROFILE" >&2; exit 1 ;;
+esac
+case "$DEFINES" in
+    *API_*=1*) ;;
+    *) echo "FakeDxc: missing API define in$DEFINES" >&2; exit 1 ;;
+esac
+{
+    echo "$PROFILE$DEFINES${SPIRV:+ spirv}"
+    for i in 1 2 3 4 5 6 7 8 9 10 11 12 13 14 15 16 17 18 19 20; do
+        echo "// $i $PROFILE$DEFINES"
+    done
+} > "$OUTPUT"
@@ -0,0 +1,5 @@
+#!/bin/sh
+# Stand-in for compile_hlsl.bat in the ShaderBuildTool test: writes a dummy shader instance
+# to SBT_OUTPUT, and logs the instance to the file given as first argument.
+echo "$SBT_ENTRY_POINT $SBT_DEFINES" >> "$1"
+echo "static const BYTE $SBT_VARIABLE_NAME[] = { 0x00 }; // $SBT_PROFILE $SBT_DEFINES" > "$SBT_OUTPUT"
@@ -0,0 +1,12 @@
+#!/bin/sh
+# Stand-in for spirv-cross in the build_shaders.sh test: copies the input file to the --output file.
+while [ $# -gt 0 ]; do
+    case "$1" in
+        --output) OUTPUT=$2; shift ;;
+        --version) shift ;;
+        -*) ;;
+        *) INPUT=$1 ;;
+    esac
+    shift
+done
+{ echo "#version 150"; cat "$INPUT"; } > "$OUTPUT"
@@ -0,0 +1,167 @@
+// This code contains NVIDIA Confidential Information and is disclosed to you
+// under a form of NVIDIA software license agreement provided separately to you.
+//
+// Notice
+// NVIDIA Corporation and its licensors retain all intellectual property and
+// proprietary rights in and to this software and related documentation and
+// any modifications thereto. Any use, reproduction, disclosure, or
+// distribution of this software and related documentation without an express
+// license agreement from NVIDIA Corporation is strictly prohibited.
+//
+// ALL NVIDIA DESIGN SPECIFICATIONS, CODE ARE PROVIDED "AS IS.". NVIDIA MAKES
+// NO WARRANTIES, EXPRESSED, IMPLIED, STATUTORY, OR OTHERWISE WITH RESPECT TO
+// THE MATERIALS, AND EXPRESSLY DISCLAIMS ALL IMPLIED WARRANTIES OF NONINFRINGEMENT,
+// MERCHANTABILITY, AND FITNESS FOR A PARTICULAR PURPOSE.
+//
+// Information and code furnished is believed to be accurate and reliable.
+// However, NVIDIA Corporation assumes no responsibility for the consequences of use of such
+// information or for any infringement of patents or other rights of third parties that may
+// result from its use. No license is granted by implication or otherwise under any patent
+// or patent rights of NVIDIA Corporation. Details are subject to change without notice.
+// This code supersedes and replaces all information previously supplied.
+// NVIDIA Corporation products are not authorized for use as critical
+// components in life support devices or systems without express written approval of
+// NVIDIA Corporation.
+//
+// Copyright (c) 2008-2021 NVIDIA Corporation. All rights reserved.
+
+#include "PipelineCacheBlob.h"
+
+#include <stdio.h>
+#include <vector>
+
+static UINT s_NumFailures = 0;
+
+#define CHECK(exp) \
+    { if (!(exp)) { fprintf(stderr, "%s(%d): CHECK(%s) failed\n", __FILE__, __LINE__, #exp); ++s_NumFailures; } }
+
+using namespace GFSDK::SSAO;
+
+//--------------------------------------------------------------------------------
+static PipelineCacheDeviceInfo GetTestDevice()
+{
+    PipelineCacheDeviceInfo Device;
+    Device.API = PipelineCacheDeviceInfo::API_D3D12;
+    Device.VendorId = 0x10DE;
+    Device.DeviceId = 0x1B80;
+    Device.DriverVersionHigh = 0x001E000F;
+    Device.DriverVersionLow = 0x00155A5A;
+    return Device;
+}
+
+static std::vector<char> MakeBlob(const PipelineCacheDeviceInfo& Device, UINT DataSize)
+{
+    std::vector<char> Blob(PipelineCacheBlob::GetBlobSize(DataSize));
+    char* pData = static_cast<char*>(PipelineCacheBlob::GetData(Blob.data()));
+    for (UINT Index = 0; Index < DataSize; ++Index)
+    {
+        pData[Index] = char(Index * 7 + 3);
+    }
+    PipelineCacheBlob::WriteHeader(Blob.data(), Device, DataSize);
+    return Blob;
+}
+
+static GFSDK_SSAO_Status Validate(const std::vector<char>& Blob, const PipelineCacheDeviceInfo& Device, GFSDK_SSAO_SIZE_T BlobSize)
+{
+    const void* pData = NULL;
+    UINT DataSize = 0;
+    return PipelineCacheBlob::Validate(Blob.data(), BlobSize, Device, &pData, &DataSize);
+}
+
+static GFSDK_SSAO_Status Validate(const std::vector<char>& Blob, const PipelineCacheDeviceInfo& Device)
+{
+    return Validate(Blob, Device, Blob.size());
+}
+
+//--------------------------------------------------------------------------------
+static void TestRoundTrip()
+{
+    const UINT DataSize = 1000;
+    std::vector<char> Blob = MakeBlob(GetTestDevice(), DataSize);
+
+    const void* pData = NULL;
+    UINT ValidatedSize = 0;
+    CHECK(PipelineCacheBlob::Validate(Blob.data(), Blob.size(), GetTestDevice(), &pData, &ValidatedSize) == GFSDK_SSAO_OK);
+    CHECK(pData == PipelineCacheBlob::GetData(Blob.data()));
+    CHECK(ValidatedSize == DataSize);
+
+    // Empty data, as saved before any PSO was created
+    CHECK(Validate(MakeBlob(GetTestDevice(), 0), GetTestDevice()) == GFSDK_SSAO_OK);
+
+    // Unaligned blob, as it may be read into a file buffer at any offset
+    std::vector<char> Unaligned(Blob.size() + 1);
+    memcpy(Unaligned.data() + 1, Blob.data(), Blob.size());
+    CHECK(PipelineCacheBlob::Validate(Unaligned.data() + 1, Blob.size(), GetTestDevice(), &pData, &ValidatedSize) == GFSDK_SSAO_OK);
+    CHECK(pData == Unaligned.data() + 1 + sizeof(PipelineCacheBlob::Header));
+}
+
+//--------------------------------------------------------------------------------
+static void TestCorrupted()
+{
+    std::vector<char> Blob = MakeBlob(GetTestDevice(), 100);
+
+    // Truncated header or data
+    CHECK(Validate(Blob, GetTestDevice(), 0) == GFSDK_SSAO_PIPELINE_CACHE_CORRUPTED);
+    CHECK(Validate(Blob, GetTestDevice(), sizeof(PipelineCacheBlob::Header) - 1) == GFSDK_SSAO_PIPELINE_CACHE_CORRUPTED);
+    CHECK(Validate(Blob, GetTestDevice(), Blob.size() - 1) == GFSDK_SSAO_PIPELINE_CACHE_CORRUPTED);
+
+    // Trailing bytes
+    std::vector<char> Padded = Blob;
+    Padded.push_back(0);
+    CHECK(Validate(Padded, GetTestDevice()) == GFSDK_SSAO_PIPELINE_CACHE_CORRUPTED);
+
+    // Modified data
+    std::vector<char> Modified = Blob;
+    Modified[Modified.size() - 10] ^= 1;
+    CHECK(Validate(Modified, GetTestDevice()) == GFSDK_SSAO_PIPELINE_CACHE_CORRUPTED);
+
+    // Not a pipeline cache at all
+    std::vector<char> Garbage(Blob.size(), 'x');
+    CHECK(Validate(Garbage, GetTestDevice()) == GFSDK_SSAO_PIPELINE_CACHE_CORRUPTED);
+}
+
+//--------------------------------------------------------------------------------
+static void TestMismatch()
+{
+    std::vector<char> Blob = MakeBlob(GetTestDevice(), 100);
+
+    PipelineCacheDeviceInfo OtherDevice = GetTestDevice();
+    OtherDevice.DeviceId = 0x1E07;
+    CHECK(Validate(Blob, OtherDevice) == GFSDK_SSAO_PIPELINE_CACHE_MISMATCH);
+
+    PipelineCacheDeviceInfo OtherDriver = GetTestDevice();
+    OtherDriver.DriverVersionLow += 1;
+    CHECK(Validate(Blob, OtherDriver) == GFSDK_SSAO_PIPELINE_CACHE_MISMATCH);
+
+    // Saved by another build of the library
+    PipelineCacheBlob::Header H;
+    memcpy(&H, Blob.data(), sizeof(H));
+    H.LibraryVersion.Revision += 1;
+    std::vector<char> OtherLibrary = Blob;
+    memcpy(OtherLibrary.data(), &H, sizeof(H));
+    CHECK(Validate(OtherLibrary, GetTestDevice()) == GFSDK_SSAO_PIPELINE_CACHE_MISMATCH);
+
+    // Saved with another format version
+    memcpy(&H, Blob.data(), sizeof(H));
+    H.FormatVersion += 1;
+    std::vector<char> OtherFormat = Blob;
+    memcpy(OtherFormat.data(), &H, sizeof(H));
+    CHECK(Validate(OtherFormat, GetTestDevice()) == GFSDK_SSAO_PIPELINE_CACHE_MISMATCH);
+}
+
+//--------------------------------------------------------------------------------
+int main()
+{
+    TestRoundTrip();
+    TestCorrupted();
+    TestMismatch();
+
+    if (s_NumFailures)
+    {
+        fprintf(stderr, "%u check(s) failed\n", s_NumFailures);
+        return 1;
+    }
+
+    printf("All tests passed\n");
+    return 0;
+}
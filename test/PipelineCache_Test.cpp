@@ -0,0 +1,222 @@
+// This code contains NVIDIA Confidential Information and is disclosed to you
+// under a form of NVIDIA software license agreement provided separately to you.
+//
+// Notice
+// NVIDIA Corporation and its licensors retain all intellectual property and
+// proprietary rights in and to this software and related documentation and
+// any modifications thereto. Any use, reproduction, disclosure, or
+// distribution of this software and related documentation without an express
+// license agreement from NVIDIA Corporation is strictly prohibited.
+//
+// ALL NVIDIA DESIGN SPECIFICATIONS, CODE ARE PROVIDED "AS IS.". NVIDIA MAKES
+// NO WARRANTIES, EXPRESSED, IMPLIED, STATUTORY, OR OTHERWISE WITH RESPECT TO
+// THE MATERIALS, AND EXPRESSLY DISCLAIMS ALL IMPLIED WARRANTIES OF NONINFRINGEMENT,
+// MERCHANTABILITY, AND FITNESS FOR A PARTICULAR PURPOSE.
+//
+// Information and code furnished is believed to be accurate and reliable.
+// However, NVIDIA Corporation assumes no responsibility for the consequences of use of such
+// information or for any infringement of patents or other rights of third parties that may
+// result from its use. No license is granted by implication or otherwise under any patent
+// or patent rights of NVIDIA Corporation. Details are subject to change without notice.
+// This code supersedes and replaces all information previously supplied.
+// NVIDIA Corporation products are not authorized for use as critical
+// components in life support devices or systems without express written approval of
+// NVIDIA Corporation.
+//
+// Copyright (c) 2008-2021 NVIDIA Corporation. All rights reserved.
+
+#include "PipelineCache.h"
+
+#include <stdio.h>
+#include <new>
+
+static UINT s_NumFailures = 0;
+
+#define CHECK(exp) \
+    { if (!(exp)) { fprintf(stderr, "%s(%d): CHECK(%s) failed\n", __FILE__, __LINE__, #exp); ++s_NumFailures; } }
+
+using namespace GFSDK::SSAO;
+
+//--------------------------------------------------------------------------------
+struct FakeKey
+{
+    int Permutations[3];
+    unsigned char Format;
+    float BlendFactor;
+
+    FakeKey(int A = 0, int B = 0, int C = 0, unsigned char Format = 0, float BlendFactor = 0.f)
+    {
+        ZERO_STRUCT(*this);
+        this->Permutations[0] = A;
+        this->Permutations[1] = B;
+        this->Permutations[2] = C;
+        this->Format = Format;
+        this->BlendFactor = BlendFactor;
+    }
+};
+
+struct FakePipeline
+{
+    FakePipeline()
+        : NumReleaseCalls(0)
+    {
+    }
+
+    void Release()
+    {
+        ++NumReleaseCalls;
+    }
+
+    UINT NumReleaseCalls;
+};
+
+typedef PipelineCache<FakeKey, FakePipeline*> FakePipelineCache;
+
+//--------------------------------------------------------------------------------
+static UINT s_NumAllocations = 0;
+static UINT s_MaxNumAllocations = ~0u;
+
+static void* CountedNew(size_t Size)
+{
+    if (s_NumAllocations == s_MaxNumAllocations)
+    {
+        return NULL;
+    }
+    ++s_NumAllocations;
+    return ::operator new(Size);
+}
+
+static void CountedDelete(void* p)
+{
+    --s_NumAllocations;
+    ::operator delete(p);
+}
+
+static GFSDK_SSAO_CustomHeap GetCountedHeap()
+{
+    GFSDK_SSAO_CustomHeap NewDelete;
+    NewDelete.new_ = CountedNew;
+    NewDelete.delete_ = CountedDelete;
+    return NewDelete;
+}
+
+//--------------------------------------------------------------------------------
+static void TestFindInsert()
+{
+    const UINT NumPipelines = 100;
+    FakePipeline Pipelines[NumPipelines];
+
+    FakePipelineCache Cache;
+    Cache.Create(GetCountedHeap());
+    CHECK(Cache.GetCount() == 0);
+    CHECK(Cache.Find(FakeKey()) == NULL);
+
+    // Keys differing in any field, including the output state, map to different pipelines
+    for (UINT Index = 0; Index < NumPipelines; ++Index)
+    {
+        FakeKey Key(Index % 2, Index % 3, Index % 5, (unsigned char)(Index / 30), (Index % 4) * 0.5f);
+        CHECK(Cache.Find(Key) == NULL);
+        Cache.Insert(Key, &Pipelines[Index]);
+        CHECK(Cache.Find(Key) == &Pipelines[Index]);
+    }
+    CHECK(Cache.GetCount() == NumPipelines);
+
+    // Switching back to any previous key finds its pipeline again
+    for (UINT Pass = 0; Pass < 2; ++Pass)
+    {
+        for (UINT Index = 0; Index < NumPipelines; ++Index)
+        {
+            FakeKey Key(Index % 2, Index % 3, Index % 5, (unsigned char)(Index / 30), (Index % 4) * 0.5f);
+            CHECK(Cache.Find(Key) == &Pipelines[Index]);
+            CHECK(Cache.Find(Key) == &Pipelines[Index]);
+        }
+    }
+    CHECK(Cache.Find(FakeKey(7)) == NULL);
+
+    Cache.Release();
+    CHECK(Cache.GetCount() == 0);
+    CHECK(s_NumAllocations == 0);
+
+    for (UINT Index = 0; Index < NumPipelines; ++Index)
+    {
+        CHECK(Pipelines[Index].NumReleaseCalls == 1);
+    }
+
+    // The cache can be used again after Release
+    Cache.Create(GetCountedHeap());
+    CHECK(Cache.Find(FakeKey()) == NULL);
+    Cache.Insert(FakeKey(), &Pipelines[0]);
+    CHECK(Cache.Find(FakeKey()) == &Pipelines[0]);
+    Cache.Release();
+    CHECK(Pipelines[0].NumReleaseCalls == 2);
+    CHECK(s_NumAllocations == 0);
+}
+
+//--------------------------------------------------------------------------------
+static void TestHash()
+{
+    // FNV-1a test vector: hash of 4 zero bytes
+    typedef PipelineCache<UINT, FakePipeline*> UIntPipelineCache;
+    CHECK(UIntPipelineCache::GetHash(0) == 0x4B95F515u);
+
+    CHECK(FakePipelineCache::GetHash(FakeKey(1, 2, 3)) == FakePipelineCache::GetHash(FakeKey(1, 2, 3)));
+    CHECK(FakePipelineCache::GetHash(FakeKey(1, 2, 3)) != FakePipelineCache::GetHash(FakeKey(1, 2, 4)));
+}
+
+//--------------------------------------------------------------------------------
+static void TestAllocationFailure()
+{
+    FakePipeline Pipelines[9];
+
+    FakePipelineCache Cache;
+    Cache.Create(GetCountedHeap());
+    s_MaxNumAllocations = 1;
+
+    // The first 8 entries fit in the first allocation
+    for (UINT Index = 0; Index < 8; ++Index)
+    {
+        Cache.Insert(FakeKey(Index), &Pipelines[Index]);
+    }
+
+    // Growing fails: the new pipeline is released, and the cache is unchanged
+    bool Threw = false;
+    try
+    {
+        Cache.Insert(FakeKey(8), &Pipelines[8]);
+    }
+    catch (...)
+    {
+        Threw = true;
+    }
+    CHECK(Threw);
+    CHECK(Pipelines[8].NumReleaseCalls == 1);
+    CHECK(Cache.GetCount() == 8);
+    CHECK(Cache.Find(FakeKey(8)) == NULL);
+    CHECK(Cache.Find(FakeKey(3)) == &Pipelines[3]);
+
+    s_MaxNumAllocations = ~0u;
+    Cache.Release();
+    CHECK(s_NumAllocations == 0);
+
+    for (UINT Index = 0; Index < 8; ++Index)
+    {
+        CHECK(Pipelines[Index].NumReleaseCalls == 1);
+    }
+}
+
+//--------------------------------------------------------------------------------
+int main()
+{
+    TestFindInsert();
+    TestHash();
+    TestAllocationFailure();
+
+    if (s_NumFailures)
+    {
+        fprintf(stderr, "%u check(s) failed\n", s_NumFailures);
+        return 1;
+    }
+
+    printf("All tests passed\n");
+    return 0;
+}
@@ -0,0 +1,274 @@
+// This code contains NVIDIA Confidential Information and is disclosed to you
+// under a form of NVIDIA software license agreement provided separately to you.
+//
+// Notice
+// NVIDIA Corporation and its licensors retain all intellectual property and
+// proprietary rights in and to this software and related documentation and
+// any modifications thereto. Any use, reproduction, disclosure, or
+// distribution of this software and related documentation without an express
+// license agreement from NVIDIA Corporation is strictly prohibited.
+//
+// ALL NVIDIA DESIGN SPECIFICATIONS, CODE ARE PROVIDED "AS IS.". NVIDIA MAKES
+// NO WARRANTIES, EXPRESSED, IMPLIED, STATUTORY, OR OTHERWISE WITH RESPECT TO
+// THE MATERIALS, AND EXPRESSLY DISCLAIMS ALL IMPLIED WARRANTIES OF NONINFRINGEMENT,
+// MERCHANTABILITY, AND FITNESS FOR A PARTICULAR PURPOSE.
+//
+// Information and code furnished is believed to be accurate and reliable.
+// However, NVIDIA Corporation assumes no responsibility for the consequences of use of such
+// information or for any infringement of patents or other rights of third parties that may
+// result from its use. No license is granted by implication or otherwise under any patent
+// or patent rights of NVIDIA Corporation. Details are subject to change without notice.
+// This code supersedes and replaces all information previously supplied.
+// NVIDIA Corporation products are not authorized for use as critical
+// components in life support devices or systems without express written approval of
+// NVIDIA Corporation.
+//
+// Copyright (c) 2008-2021 NVIDIA Corporation. All rights reserved.
+
+#include "RenderTimes.h"
+
+#include <stdio.h>
+#include <math.h>
+
+static UINT s_NumFailures = 0;
+
+#define CHECK(exp) \
+    { if (!(exp)) { fprintf(stderr, "%s(%d): CHECK(%s) failed\n", __FILE__, __LINE__, #exp); ++s_NumFailures; } }
+
+using namespace GFSDK::SSAO;
+
+//--------------------------------------------------------------------------------
+static bool IsNear(float A, float B)
+{
+    return fabsf(A - B) < 1.e-3f;
+}
+
+//--------------------------------------------------------------------------------
+// Adds frames whose LINEAR_Z time is FirstMS, FirstMS+1, ... and whose TOTAL time is twice that
+static void AddFrames(RenderTimesHistory& History, UINT FirstMS, UINT NumFrames)
+{
+    for (UINT i = 0; i < NumFrames; ++i)
+    {
+        RenderTimes Frame;
+        Frame.TimeMS[REGIME_TIME_LINEAR_Z] = float(FirstMS + i);
+        Frame.TimeMS[REGIME_TIME_TOTAL] = 2.f * float(FirstMS + i);
+        History.Add(Frame);
+    }
+}
+
+//--------------------------------------------------------------------------------
+static void TestEmpty()
+{
+    RenderTimesHistory History;
+
+    GFSDK_SSAO_RenderTimes Times;
+    Times.NumFrames = 1;
+    Times.Passes[GFSDK_SSAO_PASS_TOTAL].AvgMS = 1.f;
+    History.GetRenderTimes(&Times);
+
+    CHECK(Times.NumFrames == 0);
+    for (UINT i = 0; i < GFSDK_SSAO_PASS_COUNT; ++i)
+    {
+        CHECK(Times.Passes[i].LastMS == 0.f);
+        CHECK(Times.Passes[i].MinMS == 0.f);
+        CHECK(Times.Passes[i].AvgMS == 0.f);
+        CHECK(Times.Passes[i].P95MS == 0.f);
+        CHECK(Times.Passes[i].P99MS == 0.f);
+    }
+}
+
+//--------------------------------------------------------------------------------
+static void TestStatistics()
+{
+    RenderTimesHistory History;
+    AddFrames(History, 1, 100);
+
+    GFSDK_SSAO_RenderTimes Times;
+    History.GetRenderTimes(&Times);
+
+    CHECK(Times.NumFrames == 100);
+
+    const GFSDK_SSAO_PassTime& LinearZ = Times.Passes[GFSDK_SSAO_PASS_LINEAR_Z];
+    CHECK(IsNear(LinearZ.LastMS, 100.f));
+    CHECK(IsNear(LinearZ.MinMS, 1.f));
+    CHECK(IsNear(LinearZ.AvgMS, 50.5f));
+    CHECK(IsNear(LinearZ.P95MS, 95.f));
+    CHECK(IsNear(LinearZ.P99MS, 99.f));
+
+    const GFSDK_SSAO_PassTime& Total = Times.Passes[GFSDK_SSAO_PASS_TOTAL];
+    CHECK(IsNear(Total.MinMS, 2.f));
+    CHECK(IsNear(Total.P99MS, 198.f));
+
+    // The passes that never ran count as 0 ms
+    CHECK(Times.Passes[GFSDK_SSAO_PASS_BLURY].AvgMS == 0.f);
+    CHECK(Times.Passes[GFSDK_SSAO_PASS_BLURY].P99MS == 0.f);
+}
+
+//--------------------------------------------------------------------------------
+static void TestSingleFrame()
+{
+    RenderTimesHistory History;
+    AddFrames(History, 3, 1);
+
+    GFSDK_SSAO_RenderTimes Times;
+    History.GetRenderTimes(&Times);
+
+    const GFSDK_SSAO_PassTime& LinearZ = Times.Passes[GFSDK_SSAO_PASS_LINEAR_Z];
+    CHECK(Times.NumFrames == 1);
+    CHECK(IsNear(LinearZ.LastMS, 3.f));
+    CHECK(IsNear(LinearZ.MinMS, 3.f));
+    CHECK(IsNear(LinearZ.AvgMS, 3.f));
+    CHECK(IsNear(LinearZ.P95MS, 3.f));
+    CHECK(IsNear(LinearZ.P99MS, 3.f));
+}
+
+//--------------------------------------------------------------------------------
+static void TestWrapAround()
+{
+    // Only the last HISTORY_SIZE frames, 73 to 200, are kept
+    RenderTimesHistory History;
+    AddFrames(History, 1, 200);
+
+    GFSDK_SSAO_RenderTimes Times;
+    History.GetRenderTimes(&Times);
+
+    CHECK(Times.NumFrames == GFSDK_SSAO_RENDER_TIMES_HISTORY_SIZE);
+
+    const GFSDK_SSAO_PassTime& LinearZ = Times.Passes[GFSDK_SSAO_PASS_LINEAR_Z];
+    CHECK(IsNear(LinearZ.LastMS, 200.f));
+    CHECK(IsNear(LinearZ.MinMS, 73.f));
+    CHECK(IsNear(LinearZ.AvgMS, 136.5f));
+    CHECK(IsNear(LinearZ.P95MS, 194.f));
+    CHECK(IsNear(LinearZ.P99MS, 199.f));
+
+    History.Reset();
+    History.GetRenderTimes(&Times);
+    CHECK(Times.NumFrames == 0);
+}
+
+//--------------------------------------------------------------------------------
+static void TestCPUTimes()
+{
+    // The host times have their own history, ahead of the GPU times read back
+    RenderTimesHistory History;
+    AddFrames(History, 1, 2);
+
+    for (UINT i = 0; i < 5; ++i)
+    {
+        CPUTimes Frame;
+        Frame.TimeMS[CPU_TIME_SET_DATA_FLOW] = 0.01f * float(i + 1);
+        Frame.TimeMS[CPU_TIME_TOTAL] = 0.1f * float(i + 1);
+        History.Add(Frame);
+    }
+
+    GFSDK_SSAO_RenderTimes Times;
+    History.GetRenderTimes(&Times);
+
+    CHECK(Times.NumFrames == 2);
+    CHECK(Times.NumCPUFrames == 5);
+    CHECK(IsNear(Times.Passes[GFSDK_SSAO_PASS_LINEAR_Z].LastMS, 2.f));
+
+    const GFSDK_SSAO_PassTime& Total = Times.CPUPhases[GFSDK_SSAO_CPU_PHASE_TOTAL];
+    CHECK(IsNear(Total.LastMS, 0.5f));
+    CHECK(IsNear(Total.MinMS, 0.1f));
+    CHECK(IsNear(Total.AvgMS, 0.3f));
+    CHECK(IsNear(Total.P99MS, 0.5f));
+    CHECK(IsNear(Times.CPUPhases[GFSDK_SSAO_CPU_PHASE_SET_DATA_FLOW].AvgMS, 0.03f));
+    CHECK(Times.CPUPhases[GFSDK_SSAO_CPU_PHASE_RENDER].P99MS == 0.f);
+
+    History.Reset();
+    History.GetRenderTimes(&Times);
+    CHECK(Times.NumFrames == 0);
+    CHECK(Times.NumCPUFrames == 0);
+}
+
+//--------------------------------------------------------------------------------
+// Simulates a GPU that completes each frame Latency frames after it was recorded
+static void TestTimestampQueryRingLatency(UINT Latency)
+{
+    const UINT NumFrames = 100;
+    const UINT Size = TimestampQueryRing::FRAMES_IN_FLIGHT;
+
+    TimestampQueryRing Ring;
+    UINT SlotFrames[Size];
+    UINT NumRecorded = 0;
+    UINT NextFrameRead = 0;
+
+    for (UINT Frame = 0; Frame < NumFrames; ++Frame)
+    {
+        CHECK(Ring.BeginFrame());
+        CHECK(Ring.IsRecording());
+        SlotFrames[Ring.GetWriteSlot()] = Frame;
+        Ring.EndFrame(true);
+        CHECK(!Ring.IsRecording());
+        ++NumRecorded;
+        CHECK(SlotFrames[Ring.GetNewestSlot()] == Frame);
+
+        while (Ring.GetNumInFlight() && SlotFrames[Ring.GetOldestSlot()] + Latency <= Frame)
+        {
+            // The slots are read back in the order the frames were recorded
+            CHECK(SlotFrames[Ring.GetOldestSlot()] == NextFrameRead);
+            ++NextFrameRead;
+            Ring.PopOldestSlot();
+        }
+        CHECK(Ring.GetNumInFlight() == ((Frame < Latency) ? Frame + 1 : Latency));
+    }
+
+    CHECK(NumRecorded == NumFrames);
+    CHECK(NextFrameRead + Latency == NumFrames);
+}
+
+//--------------------------------------------------------------------------------
+static void TestTimestampQueryRing()
+{
+    // Every frame is timed as long as the GPU lags by less than FRAMES_IN_FLIGHT frames
+    TestTimestampQueryRingLatency(0);
+    TestTimestampQueryRingLatency(1);
+    TestTimestampQueryRingLatency(3);
+    TestTimestampQueryRingLatency(TimestampQueryRing::FRAMES_IN_FLIGHT - 1);
+
+    // A frame that recorded no timestamp does not use a slot
+    TimestampQueryRing Ring;
+    CHECK(Ring.BeginFrame());
+    Ring.EndFrame(false);
+    CHECK(Ring.GetNumInFlight() == 0);
+    CHECK(Ring.GetWriteSlot() == 0);
+
+    // The frames recorded while all the slots are in flight are not timed
+    for (UINT Frame = 0; Frame < TimestampQueryRing::FRAMES_IN_FLIGHT; ++Frame)
+    {
+        CHECK(Ring.BeginFrame());
+        Ring.EndFrame(true);
+    }
+    CHECK(Ring.GetNumInFlight() == TimestampQueryRing::FRAMES_IN_FLIGHT);
+    CHECK(!Ring.BeginFrame());
+    CHECK(!Ring.IsRecording());
+    Ring.EndFrame(true);
+    CHECK(Ring.GetNumInFlight() == TimestampQueryRing::FRAMES_IN_FLIGHT);
+
+    CHECK(Ring.GetOldestSlot() == 0);
+    Ring.PopOldestSlot();
+    CHECK(Ring.GetOldestSlot() == 1);
+    CHECK(Ring.BeginFrame());
+    CHECK(Ring.GetWriteSlot() == 0);
+}
+
+//--------------------------------------------------------------------------------
+int main()
+{
+    TestEmpty();
+    TestStatistics();
+    TestSingleFrame();
+    TestWrapAround();
+    TestCPUTimes();
+    TestTimestampQueryRing();
+
+    if (s_NumFailures)
+    {
+        fprintf(stderr, "%u check(s) failed\n", s_NumFailures);
+        return 1;
+    }
+
+    printf("All tests passed\n");
+    return 0;
+}
@@ -0,0 +1,142 @@
+// This code contains NVIDIA Confidential Information and is disclosed to you
+// under a form of NVIDIA software license agreement provided separately to you.
+//
+// Notice
+// NVIDIA Corporation and its licensors retain all intellectual property and
+// proprietary rights in and to this software and related documentation and
+// any modifications thereto. Any use, reproduction, disclosure, or
+// distribution of this software and related documentation without an express
+// license agreement from NVIDIA Corporation is strictly prohibited.
+//
+// ALL NVIDIA DESIGN SPECIFICATIONS, CODE ARE PROVIDED "AS IS.". NVIDIA MAKES
+// NO WARRANTIES, EXPRESSED, IMPLIED, STATUTORY, OR OTHERWISE WITH RESPECT TO
+// THE MATERIALS, AND EXPRESSLY DISCLAIMS ALL IMPLIED WARRANTIES OF NONINFRINGEMENT,
+// MERCHANTABILITY, AND FITNESS FOR A PARTICULAR PURPOSE.
+//
+// Information and code furnished is believed to be accurate and reliable.
+// However, NVIDIA Corporation assumes no responsibility for the consequences of use of such
+// information or for any infringement of patents or other rights of third parties that may
+// result from its use. No license is granted by implication or otherwise under any patent
+// or patent rights of NVIDIA Corporation. Details are subject to change without notice.
+// This code supersedes and replaces all information previously supplied.
+// NVIDIA Corporation products are not authorized for use as critical
+// components in life support devices or systems without express written approval of
+// NVIDIA Corporation.
+//
+// Copyright (c) 2008-2021 NVIDIA Corporation. All rights reserved.
+
+#include "ShaderBlob.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <stdint.h>
+
+//--------------------------------------------------------------------------------
+// Links shaders generated by build_shaders.sh (with the stand-in dxc of FakeDxc.sh) through
+// GFSDK_SSAO_INCBIN, and checks the instances that Create() gets. Built by BuildShaders_Test.cmake
+// with -DSHADER_OUTPUT_DIR=\"...\".
+//--------------------------------------------------------------------------------
+
+static unsigned int s_NumFailures = 0;
+
+#define CHECK(exp) \
+    { if (!(exp)) { fprintf(stderr, "%s(%d): CHECK(%s) failed\n", __FILE__, __LINE__, #exp); ++s_NumFailures; } }
+
+typedef const char* DevicePointer;
+
+static unsigned int s_NumCreated = 0;
+static const void* s_pCreatedData[32];
+
+// FakeDxc.sh writes "PROFILE DEFINES\n" and filler lines, and spirv-cross adds a #version line.
+// Creating the shaders again gets the same (decompressed) data.
+static void CheckInstance(const char* pExpectedPrefix, const void* pData, size_t Size)
+{
+    const char* pText = (const char*)pData;
+    const unsigned int Index = s_NumCreated % 16;
+    CHECK(s_NumCreated < 16 || s_pCreatedData[Index] == pData);
+    s_pCreatedData[Index] = pData;
+    CHECK(((uintptr_t)pData & 15) == 0);
+    CHECK(!strncmp(pText, pExpectedPrefix, strlen(pExpectedPrefix)));
+    CHECK(Size > 0 && pText[Size - 1] == '\n');
+    CHECK(strlen(pText) == Size);
+    ++s_NumCreated;
+}
+
+struct PixelShader
+{
+    void Create(DevicePointer ExpectedPrefix, const void* pBytecode, size_t BytecodeLength)
+    {
+        CheckInstance(ExpectedPrefix, pBytecode, BytecodeLength);
+    }
+    void Release(DevicePointer)
+    {
+    }
+};
+
+namespace GLSLPrograms
+{
+    struct BlurX_PS
+    {
+        void Create(DevicePointer ExpectedPrefix, const char* pFragmentShaderSource, size_t Size)
+        {
+            CheckInstance(ExpectedPrefix, pFragmentShaderSource, Size);
+        }
+        void Release(DevicePointer)
+        {
+        }
+    };
+}
+
+#include "DXIL/CoarseAO_PS.h"
+#include "GLSL/BlurX_PS.h"
+
+#define GFSDK_SSAO_SHADER_BLOB_DIR SHADER_OUTPUT_DIR "/DXIL"
+#include "DXIL/CoarseAO_PS.cpp"
+#undef GFSDK_SSAO_SHADER_BLOB_DIR
+
+#define GFSDK_SSAO_SHADER_BLOB_DIR SHADER_OUTPUT_DIR "/GLSL"
+#include "GLSL/BlurX_PS.cpp"
+#undef GFSDK_SSAO_SHADER_BLOB_DIR
+
+//--------------------------------------------------------------------------------
+static void TestDecompressLZ4()
+{
+    // "abcabcabcabcabc!": 3 literals, a match of 12 at offset 3, and the last literal
+    const unsigned char Block[] = { 0x38, 'a', 'b', 'c', 3, 0, 0x10, '!' };
+    unsigned char Out[16];
+    CHECK(GFSDK::SSAO::DecompressLZ4(Block, sizeof(Block), Out, sizeof(Out)));
+    CHECK(!memcmp(Out, "abcabcabcabcabc!", 16));
+
+    CHECK(!GFSDK::SSAO::DecompressLZ4(Block, sizeof(Block), Out, 15));
+    CHECK(!GFSDK::SSAO::DecompressLZ4(Block, sizeof(Block) - 3, Out, sizeof(Out)));
+
+    const unsigned char BadOffset[] = { 0x38, 'a', 'b', 'c', 4, 0, 0x10, '!' };
+    CHECK(!GFSDK::SSAO::DecompressLZ4(BadOffset, sizeof(BadOffset), Out, sizeof(Out)));
+}
+
+//--------------------------------------------------------------------------------
+int main()
+{
+    TestDecompressLZ4();
+
+    Generated::CoarseAO_PS CoarseAO;
+    CoarseAO.Create("ps_6_0 API_D3D12=1 FETCH_GBUFFER_NORMAL=");
+    CHECK(s_NumCreated == 12);
+
+    Generated::BlurX_PS BlurX;
+    BlurX.Create("#version 150\nps_6_0 API_GL=1 ENABLE_SHARPNESS_PROFILE=");
+    CHECK(s_NumCreated == 16);
+
+    CoarseAO.Create("ps_6_0 API_D3D12=1 FETCH_GBUFFER_NORMAL=");
+    BlurX.Create("#version 150\nps_6_0 API_GL=1 ENABLE_SHARPNESS_PROFILE=");
+    CHECK(s_NumCreated == 32);
+
+    if (s_NumFailures)
+    {
+        fprintf(stderr, "%u check(s) failed\n", s_NumFailures);
+        return 1;
+    }
+
+    printf("All tests passed\n");
+    return 0;
+}
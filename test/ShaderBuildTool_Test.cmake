@@ -0,0 +1,75 @@
+#
+# Runs ShaderBuildTool on a copy of CoarseAO_PS.hlsl with a fake compile tool, and checks that
+# all the permutations are compiled once, that only a source change triggers recompiles, and that
+# a --permutations config prunes the instances.
+# Usage: cmake -DSHADER_BUILD_TOOL=... -DSOURCE_DIR=... -DWORK_DIR=... -P ShaderBuildTool_Test.cmake
+#
+file(REMOVE_RECURSE ${WORK_DIR})
+file(MAKE_DIRECTORY ${WORK_DIR}/out)
+file(COPY ${SOURCE_DIR}/src/shaders/src/ DESTINATION ${WORK_DIR}/src)
+
+set(LOG ${WORK_DIR}/compiles.log)
+file(WRITE ${LOG} "")
+
+function(run_shader_build_tool EXPECTED_NUM_COMPILES)
+    execute_process(
+        COMMAND ${SHADER_BUILD_TOOL} ${ARGN} ps_5_0 ${WORK_DIR}/src/CoarseAO_PS.hlsl CoarseAO_PS ${WORK_DIR}/out
+                "sh ${SOURCE_DIR}/test/FakeShaderCompiler.sh ${LOG}" D3D11
+        RESULT_VARIABLE RESULT)
+    if(NOT RESULT EQUAL 0)
+        message(FATAL_ERROR "ShaderBuildTool failed: ${RESULT}")
+    endif()
+
+    file(STRINGS ${LOG} COMPILES)
+    list(LENGTH COMPILES NUM_COMPILES)
+    if(NOT NUM_COMPILES EQUAL EXPECTED_NUM_COMPILES)
+        message(FATAL_ERROR "Expected ${EXPECTED_NUM_COMPILES} compiles in total, got ${NUM_COMPILES}")
+    endif()
+endfunction()
+
+# 3 x 2 x 2 permutations, then none with an unchanged source
+run_shader_build_tool(12 --jobs 4)
+file(READ ${WORK_DIR}/out/CoarseAO_PS.cpp FIRST_CPP)
+string(REGEX MATCHALL "\\.Create\\(Device, g_CoarseAO_PS_[A-Z_0-9]+_D3D11" CREATES "${FIRST_CPP}")
+list(LENGTH CREATES NUM_CREATES)
+if(NOT NUM_CREATES EQUAL 12)
+    message(FATAL_ERROR "Expected 12 permutations in CoarseAO_PS.cpp, got ${NUM_CREATES}")
+endif()
+
+run_shader_build_tool(12 --jobs 4)
+
+# Changing an included file recompiles everything, and the output does not depend on the order of the compiles
+file(APPEND ${WORK_DIR}/src/FetchNormal_Common.hlsl "\n// Modified\n")
+run_shader_build_tool(24 --jobs 3)
+run_shader_build_tool(36 --jobs 1 --no-cache)
+file(READ ${WORK_DIR}/out/CoarseAO_PS.cpp LAST_CPP)
+if(NOT FIRST_CPP STREQUAL LAST_CPP)
+    message(FATAL_ERROR "CoarseAO_PS.cpp depends on the build order")
+endif()
+
+# The pruned instances are a subset of the cached ones; the enums keep all the values, and Get() checks them
+file(WRITE ${WORK_DIR}/permutations.cfg "# No MSAA normals, single layer\nFETCH_GBUFFER_NORMAL 0 1 \nDEPTH_LAYER_COUNT 1\nENABLE_BLUR 1\n")
+run_shader_build_tool(36 --permutations ${WORK_DIR}/permutations.cfg)
+file(READ ${WORK_DIR}/out/CoarseAO_PS.cpp PRUNED_CPP)
+string(REGEX MATCHALL "\\.Create\\(Device, g_CoarseAO_PS_FETCH_GBUFFER_NORMAL_[01]_DEPTH_LAYER_COUNT_1_[A-Z_0-9]+_D3D11" CREATES "${PRUNED_CPP}")
+list(LENGTH CREATES NUM_CREATES)
+if(NOT NUM_CREATES EQUAL 4 OR PRUNED_CPP MATCHES "FETCH_GBUFFER_NORMAL_2|DEPTH_LAYER_COUNT_2")
+    message(FATAL_ERROR "Expected the 4 permutations of the config in CoarseAO_PS.cpp")
+endif()
+file(READ ${WORK_DIR}/out/CoarseAO_PS.h PRUNED_H)
+if(NOT PRUNED_H MATCHES "FETCH_GBUFFER_NORMAL_2," OR
+   NOT PRUNED_H MATCHES "return \\(\\(0x3u >> A\\) & \\(0x1u >> B\\) & \\(0x3u >> C\\) & 1\\) != 0;" OR
+   NOT PRUNED_H MATCHES "if \\(!IsBuilt\\(A, B, C\\)\\)\n +{\n +THROW_PERMUTATION_NOT_BUILT\\(\\);")
+    message(FATAL_ERROR "Unexpected IsBuilt/Get in CoarseAO_PS.h:\n${PRUNED_H}")
+endif()
+
+# A value that the shader does not declare is an error
+file(WRITE ${WORK_DIR}/permutations.cfg "NUM_STEPS 4 6\n")
+execute_process(
+    COMMAND ${SHADER_BUILD_TOOL} --permutations ${WORK_DIR}/permutations.cfg ps_5_0 ${WORK_DIR}/src/CoarseAO_PS.hlsl CoarseAO_PS ${WORK_DIR}/out
+            "sh ${SOURCE_DIR}/test/FakeShaderCompiler.sh ${LOG}" D3D11
+    RESULT_VARIABLE RESULT
+    ERROR_VARIABLE ERROR)
+if(RESULT EQUAL 0 OR NOT ERROR MATCHES "6 is not a value of NUM_STEPS")
+    message(FATAL_ERROR "Expected an error for an unknown permutation value: ${ERROR}")
+endif()
@@ -0,0 +1,251 @@
+// This code contains NVIDIA Confidential Information and is disclosed to you
+// under a form of NVIDIA software license agreement provided separately to you.
+//
+// Notice
+// NVIDIA Corporation and its licensors retain all intellectual property and
+// proprietary rights in and to this software and related documentation and
+// any modifications thereto. Any use, reproduction, disclosure, or
+// distribution of this software and related documentation without an express
+// license agreement from NVIDIA Corporation is strictly prohibited.
+//
+// ALL NVIDIA DESIGN SPECIFICATIONS, CODE ARE PROVIDED "AS IS.". NVIDIA MAKES
+// NO WARRANTIES, EXPRESSED, IMPLIED, STATUTORY, OR OTHERWISE WITH RESPECT TO
+// THE MATERIALS, AND EXPRESSLY DISCLAIMS ALL IMPLIED WARRANTIES OF NONINFRINGEMENT,
+// MERCHANTABILITY, AND FITNESS FOR A PARTICULAR PURPOSE.
+//
+// Information and code furnished is believed to be accurate and reliable.
+// However, NVIDIA Corporation assumes no responsibility for the consequences of use of such
+// information or for any infringement of patents or other rights of third parties that may
+// result from its use. No license is granted by implication or otherwise under any patent
+// or patent rights of NVIDIA Corporation. Details are subject to change without notice.
+// This code supersedes and replaces all information previously supplied.
+// NVIDIA Corporation products are not authorized for use as critical
+// components in life support devices or systems without express written approval of
+// NVIDIA Corporation.
+//
+// Copyright (c) 2008-2021 NVIDIA Corporation. All rights reserved.
+
+#include "TaskBatch.h"
+
+#include <stdio.h>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+static UINT s_NumFailures = 0;
+
+#define CHECK(exp) \
+    { if (!(exp)) { fprintf(stderr, "%s(%d): CHECK(%s) failed\n", __FILE__, __LINE__, #exp); ++s_NumFailures; } }
+
+using namespace GFSDK::SSAO;
+
+//--------------------------------------------------------------------------------
+struct CountedTasks
+{
+    CountedTasks(UINT NumTasks, UINT FailingTask = ~0u)
+        : Counts(NumTasks)
+        , FailingTask(FailingTask)
+    {
+    }
+
+    static void Run(void* pUserData, UINT TaskIndex)
+    {
+        CountedTasks& Tasks = *static_cast<CountedTasks*>(pUserData);
+        ++Tasks.Counts[TaskIndex];
+        if (TaskIndex == Tasks.FailingTask)
+        {
+            throw std::runtime_error("");
+        }
+    }
+
+    bool AllRunOnce() const
+    {
+        for (size_t Index = 0; Index < Counts.size(); ++Index)
+        {
+            if (Counts[Index] != 1)
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    std::vector<std::atomic<UINT> > Counts;
+    UINT FailingTask;
+};
+
+//--------------------------------------------------------------------------------
+// Runs the submitted tasks on the calling thread, before returning
+static void SubmitInline(void (*pTask)(void*), void* pTaskData, void* pUserData)
+{
+    ++*static_cast<UINT*>(pUserData);
+    pTask(pTaskData);
+}
+
+//--------------------------------------------------------------------------------
+// Runs each submitted task on its own thread
+static void SubmitToThread(void (*pTask)(void*), void* pTaskData, void* pUserData)
+{
+    static_cast<std::vector<std::thread>*>(pUserData)->push_back(std::thread(pTask, pTaskData));
+}
+
+//--------------------------------------------------------------------------------
+static void TestThreads()
+{
+    const UINT NumThreads[] = { 1, 2, 4, 0, 1000 };
+    for (UINT Index = 0; Index < SIZEOF_ARRAY(NumThreads); ++Index)
+    {
+        for (UINT NumTasks = 0; NumTasks < 300; NumTasks += 37)
+        {
+            CountedTasks Tasks(NumTasks);
+            TaskBatch Batch(GFSDK_SSAO_TaskScheduler(), NumThreads[Index]);
+            Batch.Run(CountedTasks::Run, &Tasks, NumTasks);
+            CHECK(Tasks.AllRunOnce());
+
+            // A batch can be run more than once
+            Batch.Run(CountedTasks::Run, &Tasks, NumTasks);
+            for (UINT TaskIndex = 0; TaskIndex < NumTasks; ++TaskIndex)
+            {
+                CHECK(Tasks.Counts[TaskIndex] == 2);
+            }
+        }
+    }
+}
+
+//--------------------------------------------------------------------------------
+static void TestScheduler()
+{
+    // One submitted task per batch task, minus the calling thread, and at most one per logical processor
+    const UINT NumLogicalProcessors = Max(std::thread::hardware_concurrency(), 1u);
+
+    for (UINT NumTasks = 0; NumTasks < 40; NumTasks += 13)
+    {
+        UINT NumSubmitted = 0;
+        GFSDK_SSAO_TaskScheduler Scheduler;
+        Scheduler.submit_ = SubmitInline;
+        Scheduler.pUserData = &NumSubmitted;
+
+        CountedTasks Tasks(NumTasks);
+        TaskBatch Batch(Scheduler, 1);
+        Batch.Run(CountedTasks::Run, &Tasks, NumTasks);
+        CHECK(Tasks.AllRunOnce());
+        CHECK(NumSubmitted == (NumTasks ? Min(NumTasks, NumLogicalProcessors) - 1 : 0));
+    }
+
+    for (UINT NumTasks = 0; NumTasks < 40; NumTasks += 13)
+    {
+        std::vector<std::thread> Threads;
+        GFSDK_SSAO_TaskScheduler Scheduler;
+        Scheduler.submit_ = SubmitToThread;
+        Scheduler.pUserData = &Threads;
+
+        CountedTasks Tasks(NumTasks);
+        {
+            TaskBatch Batch(Scheduler, 1);
+            Batch.Run(CountedTasks::Run, &Tasks, NumTasks);
+        }
+        CHECK(Tasks.AllRunOnce());
+        CHECK(Threads.size() == (NumTasks ? Min(NumTasks, NumLogicalProcessors) - 1 : 0));
+
+        for (size_t Index = 0; Index < Threads.size(); ++Index)
+        {
+            Threads[Index].join();
+        }
+    }
+}
+
+//--------------------------------------------------------------------------------
+static void TestExceptions()
+{
+    const UINT NumThreads[] = { 1, 4 };
+    for (UINT Index = 0; Index < SIZEOF_ARRAY(NumThreads); ++Index)
+    {
+        CountedTasks Tasks(100, 42);
+        TaskBatch Batch(GFSDK_SSAO_TaskScheduler(), NumThreads[Index]);
+
+        bool Thrown = false;
+        try
+        {
+            Batch.Run(CountedTasks::Run, &Tasks, 100);
+        }
+        catch (const std::runtime_error&)
+        {
+            Thrown = true;
+        }
+
+        CHECK(Thrown);
+        CHECK(Tasks.AllRunOnce());
+    }
+}
+
+//--------------------------------------------------------------------------------
+struct TestObject
+{
+    TestObject()
+        : NumCreateOnceCalls(0)
+        , Created(false)
+    {
+    }
+
+    bool IsCreated() const
+    {
+        return Created;
+    }
+
+    void CreateOnce()
+    {
+        ++NumCreateOnceCalls;
+        Created = true;
+    }
+
+    std::atomic<UINT> NumCreateOnceCalls;
+    bool Created;
+};
+
+//--------------------------------------------------------------------------------
+static void TestCreateOnceList()
+{
+    const UINT NumObjects = CreateOnceList::MAX_NUM_OBJECTS + 10;
+    std::vector<TestObject> Objects(NumObjects);
+    Objects[3].Created = true;
+
+    CreateOnceList CreationList;
+    for (UINT Pass = 0; Pass < 2; ++Pass)
+    {
+        for (UINT Index = 0; Index < NumObjects; ++Index)
+        {
+            CreationList.Add(Objects[Index]);
+        }
+    }
+
+    // The objects that do not fit are created right away
+    CHECK(CreationList.GetCount() == CreateOnceList::MAX_NUM_OBJECTS);
+    CHECK(Objects[NumObjects - 1].NumCreateOnceCalls == 1);
+
+    TaskBatch Batch(GFSDK_SSAO_TaskScheduler(), 4);
+    CreationList.Run(Batch);
+    CHECK(CreationList.GetCount() == 0);
+
+    for (UINT Index = 0; Index < NumObjects; ++Index)
+    {
+        CHECK(Objects[Index].NumCreateOnceCalls == (Index == 3 ? 0u : 1u));
+    }
+}
+
+//--------------------------------------------------------------------------------
+int main()
+{
+    TestThreads();
+    TestScheduler();
+    TestExceptions();
+    TestCreateOnceList();
+
+    if (s_NumFailures)
+    {
+        fprintf(stderr, "%u check(s) failed\n", s_NumFailures);
+        return 1;
+    }
+
+    printf("All tests passed\n");
+    return 0;
+}
@@ -0,0 +1,156 @@
+// This code contains NVIDIA Confidential Information and is disclosed to you
+// under a form of NVIDIA software license agreement provided separately to you.
+//
+// Notice
+// NVIDIA Corporation and its licensors retain all intellectual property and
+// proprietary rights in and to this software and related documentation and
+// any modifications thereto. Any use, reproduction, disclosure, or
+// distribution of this software and related documentation without an express
+// license agreement from NVIDIA Corporation is strictly prohibited.
+//
+// ALL NVIDIA DESIGN SPECIFICATIONS, CODE ARE PROVIDED "AS IS.". NVIDIA MAKES
+// NO WARRANTIES, EXPRESSED, IMPLIED, STATUTORY, OR OTHERWISE WITH RESPECT TO
+// THE MATERIALS, AND EXPRESSLY DISCLAIMS ALL IMPLIED WARRANTIES OF NONINFRINGEMENT,
+// MERCHANTABILITY, AND FITNESS FOR A PARTICULAR PURPOSE.
+//
+// Information and code furnished is believed to be accurate and reliable.
+// However, NVIDIA Corporation assumes no responsibility for the consequences of use of such
+// information or for any infringement of patents or other rights of third parties that may
+// result from its use. No license is granted by implication or otherwise under any patent
+// or patent rights of NVIDIA Corporation. Details are subject to change without notice.
+// This code supersedes and replaces all information previously supplied.
+// NVIDIA Corporation products are not authorized for use as critical
+// components in life support devices or systems without express written approval of
+// NVIDIA Corporation.
+//
+// Copyright (c) 2008-2021 NVIDIA Corporation. All rights reserved.
+
+#pragma once
+#include "GFSDK_SSAO.h"
+
+#include <math.h>
+#include <vector>
+
+//--------------------------------------------------------------------------------
+// Procedural host scenes shared by the CPU test and benchmark executables.
+// The depths are hardware depths from a left-handed perspective projection.
+//--------------------------------------------------------------------------------
+class TestScene
+{
+public:
+    enum Type
+    {
+        FLAT,       // A plane facing the camera, without any occlusion
+        CORNER,     // A floor, a side wall and a wavy back wall
+    };
+
+    TestScene(Type SceneType, GFSDK_SSAO_UINT Width, GFSDK_SSAO_UINT Height)
+        : m_Width(Width)
+        , m_Height(Height)
+        , m_Depths(Width * Height)
+        , m_Normals(Width * Height * 4)
+    {
+        const float ZNear = 0.1f;
+        const float ZFar = 100.f;
+        const float YScale = 1.f / tanf(0.5f);
+        const float XScale = YScale * float(Height) / float(Width);
+        const float ZScale = ZFar / (ZFar - ZNear);
+        const float ZBias = -ZNear * ZFar / (ZFar - ZNear);
+
+        const float Projection[16] =
+        {
+            XScale, 0.f,    0.f,    0.f,
+            0.f,    YScale, 0.f,    0.f,
+            0.f,    0.f,    ZScale, 1.f,
+            0.f,    0.f,    ZBias,  0.f,
+        };
+        m_Projection = GFSDK_SSAO_Float4x4(Projection);
+
+        for (GFSDK_SSAO_UINT Y = 0; Y < Height; ++Y)
+        {
+            for (GFSDK_SSAO_UINT X = 0; X < Width; ++X)
+            {
+                const float U = (float(X) + 0.5f) / float(Width) * 2.f - 1.f;
+                const float V = 1.f - (float(Y) + 0.5f) / float(Height) * 2.f;
+                const float DirX = U / XScale;
+                const float DirY = V / YScale;
+
+                // View depth of the first surface hit, and its world-space (= view-space) normal
+                float ViewDepth = 20.f;
+                float Normal[3] = { 0.f, 0.f, -1.f };
+                if (SceneType == CORNER)
+                {
+                    ViewDepth = 20.f + 0.3f * sinf(float(X) * 0.05f) + 0.2f * cosf(float(Y) * 0.07f);
+                    if (DirY < 0.f && -1.f / DirY < ViewDepth)
+                    {
+                        ViewDepth = -1.f / DirY;
+                        Normal[0] = 0.f; Normal[1] = 1.f; Normal[2] = 0.f;
+                    }
+                    if (DirX > 0.f && 2.f / DirX < ViewDepth)
+                    {
+                        ViewDepth = 2.f / DirX;
+                        Normal[0] = -1.f; Normal[1] = 0.f; Normal[2] = 0.f;
+                    }
+                }
+
+                const GFSDK_SSAO_UINT Index = Y * Width + X;
+                m_Depths[Index] = ZScale + ZBias / ViewDepth;
+                for (GFSDK_SSAO_UINT C = 0; C < 3; ++C)
+                {
+                    m_Normals[4 * Index + C] = Normal[C] * 0.5f + 0.5f;
+                }
+                m_Normals[4 * Index + 3] = 1.f;
+            }
+        }
+    }
+
+    GFSDK_SSAO_InputData_CPU GetInputData(bool EnableNormals) const
+    {
+        GFSDK_SSAO_InputData_CPU InputData;
+        InputData.DepthData.ProjectionMatrix.Data = m_Projection;
+        InputData.DepthData.ProjectionMatrix.Layout = GFSDK_SSAO_ROW_MAJOR_ORDER;
+        InputData.DepthData.FullResDepthTextureSRV.pData = &m_Depths[0];
+        InputData.DepthData.FullResDepthTextureSRV.Width = m_Width;
+        InputData.DepthData.FullResDepthTextureSRV.Height = m_Height;
+
+        // The second layer is the first one, which is enough to exercise the dual-layer kernels
+        InputData.DepthData.FullResDepthTexture2ndLayerSRV = InputData.DepthData.FullResDepthTextureSRV;
+
+        if (EnableNormals)
+        {
+            const float Identity[16] =
+            {
+                1.f, 0.f, 0.f, 0.f,
+                0.f, 1.f, 0.f, 0.f,
+                0.f, 0.f, 1.f, 0.f,
+                0.f, 0.f, 0.f, 1.f,
+            };
+            InputData.NormalData.Enable = true;
+            InputData.NormalData.WorldToViewMatrix.Data = GFSDK_SSAO_Float4x4(Identity);
+            InputData.NormalData.DecodeScale = 2.f;
+            InputData.NormalData.DecodeBias = -1.f;
+            InputData.NormalData.FullResNormalTextureSRV.pData = &m_Normals[0];
+            InputData.NormalData.FullResNormalTextureSRV.Width = m_Width;
+            InputData.NormalData.FullResNormalTextureSRV.Height = m_Height;
+            InputData.NormalData.FullResNormalTextureSRV.NumChannels = 4;
+        }
+
+        return InputData;
+    }
+
+    GFSDK_SSAO_UINT GetWidth() const
+    {
+        return m_Width;
+    }
+    GFSDK_SSAO_UINT GetHeight() const
+    {
+        return m_Height;
+    }
+
+private:
+    GFSDK_SSAO_UINT m_Width;
+    GFSDK_SSAO_UINT m_Height;
+    GFSDK_SSAO_Float4x4 m_Projection;
+    std::vector<float> m_Depths;
+    std::vector<float> m_Normals;
+};
@@ -0,0 +1,1560 @@
+// This code contains NVIDIA Confidential Information and is disclosed to you
+// under a form of NVIDIA software license agreement provided separately to you.
+//
+// Notice
+// NVIDIA Corporation and its licensors retain all intellectual property and
+// proprietary rights in and to this software and related documentation and
+// any modifications thereto. Any use, reproduction, disclosure, or
+// distribution of this software and related documentation without an express
+// license agreement from NVIDIA Corporation is strictly prohibited.
+//
+// ALL NVIDIA DESIGN SPECIFICATIONS, CODE ARE PROVIDED "AS IS.". NVIDIA MAKES
+// NO WARRANTIES, EXPRESSED, IMPLIED, STATUTORY, OR OTHERWISE WITH RESPECT TO
+// THE MATERIALS, AND EXPRESSLY DISCLAIMS ALL IMPLIED WARRANTIES OF NONINFRINGEMENT,
+// MERCHANTABILITY, AND FITNESS FOR A PARTICULAR PURPOSE.
+//
+// Information and code furnished is believed to be accurate and reliable.
+// However, NVIDIA Corporation assumes no responsibility for the consequences of use of such
+// information or for any infringement of patents or other rights of third parties that may
+// result from its use. No license is granted by implication or otherwise under any patent
+// or patent rights of NVIDIA Corporation. Details are subject to change without notice.
+// This code supersedes and replaces all information previously supplied.
+// NVIDIA Corporation products are not authorized for use as critical
+// components in life support devices or systems without express written approval of
+// NVIDIA Corporation.
+//
+// Copyright (c) 2008-2021 NVIDIA Corporation. All rights reserved.
+
+#include "TestScene.h"
+#include "Shaders_CPU.h"
+#include "ChromeTrace.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+//--------------------------------------------------------------------------------
+// Functional tests of the CPU context. Returns the number of failed checks.
+//--------------------------------------------------------------------------------
+
+static UINT s_NumFailures = 0;
+
+#define CHECK(exp) \
+    { if (!(exp)) { fprintf(stderr, "%s(%d): CHECK(%s) failed\n", __FILE__, __LINE__, #exp); ++s_NumFailures; } }
+
+//--------------------------------------------------------------------------------
+static GFSDK_SSAO_Status RenderAO(
+    const TestScene& Scene,
+    const GFSDK_SSAO_Parameters& Params,
+    bool EnableNormals,
+    UINT NumThreads,
+    std::vector<float>& Pixels,
+    GFSDK_SSAO_InstructionSet_CPU MaxInstructionSet = GFSDK_SSAO_CPU_AVX512,
+    GFSDK_SSAO_InstructionSet_CPU* pInstructionSet = NULL)
+{
+    GFSDK_SSAO_ContextDesc_CPU ContextDesc;
+    ContextDesc.NumThreads = NumThreads;
+    ContextDesc.MaxInstructionSet = MaxInstructionSet;
+
+    GFSDK_SSAO_Context_CPU* pAOContext = NULL;
+    GFSDK_SSAO_Status Status = GFSDK_SSAO_CreateContext_CPU(ContextDesc, &pAOContext);
+    if (Status == GFSDK_SSAO_OK)
+    {
+        if (pInstructionSet)
+        {
+            *pInstructionSet = pAOContext->GetInstructionSet();
+        }
+
+        Pixels.assign(Scene.GetWidth() * Scene.GetHeight(), -1.f);
+
+        GFSDK_SSAO_RenderTargetView_CPU RenderTarget;
+        RenderTarget.pData = &Pixels[0];
+        RenderTarget.Width = Scene.GetWidth();
+        RenderTarget.Height = Scene.GetHeight();
+        RenderTarget.NumChannels = 1;
+
+        GFSDK_SSAO_Output_CPU Output;
+        Output.pRenderTargetView = &RenderTarget;
+
+        Status = pAOContext->RenderAO(Scene.GetInputData(EnableNormals), Params, Output);
+    }
+
+    if (pAOContext)
+    {
+        pAOContext->Release();
+    }
+
+    return Status;
+}
+
+//--------------------------------------------------------------------------------
+static bool IsInUnitRange(const std::vector<float>& Pixels)
+{
+    for (size_t i = 0; i < Pixels.size(); ++i)
+    {
+        // Also rejects NaNs
+        if (!(Pixels[i] >= 0.f && Pixels[i] <= 1.f))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+//--------------------------------------------------------------------------------
+static float GetMean(const std::vector<float>& Pixels, UINT Width, UINT X0, UINT Y0, UINT X1, UINT Y1)
+{
+    double Sum = 0.0;
+    for (UINT Y = Y0; Y < Y1; ++Y)
+    {
+        for (UINT X = X0; X < X1; ++X)
+        {
+            Sum += Pixels[Y * Width + X];
+        }
+    }
+    return float(Sum / double((X1 - X0) * (Y1 - Y0)));
+}
+
+//--------------------------------------------------------------------------------
+static float GetMaxDifference(const std::vector<float>& A, const std::vector<float>& B)
+{
+    if (A.size() != B.size())
+    {
+        return 1.f;
+    }
+
+    float MaxDiff = 0.f;
+    for (size_t i = 0; i < A.size(); ++i)
+    {
+        // NaNs count as a difference of 1
+        const float Diff = fabsf(A[i] - B[i]);
+        if (!(Diff <= MaxDiff))
+        {
+            MaxDiff = (Diff == Diff) ? Diff : 1.f;
+        }
+    }
+    return MaxDiff;
+}
+
+//--------------------------------------------------------------------------------
+// Custom heap failing after a given number of allocations
+//--------------------------------------------------------------------------------
+struct LimitedHeap
+{
+    static void* New(size_t Size)
+    {
+        if (!s_NumAllocationsLeft)
+        {
+            return NULL;
+        }
+        --s_NumAllocationsLeft;
+        ++s_NumLiveAllocations;
+        return ::operator new(Size);
+    }
+
+    static void Delete(void* pData)
+    {
+        --s_NumLiveAllocations;
+        ::operator delete(pData);
+    }
+
+    static UINT s_NumAllocationsLeft;
+    static int s_NumLiveAllocations;
+};
+
+UINT LimitedHeap::s_NumAllocationsLeft = 0;
+int LimitedHeap::s_NumLiveAllocations = 0;
+
+//--------------------------------------------------------------------------------
+static void TestAllocationFailures()
+{
+    GFSDK_SSAO_CustomHeap CustomHeap;
+    CustomHeap.new_ = LimitedHeap::New;
+    CustomHeap.delete_ = LimitedHeap::Delete;
+
+    GFSDK_SSAO_ContextDesc_CPU ContextDesc;
+    ContextDesc.NumThreads = 4;
+
+    // Fail each allocation of the context creation in turn, until it succeeds
+    GFSDK_SSAO_Status Status = GFSDK_SSAO_MEMORY_ALLOCATION_FAILED;
+    for (UINT NumAllocations = 0; NumAllocations < 64 && Status != GFSDK_SSAO_OK; ++NumAllocations)
+    {
+        LimitedHeap::s_NumAllocationsLeft = NumAllocations;
+
+        GFSDK_SSAO_Context_CPU* pAOContext = NULL;
+        Status = GFSDK_SSAO_CreateContext_CPU(ContextDesc, &pAOContext, &CustomHeap);
+        CHECK(Status == GFSDK_SSAO_OK || Status == GFSDK_SSAO_MEMORY_ALLOCATION_FAILED);
+        if (pAOContext)
+        {
+            pAOContext->Release();
+        }
+        CHECK(LimitedHeap::s_NumLiveAllocations == 0);
+    }
+    CHECK(Status == GFSDK_SSAO_OK);
+}
+
+//--------------------------------------------------------------------------------
+static void TestInvalidArguments()
+{
+    GFSDK_SSAO_ContextDesc_CPU ContextDesc;
+    CHECK(GFSDK_SSAO_CreateContext_CPU(ContextDesc, NULL) == GFSDK_SSAO_NULL_ARGUMENT);
+
+    GFSDK_SSAO_Version WrongVersion;
+    WrongVersion.Major += 1;
+
+    GFSDK_SSAO_Context_CPU* pAOContext = NULL;
+    CHECK(GFSDK_SSAO_CreateContext_CPU(ContextDesc, &pAOContext, NULL, WrongVersion) == GFSDK_SSAO_VERSION_MISMATCH);
+    if (pAOContext)
+    {
+        pAOContext->Release();
+        pAOContext = NULL;
+    }
+
+    // A header from before the last change of the interface or of the structs passed to it
+    GFSDK_SSAO_Version OlderVersion;
+    OlderVersion.Minor -= 1;
+    CHECK(GFSDK_SSAO_CreateContext_CPU(ContextDesc, &pAOContext, NULL, OlderVersion) == GFSDK_SSAO_VERSION_MISMATCH);
+    if (pAOContext)
+    {
+        pAOContext->Release();
+        pAOContext = NULL;
+    }
+
+    CHECK(GFSDK_SSAO_CreateContext_CPU(ContextDesc, &pAOContext) == GFSDK_SSAO_OK);
+    if (pAOContext)
+    {
+        const TestScene Scene(TestScene::FLAT, 16, 16);
+        GFSDK_SSAO_Parameters Params;
+        GFSDK_SSAO_Output_CPU Output;
+        CHECK(pAOContext->RenderAO(Scene.GetInputData(false), Params, Output) != GFSDK_SSAO_OK);
+
+        pAOContext->Release();
+    }
+}
+
+//--------------------------------------------------------------------------------
+// Every configuration renders, stays in [0,1], and does not depend on the number of threads
+//--------------------------------------------------------------------------------
+static void TestConfigurations()
+{
+    // Odd dimensions, to exercise the partial tiles and SIMD tails
+    const TestScene Scene(TestScene::CORNER, 97, 61);
+
+    for (UINT Config = 0; Config < 32; ++Config)
+    {
+        GFSDK_SSAO_Parameters Params;
+        Params.Radius = 1.5f;
+        Params.Algorithm = (Config & 1) ? GFSDK_SSAO_LINE_SWEEP : GFSDK_SSAO_HBAO_PLUS;
+        Params.Blur.Enable = (Config & 2) != 0;
+        Params.EnableDualLayerAO = (Config & 4) != 0;
+        Params.DepthStorage = (Config & 8) ? GFSDK_SSAO_FP32_VIEW_DEPTHS : GFSDK_SSAO_FP16_VIEW_DEPTHS;
+        const bool EnableNormals = (Config & 16) != 0;
+
+        std::vector<float> SingleThreaded;
+        std::vector<float> MultiThreaded;
+        CHECK(RenderAO(Scene, Params, EnableNormals, 1, SingleThreaded) == GFSDK_SSAO_OK);
+        CHECK(RenderAO(Scene, Params, EnableNormals, 3, MultiThreaded) == GFSDK_SSAO_OK);
+
+        CHECK(IsInUnitRange(SingleThreaded));
+        CHECK(SingleThreaded.size() == MultiThreaded.size() &&
+              !memcmp(&SingleThreaded[0], &MultiThreaded[0], SingleThreaded.size() * sizeof(float)));
+    }
+}
+
+//--------------------------------------------------------------------------------
+// The vector kernels render the same AO as the scalar ones. The configurations run every kernel
+// of the tables: LinearizeDepth, DeinterleaveDepth and ReconstructNormal without input normals,
+// LinearizeDeinterleaveDepth with them, then CoarseAO, ReinterleaveAO and each Blur.
+// The instruction sets not supported by the host are skipped.
+// The AVX2 and AVX-512 kernels are built with FMA, hence the tolerance.
+//--------------------------------------------------------------------------------
+static void TestInstructionSets()
+{
+    const TestScene Scene(TestScene::CORNER, 97, 61);
+    const GFSDK_SSAO_InstructionSet_CPU InstructionSets[] = { GFSDK_SSAO_CPU_SSE42, GFSDK_SSAO_CPU_AVX2, GFSDK_SSAO_CPU_AVX512 };
+    const char* InstructionSetNames[] = { "SSE4.2", "AVX2", "AVX-512" };
+    const float MaxDiff = 1.e-4f;
+
+    for (UINT Config = 0; Config < 128; ++Config)
+    {
+        GFSDK_SSAO_Parameters Params;
+        Params.Radius = 1.5f;
+        Params.EnableDualLayerAO = (Config & 1) != 0;
+        Params.DepthStorage = (Config & 2) ? GFSDK_SSAO_FP32_VIEW_DEPTHS : GFSDK_SSAO_FP16_VIEW_DEPTHS;
+        Params.StepCount = (Config & 4) ? GFSDK_SSAO_STEP_COUNT_8 : GFSDK_SSAO_STEP_COUNT_4;
+        const bool EnableNormals = (Config & 8) != 0;
+        Params.Blur.Enable = (Config & 16) != 0;
+        Params.Blur.Radius = (Config & 32) ? GFSDK_SSAO_BLUR_RADIUS_4 : GFSDK_SSAO_BLUR_RADIUS_2;
+        Params.Blur.SharpnessProfile.Enable = (Config & 64) != 0;
+        Params.Blur.SharpnessProfile.ForegroundSharpnessScale = 4.f;
+        Params.Blur.SharpnessProfile.ForegroundViewDepth = 2.f;
+        Params.Blur.SharpnessProfile.BackgroundViewDepth = 15.f;
+
+        // The blur parameters have no effect without the blur
+        if (!Params.Blur.Enable && (Config & (32 | 64)))
+        {
+            continue;
+        }
+
+        std::vector<float> Reference;
+        CHECK(RenderAO(Scene, Params, EnableNormals, 1, Reference, GFSDK_SSAO_CPU_SCALAR) == GFSDK_SSAO_OK);
+
+        for (UINT i = 0; i < SIZEOF_ARRAY(InstructionSets); ++i)
+        {
+            std::vector<float> Pixels;
+            GFSDK_SSAO_InstructionSet_CPU InstructionSet = GFSDK_SSAO_CPU_SCALAR;
+            CHECK(RenderAO(Scene, Params, EnableNormals, 1, Pixels, InstructionSets[i], &InstructionSet) == GFSDK_SSAO_OK);
+
+            if (InstructionSet != InstructionSets[i])
+            {
+                if (Config == 0)
+                {
+                    printf("Skipping the %s kernels, not supported by this CPU\n", InstructionSetNames[i]);
+                }
+                continue;
+            }
+
+            CHECK(GetMaxDifference(Pixels, Reference) <= MaxDiff);
+        }
+    }
+}
+
+//--------------------------------------------------------------------------------
+// A plane facing the camera is not occluded, and a concave corner is
+//--------------------------------------------------------------------------------
+static void TestOcclusion()
+{
+    const UINT Width = 160;
+    const UINT Height = 96;
+    const TestScene FlatScene(TestScene::FLAT, Width, Height);
+    const TestScene CornerScene(TestScene::CORNER, Width, Height);
+
+    for (UINT Config = 0; Config < 4; ++Config)
+    {
+        GFSDK_SSAO_Parameters Params;
+        Params.Radius = 2.f;
+        Params.Algorithm = (Config & 1) ? GFSDK_SSAO_LINE_SWEEP : GFSDK_SSAO_HBAO_PLUS;
+        Params.Blur.Enable = (Config & 2) != 0;
+
+        std::vector<float> Pixels;
+        CHECK(RenderAO(FlatScene, Params, true, 1, Pixels) == GFSDK_SSAO_OK);
+        CHECK(GetMean(Pixels, Width, 0, 0, Width, Height) > 0.99f);
+
+        // The bottom-right quadrant contains the crease between the floor and the side wall,
+        // and the top-left quadrant only sees the back wall
+        CHECK(RenderAO(CornerScene, Params, true, 1, Pixels) == GFSDK_SSAO_OK);
+        const float OpenAO = GetMean(Pixels, Width, 0, 0, Width / 2, Height / 2);
+        const float CreaseAO = GetMean(Pixels, Width, Width / 2, Height / 2, Width, Height);
+        CHECK(OpenAO > 0.95f);
+        CHECK(CreaseAO < OpenAO - 0.1f);
+    }
+}
+
+//--------------------------------------------------------------------------------
+// The lines of each direction cover every pixel exactly once, one pixel per step
+//--------------------------------------------------------------------------------
+static void TestLineSweepLines()
+{
+    const UINT Sizes[][2] = { { 1, 1 }, { 7, 3 }, { 3, 7 }, { 64, 17 }, { 101, 203 } };
+
+    for (UINT SizeIndex = 0; SizeIndex < SIZEOF_ARRAY(Sizes); ++SizeIndex)
+    {
+        const UINT Width = Sizes[SizeIndex][0];
+        const UINT Height = Sizes[SizeIndex][1];
+
+        for (UINT DirectionIndex = 0; DirectionIndex < NUM_DIRECTIONS / 2; ++DirectionIndex)
+        {
+            const GFSDK::SSAO::CPU::LineSweepLines Lines(DirectionIndex, Width, Height);
+            std::vector<UINT> Coverage(Width * Height, 0);
+            bool Contiguous = true;
+
+            for (UINT Line = 0; Line < Lines.GetNumLines(); ++Line)
+            {
+                UINT StepBegin, StepEnd;
+                Lines.GetSteps(Line, StepBegin, StepEnd);
+
+                UINT PrevX = 0, PrevY = 0;
+                for (UINT Step = StepBegin; Step < StepEnd; ++Step)
+                {
+                    UINT X, Y;
+                    Lines.GetPixel(Line, Step, X, Y);
+                    if (X >= Width || Y >= Height)
+                    {
+                        Contiguous = false;
+                        continue;
+                    }
+                    Coverage[Y * Width + X]++;
+
+                    if (Step != StepBegin)
+                    {
+                        const int DX = int(X) - int(PrevX);
+                        const int DY = int(Y) - int(PrevY);
+                        Contiguous = Contiguous && DX >= -1 && DX <= 1 && DY >= -1 && DY <= 1 && (DX != 0 || DY != 0);
+                    }
+                    PrevX = X;
+                    PrevY = Y;
+                }
+            }
+
+            bool CoveredOnce = true;
+            for (size_t i = 0; i < Coverage.size(); ++i)
+            {
+                CoveredOnce = CoveredOnce && (Coverage[i] == 1);
+            }
+            CHECK(CoveredOnce);
+            CHECK(Contiguous);
+        }
+    }
+}
+
+//--------------------------------------------------------------------------------
+// Host texture with its own storage, for the kernel-level tests
+//--------------------------------------------------------------------------------
+template<class TexelType>
+struct TestTexture
+{
+    void Create(UINT Width, UINT Height, UINT NumChannels)
+    {
+        Data.assign(size_t(Width) * Height * NumChannels, TexelType(0));
+        RTV.pData = &Data[0];
+        RTV.Width = Width;
+        RTV.Height = Height;
+        RTV.RowPitch = Width * NumChannels;
+        RTV.PixelStride = NumChannels;
+    }
+
+    std::vector<TexelType> Data;
+    GFSDK::SSAO::CPU::TextureRTV<TexelType> RTV;
+};
+
+//--------------------------------------------------------------------------------
+// Constant buffers set up like in the CPU renderer, to run the kernels directly.
+// The first depth layer is Scene, and the second one (if any) is SecondLayerScene.
+//--------------------------------------------------------------------------------
+struct KernelConstants
+{
+    KernelConstants(const TestScene& Scene, const TestScene* pSecondLayerScene, const GFSDK_SSAO_Parameters& Params)
+    {
+        const GFSDK_SSAO_InputData_CPU InputData = Scene.GetInputData(true);
+        GFSDK_SSAO_InputDepthData_CPU DepthData = InputData.DepthData;
+        DepthData.FullResDepthTexture2ndLayerSRV = pSecondLayerScene ? pSecondLayerScene->GetInputData(false).DepthData.FullResDepthTextureSRV
+                                                                     : GFSDK_SSAO_ShaderResourceView_CPU();
+        CHECK(InputDepth.SetData(DepthData) == GFSDK_SSAO_OK);
+
+        Viewports.SetFullResolution(Scene.GetWidth(), Scene.GetHeight());
+        GlobalCB.SetDepthData(InputDepth);
+        GlobalCB.SetResolutionConstants(Viewports);
+        GlobalCB.SetNormalData(InputData.NormalData);
+        GlobalCB.SetAOParameters(Params, InputDepth);
+        GlobalCB.UpdateBuffer(GFSDK_SSAO_RENDER_AO);
+        PerPassCBs.Create();
+    }
+
+    static GFSDK::SSAO::CPU::ShaderResourceView GetSRV(const GFSDK::SSAO::CPU::UserTextureSRV& Texture)
+    {
+        GFSDK::SSAO::CPU::ShaderResourceView SRV;
+        SRV.pData = Texture.pData;
+        SRV.Width = Texture.Width;
+        SRV.Height = Texture.Height;
+        SRV.RowPitch = Texture.RowPitch;
+        SRV.PixelStride = Texture.PixelStride;
+        return SRV;
+    }
+
+    UINT GetQuarterWidth() const
+    {
+        return UINT(Viewports.QuarterRes.Width);
+    }
+    UINT GetQuarterHeight() const
+    {
+        return UINT(Viewports.QuarterRes.Height);
+    }
+
+    GFSDK::SSAO::CPU::InputDepthInfo InputDepth;
+    GFSDK::SSAO::Viewports Viewports;
+    GFSDK::SSAO::CPU::GlobalConstantBuffer GlobalCB;
+    GFSDK::SSAO::CPU::PerPassConstantBuffers PerPassCBs;
+};
+
+//--------------------------------------------------------------------------------
+// Kernels of each instruction set supported by the host, the scalar ones first
+//--------------------------------------------------------------------------------
+static std::vector<GFSDK::SSAO::CPU::Shaders> GetSupportedShaders()
+{
+    std::vector<GFSDK::SSAO::CPU::Shaders> AllShaders;
+    const GFSDK_SSAO_InstructionSet_CPU InstructionSets[] = { GFSDK_SSAO_CPU_SCALAR, GFSDK_SSAO_CPU_SSE42, GFSDK_SSAO_CPU_AVX2, GFSDK_SSAO_CPU_AVX512 };
+
+    for (UINT i = 0; i < SIZEOF_ARRAY(InstructionSets); ++i)
+    {
+        GFSDK::SSAO::CPU::Shaders Shaders;
+        Shaders.Create(InstructionSets[i]);
+        if (Shaders.ActiveInstructionSet == InstructionSets[i])
+        {
+            AllShaders.push_back(Shaders);
+        }
+    }
+    return AllShaders;
+}
+
+//--------------------------------------------------------------------------------
+// Binds the depth slices to the FP32 or the FP16 render targets of the kernel arguments
+//--------------------------------------------------------------------------------
+static void BindSlices(TestTexture<FLOAT>* pSlices, GFSDK::SSAO::CPU::RenderTargetView* pRTVs, GFSDK::SSAO::CPU::HalfRenderTargetView*)
+{
+    for (UINT SliceIndex = 0; SliceIndex < 16; ++SliceIndex)
+    {
+        pRTVs[SliceIndex] = pSlices[SliceIndex].RTV;
+    }
+}
+
+static void BindSlices(TestTexture<GFSDK::SSAO::CPU::HALF>* pSlices, GFSDK::SSAO::CPU::RenderTargetView*, GFSDK::SSAO::CPU::HalfRenderTargetView* pRTVs)
+{
+    for (UINT SliceIndex = 0; SliceIndex < 16; ++SliceIndex)
+    {
+        pRTVs[SliceIndex] = pSlices[SliceIndex].RTV;
+    }
+}
+
+//--------------------------------------------------------------------------------
+template<class TexelType>
+static float GetMaxRelativeDifference(const std::vector<TexelType>& A, const std::vector<TexelType>& B)
+{
+    if (A.size() != B.size())
+    {
+        return 1.f;
+    }
+
+    float MaxDiff = 0.f;
+    for (size_t i = 0; i < A.size(); ++i)
+    {
+        const float ValueA = GFSDK::SSAO::CPU::DecodeTexel(A[i]);
+        const float ValueB = GFSDK::SSAO::CPU::DecodeTexel(B[i]);
+        const float Diff = fabsf(ValueA - ValueB) / Max(fabsf(ValueB), 1.e-6f);
+        if (!(Diff <= MaxDiff))
+        {
+            MaxDiff = (Diff == Diff) ? Diff : 1.f;
+        }
+    }
+    return MaxDiff;
+}
+
+//--------------------------------------------------------------------------------
+// LinearizeDeinterleaveDepth writes the same depth slices as the scalar LinearizeDepth followed by
+// DeinterleaveDepth, with FP32 and FP16 storage, one or two layers, and partial 4x4 quads on the
+// right and bottom edges. The scalar kernels match exactly. With FMA, the linearization of the
+// vector kernels differs by up to ~1e-5 in FP32, which can round to the next FP16 value.
+//--------------------------------------------------------------------------------
+template<class TexelType>
+static void TestDepthDeinterleaving(const KernelConstants& Constants, GFSDK::SSAO::CPU::ShaderPermutations::DEPTH_LAYER_COUNT DepthLayerCount)
+{
+    using namespace GFSDK::SSAO::CPU;
+
+    const bool HalfViewDepths = (sizeof(TexelType) == sizeof(HALF));
+    const bool DualLayer = (DepthLayerCount == ShaderPermutations::DEPTH_LAYER_COUNT_2);
+    const UINT NumChannels = DualLayer ? 2 : 1;
+    const UINT FullWidth = UINT(Constants.Viewports.FullRes.Width);
+    const UINT FullHeight = UINT(Constants.Viewports.FullRes.Height);
+    const std::vector<Shaders> AllShaders = GetSupportedShaders();
+    const float MaxDiff = HalfViewDepths ? 1.f / 1024.f : 1.e-4f;
+
+    // Two-pass reference, with the scalar kernels
+    TestTexture<FLOAT> ViewDepths[2];
+    TestTexture<TexelType> ReferenceSlices[16];
+    {
+        LinearizeDepthArgs Args;
+        ZERO_STRUCT(Args);
+        Args.pGlobalCB = &Constants.GlobalCB.GetCB();
+        Args.DepthTexture[0] = KernelConstants::GetSRV(Constants.InputDepth.Texture0);
+        Args.DepthTexture[1] = KernelConstants::GetSRV(Constants.InputDepth.Texture1);
+        for (UINT Layer = 0; Layer < NumChannels; ++Layer)
+        {
+            ViewDepths[Layer].Create(FullWidth, FullHeight, 1);
+            Args.ViewDepthTexture[Layer] = ViewDepths[Layer].RTV;
+        }
+        Scalar::GetKernelTable().LinearizeDepth_PS.Get(DepthLayerCount)(Args, 0, FullHeight);
+    }
+    {
+        DeinterleaveDepthArgs Args;
+        ZERO_STRUCT(Args);
+        Args.pGlobalCB = &Constants.GlobalCB.GetCB();
+        Args.HalfViewDepths = HalfViewDepths;
+        for (UINT Layer = 0; Layer < NumChannels; ++Layer)
+        {
+            Args.ViewDepthTexture[Layer] = ViewDepths[Layer].RTV;
+        }
+        for (UINT SliceIndex = 0; SliceIndex < 16; ++SliceIndex)
+        {
+            ReferenceSlices[SliceIndex].Create(Constants.GetQuarterWidth(), Constants.GetQuarterHeight(), NumChannels);
+        }
+        BindSlices(ReferenceSlices, Args.QuarterResViewDepthTexture, Args.QuarterResHalfViewDepthTexture);
+        Scalar::GetKernelTable().DeinterleaveDepth_PS.Get(DepthLayerCount)(Args, 0, Constants.GetQuarterHeight());
+    }
+
+    for (size_t i = 0; i < AllShaders.size(); ++i)
+    {
+        TestTexture<TexelType> Slices[16];
+        LinearizeDeinterleaveDepthArgs Args;
+        ZERO_STRUCT(Args);
+        Args.pGlobalCB = &Constants.GlobalCB.GetCB();
+        Args.HalfViewDepths = HalfViewDepths;
+        Args.DepthTexture[0] = KernelConstants::GetSRV(Constants.InputDepth.Texture0);
+        Args.DepthTexture[1] = KernelConstants::GetSRV(Constants.InputDepth.Texture1);
+        Args.Width = FullWidth;
+        Args.Height = FullHeight;
+        for (UINT SliceIndex = 0; SliceIndex < 16; ++SliceIndex)
+        {
+            Slices[SliceIndex].Create(Constants.GetQuarterWidth(), Constants.GetQuarterHeight(), NumChannels);
+        }
+        BindSlices(Slices, Args.QuarterResViewDepthTexture, Args.QuarterResHalfViewDepthTexture);
+
+        // In tiles of 3 rows, like the tiles of the renderer
+        for (UINT RowBegin = 0; RowBegin < Constants.GetQuarterHeight(); RowBegin += 3)
+        {
+            const UINT RowEnd = Min(RowBegin + 3, Constants.GetQuarterHeight());
+            AllShaders[i].LinearizeDeinterleaveDepth_PS.Get(DepthLayerCount)(Args, RowBegin, RowEnd);
+        }
+
+        for (UINT SliceIndex = 0; SliceIndex < 16; ++SliceIndex)
+        {
+            if (AllShaders[i].ActiveInstructionSet == GFSDK_SSAO_CPU_SCALAR)
+            {
+                CHECK(Slices[SliceIndex].Data == ReferenceSlices[SliceIndex].Data);
+            }
+            else
+            {
+                CHECK(GetMaxRelativeDifference(Slices[SliceIndex].Data, ReferenceSlices[SliceIndex].Data) <= MaxDiff);
+            }
+        }
+    }
+}
+
+static void TestDepthDeinterleaving()
+{
+    // The second layer is a plane crossing the wavy back wall, so that both layers hold the min or the max
+    const TestScene Scene(TestScene::CORNER, 97, 61);
+    const TestScene SecondLayerScene(TestScene::FLAT, 97, 61);
+
+    for (UINT Config = 0; Config < 4; ++Config)
+    {
+        const bool DualLayer = (Config & 1) != 0;
+        GFSDK_SSAO_Parameters Params;
+        Params.EnableDualLayerAO = DualLayer;
+        const KernelConstants Constants(Scene, DualLayer ? &SecondLayerScene : NULL, Params);
+
+        const GFSDK::SSAO::CPU::ShaderPermutations::DEPTH_LAYER_COUNT DepthLayerCount = DualLayer ? GFSDK::SSAO::CPU::ShaderPermutations::DEPTH_LAYER_COUNT_2
+                                                                                                     : GFSDK::SSAO::CPU::ShaderPermutations::DEPTH_LAYER_COUNT_1;
+        if (Config & 2)
+        {
+            TestDepthDeinterleaving<GFSDK::SSAO::CPU::HALF>(Constants, DepthLayerCount);
+        }
+        else
+        {
+            TestDepthDeinterleaving<FLOAT>(Constants, DepthLayerCount);
+        }
+    }
+}
+
+//--------------------------------------------------------------------------------
+// BlurX_PS.hlsl followed by BlurY_PS.hlsl through a full-res AOZ texture, written after
+// Blur_Common.hlsl, as the reference of the fused Blur_PS. The bilinear fetches of the adaptive
+// sampling are halfway between two texels, and the intermediate AOZ texture is FP32 like the ring.
+//--------------------------------------------------------------------------------
+class ReferenceBlur
+{
+public:
+    ReferenceBlur(const GFSDK::SSAO::GlobalConstantBuffer& CB, int KernelRadius, bool EnableSharpnessProfile, UINT Width, UINT Height)
+        : m_CB(CB)
+        , m_KernelRadius(KernelRadius)
+        , m_EnableSharpnessProfile(EnableSharpnessProfile)
+        , m_Width(int(Width))
+        , m_Height(int(Height))
+    {
+        const float BlurSigma = (float(KernelRadius) + 1.f) * 0.5f;
+        m_BlurFalloff = 1.f / (2.f * BlurSigma * BlurSigma);
+    }
+
+    void Run(const std::vector<float>& AOZ, std::vector<float>& Output) const
+    {
+        std::vector<float> BlurredX(AOZ.size());
+        for (int Y = 0; Y < m_Height; ++Y)
+        {
+            for (int X = 0; X < m_Width; ++X)
+            {
+                float* pOut = &BlurredX[2 * (Y * m_Width + X)];
+                pOut[0] = ComputeBlur(AOZ, X, Y, 1, 0, pOut[1]);
+            }
+        }
+
+        Output.resize(m_Width * m_Height);
+        for (int Y = 0; Y < m_Height; ++Y)
+        {
+            for (int X = 0; X < m_Width; ++X)
+            {
+                float CenterDepth;
+                const float AO = ComputeBlur(BlurredX, X, Y, 0, 1, CenterDepth);
+                Output[Y * m_Width + X] = powf(Saturate(AO), m_CB.fPowExponent);
+            }
+        }
+    }
+
+private:
+    static float Saturate(float X)
+    {
+        return (X > 0.f) ? ((X < 1.f) ? X : 1.f) : 0.f;
+    }
+
+    // Point sampling with clamp-to-edge
+    const float* Sample(const std::vector<float>& AOZ, int X, int Y) const
+    {
+        X = Clamp(X, 0, m_Width - 1);
+        Y = Clamp(Y, 0, m_Height - 1);
+        return &AOZ[2 * (Y * m_Width + X)];
+    }
+
+    float GetSharpness(float ViewDepth) const
+    {
+        if (m_EnableSharpnessProfile)
+        {
+            const float LerpFactor = Saturate((ViewDepth - m_CB.fBlurViewDepth0) / (m_CB.fBlurViewDepth1 - m_CB.fBlurViewDepth0));
+            return m_CB.fBlurSharpness0 + (m_CB.fBlurSharpness1 - m_CB.fBlurSharpness0) * LerpFactor;
+        }
+        return m_CB.fBlurSharpness1;
+    }
+
+    float ComputeBlur(const std::vector<float>& AOZ, int X, int Y, int DX, int DY, float& CenterDepth) const
+    {
+        const float* pCenter = Sample(AOZ, X, Y);
+        CenterDepth = pCenter[1];
+
+        const float Sharpness = GetSharpness(CenterDepth);
+        const float Scale = Sharpness;
+        const float Bias = -CenterDepth * Sharpness;
+
+        float TotalAO = pCenter[0];
+        float TotalW = 1.f;
+
+        // USE_DEPTH_SLOPE: the slope is taken from the sample at radius 1 on each side
+        for (int Side = 0; Side < 2; ++Side)
+        {
+            const int SX = Side ? -DX : DX;
+            const int SY = Side ? -DY : DY;
+            const float DepthSlope = Sample(AOZ, X + SX, Y + SY)[1] - CenterDepth;
+
+            for (int R = 1; R <= m_KernelRadius; )
+            {
+                float SampleAO;
+                float SampleDepth;
+                int Step;
+
+                // USE_ADAPTIVE_SAMPLING: one linear fetch per 2 texels in the outer half of the kernel
+                if (m_KernelRadius >= 4 && R > m_KernelRadius / 2)
+                {
+                    const float* pA = Sample(AOZ, X + R * SX, Y + R * SY);
+                    const float* pB = Sample(AOZ, X + (R + 1) * SX, Y + (R + 1) * SY);
+                    SampleAO = 0.5f * (pA[0] + pB[0]);
+                    SampleDepth = 0.5f * (pA[1] + pB[1]);
+                    Step = 2;
+                }
+                else
+                {
+                    const float* pAOZ = Sample(AOZ, X + R * SX, Y + R * SY);
+                    SampleAO = pAOZ[0];
+                    SampleDepth = pAOZ[1];
+                    Step = 1;
+                }
+
+                // CrossBilateralWeight
+                const float FloatR = float(R);
+                SampleDepth -= DepthSlope * FloatR;
+                const float DeltaZ = SampleDepth * Scale + Bias;
+                const float W = exp2f(-FloatR*FloatR*m_BlurFalloff - DeltaZ*DeltaZ);
+
+                TotalAO += W * SampleAO;
+                TotalW += W;
+                R += Step;
+            }
+        }
+
+        return TotalAO / TotalW;
+    }
+
+    const GFSDK::SSAO::GlobalConstantBuffer& m_CB;
+    int m_KernelRadius;
+    bool m_EnableSharpnessProfile;
+    int m_Width;
+    int m_Height;
+    float m_BlurFalloff;
+};
+
+//--------------------------------------------------------------------------------
+// The fused Blur_PS matches BlurX followed by BlurY, with and without the sharpness profile, across
+// the edges of the BLUR_STRIP_WIDTH strips, on the image borders, and for any split into row tiles.
+// The scalar kernels match exactly, the vector ones within the error of their exp2 and pow.
+//--------------------------------------------------------------------------------
+static void TestBlur()
+{
+    using namespace GFSDK::SSAO::CPU;
+
+    // Two strips with a partial one, a single full strip, and an image smaller than the kernels
+    const UINT Sizes[][2] = { { 2 * BLUR_STRIP_WIDTH + 37, 43 }, { BLUR_STRIP_WIDTH, 9 }, { 5, 3 } };
+    const UINT TileHeights[] = { 32, 7, 1 };
+    const std::vector<Shaders> AllShaders = GetSupportedShaders();
+
+    for (UINT SizeIndex = 0; SizeIndex < SIZEOF_ARRAY(Sizes); ++SizeIndex)
+    {
+        const UINT Width = Sizes[SizeIndex][0];
+        const UINT Height = Sizes[SizeIndex][1];
+        const TestScene Scene(TestScene::CORNER, Width, Height);
+
+        // Smooth depths from 1 to ~18, with steps between tiles of pixels, and noisy AO
+        std::vector<float> AOZ(2 * Width * Height);
+        UINT Random = 12345;
+        for (UINT Y = 0; Y < Height; ++Y)
+        {
+            for (UINT X = 0; X < Width; ++X)
+            {
+                Random = Random * 1664525u + 1013904223u;
+                AOZ[2 * (Y * Width + X) + 0] = float(Random >> 8) / float(1 << 24);
+                AOZ[2 * (Y * Width + X) + 1] = 1.f + 0.02f * float(X) + 0.05f * float(Y) + 0.3f * float(((X / 13) + (Y / 5)) & 1);
+            }
+        }
+
+        for (UINT Config = 0; Config < 4; ++Config)
+        {
+            const ShaderPermutations::KERNEL_RADIUS KernelRadius = (Config & 1) ? ShaderPermutations::KERNEL_RADIUS_4 : ShaderPermutations::KERNEL_RADIUS_2;
+            const ShaderPermutations::ENABLE_SHARPNESS_PROFILE SharpnessProfile = (Config & 2) ? ShaderPermutations::ENABLE_SHARPNESS_PROFILE_1 : ShaderPermutations::ENABLE_SHARPNESS_PROFILE_0;
+
+            GFSDK_SSAO_Parameters Params;
+            Params.PowerExponent = 2.f;
+            Params.Blur.Enable = true;
+            Params.Blur.Radius = (Config & 1) ? GFSDK_SSAO_BLUR_RADIUS_4 : GFSDK_SSAO_BLUR_RADIUS_2;
+            Params.Blur.Sharpness = 4.f;
+            Params.Blur.SharpnessProfile.Enable = (Config & 2) != 0;
+            Params.Blur.SharpnessProfile.ForegroundSharpnessScale = 4.f;
+            Params.Blur.SharpnessProfile.ForegroundViewDepth = 4.f;
+            Params.Blur.SharpnessProfile.BackgroundViewDepth = 12.f;
+            const KernelConstants Constants(Scene, NULL, Params);
+
+            std::vector<float> Reference;
+            const ReferenceBlur Blur(Constants.GlobalCB.GetCB(), (Config & 1) ? 4 : 2, (Config & 2) != 0, Width, Height);
+            Blur.Run(AOZ, Reference);
+
+            for (size_t i = 0; i < AllShaders.size(); ++i)
+            {
+                for (UINT TileIndex = 0; TileIndex < SIZEOF_ARRAY(TileHeights); ++TileIndex)
+                {
+                    TestTexture<FLOAT> Output;
+                    Output.Create(Width, Height, 1);
+
+                    BlurArgs Args;
+                    ZERO_STRUCT(Args);
+                    Args.pGlobalCB = &Constants.GlobalCB.GetCB();
+                    Args.AOZTexture.pData = &AOZ[0];
+                    Args.AOZTexture.Width = Width;
+                    Args.AOZTexture.Height = Height;
+                    Args.AOZTexture.RowPitch = 2 * Width;
+                    Args.AOZTexture.PixelStride = 2;
+                    Args.Output.RenderTarget = Output.RTV;
+                    Args.Output.BlendMode = GFSDK_SSAO_OVERWRITE_RGB;
+
+                    for (UINT RowBegin = 0; RowBegin < Height; RowBegin += TileHeights[TileIndex])
+                    {
+                        AllShaders[i].Blur_PS.Get(KernelRadius, SharpnessProfile)(Args, RowBegin, Min(RowBegin + TileHeights[TileIndex], Height));
+                    }
+
+                    if (AllShaders[i].ActiveInstructionSet == GFSDK_SSAO_CPU_SCALAR)
+                    {
+                        CHECK(Output.Data == Reference);
+                    }
+                    else
+                    {
+                        CHECK(GetMaxDifference(Output.Data, Reference) <= 1.e-5f);
+                    }
+                }
+            }
+        }
+    }
+}
+
+//--------------------------------------------------------------------------------
+// Tests of the kernel tables: one rendering per axis of the permutations, compared with a
+// reference that does not use the permutation. The scalar kernels are used, so that each
+// reference holds exactly or within rounding.
+//--------------------------------------------------------------------------------
+static GFSDK_SSAO_Status RenderWithScalarKernels(
+    const GFSDK_SSAO_InputData_CPU& InputData,
+    const GFSDK_SSAO_Parameters& Params,
+    GFSDK_SSAO_RenderMask RenderMask,
+    UINT NumChannels,
+    std::vector<float>& Pixels)
+{
+    GFSDK_SSAO_ContextDesc_CPU ContextDesc;
+    ContextDesc.NumThreads = 1;
+    ContextDesc.MaxInstructionSet = GFSDK_SSAO_CPU_SCALAR;
+
+    GFSDK_SSAO_Context_CPU* pAOContext = NULL;
+    GFSDK_SSAO_Status Status = GFSDK_SSAO_CreateContext_CPU(ContextDesc, &pAOContext);
+    if (Status == GFSDK_SSAO_OK)
+    {
+        const GFSDK_SSAO_ShaderResourceView_CPU& DepthSRV = InputData.DepthData.FullResDepthTextureSRV;
+        Pixels.assign(DepthSRV.Width * DepthSRV.Height * NumChannels, -1.f);
+
+        GFSDK_SSAO_RenderTargetView_CPU RenderTarget;
+        RenderTarget.pData = &Pixels[0];
+        RenderTarget.Width = DepthSRV.Width;
+        RenderTarget.Height = DepthSRV.Height;
+        RenderTarget.NumChannels = NumChannels;
+
+        GFSDK_SSAO_Output_CPU Output;
+        Output.pRenderTargetView = &RenderTarget;
+
+        Status = pAOContext->RenderAO(InputData, Params, Output, RenderMask);
+    }
+
+    if (pAOContext)
+    {
+        pAOContext->Release();
+    }
+
+    return Status;
+}
+
+//--------------------------------------------------------------------------------
+// FETCH_GBUFFER_NORMAL_1: GBuffer normals equal to the reconstructed ones (read back with
+// GFSDK_SSAO_RENDER_DEBUG_NORMAL) render the same AO as FETCH_GBUFFER_NORMAL_0.
+// FETCH_GBUFFER_NORMAL_2: the same normals and depths as sample 0 of 2x MSAA textures render
+// exactly the same AO as FETCH_GBUFFER_NORMAL_1.
+//--------------------------------------------------------------------------------
+static void TestNormalPermutations()
+{
+    const TestScene Scene(TestScene::CORNER, 97, 61);
+    const UINT NumPixels = Scene.GetWidth() * Scene.GetHeight();
+
+    GFSDK_SSAO_Parameters Params;
+    Params.Radius = 1.5f;
+    Params.Blur.Enable = false;
+
+    GFSDK_SSAO_InputData_CPU InputData = Scene.GetInputData(false);
+    std::vector<float> ReconstructedAO;
+    CHECK(RenderWithScalarKernels(InputData, Params, GFSDK_SSAO_RENDER_AO, 1, ReconstructedAO) == GFSDK_SSAO_OK);
+
+    // The debug normals are the negated view-space normals, hence the DecodeScale of -1
+    std::vector<float> DebugNormals;
+    CHECK(RenderWithScalarKernels(InputData, Params, GFSDK_SSAO_RENDER_DEBUG_NORMAL, 4, DebugNormals) == GFSDK_SSAO_OK);
+
+    const float Identity[16] =
+    {
+        1.f, 0.f, 0.f, 0.f,
+        0.f, 1.f, 0.f, 0.f,
+        0.f, 0.f, 1.f, 0.f,
+        0.f, 0.f, 0.f, 1.f,
+    };
+    InputData.NormalData.Enable = true;
+    InputData.NormalData.WorldToViewMatrix.Data = GFSDK_SSAO_Float4x4(Identity);
+    InputData.NormalData.DecodeScale = -1.f;
+    InputData.NormalData.DecodeBias = 0.f;
+    InputData.NormalData.FullResNormalTextureSRV.pData = &DebugNormals[0];
+    InputData.NormalData.FullResNormalTextureSRV.Width = Scene.GetWidth();
+    InputData.NormalData.FullResNormalTextureSRV.Height = Scene.GetHeight();
+    InputData.NormalData.FullResNormalTextureSRV.NumChannels = 4;
+
+    std::vector<float> GBufferAO;
+    CHECK(RenderWithScalarKernels(InputData, Params, GFSDK_SSAO_RENDER_AO, 1, GBufferAO) == GFSDK_SSAO_OK);
+    CHECK(GetMaxDifference(GBufferAO, ReconstructedAO) <= 1.e-5f);
+
+    // Sample 1 holds a closer depth and another normal, which must not be read
+    std::vector<float> MSAADepths(2 * NumPixels);
+    std::vector<float> MSAANormals(2 * 4 * NumPixels);
+    for (UINT i = 0; i < NumPixels; ++i)
+    {
+        MSAADepths[2 * i + 0] = InputData.DepthData.FullResDepthTextureSRV.pData[i];
+        MSAADepths[2 * i + 1] = 0.5f;
+        for (UINT Channel = 0; Channel < 4; ++Channel)
+        {
+            MSAANormals[8 * i + Channel] = DebugNormals[4 * i + Channel];
+            MSAANormals[8 * i + 4 + Channel] = (Channel == 0) ? 1.f : 0.f;
+        }
+    }
+    InputData.DepthData.FullResDepthTextureSRV.pData = &MSAADepths[0];
+    InputData.DepthData.FullResDepthTextureSRV.SampleCount = 2;
+    InputData.DepthData.FullResDepthTexture2ndLayerSRV = InputData.DepthData.FullResDepthTextureSRV;
+    InputData.NormalData.FullResNormalTextureSRV.pData = &MSAANormals[0];
+    InputData.NormalData.FullResNormalTextureSRV.SampleCount = 2;
+
+    std::vector<float> MSAAGBufferAO;
+    CHECK(RenderWithScalarKernels(InputData, Params, GFSDK_SSAO_RENDER_AO, 1, MSAAGBufferAO) == GFSDK_SSAO_OK);
+    CHECK(MSAAGBufferAO == GBufferAO);
+}
+
+//--------------------------------------------------------------------------------
+// DEPTH_LAYER_COUNT_2: two identical layers render exactly the same AO as a single layer,
+// whose depths are also stored in FP16
+//--------------------------------------------------------------------------------
+static void TestDepthLayerPermutations()
+{
+    const TestScene Scene(TestScene::CORNER, 97, 61);
+
+    for (UINT Config = 0; Config < 4; ++Config)
+    {
+        GFSDK_SSAO_Parameters Params;
+        Params.Radius = 1.5f;
+        Params.DepthStorage = GFSDK_SSAO_FP16_VIEW_DEPTHS;
+        Params.Blur.Enable = (Config & 1) != 0;
+        const bool EnableNormals = (Config & 2) != 0;
+
+        std::vector<float> SingleLayerAO;
+        CHECK(RenderWithScalarKernels(Scene.GetInputData(EnableNormals), Params, GFSDK_SSAO_RENDER_AO, 1, SingleLayerAO) == GFSDK_SSAO_OK);
+
+        Params.EnableDualLayerAO = true;
+        std::vector<float> DualLayerAO;
+        CHECK(RenderWithScalarKernels(Scene.GetInputData(EnableNormals), Params, GFSDK_SSAO_RENDER_AO, 1, DualLayerAO) == GFSDK_SSAO_OK);
+        CHECK(DualLayerAO == SingleLayerAO);
+    }
+}
+
+//--------------------------------------------------------------------------------
+// CoarseAO_PS.hlsl for one quarter-res pixel of a slice, with the number of steps and of depth
+// layers as runtime values. Reads FP32 depth slices, and GBuffer normals with DepthClampMode
+// CLAMP_TO_EDGE and without foreground, background or depth-threshold parameters.
+//--------------------------------------------------------------------------------
+static float ReferenceCoarseAO(
+    const GFSDK::SSAO::GlobalConstantBuffer& CB,
+    const GFSDK::SSAO::PerPassConstantStruct& PerPass,
+    const GFSDK::SSAO::CPU::ShaderResourceView& DepthSlice,
+    const GFSDK::SSAO::CPU::ShaderResourceView& GBufferNormals,
+    int NumSteps,
+    bool DualLayer,
+    int X,
+    int Y)
+{
+    const float PosX = float(X) * 4.f + PerPass.f2Offset.X;
+    const float PosY = float(Y) * 4.f + PerPass.f2Offset.Y;
+    const float U = PosX * (CB.f2InvQuarterResolution.X / 4.f);
+    const float V = PosY * (CB.f2InvQuarterResolution.Y / 4.f);
+
+    const float ViewDepth = DepthSlice.Load(X, Y)[0];
+    const float P[3] = { (CB.f2UVToViewA.X * U + CB.f2UVToViewB.X) * ViewDepth, (CB.f2UVToViewA.Y * V + CB.f2UVToViewB.Y) * ViewDepth, ViewDepth };
+
+    // FetchFullResViewNormal_GBuffer
+    const FLOAT* pN = GBufferNormals.Load(Min(UINT(PosX), GBufferNormals.Width - 1), Min(UINT(PosY), GBufferNormals.Height - 1));
+    float N[3];
+    for (UINT Row = 0; Row < 3; ++Row)
+    {
+        N[Row] = 0.f;
+        for (UINT Col = 0; Col < 3; ++Col)
+        {
+            N[Row] += (pN[Col] * CB.fNormalDecodeScale + CB.fNormalDecodeBias) * CB.f44NormalMatrix.Data[Col * 4 + Row];
+        }
+    }
+    const float InvLength = 1.f / sqrtf(N[0] * N[0] + N[1] * N[1] + N[2] * N[2]);
+    N[0] *= InvLength;
+    N[1] *= InvLength;
+    N[2] *= InvLength;
+
+    const float RadiusPixels = CB.fRadiusToScreen / ViewDepth;
+    if (RadiusPixels < 1.f)
+    {
+        return 1.f;
+    }
+
+    const float StepSizePixels = (RadiusPixels / 4.f) / float(NumSteps + 1);
+    float SmallScaleAO = 0.f;
+    float LargeScaleAO = 0.f;
+
+    for (int DirectionIndex = 0; DirectionIndex < NUM_DIRECTIONS; ++DirectionIndex)
+    {
+        const float Angle = 2.f * GFSDK_PI / NUM_DIRECTIONS * float(DirectionIndex);
+        const float DirX = cosf(Angle) * PerPass.f4Jitter.X - sinf(Angle) * PerPass.f4Jitter.Y;
+        const float DirY = cosf(Angle) * PerPass.f4Jitter.Y + sinf(Angle) * PerPass.f4Jitter.X;
+
+        float RayPixels = PerPass.f4Jitter.Z * StepSizePixels + 1.f;
+        for (int StepIndex = 0; StepIndex < NumSteps; ++StepIndex, RayPixels += StepSizePixels)
+        {
+            const float SnappedX = nearbyintf(RayPixels * DirX);
+            const float SnappedY = nearbyintf(RayPixels * DirY);
+            const float SnappedU = SnappedX * CB.f2InvQuarterResolution.X + U;
+            const float SnappedV = SnappedY * CB.f2InvQuarterResolution.Y + V;
+            const FLOAT* pS = DepthSlice.Load(UINT(Clamp(X + int(SnappedX), 0, int(DepthSlice.Width) - 1)),
+                                              UINT(Clamp(Y + int(SnappedY), 0, int(DepthSlice.Height) - 1)));
+
+            float AO = 0.f;
+            for (int Layer = 0; Layer < (DualLayer ? 2 : 1); ++Layer)
+            {
+                const float SampleDepth = pS[Layer];
+                const float S[3] = { (CB.f2UVToViewA.X * SnappedU + CB.f2UVToViewB.X) * SampleDepth, (CB.f2UVToViewA.Y * SnappedV + CB.f2UVToViewB.Y) * SampleDepth, SampleDepth };
+                const float VX = S[0] - P[0];
+                const float VY = S[1] - P[1];
+                const float VZ = S[2] - P[2];
+                const float VdotV = VX * VX + VY * VY + VZ * VZ;
+                const float NdotV = (N[0] * VX + N[1] * VY + N[2] * VZ) / sqrtf(VdotV);
+                const float Falloff = VdotV * CB.fNegInvR2 + 1.f;
+                AO = Max(AO, Clamp(NdotV - CB.fNDotVBias, 0.f, 1.f) * Clamp(Falloff, 0.f, 1.f));
+            }
+
+            if (StepIndex == 0)
+            {
+                SmallScaleAO += AO;
+            }
+            else
+            {
+                LargeScaleAO += AO;
+            }
+        }
+    }
+
+    const float AO = (SmallScaleAO * CB.fSmallScaleAOAmount + LargeScaleAO * CB.fLargeScaleAOAmount) / float(NUM_DIRECTIONS * NumSteps);
+    return Clamp(1.f - AO * 2.f, 0.f, 1.f);
+}
+
+//--------------------------------------------------------------------------------
+// NUM_STEPS_4 and NUM_STEPS_8: the scalar CoarseAO_PS kernels of each step count and depth layer
+// count match ReferenceCoarseAO in all the slices
+//--------------------------------------------------------------------------------
+static void TestStepCountPermutations()
+{
+    using namespace GFSDK::SSAO::CPU;
+
+    const TestScene Scene(TestScene::CORNER, 97, 61);
+    const TestScene SecondLayerScene(TestScene::FLAT, 97, 61);
+    const KernelTable& Kernels = Scalar::GetKernelTable();
+
+    GFSDK_SSAO_InputNormalData_CPU NormalData = Scene.GetInputData(true).NormalData;
+    ShaderResourceView GBufferNormals;
+    GBufferNormals.pData = NormalData.FullResNormalTextureSRV.pData;
+    GBufferNormals.Width = Scene.GetWidth();
+    GBufferNormals.Height = Scene.GetHeight();
+    GBufferNormals.RowPitch = 4 * Scene.GetWidth();
+    GBufferNormals.PixelStride = 4;
+
+    for (UINT Config = 0; Config < 4; ++Config)
+    {
+        const bool DualLayer = (Config & 1) != 0;
+        const ShaderPermutations::DEPTH_LAYER_COUNT DepthLayerCount = DualLayer ? ShaderPermutations::DEPTH_LAYER_COUNT_2 : ShaderPermutations::DEPTH_LAYER_COUNT_1;
+        const ShaderPermutations::NUM_STEPS NumSteps = (Config & 2) ? ShaderPermutations::NUM_STEPS_8 : ShaderPermutations::NUM_STEPS_4;
+
+        GFSDK_SSAO_Parameters Params;
+        Params.Radius = 1.5f;
+        Params.EnableDualLayerAO = DualLayer;
+        Params.DepthStorage = GFSDK_SSAO_FP32_VIEW_DEPTHS;
+        Params.StepCount = (Config & 2) ? GFSDK_SSAO_STEP_COUNT_8 : GFSDK_SSAO_STEP_COUNT_4;
+        const KernelConstants Constants(Scene, DualLayer ? &SecondLayerScene : NULL, Params);
+        const UINT QuarterWidth = Constants.GetQuarterWidth();
+        const UINT QuarterHeight = Constants.GetQuarterHeight();
+
+        TestTexture<FLOAT> Slices[16];
+        {
+            LinearizeDeinterleaveDepthArgs Args;
+            ZERO_STRUCT(Args);
+            Args.pGlobalCB = &Constants.GlobalCB.GetCB();
+            Args.DepthTexture[0] = KernelConstants::GetSRV(Constants.InputDepth.Texture0);
+            Args.DepthTexture[1] = KernelConstants::GetSRV(Constants.InputDepth.Texture1);
+            Args.Width = Scene.GetWidth();
+            Args.Height = Scene.GetHeight();
+            for (UINT SliceIndex = 0; SliceIndex < 16; ++SliceIndex)
+            {
+                Slices[SliceIndex].Create(QuarterWidth, QuarterHeight, DualLayer ? 2 : 1);
+            }
+            BindSlices(Slices, Args.QuarterResViewDepthTexture, Args.QuarterResHalfViewDepthTexture);
+            Kernels.LinearizeDeinterleaveDepth_PS.Get(DepthLayerCount)(Args, 0, QuarterHeight);
+        }
+
+        float MaxDiff = 0.f;
+        for (UINT SliceIndex = 0; SliceIndex < 16; ++SliceIndex)
+        {
+            TestTexture<FLOAT> AO;
+            AO.Create(QuarterWidth, QuarterHeight, 1);
+
+            CoarseAOArgs Args;
+            ZERO_STRUCT(Args);
+            Args.pGlobalCB = &Constants.GlobalCB.GetCB();
+            Args.pPerPassCB = &Constants.PerPassCBs.GetCB(SliceIndex);
+            Args.DepthClampMode = Params.DepthClampMode;
+            Args.QuarterResViewDepthTexture = Slices[SliceIndex].RTV;
+            Args.NormalTexture = GBufferNormals;
+            Args.AOTexture = AO.RTV;
+            Kernels.CoarseAO_PS.Get(ShaderPermutations::FETCH_GBUFFER_NORMAL_1, DepthLayerCount, NumSteps)(Args, 0, QuarterHeight);
+
+            for (UINT Y = 0; Y < QuarterHeight; ++Y)
+            {
+                for (UINT X = 0; X < QuarterWidth; ++X)
+                {
+                    const float ReferenceAO = ReferenceCoarseAO(Constants.GlobalCB.GetCB(), *Args.pPerPassCB, Slices[SliceIndex].RTV, GBufferNormals,
+                                                                (Config & 2) ? 8 : 4, DualLayer, int(X), int(Y));
+                    MaxDiff = Max(MaxDiff, fabsf(*AO.RTV.Store(X, Y) - ReferenceAO));
+                }
+            }
+        }
+        CHECK(MaxDiff <= 1.e-5f);
+    }
+}
+
+//--------------------------------------------------------------------------------
+// ENABLE_BLUR_1, KERNEL_RADIUS_2/4 and ENABLE_SHARPNESS_PROFILE_0/1: the blurred AO matches
+// ReferenceBlur applied to the AO rendered without blur, with the view depths of LinearizeDepth_PS
+//--------------------------------------------------------------------------------
+static void TestBlurPermutations()
+{
+    using namespace GFSDK::SSAO::CPU;
+
+    const TestScene Scene(TestScene::CORNER, 2 * BLUR_STRIP_WIDTH + 37, 43);
+    const UINT Width = Scene.GetWidth();
+    const UINT Height = Scene.GetHeight();
+
+    GFSDK_SSAO_Parameters Params;
+    Params.Radius = 1.5f;
+    Params.DepthStorage = GFSDK_SSAO_FP32_VIEW_DEPTHS;
+    Params.PowerExponent = 1.f;
+    Params.Blur.Enable = false;
+
+    std::vector<float> UnblurredAO;
+    CHECK(RenderWithScalarKernels(Scene.GetInputData(false), Params, GFSDK_SSAO_RENDER_AO, 1, UnblurredAO) == GFSDK_SSAO_OK);
+
+    for (UINT Config = 0; Config < 4; ++Config)
+    {
+        Params.PowerExponent = 2.f;
+        Params.Blur.Enable = true;
+        Params.Blur.Radius = (Config & 1) ? GFSDK_SSAO_BLUR_RADIUS_4 : GFSDK_SSAO_BLUR_RADIUS_2;
+        Params.Blur.SharpnessProfile.Enable = (Config & 2) != 0;
+        Params.Blur.SharpnessProfile.ForegroundSharpnessScale = 4.f;
+        Params.Blur.SharpnessProfile.ForegroundViewDepth = 2.f;
+        Params.Blur.SharpnessProfile.BackgroundViewDepth = 15.f;
+        const KernelConstants Constants(Scene, NULL, Params);
+
+        TestTexture<FLOAT> ViewDepths;
+        ViewDepths.Create(Width, Height, 1);
+        {
+            LinearizeDepthArgs Args;
+            ZERO_STRUCT(Args);
+            Args.pGlobalCB = &Constants.GlobalCB.GetCB();
+            Args.DepthTexture[0] = KernelConstants::GetSRV(Constants.InputDepth.Texture0);
+            Args.ViewDepthTexture[0] = ViewDepths.RTV;
+            Scalar::GetKernelTable().LinearizeDepth_PS.Get(ShaderPermutations::DEPTH_LAYER_COUNT_1)(Args, 0, Height);
+        }
+
+        std::vector<float> AOZ(2 * Width * Height);
+        for (UINT i = 0; i < Width * Height; ++i)
+        {
+            AOZ[2 * i + 0] = UnblurredAO[i];
+            AOZ[2 * i + 1] = ViewDepths.Data[i];
+        }
+
+        std::vector<float> Reference;
+        const ReferenceBlur Blur(Constants.GlobalCB.GetCB(), (Config & 1) ? 4 : 2, (Config & 2) != 0, Width, Height);
+        Blur.Run(AOZ, Reference);
+
+        std::vector<float> BlurredAO;
+        CHECK(RenderWithScalarKernels(Scene.GetInputData(false), Params, GFSDK_SSAO_RENDER_AO, 1, BlurredAO) == GFSDK_SSAO_OK);
+        CHECK(GetMaxDifference(BlurredAO, Reference) <= 1.e-6f);
+    }
+}
+
+//--------------------------------------------------------------------------------
+// The render times of a context only count its own frames, and cover the passes that ran
+//--------------------------------------------------------------------------------
+static void TestRenderTimes()
+{
+    const TestScene Scene(TestScene::CORNER, 64, 48);
+
+    GFSDK_SSAO_ContextDesc_CPU ContextDesc;
+    ContextDesc.NumThreads = 2;
+
+    GFSDK_SSAO_Context_CPU* pAOContext = NULL;
+    GFSDK_SSAO_Context_CPU* pOtherContext = NULL;
+    CHECK(GFSDK_SSAO_CreateContext_CPU(ContextDesc, &pAOContext) == GFSDK_SSAO_OK);
+    CHECK(GFSDK_SSAO_CreateContext_CPU(ContextDesc, &pOtherContext) == GFSDK_SSAO_OK);
+    if (!pAOContext || !pOtherContext)
+    {
+        return;
+    }
+
+    CHECK(pAOContext->GetRenderTimes(NULL) == GFSDK_SSAO_NULL_ARGUMENT);
+
+    GFSDK_SSAO_RenderTimes Times;
+    CHECK(pAOContext->GetRenderTimes(&Times) == GFSDK_SSAO_OK);
+    CHECK(Times.NumFrames == 0);
+
+    std::vector<float> Pixels(Scene.GetWidth() * Scene.GetHeight());
+    GFSDK_SSAO_RenderTargetView_CPU RenderTarget;
+    RenderTarget.pData = &Pixels[0];
+    RenderTarget.Width = Scene.GetWidth();
+    RenderTarget.Height = Scene.GetHeight();
+    RenderTarget.NumChannels = 1;
+
+    GFSDK_SSAO_Output_CPU Output;
+    Output.pRenderTargetView = &RenderTarget;
+
+    GFSDK_SSAO_Parameters Params;
+    Params.Blur.Enable = true;
+
+    const UINT NumFrames = 3;
+    for (UINT Frame = 0; Frame < NumFrames; ++Frame)
+    {
+        CHECK(pAOContext->RenderAO(Scene.GetInputData(false), Params, Output) == GFSDK_SSAO_OK);
+    }
+
+    CHECK(pAOContext->GetRenderTimes(&Times) == GFSDK_SSAO_OK);
+    CHECK(Times.NumFrames == NumFrames);
+
+    const GFSDK_SSAO_PassTime& Total = Times.Passes[GFSDK_SSAO_PASS_TOTAL];
+    CHECK(Total.LastMS > 0.f);
+    CHECK(Total.MinMS > 0.f && Total.MinMS <= Total.AvgMS && Total.AvgMS <= Total.P95MS && Total.P95MS <= Total.P99MS);
+    CHECK(Times.Passes[GFSDK_SSAO_PASS_COARSE_AO].MinMS > 0.f);
+    CHECK(Times.Passes[GFSDK_SSAO_PASS_COARSE_AO].P99MS <= Total.P99MS);
+    CHECK(Times.Passes[GFSDK_SSAO_PASS_BLURX].MinMS > 0.f);
+
+    // The blur is fused into a single pass
+    CHECK(Times.Passes[GFSDK_SSAO_PASS_BLURY].P99MS == 0.f);
+
+    // Host times of the RenderAO calls, which have no app state to save on the CPU context
+    CHECK(Times.NumCPUFrames == NumFrames);
+    const GFSDK_SSAO_PassTime& CPUTotal = Times.CPUPhases[GFSDK_SSAO_CPU_PHASE_TOTAL];
+    const GFSDK_SSAO_PassTime& CPURender = Times.CPUPhases[GFSDK_SSAO_CPU_PHASE_RENDER];
+    CHECK(CPUTotal.MinMS > 0.f && CPUTotal.MinMS <= CPUTotal.AvgMS && CPUTotal.AvgMS <= CPUTotal.P95MS && CPUTotal.P95MS <= CPUTotal.P99MS);
+    CHECK(CPURender.LastMS > 0.f && CPURender.LastMS <= CPUTotal.LastMS);
+    CHECK(Times.CPUPhases[GFSDK_SSAO_CPU_PHASE_SET_DATA_FLOW].LastMS > 0.f);
+    CHECK(Times.CPUPhases[GFSDK_SSAO_CPU_PHASE_SET_AO_PARAMETERS].LastMS <= Times.CPUPhases[GFSDK_SSAO_CPU_PHASE_SET_DATA_FLOW].LastMS);
+    CHECK(Times.CPUPhases[GFSDK_SSAO_CPU_PHASE_SAVE_APP_STATE].P99MS == 0.f);
+    CHECK(Times.CPUPhases[GFSDK_SSAO_CPU_PHASE_RESTORE_APP_STATE].P99MS == 0.f);
+
+    // A call that fails validation is not recorded
+    GFSDK_SSAO_Output_CPU NullOutput;
+    CHECK(pAOContext->RenderAO(Scene.GetInputData(false), Params, NullOutput) != GFSDK_SSAO_OK);
+    CHECK(pAOContext->GetRenderTimes(&Times) == GFSDK_SSAO_OK);
+    CHECK(Times.NumCPUFrames == NumFrames);
+
+    CHECK(pOtherContext->GetRenderTimes(&Times) == GFSDK_SSAO_OK);
+    CHECK(Times.NumFrames == 0);
+    CHECK(Times.NumCPUFrames == 0);
+
+    pAOContext->Release();
+    pOtherContext->Release();
+}
+
+//--------------------------------------------------------------------------------
+// Ranges and counters received by the profiler hooks, from any thread
+struct ProfilerEvents
+{
+    std::mutex Lock;
+    std::thread::id CallingThread;
+    UINT NumBeginRanges;
+    UINT NumEndRanges;
+    UINT NumCoarseAORanges;
+    UINT NumTotalRangesOnCallingThread;
+    UINT NumCounters;
+    float RenderAOCounterMS;
+
+    static void BeginRange(const char* pName, GFSDK_SSAO_UINT Color, void* pCommandList, void* pUserData)
+    {
+        ProfilerEvents& Events = *static_cast<ProfilerEvents*>(pUserData);
+        std::lock_guard<std::mutex> Guard(Events.Lock);
+        ++Events.NumBeginRanges;
+        Events.NumCoarseAORanges += !strcmp(pName, "CoarseAO") && (Color >> 24) == 0xff && !pCommandList;
+        Events.NumTotalRangesOnCallingThread += !strcmp(pName, "HBAO+") && std::this_thread::get_id() == Events.CallingThread;
+    }
+
+    static void EndRange(void* pCommandList, void* pUserData)
+    {
+        ProfilerEvents& Events = *static_cast<ProfilerEvents*>(pUserData);
+        std::lock_guard<std::mutex> Guard(Events.Lock);
+        Events.NumEndRanges += !pCommandList;
+    }
+
+    static void Counter(const char* pName, GFSDK_SSAO_FLOAT Value, void* pUserData)
+    {
+        ProfilerEvents& Events = *static_cast<ProfilerEvents*>(pUserData);
+        std::lock_guard<std::mutex> Guard(Events.Lock);
+        ++Events.NumCounters;
+        if (!strcmp(pName, "RenderAO"))
+        {
+            Events.RenderAOCounterMS = Value;
+        }
+    }
+};
+
+//--------------------------------------------------------------------------------
+static void TestProfilerHooks()
+{
+    const TestScene Scene(TestScene::CORNER, 64, 48);
+
+    GFSDK_SSAO_ContextDesc_CPU ContextDesc;
+    ContextDesc.NumThreads = 4;
+
+    GFSDK_SSAO_Context_CPU* pAOContext = NULL;
+    CHECK(GFSDK_SSAO_CreateContext_CPU(ContextDesc, &pAOContext) == GFSDK_SSAO_OK);
+    if (!pAOContext)
+    {
+        return;
+    }
+
+    ProfilerEvents Events;
+    Events.CallingThread = std::this_thread::get_id();
+    Events.NumBeginRanges = 0;
+    Events.NumEndRanges = 0;
+    Events.NumCoarseAORanges = 0;
+    Events.NumTotalRangesOnCallingThread = 0;
+    Events.NumCounters = 0;
+    Events.RenderAOCounterMS = 0.f;
+
+    GFSDK_SSAO_ProfilerHooks Hooks;
+    Hooks.begin_range_ = ProfilerEvents::BeginRange;
+    Hooks.pUserData = &Events;
+    CHECK(pAOContext->SetProfilerHooks(Hooks) == GFSDK_SSAO_NULL_ARGUMENT);
+
+    Hooks.end_range_ = ProfilerEvents::EndRange;
+    Hooks.counter_ = ProfilerEvents::Counter;
+    CHECK(pAOContext->SetProfilerHooks(Hooks) == GFSDK_SSAO_OK);
+
+    std::vector<float> Pixels(Scene.GetWidth() * Scene.GetHeight());
+    GFSDK_SSAO_RenderTargetView_CPU RenderTarget;
+    RenderTarget.pData = &Pixels[0];
+    RenderTarget.Width = Scene.GetWidth();
+    RenderTarget.Height = Scene.GetHeight();
+    RenderTarget.NumChannels = 1;
+
+    GFSDK_SSAO_Output_CPU Output;
+    Output.pRenderTargetView = &RenderTarget;
+
+    GFSDK_SSAO_Parameters Params;
+    Params.Blur.Enable = true;
+
+    CHECK(pAOContext->RenderAO(Scene.GetInputData(false), Params, Output) == GFSDK_SSAO_OK);
+
+    // One range per tile of each pass, plus the range of the whole call on the calling thread
+    CHECK(Events.NumBeginRanges > 2);
+    CHECK(Events.NumEndRanges == Events.NumBeginRanges);
+    CHECK(Events.NumCoarseAORanges > 0);
+    CHECK(Events.NumTotalRangesOnCallingThread == 1);
+
+    // One counter per pass and one per CPU phase
+    CHECK(Events.NumCounters == GFSDK_SSAO_PASS_COUNT + GFSDK_SSAO_CPU_PHASE_COUNT);
+    CHECK(Events.RenderAOCounterMS > 0.f);
+
+    // Resetting the hooks stops the reporting
+    const UINT NumBeginRanges = Events.NumBeginRanges;
+    CHECK(pAOContext->SetProfilerHooks(GFSDK_SSAO_ProfilerHooks()) == GFSDK_SSAO_OK);
+    CHECK(pAOContext->RenderAO(Scene.GetInputData(false), Params, Output) == GFSDK_SSAO_OK);
+    CHECK(Events.NumBeginRanges == NumBeginRanges);
+    CHECK(Events.NumCounters == GFSDK_SSAO_PASS_COUNT + GFSDK_SSAO_CPU_PHASE_COUNT);
+
+    pAOContext->Release();
+}
+
+//--------------------------------------------------------------------------------
+static UINT CountOccurrences(const std::string& Text, const char* pPattern)
+{
+    UINT Count = 0;
+    for (size_t Pos = Text.find(pPattern); Pos != std::string::npos; Pos = Text.find(pPattern, Pos + 1))
+    {
+        ++Count;
+    }
+    return Count;
+}
+
+//--------------------------------------------------------------------------------
+static void TestChromeTrace()
+{
+    const TestScene Scene(TestScene::CORNER, 64, 48);
+
+    std::vector<float> Pixels(Scene.GetWidth() * Scene.GetHeight());
+    GFSDK_SSAO_RenderTargetView_CPU RenderTarget;
+    RenderTarget.pData = &Pixels[0];
+    RenderTarget.Width = Scene.GetWidth();
+    RenderTarget.Height = Scene.GetHeight();
+    RenderTarget.NumChannels = 1;
+
+    GFSDK_SSAO_Output_CPU Output;
+    Output.pRenderTargetView = &RenderTarget;
+
+    GFSDK_SSAO_Parameters Params;
+    Params.Blur.Enable = true;
+
+    // One track per context, each rendering two frames
+    ChromeTraceWriter Trace;
+    const char* s_TrackNames[] = { "Single-threaded", "\"Four\" threads" };
+    for (UINT ContextIndex = 0; ContextIndex < 2; ++ContextIndex)
+    {
+        GFSDK_SSAO_ContextDesc_CPU ContextDesc;
+        ContextDesc.NumThreads = ContextIndex ? 4 : 1;
+
+        GFSDK_SSAO_Context_CPU* pAOContext = NULL;
+        CHECK(GFSDK_SSAO_CreateContext_CPU(ContextDesc, &pAOContext) == GFSDK_SSAO_OK);
+        if (!pAOContext)
+        {
+            return;
+        }
+
+        CHECK(pAOContext->SetProfilerHooks(Trace.AddContext(s_TrackNames[ContextIndex])) == GFSDK_SSAO_OK);
+        CHECK(pAOContext->RenderAO(Scene.GetInputData(false), Params, Output) == GFSDK_SSAO_OK);
+        CHECK(pAOContext->RenderAO(Scene.GetInputData(false), Params, Output) == GFSDK_SSAO_OK);
+
+        pAOContext->Release();
+    }
+    CHECK(Trace.GetNumEvents() > 0);
+
+    const char* pFileName = "GFSDK_SSAO_Test_CPU_Trace.json";
+    CHECK(Trace.Write(pFileName));
+
+    std::string Json;
+    FILE* pFile = fopen(pFileName, "r");
+    CHECK(pFile != NULL);
+    if (pFile)
+    {
+        char Buffer[4096];
+        for (size_t Size; (Size = fread(Buffer, 1, sizeof(Buffer), pFile)) != 0; )
+        {
+            Json.append(Buffer, Size);
+        }
+        fclose(pFile);
+    }
+    remove(pFileName);
+
+    CHECK(Json.find("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[") == 0);
+    CHECK(Json.find("]}") != std::string::npos);
+
+    // The track names are escaped
+    CHECK(CountOccurrences(Json, "\"process_name\"") == 2);
+    CHECK(Json.find("\"name\":\"Single-threaded\"") != std::string::npos);
+    CHECK(Json.find("\"name\":\"\\\"Four\\\" threads\"") != std::string::npos);
+
+    // Balanced ranges on both tracks, and one counter per pass and per CPU phase for each frame
+    const UINT NumBeginRanges = CountOccurrences(Json, "\"ph\":\"B\"");
+    CHECK(NumBeginRanges > 4);
+    CHECK(CountOccurrences(Json, "\"ph\":\"E\"") == NumBeginRanges);
+    CHECK(CountOccurrences(Json, "\"ph\":\"C\"") == 4 * (GFSDK_SSAO_PASS_COUNT + GFSDK_SSAO_CPU_PHASE_COUNT));
+    CHECK(Json.find("\"name\":\"CoarseAO\",\"ph\":\"B\"") != std::string::npos);
+    CHECK(Json.find("\"name\":\"RenderAO\",\"ph\":\"C\"") != std::string::npos);
+    CHECK(Json.find("\"pid\":1,") != std::string::npos);
+    CHECK(Json.find("\"pid\":2,") != std::string::npos);
+}
+
+//--------------------------------------------------------------------------------
+int main()
+{
+    TestInvalidArguments();
+    TestAllocationFailures();
+    TestConfigurations();
+    TestInstructionSets();
+    TestOcclusion();
+    TestLineSweepLines();
+    TestDepthDeinterleaving();
+    TestBlur();
+    TestNormalPermutations();
+    TestDepthLayerPermutations();
+    TestStepCountPermutations();
+    TestBlurPermutations();
+    TestRenderTimes();
+    TestProfilerHooks();
+    TestChromeTrace();
+
+    if (s_NumFailures)
+    {
+        fprintf(stderr, "%u check(s) failed\n", s_NumFailures);
+        return 1;
+    }
+
+    printf("All tests passed\n");
+    return 0;
+}